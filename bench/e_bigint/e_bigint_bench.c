@@ -0,0 +1,177 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_bigint multiplication benchmark
+ *
+ * measures a naive schoolbook product on 64bit limbs against e_bigint_mul,
+ * with a reserved scratch and with a scratch allocated on every call, for
+ * operands from 1K to 100K bits.
+ *
+ * usage: e_bigint_bench [work_scale]
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "e_bigint.h"
+
+static const size_t sizes[] = { 16, 32, 64, 128, 256, 512, 1024, 1600 };
+
+/* private function priv_now
+ *
+ * monotonic enough wall clock in seconds
+ */
+static double priv_now(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* private function priv_multiply_add
+ *
+ * 128bit value of a * b + c + d as its high and low 64 bits
+ */
+static inline uint64_t priv_multiply_add(const uint64_t a, const uint64_t b,
+                                         const uint64_t c, const uint64_t d,
+                                         uint64_t* low)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 priv_u128_t;
+    const priv_u128_t value = (priv_u128_t)a * b + c + d;
+    *low = (uint64_t)value;
+    return (uint64_t)(value >> 64);
+#else
+    const uint64_t a_high = a >> 32;
+    const uint64_t a_low = (uint32_t)a;
+    const uint64_t b_high = b >> 32;
+    const uint64_t b_low = (uint32_t)b;
+    const uint64_t middle_1 = a_high * b_low;
+    const uint64_t middle_2 = a_low * b_high;
+    const uint64_t low_low = a_low * b_low;
+    const uint64_t cross = (low_low >> 32) + (uint32_t)middle_1
+                           + (uint32_t)middle_2;
+    uint64_t high = a_high * b_high + (middle_1 >> 32) + (middle_2 >> 32)
+                    + (cross >> 32);
+    uint64_t sum = (cross << 32) | (uint32_t)low_low;
+    sum += c;
+    high += (sum < c);
+    sum += d;
+    high += (sum < d);
+    *low = sum;
+    return high;
+#endif
+}
+
+/* private function priv_naive
+ *
+ * r = a * b on n limbs, one row per limb of b
+ */
+static void priv_naive(uint64_t* r, const uint64_t* a, const uint64_t* b,
+                       const size_t n)
+{
+    memset(r, 0, 2 * n * sizeof(uint64_t));
+    for (size_t i = 0; i < n; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < n; j++) {
+            carry = priv_multiply_add(a[j], b[i], r[i + j], carry,
+                                      &r[i + j]);
+        }
+        r[i + n] = carry;
+    }
+}
+
+/* private function priv_fill
+ *
+ * n pseudo random limbs, the top one not 0
+ */
+static void priv_fill(uint64_t* limbs, const size_t n, uint64_t seed)
+{
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 6364136223846793005u + 1442695040888963407u;
+        limbs[i] = seed ^ (seed >> 29);
+    }
+    limbs[n - 1] |= (uint64_t)1 << 63;
+}
+
+int main(int argc, char* argv[])
+{
+    const double scale = (argc > 1) ? atof(argv[1]) : 1.0;
+    const size_t largest = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+    uint64_t* a_limbs = malloc(largest * sizeof(uint64_t));
+    uint64_t* b_limbs = malloc(largest * sizeof(uint64_t));
+    uint64_t* product = malloc(2 * largest * sizeof(uint64_t));
+    if (a_limbs == NULL || b_limbs == NULL || product == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    e_bigint_t a;
+    e_bigint_t b;
+    e_bigint_t c;
+    e_bigint_scratch_t scratch;
+    e_bigint_init(&a);
+    e_bigint_init(&b);
+    e_bigint_init(&c);
+    e_bigint_scratch_init(&scratch);
+
+    fprintf(stdout, "%7s %6s %12s %12s %12s %8s\n", "bits", "limbs",
+            "naive us", "e_bigint us", "no scratch", "speedup");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        const size_t n = sizes[i];
+        size_t rounds = (size_t)(scale * 2e8 / (double)(n * n));
+        rounds = (rounds == 0) ? 1 : rounds;
+        priv_fill(a_limbs, n, n);
+        priv_fill(b_limbs, n, n + 1);
+        if (e_bigint_set_limbs(&a, a_limbs, n, false) != E_STRING_SUCCESS
+            || e_bigint_set_limbs(&b, b_limbs, n, false) != E_STRING_SUCCESS
+            || e_bigint_scratch_reserve(&scratch, n, n) != E_STRING_SUCCESS
+            || e_bigint_reserve(&c, 2 * n) != E_STRING_SUCCESS) {
+            return EXIT_FAILURE;
+        }
+
+        double start = priv_now();
+        for (size_t r = 0; r < rounds; r++) {
+            priv_naive(product, a_limbs, b_limbs, n);
+        }
+        const double naive = (priv_now() - start) * 1e6 / (double)rounds;
+
+        start = priv_now();
+        for (size_t r = 0; r < rounds; r++) {
+            if (e_bigint_mul(&c, &a, &b, &scratch) != E_STRING_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+        }
+        const double reserved = (priv_now() - start) * 1e6 / (double)rounds;
+
+        start = priv_now();
+        for (size_t r = 0; r < rounds; r++) {
+            if (e_bigint_mul(&c, &a, &b, NULL) != E_STRING_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+        }
+        const double allocated = (priv_now() - start) * 1e6 / (double)rounds;
+
+        /* both products must agree, or the timings mean nothing */
+        if (memcmp(product, c.limbs, c.length * sizeof(uint64_t)) != 0) {
+            return EXIT_FAILURE;
+        }
+        fprintf(stdout, "%7zu %6zu %12.2f %12.2f %12.2f %7.2fx\n", n * 64, n,
+                naive, reserved, allocated, naive / reserved);
+    }
+
+    e_bigint_free(&a);
+    e_bigint_free(&b);
+    e_bigint_free(&c);
+    e_bigint_scratch_free(&scratch);
+    free(a_limbs);
+    free(b_limbs);
+    free(product);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_sort benchmark
+ *
+ * measures qsort against e_string_sort, e_string_sort_stable and
+ * e_string_sort_indices over random words and over urls sharing a prefix.
+ *
+ * usage: e_string_sort_bench [strings_in_millions] [threads]
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "e_string.h"
+
+/* private function priv_now
+ *
+ * monotonic enough wall clock in seconds
+ */
+static double priv_now(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* private function priv_random
+ *
+ * xorshift generator, so the inputs are the same on every run
+ */
+static uint64_t priv_random(void)
+{
+    static uint64_t state = 0x9E3779B97F4A7C15ULL;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+/* private function priv_compare
+ *
+ * qsort order of strings
+ */
+static int priv_compare(const void* a, const void* b)
+{
+    const e_string_t* first = a;
+    const e_string_t* second = b;
+    const size_t first_length = e_string_length(first);
+    const size_t second_length = e_string_length(second);
+    const size_t shortest = (first_length < second_length) ? first_length
+                                                           : second_length;
+    const int order = memcmp(e_string_data(first), e_string_data(second),
+                             shortest);
+    if (order != 0) {
+        return order;
+    }
+    return (first_length > second_length) - (first_length < second_length);
+}
+
+/* private function priv_fill
+ *
+ * fills strings with random words (kind 0) or urls (kind 1)
+ */
+static void priv_fill(e_string_t* strings, const size_t count,
+                      const int kind)
+{
+    char buffer[128];
+    for (size_t i = 0; i < count; i++) {
+        const uint64_t random = priv_random();
+        if (kind == 0) {
+            const size_t length = 4 + (size_t)(random % 16);
+            for (size_t j = 0; j < length; j++) {
+                buffer[j] = (char)('a' + priv_random() % 26);
+            }
+            buffer[length] = '\0';
+        } else {
+            snprintf(buffer, sizeof(buffer),
+                     "https://example.com/users/%llu/orders/%llu",
+                     (unsigned long long)(random % 100000),
+                     (unsigned long long)(priv_random() % 1000000));
+        }
+        strings[i] = e_string_from_cstr(buffer);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t count = ((argc > 1) ? (size_t)atoi(argv[1]) : 1) * 1000000;
+    const size_t threads = (argc > 2) ? (size_t)atoi(argv[2]) : 4;
+    const char* kinds[] = { "words", "urls" };
+
+    e_string_t* strings = malloc(count * sizeof(e_string_t));
+    e_string_t* work = malloc(count * sizeof(e_string_t));
+    size_t* indices = malloc(count * sizeof(size_t));
+    if (strings == NULL || work == NULL || indices == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    fprintf(stdout, "%-6s %-26s %10s\n", "input", "sort", "ms");
+    for (int kind = 0; kind < 2; kind++) {
+        priv_fill(strings, count, kind);
+
+        memcpy(work, strings, count * sizeof(e_string_t));
+        double start = priv_now();
+        qsort(work, count, sizeof(e_string_t), priv_compare);
+        fprintf(stdout, "%-6s %-26s %10.1f\n", kinds[kind], "qsort",
+                (priv_now() - start) * 1e3);
+
+        for (size_t t = 1; t <= threads; t = (t == 1) ? threads : t + 1) {
+            char name[32];
+            memcpy(work, strings, count * sizeof(e_string_t));
+            start = priv_now();
+            if (e_string_sort(work, count, t) != E_STRING_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+            snprintf(name, sizeof(name), "e_string_sort %zut", t);
+            fprintf(stdout, "%-6s %-26s %10.1f\n", kinds[kind], name,
+                    (priv_now() - start) * 1e3);
+
+            memcpy(work, strings, count * sizeof(e_string_t));
+            start = priv_now();
+            if (e_string_sort_stable(work, count, t) != E_STRING_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+            snprintf(name, sizeof(name), "e_string_sort_stable %zut", t);
+            fprintf(stdout, "%-6s %-26s %10.1f\n", kinds[kind], name,
+                    (priv_now() - start) * 1e3);
+
+            start = priv_now();
+            if (e_string_sort_indices(strings, count, indices, t)
+                != E_STRING_SUCCESS) {
+                return EXIT_FAILURE;
+            }
+            snprintf(name, sizeof(name), "e_string_sort_indices %zut", t);
+            fprintf(stdout, "%-6s %-26s %10.1f\n", kinds[kind], name,
+                    (priv_now() - start) * 1e3);
+            if (t == threads) {
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            e_string_free(&strings[i]);
+        }
+    }
+
+    free(indices);
+    free(work);
+    free(strings);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_validate engines benchmark
+ *
+ * measures the throughput of every validation engine supported by the running
+ * CPU over ASCII, Latin, CJK and emoji-heavy corpora.
+ *
+ * usage: e_string_validate_bench [corpus_size_in_MiB]
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "e_string.h"
+
+#define BENCH_ROUNDS 10
+
+typedef struct bench_corpus
+{
+    const char* name;
+    const char* sample;
+} bench_corpus_t;
+
+static const bench_corpus_t corpora[] = {
+    { "ascii", "The quick brown fox jumps over the lazy dog, 0123456789.\n" },
+    { "latin", "Não há pão de queijo sem açúcar, disse a avó à criança.\n" },
+    { "cjk",   "我能吞下玻璃而不伤身体。私はガラスを食べられます。\n" },
+    { "emoji", "ok 😀😃😄 🚀🌍 𝄞𝄢 done 🎉🎊\n" }
+};
+
+static const struct {
+    const char* name;
+    e_string_engine_t engine;
+} engines[] = {
+    { "scalar", E_STRING_ENGINE_SCALAR },
+    { "dfa",    E_STRING_ENGINE_DFA },
+    { "sse4.2", E_STRING_ENGINE_SSE42 },
+    { "avx2",   E_STRING_ENGINE_AVX2 },
+    { "avx512", E_STRING_ENGINE_AVX512 },
+    { "auto",   E_STRING_ENGINE_AUTO }
+};
+
+/* private function priv_now
+ *
+ * monotonic enough wall clock in seconds
+ */
+static double priv_now(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* private function priv_build_corpus
+ *
+ * repeats the sample until the buffer is full, ending on a sample boundary
+ */
+static e_string_t priv_build_corpus(const char* sample, const size_t size)
+{
+    const size_t sample_length = strlen(sample);
+    const size_t repeat = size / sample_length;
+    e_string_t result = {
+        .data_length = repeat * sample_length,
+        .buffer_capacity = repeat * sample_length,
+        .data = malloc(repeat * sample_length)
+    };
+    for (size_t i = 0; i < repeat; i++) {
+        memcpy(result.data + i * sample_length, sample, sample_length);
+    }
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t size = ((argc > 1) ? (size_t)atoi(argv[1]) : 16) << 20;
+
+    fprintf(stdout, "%-8s %-8s %12s\n", "corpus", "engine", "MB/s");
+    for (size_t c = 0; c < sizeof(corpora) / sizeof(corpora[0]); c++) {
+        e_string_t corpus = priv_build_corpus(corpora[c].sample, size);
+
+        for (size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+            /* warm up the caches and check the engine is supported */
+            if (e_string_validate_ex(&corpus, engines[e].engine)
+                != E_STRING_SUCCESS) {
+                fprintf(stdout, "%-8s %-8s %12s\n",
+                        corpora[c].name, engines[e].name, "n/a");
+                continue;
+            }
+
+            const double start = priv_now();
+            for (int round = 0; round < BENCH_ROUNDS; round++) {
+                if (e_string_validate_ex(&corpus, engines[e].engine)
+                    != E_STRING_SUCCESS) {
+                    return EXIT_FAILURE;
+                }
+            }
+            const double elapsed = priv_now() - start;
+            const double mbps = (double)corpus.data_length * BENCH_ROUNDS
+                              / elapsed / 1e6;
+            fprintf(stdout, "%-8s %-8s %12.1f\n",
+                    corpora[c].name, engines[e].name, mbps);
+        }
+
+        free(corpus.data);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_arena header
+ *
+ * this module implements a region (bump) allocator over chunked slabs.
+ * memory is handed out by moving a cursor forward inside the current chunk,
+ * and it is never released one allocation at a time: e_arena_reset releases
+ * everything at once while keeping the chunks for reuse, and e_arena_destroy
+ * gives the chunks back to the system.
+ *
+ * chunks are allocated through the arena allocator (see
+ * e_arena_set_allocator), which e_string_set_allocator sets as well.
+ *
+ * usage: add #include "e_arena.h" to your file and link to e_arena library
+ */
+
+#ifndef E_ARENA_H
+#define E_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* NAMESPACE E_ARENA **********************************************************/
+
+/* e_arena chunk struct
+ *
+ * this is a slab of memory owned by an arena, chunks are linked in the order
+ * they are used.
+ *
+ * PODs definition
+ *   - next: defines the next chunk of the arena, NULL for the last one
+ *   - capacity: defines the amount of bytes available in data
+ *   - used: defines the amount of bytes of data already handed out
+ *   - data: defines the start of the memory handed out
+ */
+typedef struct e_arena_chunk
+{
+    struct e_arena_chunk* next;
+    size_t capacity;
+    size_t used;
+    uint8_t data[];
+} e_arena_chunk_t;
+
+/* e_arena struct
+ *
+ * this is the basic data structure of a region allocator.
+ *
+ * PODs definition
+ *   - head: defines the first chunk, NULL until the first allocation
+ *   - current: defines the chunk allocations are bumped from
+ *   - chunk_size: defines the capacity of new chunks, allocations larger than
+ *     it get a chunk of their own
+ *
+ * an arena must be initialized with e_arena_init prior to usage, and it is
+ * not thread safe: use one arena per thread (or per request).
+ */
+typedef struct e_arena
+{
+    e_arena_chunk_t* head;
+    e_arena_chunk_t* current;
+    size_t chunk_size;
+} e_arena_t;
+
+/* e_arena allocator struct
+ *
+ * this is the pair of functions chunks are allocated and released with.
+ *
+ * PODs definition
+ *   - allocate: returns size bytes of memory, or NULL on failure
+ *   - release: gives back memory of size bytes
+ *   - context: defines the pointer given as first argument to both functions
+ *
+ * the default allocator wraps malloc and free.
+ */
+typedef struct e_arena_allocator
+{
+    void* (*allocate)(void* context, const size_t size);
+    void  (*release)(void* context, void* memory, const size_t size);
+    void* context;
+} e_arena_allocator_t;
+
+/* E_ARENA_DEFAULT_CHUNK_SIZE
+ *
+ * defines the chunk capacity used when e_arena_init is given 0.
+ */
+#define E_ARENA_DEFAULT_CHUNK_SIZE ((size_t)64 * 1024)
+
+
+/* e_arena_init
+ *
+ * prepares an empty arena that allocates chunks of chunk_size bytes, no
+ * memory is requested until the first allocation.
+ */
+void e_arena_init(e_arena_t* arena, const size_t chunk_size);
+
+/* e_arena_alloc
+ *
+ * returns size bytes of uninitialized memory aligned to alignment (a power of
+ * 2), or NULL when the system is out of memory. the memory stays valid until
+ * the arena is reset or destroyed.
+ */
+void* e_arena_alloc(e_arena_t* arena, const size_t size, const size_t alignment);
+
+/* e_arena_reset
+ *
+ * releases every allocation of the arena at once. the chunks are kept and
+ * reused by the next allocations, so a steady workload stops calling malloc.
+ */
+void e_arena_reset(e_arena_t* arena);
+
+/* e_arena_destroy
+ *
+ * releases every chunk of the arena, leaving it as after e_arena_init.
+ */
+void e_arena_destroy(e_arena_t* arena);
+
+/* e_arena_set_allocator
+ *
+ * replaces the allocator of the chunks of every arena, NULL restores the
+ * default one. the table is copied.
+ *
+ * chunks are released by the allocator that is set at that moment, so
+ * change it while no arena holds chunks, and do not call it while other
+ * threads use arenas.
+ */
+void e_arena_set_allocator(const e_arena_allocator_t* allocator);
+
+
+#endif /* E_ARENA_H */
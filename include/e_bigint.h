@@ -0,0 +1,209 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_bigint header
+ *
+ * this module implements an arbitrary precision integer, stored as its sign
+ * and the 64bit limbs of its magnitude, least significant limb first.
+ *
+ * multiplication picks the algorithm by the size of the operands: schoolbook
+ * for small ones, then Karatsuba, then Toom-3. the larger algorithms need
+ * temporary limbs, which are taken from an e_bigint_scratch_t that can be
+ * kept across calls, so a loop of multiplications allocates once.
+ *
+ * memory goes through the e_string allocator (see e_string_set_allocator),
+ * and errors are the e_string ones.
+ *
+ * usage: add #include "e_bigint.h" to your file and link to e_bigint library
+ */
+
+#ifndef E_BIGINT_H
+#define E_BIGINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "e_string.h"
+
+/* NAMESPACE E_BIGINT *********************************************************/
+
+/* e_bigint structure
+ *
+ * this is the data structure of an arbitrary precision integer.
+ *
+ * PODs definition
+ *   - limbs: defines the magnitude, least significant limb first
+ *   - length: defines the amount of limbs used, the last one is never 0
+ *     (zero has no limbs)
+ *   - capacity: defines the amount of limbs allocated
+ *   - negative: defines the sign, zero is never negative
+ *
+ * the fields can be read directly, they are only written by the functions.
+ */
+typedef struct e_bigint
+{
+    uint64_t* limbs;
+    size_t length;
+    size_t capacity;
+    bool negative;
+} e_bigint_t;
+
+/* e_bigint_scratch structure
+ *
+ * this is the temporary memory of the multiplication, it grows as needed
+ * and is kept until e_bigint_scratch_free.
+ *
+ * PODs definition
+ *   - limbs: defines the temporary limbs
+ *   - capacity: defines the amount of limbs allocated
+ */
+typedef struct e_bigint_scratch
+{
+    uint64_t* limbs;
+    size_t capacity;
+} e_bigint_scratch_t;
+
+
+/* lifetime
+ * use this group of functions to prepare and release e_bigint_t data.
+ */
+
+/* e_bigint_init
+ *
+ * prepares bigint as zero, no memory is requested.
+ */
+void e_bigint_init(e_bigint_t* bigint);
+
+/* e_bigint_free
+ *
+ * releases the limbs of bigint, which is then zero and can be reused.
+ */
+void e_bigint_free(e_bigint_t* bigint);
+
+/* e_bigint_reserve
+ *
+ * makes room on bigint for at least limbs limbs, keeping its value.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the memory can not be allocated, bigint
+ * is then unchanged.
+ */
+e_string_errno_t e_bigint_reserve(e_bigint_t* bigint, const size_t limbs);
+
+
+/* assignment
+ * use this group of functions to give a value to an e_bigint_t.
+ *
+ * all of them return E_STRING_OUT_OF_MEMORY without changing bigint when
+ * its limbs can not grow.
+ */
+
+/* e_bigint_set_uint64
+ *
+ * sets bigint to number.
+ */
+e_string_errno_t e_bigint_set_uint64(e_bigint_t* bigint, const uint64_t number);
+
+/* e_bigint_set_int64
+ *
+ * sets bigint to number.
+ */
+e_string_errno_t e_bigint_set_int64(e_bigint_t* bigint, const int64_t number);
+
+/* e_bigint_set_limbs
+ *
+ * sets the magnitude of bigint to the count limbs given, least significant
+ * first (leading zero limbs are dropped), negated when negative is true.
+ * limbs must not point into bigint itself.
+ */
+e_string_errno_t e_bigint_set_limbs(e_bigint_t* bigint, const uint64_t* limbs,
+                                    const size_t count, const bool negative);
+
+/* e_bigint_copy
+ *
+ * sets destination to the value of source.
+ */
+e_string_errno_t e_bigint_copy(e_bigint_t* destination,
+                               const e_bigint_t* source);
+
+
+/* arithmetic
+ * use this group of functions to operate on e_bigint_t.
+ *
+ * result can be one of the operands (e.g. e_bigint_add(&a, &a, &b) adds b to
+ * a in place). all of them return E_STRING_OUT_OF_MEMORY if result can not
+ * grow, result is then unchanged.
+ */
+
+/* e_bigint_compare
+ *
+ * returns a negative number, 0 or a positive number when a is less than,
+ * equal to or greater than b.
+ */
+int e_bigint_compare(const e_bigint_t* a, const e_bigint_t* b);
+
+/* e_bigint_add
+ *
+ * sets result to a + b.
+ */
+e_string_errno_t e_bigint_add(e_bigint_t* result, const e_bigint_t* a,
+                              const e_bigint_t* b);
+
+/* e_bigint_sub
+ *
+ * sets result to a - b.
+ */
+e_string_errno_t e_bigint_sub(e_bigint_t* result, const e_bigint_t* a,
+                              const e_bigint_t* b);
+
+/* e_bigint_mul
+ *
+ * sets result to a * b. temporary limbs are taken from scratch, which grows
+ * when it is too small; NULL uses a scratch allocated for this call only.
+ * see e_bigint_scratch_reserve to allocate it once before a loop.
+ */
+e_string_errno_t e_bigint_mul(e_bigint_t* result, const e_bigint_t* a,
+                              const e_bigint_t* b,
+                              e_bigint_scratch_t* scratch);
+
+
+/* scratch
+ * use this group of functions to manage the temporary memory of
+ * e_bigint_mul.
+ */
+
+/* e_bigint_scratch_init
+ *
+ * prepares an empty scratch, no memory is requested.
+ */
+void e_bigint_scratch_init(e_bigint_scratch_t* scratch);
+
+/* e_bigint_scratch_free
+ *
+ * releases the memory of scratch, which is then empty and can be reused.
+ */
+void e_bigint_scratch_free(e_bigint_scratch_t* scratch);
+
+/* e_bigint_scratch_limbs
+ *
+ * returns the amount of limbs of scratch used by e_bigint_mul on operands
+ * of a_limbs and b_limbs limbs, or SIZE_MAX when it can not be allocated.
+ */
+size_t e_bigint_scratch_limbs(const size_t a_limbs, const size_t b_limbs);
+
+/* e_bigint_scratch_reserve
+ *
+ * makes room on scratch for a multiplication of operands of a_limbs and
+ * b_limbs limbs, so e_bigint_mul on operands of that size does not
+ * allocate.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the memory can not be allocated,
+ * scratch is then unchanged.
+ */
+e_string_errno_t e_bigint_scratch_reserve(e_bigint_scratch_t* scratch,
+                                          const size_t a_limbs,
+                                          const size_t b_limbs);
+
+#endif /* E_BIGINT_H */
\ No newline at end of file
@@ -20,6 +20,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "e_arena.h"
+
 /* NAMESPACE E_STRING *********************************************************/
 
 /* e_string struct
@@ -32,6 +34,9 @@
  *   - data_length: defines the current length for the stored string
  *   - buffer_capacity: defines the amount of stored memory in the buffer
  *   - data: defines pointer to the start of the UTF-8 string data
+ *   - codepoint_count: defines the amount of UTF-8 codepoints in data, only
+ *     meaningful when flags has E_STRING_FLAG_COUNTED
+ *   - flags: defines what is already known about data, see E_STRING_FLAG_*
  * 
  * length and capacity are stored as size_t to allow the maximum amount the
  * system can store - which is defined in SIZE_MAX .
@@ -43,14 +48,62 @@
  * the data is stored as UTF-8 strings, user must convert there string to UTF-8
  * compatible data prior to creating e_string_t.
  * functions for conversion are available at this library as well.
+ *
+ * flags and codepoint_count are a cache filled by the functions of this
+ * library, a zero value means nothing is known yet. functions that keep a
+ * property keep its flag, and functions that change data clear it.
+ * if data is changed directly, call e_string_invalidate afterwards.
+ *
+ * strings up to E_STRING_INLINE_CAPACITY bytes are stored inside the struct
+ * itself (small-string optimization), using the space of data_length,
+ * buffer_capacity and data. flags has E_STRING_FLAG_INLINE on this layout,
+ * and the length is kept on inline_length. use e_string_length,
+ * e_string_capacity and e_string_data to access both layouts the same way.
  */
+#define E_STRING_INLINE_CAPACITY (2 * sizeof(size_t) + sizeof(uint8_t*) - 1)
+
 typedef struct e_string
 {
-    size_t data_length;
-    size_t buffer_capacity;
-    uint8_t * data;
+    union {
+        struct {
+            size_t data_length;
+            size_t buffer_capacity;
+            uint8_t * data;
+        };
+        struct {
+            uint8_t inline_data[E_STRING_INLINE_CAPACITY];
+            uint8_t inline_length;
+        };
+    };
+    uint32_t codepoint_count;
+    uint32_t flags;
 } e_string_t;
 
+/* e_string flags macros
+ *
+ * defines the properties cached in e_string_t flags.
+ *   - E_STRING_FLAG_UTF8: data was validated as UTF-8
+ *   - E_STRING_FLAG_ASCII: data was validated and is US ASCII only, so each
+ *     byte is one codepoint
+ *   - E_STRING_FLAG_COUNTED: codepoint_count holds the amount of codepoints,
+ *     never set if the amount does not fit in 32 bits
+ */
+#define E_STRING_FLAG_UTF8    0x01u
+#define E_STRING_FLAG_ASCII   0x02u
+#define E_STRING_FLAG_COUNTED 0x04u
+
+/* e_string layout flags macros
+ *
+ * defines how the data of e_string_t is stored, these flags are not a cache
+ * and are kept by e_string_invalidate.
+ *   - E_STRING_FLAG_INLINE: data is stored on inline_data
+ *   - E_STRING_FLAG_ARENA: data is owned by an e_arena_t, and is released
+ *     with the arena instead of by e_string_free
+ */
+#define E_STRING_FLAG_ARENA   0x40u
+#define E_STRING_FLAG_INLINE  0x80u
+#define E_STRING_FLAGS_LAYOUT (E_STRING_FLAG_INLINE | E_STRING_FLAG_ARENA)
+
 /* e_string errno macros
  *
  * this is a simple data that defines typical error that this library can exit.
@@ -67,9 +120,132 @@ typedef struct e_string
 typedef int e_string_errno_t;
 #define E_STRING_INVALID_BUFFER -511
 #define E_STRING_INVALID_UTF8   -512
+#define E_STRING_UNSUPPORTED_ENGINE -513
+#define E_STRING_OUT_OF_MEMORY  -514
+#define E_STRING_IO_ERROR       -515
+#define E_STRING_OUT_OF_RANGE   -516
+#define E_STRING_INVALID_UNICODE -517
+#define E_STRING_INVALID_FORMAT  -518
+#define E_STRING_INVALID_NUMBER  -519
 #define E_STRING_ERROR           false   /* 0 */
 #define E_STRING_SUCCESS         true    /* 1 */
 
+/* e_string engine enum
+ *
+ * defines the implementation used to validate UTF-8 data.
+ *   - E_STRING_ENGINE_AUTO: widest engine supported by the running CPU
+ *   - E_STRING_ENGINE_SCALAR: byte by byte reference engine, always available
+ *   - E_STRING_ENGINE_DFA: branch-free state table engine, always available
+ *   - E_STRING_ENGINE_SSE42: 16 bytes per step, x86 only
+ *   - E_STRING_ENGINE_AVX2: 32 bytes per step, x86 only
+ *   - E_STRING_ENGINE_AVX512: 64 bytes per step, x86 only (AVX-512 F and BW)
+ *
+ * all engines return exactly the same result for the same data.
+ */
+typedef enum e_string_engine
+{
+    E_STRING_ENGINE_AUTO = 0,
+    E_STRING_ENGINE_SCALAR,
+    E_STRING_ENGINE_DFA,
+    E_STRING_ENGINE_SSE42,
+    E_STRING_ENGINE_AVX2,
+    E_STRING_ENGINE_AVX512
+} e_string_engine_t;
+
+
+/* e_string allocator struct
+ *
+ * this is the table of functions used by e_string to manage heap data, so
+ * the library can run on top of any allocator (jemalloc, a per-thread pool,
+ * a tracking allocator for tests...).
+ *
+ * PODs definition
+ *   - allocate: returns size bytes of memory, or NULL on failure
+ *   - reallocate: resizes memory from old_size to new_size bytes keeping its
+ *     contents, returns NULL on failure leaving memory untouched
+ *   - release: gives back memory of size bytes
+ *   - context: defines the pointer given as first argument to every function
+ *
+ * sizes are always given back, so sized allocators do not need headers.
+ * the default allocator wraps malloc, realloc and free.
+ */
+typedef struct e_string_allocator
+{
+    void* (*allocate)(void* context, const size_t size);
+    void* (*reallocate)(void* context, void* memory,
+                        const size_t old_size, const size_t new_size);
+    void  (*release)(void* context, void* memory, const size_t size);
+    void* context;
+} e_string_allocator_t;
+
+
+/* allocator
+ * use this group of functions to choose how e_string_t heap data is managed.
+ */
+
+/* e_string_set_allocator
+ *
+ * replaces the allocator used by every e_string function, NULL restores the
+ * default one. the table is copied, and also set as the allocator of arena
+ * chunks (see e_arena_set_allocator), so it covers the memory of arenas.
+ *
+ * memory is always released by the allocator that is set at that moment, so
+ * change it before creating strings (e.g. at program start), and do not call
+ * it while other threads use e_string.
+ */
+void e_string_set_allocator(const e_string_allocator_t* allocator);
+
+/* e_string_get_allocator
+ *
+ * returns the allocator currently used by e_string.
+ */
+const e_string_allocator_t* e_string_get_allocator(void);
+
+
+/* accessors
+ * use this group of functions to read e_string_t data on any layout.
+ */
+
+/* e_string_length
+ *
+ * returns the length in bytes of the stored string.
+ */
+static inline size_t e_string_length(const e_string_t* string)
+{
+    return ((string->flags & E_STRING_FLAG_INLINE) != 0)
+           ? string->inline_length : string->data_length;
+}
+
+/* e_string_capacity
+ *
+ * returns the amount of bytes the string can hold without allocating.
+ */
+static inline size_t e_string_capacity(const e_string_t* string)
+{
+    return ((string->flags & E_STRING_FLAG_INLINE) != 0)
+           ? E_STRING_INLINE_CAPACITY : string->buffer_capacity;
+}
+
+/* e_string_data
+ *
+ * returns a pointer to the start of the UTF-8 string data, the pointer of an
+ * inline string is only valid while the e_string_t itself is not moved.
+ */
+static inline const uint8_t* e_string_data(const e_string_t* string)
+{
+    return ((string->flags & E_STRING_FLAG_INLINE) != 0)
+           ? string->inline_data : string->data;
+}
+
+/* e_string_is_inline
+ *
+ * checks if the string is stored inside the e_string_t struct.
+ */
+static inline bool e_string_is_inline(const e_string_t* string)
+{
+    return (string->flags & E_STRING_FLAG_INLINE) != 0;
+}
+
 
 /* constructors
  * use this group of functions to create e_string_t data.
@@ -78,31 +254,43 @@ typedef int e_string_errno_t;
 /* e_string_from macro
  *
  * this macro delegates to the specialized constructor based on input type.
+ *
+ * integers are listed by their standard types, which the intN_t typedefs
+ * only alias (int64_t is long on some targets and long long on others), so
+ * every integer type is accepted: long and long long go to the 64bit
+ * constructors, e_string_from(42) goes to e_string_from_int32.
  */
-#define e_string_from(X) _Generic((X),                        \
-                         const char*:  e_string_from_cstr,    \
-                         uint64_t:     e_string_from_uint64,  \
-                         uint32_t:     e_string_from_uint32,  \
-                         uint16_t:     e_string_from_uint16,  \
-                         uint8_t:      e_string_from_uint8,   \
-                         int64_t:      e_string_from_int64,   \
-                         int32_t:      e_string_from_int32,   \
-                         int16_t:      e_string_from_int16,   \
-                         int8_t:       e_string_from_int8,    \
-                         int:          e_string_from_int,     \
-                         unsigned int: e_string_from_uint,    \
+#define e_string_from(X) _Generic((X),                                 \
+                         char*:              e_string_from_cstr,       \
+                         const char*:        e_string_from_cstr,       \
+                         unsigned long long: e_string_from_uint64,     \
+                         unsigned long:      e_string_from_uint64,     \
+                         unsigned int:       e_string_from_uint32,     \
+                         unsigned short:     e_string_from_uint16,     \
+                         unsigned char:      e_string_from_uint8,      \
+                         long long:          e_string_from_int64,      \
+                         long:               e_string_from_int64,      \
+                         int:                e_string_from_int32,      \
+                         short:              e_string_from_int16,      \
+                         signed char:        e_string_from_int8,       \
+                         double:             e_string_from_double,     \
+                         float:              e_string_from_float       \
                          )(X)
 
 /* e_string_from_cstr
  *
  * this function allows the user to create a e_string based on cstr.
  * it expects the user to provide a UTF-8 compliant cstr.
+ * cstr up to E_STRING_INLINE_CAPACITY bytes do not allocate memory.
  */
 e_string_t e_string_from_cstr(const char* cstr);
 
 /* e_string_from_uint64
  *
  * this function allows the user to create based on unsigned 64bit integer.
+ *
+ * all integer constructors write the decimal digits straight into the
+ * string, which is stored inline as any 64bit integer fits in it.
  */
 e_string_t e_string_from_uint64(const uint64_t number);
 
@@ -160,6 +348,186 @@ e_string_t e_string_from_int(const int number);
  */
 e_string_t e_string_from_uint(const unsigned int number);
 
+/* e_string float format enum
+ *
+ * this is the notation used to write floating point numbers, all of them
+ * use the fewest digits that read back to the same value:
+ *   - E_STRING_FLOAT_SHORTEST: positional from 1e-6 up to 1e21 and
+ *     scientific otherwise, as ECMAScript does (0.001, 1.5, 1e+21)
+ *   - E_STRING_FLOAT_FIXED: always positional (1000000000000000000000)
+ *   - E_STRING_FLOAT_SCIENTIFIC: always scientific (1.5e+0, 1e-3)
+ *
+ * infinities are written as inf and -inf, and not a number as nan.
+ */
+typedef enum e_string_float_format
+{
+    E_STRING_FLOAT_SHORTEST = 0,
+    E_STRING_FLOAT_FIXED,
+    E_STRING_FLOAT_SCIENTIFIC
+} e_string_float_format_t;
+
+/* e_string_from_double
+ *
+ * this function allows the user to create based on double, with the
+ * shortest text that reads back to number (E_STRING_FLOAT_SHORTEST).
+ *
+ * floating point constructors do not depend on the locale, the decimal
+ * separator is always a dot. -0.0 is written as -0.
+ */
+e_string_t e_string_from_double(const double number);
+
+/* e_string_from_float
+ *
+ * this function allows the user to create based on float, with the
+ * shortest text that reads back to number as a float.
+ */
+e_string_t e_string_from_float(const float number);
+
+/* e_string_from_double_ex
+ *
+ * same as e_string_from_double on the given format.
+ */
+e_string_t e_string_from_double_ex(const double number,
+                                   const e_string_float_format_t format);
+
+/* e_string_from_float_ex
+ *
+ * same as e_string_from_float on the given format.
+ */
+e_string_t e_string_from_float_ex(const float number,
+                                  const e_string_float_format_t format);
+
+/* e_string_from_uint64_array
+ *
+ * this function allows the user to create a single string holding all the
+ * numbers of an array, in order and joined by separator (a cstr, which can
+ * be empty). the data is allocated once, with its exact final size.
+ */
+e_string_t e_string_from_uint64_array(const uint64_t* numbers,
+                                      const size_t count,
+                                      const char* separator);
+
+/* e_string_from_uint32_array
+ *
+ * same as e_string_from_uint64_array for unsigned 32bit integers.
+ */
+e_string_t e_string_from_uint32_array(const uint32_t* numbers,
+                                      const size_t count,
+                                      const char* separator);
+
+/* e_string_from_int64_array
+ *
+ * same as e_string_from_uint64_array for signed 64bit integers.
+ */
+e_string_t e_string_from_int64_array(const int64_t* numbers,
+                                     const size_t count,
+                                     const char* separator);
+
+/* e_string_from_int32_array
+ *
+ * same as e_string_from_uint64_array for signed 32bit integers.
+ */
+e_string_t e_string_from_int32_array(const int32_t* numbers,
+                                     const size_t count,
+                                     const char* separator);
+
+/* arena constructors
+ * use this group of functions to create e_string_t data owned by an arena,
+ * so building a string costs a pointer bump and all the strings of the arena
+ * are released at once by e_arena_reset or e_arena_destroy.
+ *
+ * strings that fit inline are still stored inline and do not use the arena.
+ * an arena string must not be used after its arena is reset or destroyed.
+ */
+
+/* e_string_from_cstr_in
+ *
+ * same as e_string_from_cstr, with the data taken from arena.
+ */
+e_string_t e_string_from_cstr_in(e_arena_t* arena, const char* cstr);
+
+/* e_string_from_uint64_in
+ *
+ * same as e_string_from_uint64, with the data taken from arena. 64bit
+ * integers only need the arena on targets with 32bit pointers, as they fit
+ * inline otherwise.
+ */
+e_string_t e_string_from_uint64_in(e_arena_t* arena, const uint64_t number);
+
+/* e_string_from_int64_in
+ *
+ * same as e_string_from_int64, with the data taken from arena.
+ */
+e_string_t e_string_from_int64_in(e_arena_t* arena, const int64_t number);
+
+
+/* destructors
+ * use this group of functions to release e_string_t data.
+ */
+
+/* e_string_free
+ *
+ * releases the memory of a string created by this library and leaves it as
+ * an empty inline string, so it can be freed again or reused safely.
+ * the data of arena strings is left to the arena.
+ */
+void e_string_free(e_string_t* string);
+
+
+/* mutators
+ * use this group of functions to change e_string_t data in place.
+ *
+ * the capacity grows geometrically (at least doubling), so appending n bytes
+ * one at a time costs O(n) amortized. strings move from inline to the heap
+ * when they outgrow E_STRING_INLINE_CAPACITY, and arena strings move to the
+ * heap when they grow, leaving their old data to the arena.
+ *
+ * all of them return E_STRING_OUT_OF_MEMORY without changing the string when
+ * memory can not be allocated. cached flags are kept up to date.
+ */
+
+/* e_string_reserve
+ *
+ * makes sure at least additional more bytes can be added to the string
+ * without allocating again.
+ */
+e_string_errno_t e_string_reserve(e_string_t* string, const size_t additional);
+
+/* e_string_push_codepoint
+ *
+ * appends the UTF-8 encoding of codepoint. surrogates, values above
+ * 0x10FFFF and the US ASCII control codepoints rejected by e_string_validate
+ * are refused with E_STRING_INVALID_UTF8.
+ */
+e_string_errno_t e_string_push_codepoint(e_string_t* string,
+                                         const uint32_t codepoint);
+
+/* e_string_append
+ *
+ * appends a copy of the data of other, which can be string itself.
+ */
+e_string_errno_t e_string_append(e_string_t* string, const e_string_t* other);
+
+/* e_string_append_cstr
+ *
+ * appends a copy of cstr, which is expected to be UTF-8 compliant.
+ */
+e_string_errno_t e_string_append_cstr(e_string_t* string, const char* cstr);
+
+/* e_string_shrink_to_fit
+ *
+ * releases the capacity that is not used, moving the data inline when it
+ * fits. arena strings that do not fit inline are left as they are.
+ */
+e_string_errno_t e_string_shrink_to_fit(e_string_t* string);
+
+/* e_string_clear
+ *
+ * empties the string, keeping its capacity for reuse.
+ */
+void e_string_clear(e_string_t* string);
+
+
 /* data access and validation
  * use this group of functions to validate e_string_t data and safe access.
  */
@@ -171,8 +539,34 @@ e_string_t e_string_from_uint(const unsigned int number);
  * compatible size.
  *
  * it does not change the given data, nor it fix invalid structures.
+ *
+ * the result is cached on string flags, so validating the same string again
+ * only checks the buffer and the flag. US ASCII data also caches its
+ * codepoint count.
  */
-e_string_errno_t e_string_validate(const e_string_t* string);
+e_string_errno_t e_string_validate(e_string_t* string);
+
+/* e_string_validate_ex
+ *
+ * same as e_string_validate, but allows the user to choose the engine used to
+ * validate the UTF-8 data. the engine is picked by CPUID at runtime when
+ * E_STRING_ENGINE_AUTO is given, which is what e_string_validate does.
+ *
+ * if the running CPU does not support the chosen engine the data is not
+ * checked and E_STRING_UNSUPPORTED_ENGINE is returned.
+ *
+ * the data is always checked with the chosen engine, the cached flags are
+ * neither used nor updated.
+ */
+e_string_errno_t e_string_validate_ex(const e_string_t* string,
+                                      const e_string_engine_t engine);
+
+/* e_string_invalidate
+ *
+ * clears everything cached on the string, use it after changing data
+ * directly instead of through the functions of this library.
+ */
+void e_string_invalidate(e_string_t* string);
 
 
 
@@ -357,4 +751,1618 @@ bool e_string_utf8_is_plane_16(const uint8_t u8_1st_byte,
                                const uint8_t u8_4th_byte);
 
 
+/* e_string_utf8_stream struct
+ *
+ * this is the state of an incremental UTF-8 validation, allowing data that
+ * arrives in chunks (e.g. from read) to be validated in place, without
+ * joining the chunks into a single buffer.
+ *
+ * PODs definition
+ *   - offset: defines the amount of bytes fed so far
+ *   - error_offset: defines the absolute offset of the first invalid
+ *     codepoint, only meaningful after an E_STRING_INVALID_UTF8 result
+ *   - sequence_offset: defines the absolute offset where the multi-byte
+ *     sequence left open by the last chunk started
+ *   - state: defines the automaton state carried between chunks
+ *   - status: defines the result so far, once invalid it stays invalid
+ *
+ * the struct uses constant memory regardless of the amount of data fed, and
+ * must be initialized with e_string_utf8_stream_init prior to usage.
+ */
+typedef struct e_string_utf8_stream
+{
+    size_t offset;
+    size_t error_offset;
+    size_t sequence_offset;
+    uint32_t state;
+    e_string_errno_t status;
+} e_string_utf8_stream_t;
+
+/* e_string_utf8_stream_init
+ *
+ * resets the stream so a new validation can start.
+ */
+void e_string_utf8_stream_init(e_string_utf8_stream_t* stream);
+
+/* e_string_utf8_stream_feed
+ *
+ * validates the next chunk of data. a multi-byte sequence split between this
+ * chunk and the next one is carried in the stream state, the bulk of the chunk
+ * is validated with the engine picked by e_string_validate.
+ *
+ * returns E_STRING_INVALID_UTF8 as soon as invalid data is found, with the
+ * absolute offset stored in error_offset, further chunks are ignored.
+ */
+e_string_errno_t e_string_utf8_stream_feed(e_string_utf8_stream_t* stream,
+                                           const uint8_t* data,
+                                           const size_t length);
+
+/* e_string_utf8_stream_finish
+ *
+ * ends the validation, returning E_STRING_INVALID_UTF8 if any chunk was
+ * invalid or if the data ended in the middle of a multi-byte sequence.
+ */
+e_string_errno_t e_string_utf8_stream_finish(e_string_utf8_stream_t* stream);
+
+
+
+/* NAMESPACE E_STRING_VIEW ****************************************************/
+
+
+/* e_string_view struct
+ *
+ * this is a non-owning reference to UTF-8 data, borrowed from an e_string_t
+ * or from any raw buffer. none of the e_string_view functions allocate, and
+ * the view is only valid while the data it borrows is alive and unchanged.
+ *
+ * PODs definition
+ *   - data: defines pointer to the first byte of the view
+ *   - length: defines the amount of bytes of the view
+ *   - flags: defines what is known about data, only E_STRING_FLAG_UTF8 and
+ *     E_STRING_FLAG_ASCII are used
+ *
+ * views taken from a validated string carry its flags, and every view
+ * derived from it keeps them as long as it starts and ends on codepoint
+ * boundaries, so a view never needs to be validated again.
+ */
+typedef struct e_string_view
+{
+    const uint8_t* data;
+    size_t length;
+    uint32_t flags;
+} e_string_view_t;
+
+/* e_string_split struct
+ *
+ * this is the state of an iteration over the parts of a view separated by a
+ * delimiter, see e_string_split_init.
+ *
+ * PODs definition
+ *   - rest: defines the part of the view not returned yet
+ *   - delimiter: defines the separator of the parts
+ *   - done: defines if the last part was already returned
+ */
+typedef struct e_string_split
+{
+    e_string_view_t rest;
+    e_string_view_t delimiter;
+    bool done;
+} e_string_split_t;
+
+
+/* e_string_view
+ *
+ * borrows the data of string, carrying what is known about it.
+ */
+e_string_view_t e_string_view(const e_string_t* string);
+
+/* e_string_view_from_bytes
+ *
+ * borrows length bytes of a raw buffer, nothing is known about them yet.
+ */
+e_string_view_t e_string_view_from_bytes(const uint8_t* data,
+                                         const size_t length);
+
+/* e_string_view_from_cstr
+ *
+ * borrows a cstr, without its NUL terminator.
+ */
+e_string_view_t e_string_view_from_cstr(const char* cstr);
+
+/* e_string_from_view
+ *
+ * creates a e_string_t holding a copy of view, carrying what is known about
+ * it. views up to E_STRING_INLINE_CAPACITY bytes do not allocate memory.
+ */
+e_string_t e_string_from_view(const e_string_view_t view);
+
+/* e_string_view_validate
+ *
+ * validates the data of view as e_string_validate does, caching the result
+ * on view flags.
+ */
+e_string_errno_t e_string_view_validate(e_string_view_t* view);
+
+/* e_string_view_substr
+ *
+ * returns the part of view that starts at offset with up to length bytes,
+ * both are clamped to the view. the flags are kept when the part starts and
+ * ends on codepoint boundaries, US ASCII is always kept.
+ */
+e_string_view_t e_string_view_substr(const e_string_view_t view,
+                                     const size_t offset,
+                                     const size_t length);
+
+/* e_string_view_trim
+ *
+ * returns view without the leading and trailing US ASCII white space
+ * (space, \t, \n and \r).
+ */
+e_string_view_t e_string_view_trim(const e_string_view_t view);
+
+/* e_string_view_trim_start
+ *
+ * returns view without the leading US ASCII white space.
+ */
+e_string_view_t e_string_view_trim_start(const e_string_view_t view);
+
+/* e_string_view_trim_end
+ *
+ * returns view without the trailing US ASCII white space.
+ */
+e_string_view_t e_string_view_trim_end(const e_string_view_t view);
+
+/* e_string_view_equals
+ *
+ * checks if both views hold the same bytes.
+ */
+bool e_string_view_equals(const e_string_view_t view,
+                          const e_string_view_t other);
+
+/* e_string_view_starts_with
+ *
+ * checks if view begins with the bytes of prefix.
+ */
+bool e_string_view_starts_with(const e_string_view_t view,
+                               const e_string_view_t prefix);
+
+/* e_string_view_ends_with
+ *
+ * checks if view finishes with the bytes of suffix.
+ */
+bool e_string_view_ends_with(const e_string_view_t view,
+                             const e_string_view_t suffix);
+
+/* e_string_view_split_once
+ *
+ * splits view around the first occurrence of delimiter, storing the parts
+ * before and after it. returns false leaving before and after untouched when
+ * delimiter is not found or is empty.
+ */
+bool e_string_view_split_once(const e_string_view_t view,
+                              const e_string_view_t delimiter,
+                              e_string_view_t* before,
+                              e_string_view_t* after);
+
+/* e_string_split_init
+ *
+ * prepares an iteration over the parts of view separated by delimiter.
+ * as with Rust str::split, n delimiters give n + 1 parts, which can be
+ * empty, and an empty delimiter gives view as the only part.
+ */
+void e_string_split_init(e_string_split_t* split,
+                         const e_string_view_t view,
+                         const e_string_view_t delimiter);
+
+/* e_string_split_next
+ *
+ * stores the next part on part and returns true, or returns false when all
+ * the parts were already returned.
+ */
+bool e_string_split_next(e_string_split_t* split, e_string_view_t* part);
+
+
+
+
+/* NAMESPACE E_STRING_MAP *****************************************************/
+
+
+/* e_string_map struct
+ *
+ * this is a read-only memory mapping of a file, exposed as a view.
+ *
+ * PODs definition
+ *   - view: defines the contents of the file, with flags set by validation
+ *   - mapping: defines the start of the mapping, NULL when nothing is mapped
+ *   - mapping_length: defines the amount of bytes mapped
+ */
+typedef struct e_string_map
+{
+    e_string_view_t view;
+    void* mapping;
+    size_t mapping_length;
+} e_string_map_t;
+
+/* e_string_map_file
+ *
+ * maps the file at path read-only and validates it, giving zero-copy access
+ * to files of any size: the data is never copied into the process, and its
+ * pages are shared with the page cache.
+ *
+ * the kernel is told the file is read sequentially, and the file is validated
+ * window by window while the next window is read ahead, so validation runs
+ * while the pages are faulted in.
+ *
+ * returns E_STRING_IO_ERROR if the file can not be opened or mapped (or on
+ * platforms without mmap), leaving map empty. otherwise map holds the file
+ * even when E_STRING_INVALID_UTF8 is returned, and e_string_unmap must be
+ * called once the view is no longer used.
+ */
+e_string_errno_t e_string_map_file(const char* path, e_string_map_t* map);
+
+/* e_string_unmap
+ *
+ * releases the mapping of map, leaving it empty. calling it on an empty map
+ * does nothing.
+ */
+void e_string_unmap(e_string_map_t* map);
+
+
+
+
+/* NAMESPACE E_STRING_UTF8 CODEPOINTS *****************************************/
+
+
+/* e_string_index struct
+ *
+ * this is a sparse index of the codepoints of a string, holding the byte
+ * offset of one codepoint out of every stride, so a codepoint is found by
+ * decoding at most stride - 1 codepoints from the closest checkpoint.
+ *
+ * PODs definition
+ *   - offsets: defines the byte offset of codepoints 0, stride, 2 * stride...
+ *   - checkpoint_count: defines the amount of offsets
+ *   - stride: defines the amount of codepoints between two checkpoints
+ *   - codepoint_count: defines the amount of codepoints of the string
+ *
+ * US ASCII strings need no offsets, as the byte offset of a codepoint is its
+ * position. an index is only valid while its string is not changed.
+ */
+typedef struct e_string_index
+{
+    size_t* offsets;
+    size_t checkpoint_count;
+    size_t stride;
+    size_t codepoint_count;
+} e_string_index_t;
+
+/* E_STRING_INDEX_DEFAULT_STRIDE
+ *
+ * defines the stride used when e_string_index_build is given 0, which costs
+ * 8 bytes of index for every 256 codepoints on 64bit targets.
+ */
+#define E_STRING_INDEX_DEFAULT_STRIDE 256
+
+/* e_string_utf8_length
+ *
+ * returns the amount of codepoints of string, counted with SIMD as the bytes
+ * that are not UTF-8 continuation bytes. data is expected to be valid UTF-8.
+ *
+ * the count is cached on string when it was validated, so counting the same
+ * string again is O(1).
+ */
+size_t e_string_utf8_length(e_string_t* string);
+
+/* e_string_view_utf8_length
+ *
+ * same as e_string_utf8_length for a view, without caching.
+ */
+size_t e_string_view_utf8_length(const e_string_view_t view);
+
+/* e_string_index_build
+ *
+ * validates string and builds a sparse index with a checkpoint every stride
+ * codepoints (E_STRING_INDEX_DEFAULT_STRIDE when 0), allocated with the
+ * e_string allocator. release it with e_string_index_free.
+ */
+e_string_errno_t e_string_index_build(e_string_index_t* index,
+                                      e_string_t* string,
+                                      const size_t stride);
+
+/* e_string_index_free
+ *
+ * releases the memory of index, leaving it empty.
+ */
+void e_string_index_free(e_string_index_t* index);
+
+/* e_string_char_at
+ *
+ * decodes the codepoint at position (counted in codepoints) of string.
+ * index is optional: with an index built for string the cost is O(stride),
+ * without it the data is scanned from the start with SIMD. US ASCII strings
+ * are O(1) either way.
+ *
+ * returns E_STRING_INVALID_UTF8 if string is not valid, and
+ * E_STRING_OUT_OF_RANGE if it has no more than position codepoints.
+ */
+e_string_errno_t e_string_char_at(e_string_t* string,
+                                  const e_string_index_t* index,
+                                  const size_t position,
+                                  uint32_t* codepoint);
+
+/* e_string_utf8_substr
+ *
+ * stores on view the part of string that starts at codepoint start with up
+ * to count codepoints, both clamped to the string. index is optional, as for
+ * e_string_char_at.
+ *
+ * returns E_STRING_INVALID_UTF8 if string is not valid.
+ */
+e_string_errno_t e_string_utf8_substr(e_string_t* string,
+                                      const e_string_index_t* index,
+                                      const size_t start,
+                                      const size_t count,
+                                      e_string_view_t* view);
+
+
+
+
+/* NAMESPACE E_STRING_TRANSCODE ***********************************************/
+
+
+/* e_string_from_utf16le
+ *
+ * builds on string the UTF-8 encoding of count UTF-16 code units stored in
+ * little endian order, validating them on the same pass: unpaired surrogates
+ * and the control codepoints rejected by e_string_validate make it return
+ * E_STRING_INVALID_UNICODE, leaving string empty.
+ *
+ * runs of US ASCII units are narrowed with SIMD, and runs of BMP units with
+ * no surrogates are checked with SIMD and encoded without further checks.
+ * the result is known to be valid and its codepoints are counted, so it is
+ * never validated again.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the result can not be allocated.
+ */
+e_string_errno_t e_string_from_utf16le(const uint16_t* units,
+                                       const size_t count,
+                                       e_string_t* string);
+
+/* e_string_from_utf32
+ *
+ * same as e_string_from_utf16le for count UTF-32 code units in host byte
+ * order, where codepoints above 0x10FFFF and surrogates are invalid.
+ */
+e_string_errno_t e_string_from_utf32(const uint32_t* units,
+                                     const size_t count,
+                                     e_string_t* string);
+
+/* e_string_to_utf16le
+ *
+ * stores on units the UTF-16 encoding of string in little endian order and
+ * its amount of code units on count, validating string on the same pass.
+ * runs of US ASCII and of 3 byte codepoints are decoded with SIMD.
+ *
+ * a UTF-8 string never needs more code units than it has bytes, so a
+ * capacity of e_string_length(string) units is always enough. with a
+ * smaller capacity the data is validated and measured first: if it does not
+ * fit, count gets the amount of units needed and E_STRING_INVALID_BUFFER is
+ * returned (units can be NULL for measuring).
+ *
+ * returns E_STRING_INVALID_UTF8 if string is not valid.
+ */
+e_string_errno_t e_string_to_utf16le(e_string_t* string,
+                                     uint16_t* units,
+                                     const size_t capacity,
+                                     size_t* count);
+
+/* e_string_to_utf32
+ *
+ * same as e_string_to_utf16le for UTF-32 code units in host byte order.
+ */
+e_string_errno_t e_string_to_utf32(e_string_t* string,
+                                   uint32_t* units,
+                                   const size_t capacity,
+                                   size_t* count);
+
+
+
+
+
+/* NAMESPACE E_STRING_SEARCH **************************************************/
+
+
+/* E_STRING_NOT_FOUND
+ *
+ * defines the offset returned by the search functions when there is no match.
+ */
+#define E_STRING_NOT_FOUND SIZE_MAX
+
+/* e_string_view_find
+ *
+ * returns the byte offset of the first occurrence of needle in view, or
+ * E_STRING_NOT_FOUND. an empty needle is found at offset 0.
+ *
+ * needles up to 32 bytes are searched with a SIMD filter on their first and
+ * last bytes, longer ones with Two-Way, so the worst case is linear. matches
+ * always start and end on codepoint boundaries: a match that would split a
+ * codepoint (only possible for a needle that starts or ends inside one) is
+ * skipped.
+ */
+size_t e_string_view_find(const e_string_view_t view,
+                          const e_string_view_t needle);
+
+/* e_string_view_rfind
+ *
+ * same as e_string_view_find for the last occurrence, where an empty needle
+ * is found at the end of view.
+ */
+size_t e_string_view_rfind(const e_string_view_t view,
+                           const e_string_view_t needle);
+
+/* e_string_view_count_occurrences
+ *
+ * returns the amount of non-overlapping occurrences of needle in view,
+ * searched from the start. an empty needle is counted at every codepoint
+ * boundary.
+ */
+size_t e_string_view_count_occurrences(const e_string_view_t view,
+                                       const e_string_view_t needle);
+
+/* e_string_find
+ *
+ * same as e_string_view_find over the data of string.
+ */
+size_t e_string_find(const e_string_t* string, const e_string_view_t needle);
+
+/* e_string_rfind
+ *
+ * same as e_string_view_rfind over the data of string.
+ */
+size_t e_string_rfind(const e_string_t* string, const e_string_view_t needle);
+
+/* e_string_count_occurrences
+ *
+ * same as e_string_view_count_occurrences over the data of string.
+ */
+size_t e_string_count_occurrences(const e_string_t* string,
+                                  const e_string_view_t needle);
+
+
+
+
+
+/* NAMESPACE E_STRING_MATCHER *************************************************/
+
+
+/* e_string_matcher_state struct
+ *
+ * this is a state of the automaton of e_string_matcher_t.
+ *
+ * PODs definition
+ *   - fail: defines the state of the longest proper suffix that is a prefix
+ *     of some pattern
+ *   - edges: defines the first sparse edge of the state
+ *   - edge_count: defines the amount of sparse edges of the state
+ *   - output: defines the closest state of the failure chain, the state
+ *     itself included, where patterns end (0 when there is none)
+ */
+typedef struct e_string_matcher_state
+{
+    uint32_t fail;
+    uint32_t edges;
+    uint32_t edge_count;
+    uint32_t output;
+} e_string_matcher_state_t;
+
+/* e_string_matcher struct
+ *
+ * this is an Aho-Corasick automaton of a set of patterns, that finds all of
+ * them on a text in a single pass.
+ *
+ * bytes are first mapped to classes, one for each byte used by the patterns
+ * and one shared by every other byte. states are numbered breadth first:
+ * the first dense_count states have a dense row of class_count complete
+ * transitions, the others have sparse edges and fall back to their failure
+ * link when no edge matches.
+ *
+ * PODs definition
+ *   - byte_classes: defines the class of every byte
+ *   - class_count: defines the amount of classes, the width of dense rows
+ *   - state_count: defines the amount of states, 0 once freed
+ *   - dense_count: defines the amount of states with dense rows
+ *   - edge_count: defines the amount of sparse edges
+ *   - dense: defines the dense rows
+ *   - states: defines every state
+ *   - edge_classes: defines the class of every sparse edge
+ *   - edge_targets: defines the target state of every sparse edge
+ *   - output_start: defines the first pattern ending on every state, in
+ *     outputs, with an extra entry for the end of the last state
+ *   - outputs: defines the patterns ending on each state, by pattern index
+ *   - pattern_lengths: defines the length of every pattern
+ *   - pattern_count: defines the amount of patterns
+ *   - max_length: defines the length of the longest pattern
+ */
+typedef struct e_string_matcher
+{
+    uint8_t byte_classes[256];
+    uint32_t class_count;
+    uint32_t state_count;
+    uint32_t dense_count;
+    uint32_t edge_count;
+    uint32_t* dense;
+    e_string_matcher_state_t* states;
+    uint8_t* edge_classes;
+    uint32_t* edge_targets;
+    uint32_t* output_start;
+    uint32_t* outputs;
+    size_t* pattern_lengths;
+    size_t pattern_count;
+    size_t max_length;
+} e_string_matcher_t;
+
+/* e_string_match struct
+ *
+ * this is a match of a pattern of e_string_matcher_t on a text.
+ *
+ * PODs definition
+ *   - pattern: defines the index of the pattern on the build array
+ *   - offset: defines the byte offset of the match on the text
+ *   - length: defines the length of the match in bytes
+ */
+typedef struct e_string_match
+{
+    size_t pattern;
+    size_t offset;
+    size_t length;
+} e_string_match_t;
+
+/* e_string_match_callback
+ *
+ * defines the function called by e_string_matcher_find_all for every match,
+ * which returns false to stop the scan.
+ */
+typedef bool (*e_string_match_callback_t)(const e_string_match_t* match,
+                                          void* context);
+
+/* e_string_matcher_build
+ *
+ * builds on matcher the automaton of pattern_count patterns, allocated with
+ * the e_string allocator. the patterns are not referenced afterwards.
+ * release it with e_string_matcher_free.
+ *
+ * returns E_STRING_INVALID_BUFFER if a pattern is empty, and
+ * E_STRING_OUT_OF_MEMORY if the automaton can not be allocated.
+ */
+e_string_errno_t e_string_matcher_build(e_string_matcher_t* matcher,
+                                        const e_string_t* patterns,
+                                        const size_t pattern_count);
+
+/* e_string_matcher_free
+ *
+ * releases the memory of matcher, leaving it without patterns.
+ */
+void e_string_matcher_free(e_string_matcher_t* matcher);
+
+/* e_string_matcher_find
+ *
+ * stores on match the leftmost match of text starting at byte from or
+ * later, preferring the pattern that comes first on the build array when
+ * several start at the same offset. returns false when there is no match.
+ *
+ * the next non-overlapping match is found from match offset plus length.
+ */
+bool e_string_matcher_find(const e_string_matcher_t* matcher,
+                           const e_string_view_t text,
+                           const size_t from,
+                           e_string_match_t* match);
+
+/* e_string_matcher_find_all
+ *
+ * calls callback (when not NULL) with context for every match of every
+ * pattern on text, overlapping ones included, ordered by their end offset.
+ * returns the amount of matches reported.
+ */
+size_t e_string_matcher_find_all(const e_string_matcher_t* matcher,
+                                 const e_string_view_t text,
+                                 e_string_match_callback_t callback,
+                                 void* context);
+
+
+
+
+/* NAMESPACE E_STRING_HASH ****************************************************/
+
+
+/* E_STRING_HASH_SEED
+ *
+ * defines the seed of the hashes cached by e_string_key_t.
+ */
+#define E_STRING_HASH_SEED 0
+
+/* e_string_view_hash64
+ *
+ * returns a 64bit non-cryptographic hash of the data of view with seed.
+ * the same data and seed give the same hash on every machine and engine,
+ * different seeds give unrelated hashes.
+ */
+uint64_t e_string_view_hash64(const e_string_view_t view, const uint64_t seed);
+
+/* e_string_hash64
+ *
+ * returns the hash of the data of string with seed, the same as
+ * e_string_view_hash64 of its view.
+ */
+uint64_t e_string_hash64(const e_string_t* string, const uint64_t seed);
+
+/* e_string_hash64_batch
+ *
+ * stores on hashes the hash with seed of each of the count strings. the
+ * data of the next strings is loaded while the current ones are hashed, so
+ * hashing many strings spread over memory waits less on cache misses than
+ * calling e_string_hash64 on each.
+ */
+void e_string_hash64_batch(const e_string_t* strings, const size_t count,
+                           const uint64_t seed, uint64_t* hashes);
+
+/* e_string_key struct
+ *
+ * this is a string that caches its hash, for strings used repeatedly as
+ * keys. the hash is kept apart so e_string_t stays 32 bytes for the
+ * strings that are never hashed.
+ *
+ * PODs definition
+ *   - string: defines the key, which can be used with any e_string function
+ *   - hash: defines the hash of string with E_STRING_HASH_SEED, only
+ *     meaningful when hashed is true
+ *   - hashed: defines if hash is up to date
+ *
+ * the state of the hash belongs to the key, not to its string: a key can be
+ * initialized as { .string = e_string_from_cstr("key") } or from the string
+ * of another key, and the hash is computed on first use. the e_string
+ * functions do not know about the key, so call e_string_key_invalidate
+ * after changing string.
+ */
+typedef struct e_string_key
+{
+    e_string_t string;
+    uint64_t hash;
+    bool hashed;
+} e_string_key_t;
+
+/* e_string_key_hash
+ *
+ * returns the hash of the string of key with E_STRING_HASH_SEED, computing
+ * it only when it is not cached yet.
+ */
+uint64_t e_string_key_hash(e_string_key_t* key);
+
+/* e_string_key_invalidate
+ *
+ * drops the hash cached by key, use it after changing the string of key.
+ */
+void e_string_key_invalidate(e_string_key_t* key);
+
+
+
+
+/* NAMESPACE E_STRING_INTERN **************************************************/
+
+
+/* e_string_id
+ *
+ * defines the id of a string interned on an e_string_intern_pool_t, equal
+ * strings of the same pool have the same id.
+ */
+typedef uint32_t e_string_id_t;
+
+/* E_STRING_INTERN_NONE
+ *
+ * defines the id that no string has.
+ */
+#define E_STRING_INTERN_NONE UINT32_MAX
+
+/* e_string_intern_pool struct
+ *
+ * this is a set of unique strings, where each string is stored once and is
+ * known by its id, so equal strings are compared as ids (or as the pointers
+ * of e_string_intern_get) instead of byte by byte.
+ *
+ * PODs definition
+ *   - shards: defines the shards of the pool, allocated by
+ *     e_string_intern_pool_init. each has its own lock, hash table, arena
+ *     and entries, and strings are spread over them by hash.
+ *
+ * e_string_intern, e_string_intern_find and e_string_intern_get can be
+ * called from many threads at once. threads only wait on each other when
+ * interning strings of the same shard at the same time, and
+ * e_string_intern_get takes no lock at all.
+ * strings are never removed, the memory is released at once by
+ * e_string_intern_pool_free.
+ *
+ * the pool is not part of the e_string library: link to e_string_intern,
+ * which is built where C11 threads are available.
+ */
+typedef struct e_string_intern_pool
+{
+    struct e_string_intern_shard* shards;
+} e_string_intern_pool_t;
+
+/* e_string_intern_pool_init
+ *
+ * prepares an empty pool, release it with e_string_intern_pool_free.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the shards can not be allocated.
+ */
+e_string_errno_t e_string_intern_pool_init(e_string_intern_pool_t* pool);
+
+/* e_string_intern_pool_free
+ *
+ * releases every string of pool, the ids and pointers given by the pool
+ * are no longer valid.
+ */
+void e_string_intern_pool_free(e_string_intern_pool_t* pool);
+
+/* e_string_intern
+ *
+ * stores on id the id of the data of view on pool, adding a copy of it when
+ * it is not there yet. the UTF-8 and ASCII flags of view are kept by the
+ * copy.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the copy can not be allocated, and
+ * E_STRING_OUT_OF_RANGE if the shard of view already holds 2^26 - 1
+ * strings.
+ */
+e_string_errno_t e_string_intern(e_string_intern_pool_t* pool,
+                                 const e_string_view_t view,
+                                 e_string_id_t* id);
+
+/* e_string_intern_find
+ *
+ * returns the id of the data of view on pool, or E_STRING_INTERN_NONE if it
+ * was never interned.
+ */
+e_string_id_t e_string_intern_find(e_string_intern_pool_t* pool,
+                                   const e_string_view_t view);
+
+/* e_string_intern_get
+ *
+ * returns the string of id on pool, or NULL if pool has no such id.
+ * the string stays at the same address until the pool is freed, and must
+ * not be changed or freed.
+ */
+const e_string_t* e_string_intern_get(const e_string_intern_pool_t* pool,
+                                      const e_string_id_t id);
+
+/* e_string_intern_pool_count
+ *
+ * returns the amount of strings on pool.
+ */
+size_t e_string_intern_pool_count(const e_string_intern_pool_t* pool);
+
+
+
+
+/* NAMESPACE E_STRING_HASH_MAP ************************************************/
+
+
+/* e_string_hash_map struct
+ *
+ * this is an open addressing hash map from string keys to values of a fixed
+ * size, laid out as a SwissTable: a control byte per slot holds 7 bits of
+ * the hash of its key, and lookups compare the control bytes of 16 slots at
+ * once before reading any key.
+ *
+ * PODs definition
+ *   - control: defines the control byte of every slot
+ *   - slots: defines the slots, each a key (e_string_t) followed by its
+ *     value
+ *   - slot_size: defines the size of a slot, a multiple of 8 bytes
+ *   - value_size: defines the size of a value
+ *   - capacity: defines the amount of slots, 0 before the first key
+ *   - count: defines the amount of keys
+ *   - growth_left: defines the amount of keys that can be added before the
+ *     slots are rebuilt
+ *   - arena: defines the memory of keys that are too long to be inline
+ *   - key_bytes: defines the bytes of arena used by the keys on map
+ *   - dead_bytes: defines the bytes of arena left behind by removed keys
+ *
+ * keys are copied into the map: inline when they fit, on arena otherwise.
+ * once removed keys take more of arena than the keys on map (and at least a
+ * chunk), the next key added rebuilds the map on a new arena.
+ * lookups take a view or a C string (heterogeneous lookup), so looking up a
+ * key never creates an e_string_t. keys and values move when the map grows,
+ * so their pointers are only valid until the next key is added.
+ */
+typedef struct e_string_hash_map
+{
+    uint8_t* control;
+    uint8_t* slots;
+    size_t slot_size;
+    size_t value_size;
+    size_t capacity;
+    size_t count;
+    size_t growth_left;
+    e_arena_t arena;
+    size_t key_bytes;
+    size_t dead_bytes;
+} e_string_hash_map_t;
+
+/* e_string_hash_map_init
+ *
+ * prepares an empty map of values of value_size bytes, no memory is
+ * requested until the first key is added.
+ */
+void e_string_hash_map_init(e_string_hash_map_t* map, const size_t value_size);
+
+/* e_string_hash_map_free
+ *
+ * releases every key and value of map, leaving it empty.
+ */
+void e_string_hash_map_free(e_string_hash_map_t* map);
+
+/* e_string_hash_map_reserve
+ *
+ * grows map so count keys can be added without rebuilding it.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the slots can not be allocated.
+ */
+e_string_errno_t e_string_hash_map_reserve(e_string_hash_map_t* map,
+                                           const size_t count);
+
+/* e_string_hash_map_entry
+ *
+ * stores on value a pointer to the value of key, adding key with a value
+ * of zeroes when it is not on map yet. inserted (when not NULL) tells if
+ * key was added. values are aligned to 8 bytes.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if key can not be added.
+ */
+e_string_errno_t e_string_hash_map_entry(e_string_hash_map_t* map,
+                                         const e_string_view_t key,
+                                         void** value,
+                                         bool* inserted);
+
+/* e_string_hash_map_put
+ *
+ * copies value_size bytes of value as the value of key, adding key when it
+ * is not on map yet.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if key can not be added.
+ */
+e_string_errno_t e_string_hash_map_put(e_string_hash_map_t* map,
+                                       const e_string_view_t key,
+                                       const void* value);
+
+/* e_string_hash_map_get
+ *
+ * returns a pointer to the value of key, or NULL if key is not on map.
+ */
+void* e_string_hash_map_get(const e_string_hash_map_t* map,
+                            const e_string_view_t key);
+
+/* e_string_hash_map_get_cstr
+ *
+ * returns a pointer to the value of the NUL terminated key, or NULL if key
+ * is not on map.
+ */
+void* e_string_hash_map_get_cstr(const e_string_hash_map_t* map,
+                                 const char* key);
+
+/* e_string_hash_map_get_key
+ *
+ * returns a pointer to the value of key, or NULL if key is not on map. the
+ * hash cached by key is used, and computed on first use.
+ */
+void* e_string_hash_map_get_key(const e_string_hash_map_t* map,
+                                e_string_key_t* key);
+
+/* e_string_hash_map_remove
+ *
+ * removes key and its value from map, returns false if key is not on map.
+ */
+bool e_string_hash_map_remove(e_string_hash_map_t* map,
+                              const e_string_view_t key);
+
+/* e_string_hash_map_next
+ *
+ * iterates over the keys of map in no particular order. cursor starts at 0,
+ * and each call stores the next key and a pointer to its value, or returns
+ * false when every key was visited. map must not change during the
+ * iteration.
+ */
+bool e_string_hash_map_next(const e_string_hash_map_t* map, size_t* cursor,
+                            const e_string_t** key, void** value);
+
+
+
+
+/* NAMESPACE E_STRING_BUILDER *************************************************/
+
+
+/* e_string_builder struct
+ *
+ * this is a list of segments that are assembled into one string at the
+ * end, so building a large string from many pieces copies each piece once.
+ *
+ * PODs definition
+ *   - segments: defines the pieces of the string in order, each a view on
+ *     data borrowed from the caller or copied into arena
+ *   - segment_count: defines the amount of segments
+ *   - segment_capacity: defines the amount of segments allocated
+ *   - length: defines the total length of the segments
+ *   - chunk: defines the arena memory copies are currently made into
+ *   - chunk_used: defines the amount of bytes of chunk already used
+ *   - chunk_capacity: defines the amount of bytes of chunk
+ *   - flags: defines what is known about every segment, only
+ *     E_STRING_FLAG_UTF8 and E_STRING_FLAG_ASCII are used
+ *   - arena: defines the memory of the copied pieces
+ *
+ * borrowed data must stay valid and unchanged until the builder is built,
+ * written or reset. copies made one after the other share a segment, so
+ * segments can be given to writev as they are.
+ */
+typedef struct e_string_builder
+{
+    e_string_view_t* segments;
+    size_t segment_count;
+    size_t segment_capacity;
+    size_t length;
+    uint8_t* chunk;
+    size_t chunk_used;
+    size_t chunk_capacity;
+    uint32_t flags;
+    e_arena_t arena;
+} e_string_builder_t;
+
+/* e_string_builder_init
+ *
+ * prepares an empty builder, no memory is requested until the first piece
+ * is added.
+ */
+void e_string_builder_init(e_string_builder_t* builder);
+
+/* e_string_builder_free
+ *
+ * releases the memory of builder, leaving it empty.
+ */
+void e_string_builder_free(e_string_builder_t* builder);
+
+/* e_string_builder_reset
+ *
+ * removes every piece of builder, keeping its memory for the next string.
+ */
+void e_string_builder_reset(e_string_builder_t* builder);
+
+/* e_string_builder_append_view
+ *
+ * adds the data of view without copying it. views shorter than 64 bytes
+ * are copied instead, as a segment of their own would cost more than the
+ * copy.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the segment can not be added.
+ */
+e_string_errno_t e_string_builder_append_view(e_string_builder_t* builder,
+                                              const e_string_view_t view);
+
+/* e_string_builder_append_copy
+ *
+ * adds a copy of the data of view, which can be released right away.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the copy can not be made.
+ */
+e_string_errno_t e_string_builder_append_copy(e_string_builder_t* builder,
+                                              const e_string_view_t view);
+
+/* e_string_builder_append
+ *
+ * adds the data of string as e_string_builder_append_view does, string
+ * must not change until the builder is built, written or reset.
+ */
+e_string_errno_t e_string_builder_append(e_string_builder_t* builder,
+                                         const e_string_t* string);
+
+/* e_string_builder_append_cstr
+ *
+ * adds a copy of the NUL terminated cstr.
+ */
+e_string_errno_t e_string_builder_append_cstr(e_string_builder_t* builder,
+                                              const char* cstr);
+
+/* e_string_builder_append_uint64
+ *
+ * adds the decimal digits of number, written straight into the builder.
+ */
+e_string_errno_t e_string_builder_append_uint64(e_string_builder_t* builder,
+                                                const uint64_t number);
+
+/* e_string_builder_build
+ *
+ * stores on string a new string of exactly the length of builder, holding
+ * every segment in order. the UTF-8 and ASCII flags known for every segment
+ * are kept. the builder is not changed.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the string can not be allocated.
+ */
+e_string_errno_t e_string_builder_build(const e_string_builder_t* builder,
+                                        e_string_t* string);
+
+/* e_string_builder_write
+ *
+ * writes every segment of builder to the file descriptor fd with writev,
+ * without assembling them first. partial writes are resumed until every
+ * byte is written.
+ *
+ * returns E_STRING_IO_ERROR if a write fails (or on platforms without
+ * writev), some segments may have been written already.
+ */
+e_string_errno_t e_string_builder_write(const e_string_builder_t* builder,
+                                        const int fd);
+
+
+
+
+/* NAMESPACE E_FORMAT *********************************************************/
+
+
+/* e_format
+ * use this group of functions to format values into e_string_t, or into a
+ * buffer of the caller, without snprintf.
+ *
+ * the format is a text where every {} is replaced by the next argument, and
+ * {{ and }} stand for { and }. arguments are converted by _Generic, so a
+ * value of an unsupported type is a compile error instead of undefined
+ * behavior at runtime:
+ *   - char* and const char*: NUL terminated text
+ *   - e_string_t* and const e_string_t*: the data of the string
+ *   - e_string_view_t: the data of the view
+ *   - bool: true or false
+ *   - char: the character itself
+ *   - uint8_t upto uint64_t and int8_t upto int64_t: decimal digits
+ *   - double and float: shortest text, as e_string_from_double
+ *
+ * true, false and character constants such as 'x' are int in C, so they are
+ * written as numbers unless cast to bool or char.
+ *
+ * the length of the output is computed before anything is written, so the
+ * string grows once, and nothing is written at all on errors.
+ *
+ * example:
+ *   e_format(&line, "{} took {} ms", &name, elapsed);
+ */
+
+/* E_FORMAT_MAX_ARGS
+ *
+ * amount of arguments a format can take after the format itself.
+ */
+#define E_FORMAT_MAX_ARGS 16
+
+/* e_format type enum
+ *
+ * this is the kind of value held by an e_format_arg_t.
+ */
+typedef enum e_format_type
+{
+    E_FORMAT_TYPE_CSTR = 0,
+    E_FORMAT_TYPE_STRING,
+    E_FORMAT_TYPE_VIEW,
+    E_FORMAT_TYPE_BOOL,
+    E_FORMAT_TYPE_CHAR,
+    E_FORMAT_TYPE_UINT64,
+    E_FORMAT_TYPE_INT64,
+    E_FORMAT_TYPE_DOUBLE,
+    E_FORMAT_TYPE_FLOAT
+} e_format_type_t;
+
+/* e_format arg struct
+ *
+ * this is an argument of a format, built by the e_format_arg_x functions.
+ *
+ * PODs definition
+ *   - type: defines which member of value is used
+ *   - value: defines the argument itself
+ *
+ * strings are kept by address and read while the output is written, so a
+ * string can be formatted into itself, as can cstr and views pointing into
+ * it (they follow its data when it grows).
+ */
+typedef struct e_format_arg
+{
+    e_format_type_t type;
+    union
+    {
+        const char* cstr;
+        const e_string_t* string;
+        e_string_view_t view;
+        bool boolean;
+        char character;
+        uint64_t uint64;
+        int64_t int64;
+        double floating;
+    } value;
+} e_format_arg_t;
+
+/* e_format_arg_cstr
+ *
+ * argument for a NUL terminated cstr.
+ */
+static inline e_format_arg_t e_format_arg_cstr(const char* cstr)
+{
+    const e_format_arg_t arg = { .type = E_FORMAT_TYPE_CSTR,
+                                 .value.cstr = cstr };
+    return arg;
+}
+
+/* e_format_arg_string
+ *
+ * argument for the data of string.
+ */
+static inline e_format_arg_t e_format_arg_string(const e_string_t* string)
+{
+    const e_format_arg_t arg = { .type = E_FORMAT_TYPE_STRING,
+                                 .value.string = string };
+    return arg;
+}
+
+/* e_format_arg_view
+ *
+ * argument for the data of view.
+ */
+static inline e_format_arg_t e_format_arg_view(const e_string_view_t view)
+{
+    const e_format_arg_t arg = { .type = E_FORMAT_TYPE_VIEW,
+                                 .value.view = view };
+    return arg;
+}
+
+/* e_format_arg_bool
+ *
+ * argument written as true or false.
+ */
+static inline e_format_arg_t e_format_arg_bool(const bool boolean)
+{
+    const e_format_arg_t arg = { .type = E_FORMAT_TYPE_BOOL,
+                                 .value.boolean = boolean };
+    return arg;
+}
+
+/* e_format_arg_char
+ *
+ * argument written as the character itself.
+ */
+static inline e_format_arg_t e_format_arg_char(const char character)
+{
+    const e_format_arg_t arg = { .type = E_FORMAT_TYPE_CHAR,
+                                 .value.character = character };
+    return arg;
+}
+
+/* e_format_arg_uint64
+ *
+ * argument written as the decimal digits of an unsigned integer.
+ */
+static inline e_format_arg_t e_format_arg_uint64(const uint64_t number)
+{
+    const e_format_arg_t arg = { .type = E_FORMAT_TYPE_UINT64,
+                                 .value.uint64 = number };
+    return arg;
+}
+
+/* e_format_arg_int64
+ *
+ * argument written as the decimal digits of a signed integer.
+ */
+static inline e_format_arg_t e_format_arg_int64(const int64_t number)
+{
+    const e_format_arg_t arg = { .type = E_FORMAT_TYPE_INT64,
+                                 .value.int64 = number };
+    return arg;
+}
+
+/* e_format_arg_double
+ *
+ * argument written as the shortest text of a double.
+ */
+static inline e_format_arg_t e_format_arg_double(const double number)
+{
+    const e_format_arg_t arg = { .type = E_FORMAT_TYPE_DOUBLE,
+                                 .value.floating = number };
+    return arg;
+}
+
+/* e_format_arg_float
+ *
+ * argument written as the shortest text of a float.
+ */
+static inline e_format_arg_t e_format_arg_float(const float number)
+{
+    const e_format_arg_t arg = { .type = E_FORMAT_TYPE_FLOAT,
+                                 .value.floating = number };
+    return arg;
+}
+
+/* E_FORMAT_ARG macro
+ *
+ * this macro delegates to the argument constructor based on input type, as
+ * e_string_from does (integers by their standard types, so any of them is
+ * accepted).
+ */
+#define E_FORMAT_ARG(X) _Generic((X),                              \
+                        char*:              e_format_arg_cstr,     \
+                        const char*:        e_format_arg_cstr,     \
+                        e_string_t*:        e_format_arg_string,   \
+                        const e_string_t*:  e_format_arg_string,   \
+                        e_string_view_t:    e_format_arg_view,     \
+                        bool:               e_format_arg_bool,     \
+                        char:               e_format_arg_char,     \
+                        unsigned long long: e_format_arg_uint64,   \
+                        unsigned long:      e_format_arg_uint64,   \
+                        unsigned int:       e_format_arg_uint64,   \
+                        unsigned short:     e_format_arg_uint64,   \
+                        unsigned char:      e_format_arg_uint64,   \
+                        long long:          e_format_arg_int64,    \
+                        long:               e_format_arg_int64,    \
+                        int:                e_format_arg_int64,    \
+                        short:              e_format_arg_int64,    \
+                        signed char:        e_format_arg_int64,    \
+                        double:             e_format_arg_double,   \
+                        float:              e_format_arg_float     \
+                        )(X)
+
+/* E_FORMAT_COUNT and E_FORMAT_ARGS macros
+ *
+ * count the arguments of a format (the format included), and apply
+ * E_FORMAT_ARG to each of them.
+ */
+#define E_FORMAT_COUNT(...)                                                   \
+        E_FORMAT_COUNT_N(__VA_ARGS__, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8,   \
+                         7, 6, 5, 4, 3, 2, 1, 0)
+#define E_FORMAT_COUNT_N(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12,   \
+                         _13, _14, _15, _16, _17, N, ...) N
+#define E_FORMAT_CONCAT(A, B) E_FORMAT_CONCAT_N(A, B)
+#define E_FORMAT_CONCAT_N(A, B) A ## B
+#define E_FORMAT_ARGS(...)                                                    \
+        E_FORMAT_CONCAT(E_FORMAT_ARGS_, E_FORMAT_COUNT(__VA_ARGS__))(__VA_ARGS__)
+#define E_FORMAT_ARGS_1(X) E_FORMAT_ARG(X)
+#define E_FORMAT_ARGS_2(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_1(__VA_ARGS__)
+#define E_FORMAT_ARGS_3(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_2(__VA_ARGS__)
+#define E_FORMAT_ARGS_4(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_3(__VA_ARGS__)
+#define E_FORMAT_ARGS_5(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_4(__VA_ARGS__)
+#define E_FORMAT_ARGS_6(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_5(__VA_ARGS__)
+#define E_FORMAT_ARGS_7(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_6(__VA_ARGS__)
+#define E_FORMAT_ARGS_8(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_7(__VA_ARGS__)
+#define E_FORMAT_ARGS_9(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_8(__VA_ARGS__)
+#define E_FORMAT_ARGS_10(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_9(__VA_ARGS__)
+#define E_FORMAT_ARGS_11(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_10(__VA_ARGS__)
+#define E_FORMAT_ARGS_12(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_11(__VA_ARGS__)
+#define E_FORMAT_ARGS_13(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_12(__VA_ARGS__)
+#define E_FORMAT_ARGS_14(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_13(__VA_ARGS__)
+#define E_FORMAT_ARGS_15(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_14(__VA_ARGS__)
+#define E_FORMAT_ARGS_16(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_15(__VA_ARGS__)
+#define E_FORMAT_ARGS_17(X, ...) E_FORMAT_ARG(X), E_FORMAT_ARGS_16(__VA_ARGS__)
+
+/* e_format macro
+ *
+ * appends to string the format with its arguments replaced, as in
+ * e_format(&string, "{} = {}", name, value).
+ *
+ * returns E_STRING_INVALID_FORMAT if the format is not a text, has a { or }
+ * that is neither {}, {{ nor }}, or does not have a {} for each argument,
+ * and E_STRING_OUT_OF_MEMORY if string can not grow. string is not changed
+ * on errors.
+ */
+#define e_format(string, ...)                                                 \
+        e_format_args((string),                                               \
+                      (const e_format_arg_t[]){ E_FORMAT_ARGS(__VA_ARGS__) }, \
+                      E_FORMAT_COUNT(__VA_ARGS__))
+
+/* e_format_to macro
+ *
+ * writes the format with its arguments replaced on the capacity bytes of
+ * buffer, storing on length the amount of bytes of the output. no NUL is
+ * added, as in e_format_to(buffer, sizeof(buffer), &length, "{}", value).
+ *
+ * returns E_STRING_INVALID_FORMAT as e_format, and E_STRING_OUT_OF_RANGE if
+ * the output does not fit, with length set to the capacity it needs.
+ */
+#define e_format_to(buffer, capacity, length, ...)                            \
+        e_format_args_to((buffer), (capacity), (length),                      \
+                         (const e_format_arg_t[]){                            \
+                             E_FORMAT_ARGS(__VA_ARGS__) },                    \
+                         E_FORMAT_COUNT(__VA_ARGS__))
+
+/* e_format_args
+ *
+ * implements e_format for an array of count arguments, where args[0] is the
+ * format as a cstr, string or view.
+ */
+e_string_errno_t e_format_args(e_string_t* string,
+                               const e_format_arg_t* args,
+                               const size_t count);
+
+/* e_format_args_to
+ *
+ * implements e_format_to for an array of count arguments, where args[0] is
+ * the format as a cstr, string or view.
+ */
+e_string_errno_t e_format_args_to(char* buffer, const size_t capacity,
+                                  size_t* length, const e_format_arg_t* args,
+                                  const size_t count);
+
+
+
+
+/* NAMESPACE E_STRING_TO_NUMBER ***********************************************/
+
+
+/* e_string_view_to_int64
+ *
+ * this function allows the user to read the whole view as a decimal
+ * integer, [+-]digits with any amount of leading zeros. no space, NUL or
+ * locale is involved, and the view does not need to be NUL terminated.
+ *
+ * returns E_STRING_INVALID_NUMBER if the view is not an integer and
+ * E_STRING_OUT_OF_RANGE if it does not fit on int64_t, number is only
+ * written on success.
+ */
+e_string_errno_t e_string_view_to_int64(const e_string_view_t view,
+                                        int64_t* number);
+
+/* e_string_view_to_uint64
+ *
+ * same as e_string_view_to_int64 for uint64_t, only + is accepted as sign.
+ */
+e_string_errno_t e_string_view_to_uint64(const e_string_view_t view,
+                                         uint64_t* number);
+
+/* e_string_view_to_double
+ *
+ * this function allows the user to read the whole view as the double
+ * closest to it (ties to even), the same double strtod gives on the C
+ * locale. the accepted text is [+-]digits[.digits][(e|E)[+-]digits], where
+ * either side of the point may be empty but not both, and inf, infinity
+ * and nan on any case with an optional sign.
+ *
+ * returns E_STRING_INVALID_NUMBER if the view is not a number, number is
+ * then not written. returns E_STRING_OUT_OF_RANGE if the value is too large
+ * for a double, number is then set to an infinity of its sign. values too
+ * small for a double read as zero, successfully.
+ */
+e_string_errno_t e_string_view_to_double(const e_string_view_t view,
+                                         double* number);
+
+/* e_string_to_int64
+ *
+ * same as e_string_view_to_int64 on the data of string.
+ */
+e_string_errno_t e_string_to_int64(const e_string_t* string, int64_t* number);
+
+/* e_string_to_uint64
+ *
+ * same as e_string_view_to_uint64 on the data of string.
+ */
+e_string_errno_t e_string_to_uint64(const e_string_t* string,
+                                    uint64_t* number);
+
+/* e_string_to_double
+ *
+ * same as e_string_view_to_double on the data of string.
+ */
+e_string_errno_t e_string_to_double(const e_string_t* string, double* number);
+
+
+
+
+/* NAMESPACE E_STRING_TABLE ***************************************************/
+
+
+/* e_string_table struct
+ *
+ * this is a column of strings packed together: the bytes of every string
+ * one after the other on a single blob, and an array of count + 1 offsets
+ * where string i is data[offsets[i]] upto data[offsets[i + 1]]. a string
+ * costs its bytes plus one offset, instead of an e_string_t and a block of
+ * its own.
+ *
+ * PODs definition
+ *   - data: defines the blob holding the bytes of every string
+ *   - data_length: defines the amount of bytes used on data
+ *   - data_capacity: defines the amount of bytes allocated for data
+ *   - offsets: defines the uint32_t or uint64_t offsets, NULL while empty
+ *   - count: defines the amount of strings
+ *   - offset_capacity: defines the amount of offsets allocated
+ *   - offset_width: defines the bytes of each offset, 4 until data grows
+ *     past 4 GiB and 8 from then on
+ *   - flags: defines what is known about every string, only
+ *     E_STRING_FLAG_UTF8 and E_STRING_FLAG_ASCII are used
+ *   - borrowed: defines if data and offsets are memory of the caller given
+ *     to e_string_table_deserialize, they are copied before any change
+ */
+typedef struct e_string_table
+{
+    uint8_t* data;
+    size_t data_length;
+    size_t data_capacity;
+    void* offsets;
+    size_t count;
+    size_t offset_capacity;
+    uint32_t offset_width;
+    uint32_t flags;
+    bool borrowed;
+} e_string_table_t;
+
+/* e_string_table_init
+ *
+ * prepares an empty table, no memory is requested until the first string
+ * is added.
+ */
+void e_string_table_init(e_string_table_t* table);
+
+/* e_string_table_free
+ *
+ * releases the memory of table, which is then empty and can be reused.
+ * borrowed memory is left to the caller.
+ */
+void e_string_table_free(e_string_table_t* table);
+
+/* e_string_table_reserve
+ *
+ * makes room for count more strings holding bytes more bytes, so they are
+ * added without growing the table.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the memory can not be allocated.
+ */
+e_string_errno_t e_string_table_reserve(e_string_table_t* table,
+                                        const size_t count,
+                                        const size_t bytes);
+
+/* e_string_table_append_view
+ *
+ * adds a copy of view at the end of table, carrying what is known about it.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the memory can not be allocated, table
+ * is then unchanged.
+ */
+e_string_errno_t e_string_table_append_view(e_string_table_t* table,
+                                            const e_string_view_t view);
+
+/* e_string_table_append
+ *
+ * same as e_string_table_append_view for the data of string.
+ */
+e_string_errno_t e_string_table_append(e_string_table_t* table,
+                                       const e_string_t* string);
+
+/* e_string_table_get
+ *
+ * returns a view on string index of table, carrying what is known about
+ * every string of table. the view is valid until the table changes. an
+ * empty view is returned when index is not below the count.
+ */
+static inline e_string_view_t e_string_table_get(
+    const e_string_table_t* table, const size_t index)
+{
+    e_string_view_t view = { .data = (const uint8_t*)"", .length = 0,
+                             .flags = E_STRING_FLAG_UTF8
+                                      | E_STRING_FLAG_ASCII };
+    if (index >= table->count) {
+        return view;
+    }
+
+    size_t start = 0;
+    size_t end = 0;
+    if (table->offset_width == sizeof(uint32_t)) {
+        start = ((const uint32_t*)table->offsets)[index];
+        end = ((const uint32_t*)table->offsets)[index + 1];
+    } else {
+        start = (size_t)((const uint64_t*)table->offsets)[index];
+        end = (size_t)((const uint64_t*)table->offsets)[index + 1];
+    }
+    view.data = table->data + start;
+    view.length = end - start;
+    view.flags = table->flags;
+    return view;
+}
+
+/* e_string_table_validate
+ *
+ * validates every string of table as e_string_validate does, caching the
+ * result on table flags. the blob is validated at once, then no string may
+ * start on a continuation byte, so no codepoint is split between strings.
+ *
+ * returns E_STRING_INVALID_UTF8 if any string is not valid UTF-8.
+ */
+e_string_errno_t e_string_table_validate(e_string_table_t* table);
+
+/* e_string_table_serialized_length
+ *
+ * returns the bytes e_string_table_serialize writes for table.
+ */
+size_t e_string_table_serialized_length(const e_string_table_t* table);
+
+/* e_string_table_serialize
+ *
+ * writes table on buffer, storing the bytes written on length: a 32 bytes
+ * header, the offsets padded to 8 bytes and the blob, on the byte order of
+ * the machine.
+ *
+ * returns E_STRING_OUT_OF_RANGE if capacity is smaller than the length,
+ * which is stored anyway so the caller can grow buffer.
+ */
+e_string_errno_t e_string_table_serialize(const e_string_table_t* table,
+                                          uint8_t* buffer,
+                                          const size_t capacity,
+                                          size_t* length);
+
+/* e_string_table_write
+ *
+ * writes table on the file descriptor fd as e_string_table_serialize does,
+ * without an intermediate buffer.
+ *
+ * returns E_STRING_IO_ERROR if the write fails or the platform has no file
+ * descriptors.
+ */
+e_string_errno_t e_string_table_write(const e_string_table_t* table,
+                                      const int fd);
+
+/* e_string_table_deserialize
+ *
+ * prepares table on the length bytes of memory written by
+ * e_string_table_serialize (e.g. a mmapped file) without copying them: the
+ * table borrows memory, which must be 8 bytes aligned and outlive it. the
+ * structure is checked (every offset is read once), the UTF-8 flags are
+ * not kept, use e_string_table_validate to get them back.
+ *
+ * returns E_STRING_INVALID_BUFFER if memory does not hold a table of this
+ * machine, table is then not written.
+ */
+e_string_errno_t e_string_table_deserialize(e_string_table_t* table,
+                                            const void* memory,
+                                            const size_t length);
+
+
+
+
+/* NAMESPACE E_STRING_SORT ****************************************************/
+
+
+/* e_string_sort
+ *
+ * this function allows the user to sort count strings in place, on the
+ * order of their bytes (as memcmp, a string is after its prefixes). it is
+ * a radix sort on the first bytes of the strings, 8 at a time, which never
+ * calls a comparison function for most of the strings.
+ *
+ * the work is shared by up to threads threads, the calling thread being
+ * one of them (0 and 1 sort on the calling thread only, as does every
+ * sort where C11 threads are not available). equal strings may end up in
+ * any order.
+ *
+ * memory for 16 bytes per string is taken from the e_string allocator
+ * while sorting. returns E_STRING_OUT_OF_MEMORY if it can not be
+ * allocated, strings are then unchanged. when there is memory for a copy
+ * of the strings as well, they are copied to their place by the threads,
+ * or else moved one at a time by the calling thread.
+ */
+e_string_errno_t e_string_sort(e_string_t* strings, const size_t count,
+                               const size_t threads);
+
+/* e_string_sort_stable
+ *
+ * same as e_string_sort, keeping the order equal strings had, with memory
+ * for 32 bytes per string.
+ */
+e_string_errno_t e_string_sort_stable(e_string_t* strings, const size_t count,
+                                      const size_t threads);
+
+/* e_string_sort_indices
+ *
+ * same as e_string_sort_stable without moving the strings: stores on
+ * indices the positions of the strings in sorted order, so strings[indices[0]]
+ * is the first one. use it to sort the records that own the strings.
+ */
+e_string_errno_t e_string_sort_indices(const e_string_t* strings,
+                                       const size_t count, size_t* indices,
+                                       const size_t threads);
+
 #endif /* E_STRING_H */
\ No newline at end of file
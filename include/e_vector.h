@@ -0,0 +1,299 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_vector header
+ *
+ * this module implements a growable array specialized by macros for each
+ * element type. the functions of a vector are generated as static inline
+ * functions that know the element size at compile time: elements are read
+ * and written as their own type, and bulk operations move the whole range
+ * with a single memcpy or memmove.
+ *
+ * only the growth and shrinking of the storage is shared by every vector
+ * type, on e_vector.c, and it goes through the e_string allocator (see
+ * e_string_set_allocator) so both modules use the same memory.
+ *
+ * usage: add #include "e_vector.h" to your file and link to e_vector library
+ */
+
+#ifndef E_VECTOR_H
+#define E_VECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "e_string.h"
+
+/* NAMESPACE E_VECTOR *********************************************************/
+
+/* e_vector_grow
+ *
+ * makes room on the storage of a vector for at least minimum elements of
+ * element_size bytes. the capacity at least doubles, so a vector built by n
+ * pushes copies each element a constant amount of times on average.
+ *
+ * small is the inline storage of the vector (NULL when it has none): data
+ * that is on it is copied to the heap, and the heap data is reallocated.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the memory can not be allocated, the
+ * vector is then unchanged. it is used by the generated functions, there is
+ * no need to call it directly.
+ */
+e_string_errno_t e_vector_grow(void** data, size_t* capacity, void* small,
+                               const size_t length, const size_t element_size,
+                               const size_t minimum);
+
+/* e_vector_shrink
+ *
+ * resizes the storage of a vector to its length, moving the data back to
+ * small when it fits there (small_capacity elements), or releasing it when
+ * the vector is empty and has no inline storage.
+ *
+ * returns E_STRING_OUT_OF_MEMORY if the memory can not be reallocated, the
+ * vector is then unchanged.
+ */
+e_string_errno_t e_vector_shrink(void** data, size_t* capacity, void* small,
+                                 const size_t small_capacity,
+                                 const size_t length,
+                                 const size_t element_size);
+
+/* e_vector_release
+ *
+ * releases the heap storage of a vector, nothing is done when data is
+ * small.
+ */
+void e_vector_release(void* data, const void* small, const size_t capacity,
+                      const size_t element_size);
+
+
+/* E_VECTOR_DECLARE
+ *
+ * declares the vector name##_t of elements of type, and its functions
+ * (name##_init, name##_push...). the storage is always on the heap.
+ *
+ * e.g. E_VECTOR_DECLARE(e_offset_vector, uint64_t) declares
+ * e_offset_vector_t and e_offset_vector_push(e_offset_vector_t*, uint64_t)
+ *
+ * it can be used once per name on any scope functions can be declared, and
+ * type must be a name that can be followed by * (use a typedef otherwise).
+ */
+#define E_VECTOR_DECLARE(name, type)                                          \
+    typedef struct name                                                       \
+    {                                                                         \
+        type* data;                                                           \
+        size_t length;                                                        \
+        size_t capacity;                                                      \
+    } name##_t;                                                               \
+                                                                              \
+    static inline type* name##_priv_small(name##_t* vector)                   \
+    {                                                                         \
+        (void)vector;                                                         \
+        return NULL;                                                          \
+    }                                                                         \
+                                                                              \
+    E_VECTOR_PRIV_FUNCTIONS(name, type, 0)
+
+/* E_VECTOR_DECLARE_SMALL
+ *
+ * same as E_VECTOR_DECLARE, with room for small_capacity elements inside
+ * the vector itself: a vector that never holds more elements than that
+ * does not allocate. small_capacity must be at least 1.
+ *
+ * a small vector points into itself while inline, so it must not be copied
+ * or moved by value: use it through pointers once initialized.
+ */
+#define E_VECTOR_DECLARE_SMALL(name, type, small_capacity)                    \
+    typedef struct name                                                       \
+    {                                                                         \
+        type* data;                                                           \
+        size_t length;                                                        \
+        size_t capacity;                                                      \
+        type small[small_capacity];                                           \
+    } name##_t;                                                               \
+                                                                              \
+    static inline type* name##_priv_small(name##_t* vector)                   \
+    {                                                                         \
+        return vector->small;                                                 \
+    }                                                                         \
+                                                                              \
+    E_VECTOR_PRIV_FUNCTIONS(name, type, small_capacity)
+
+/* e_vector functions
+ *
+ * the functions declared for every vector, where name##_t is the vector and
+ * type its elements:
+ *
+ *   - void name##_init(name##_t* vector)
+ *     prepares an empty vector, no memory is requested until it grows past
+ *     its inline storage
+ *   - void name##_free(name##_t* vector)
+ *     releases the storage, the vector is then empty and can be reused
+ *   - void name##_clear(name##_t* vector)
+ *     removes every element, keeping the storage
+ *   - e_string_errno_t name##_reserve(name##_t* vector, size_t capacity)
+ *     makes room for at least capacity elements
+ *   - e_string_errno_t name##_shrink(name##_t* vector)
+ *     resizes the storage to the length of the vector
+ *   - e_string_errno_t name##_push(name##_t* vector, type value)
+ *     adds value at the end
+ *   - bool name##_pop(name##_t* vector, type* value)
+ *     removes the last element and stores it on value (when not NULL),
+ *     returns false for an empty vector
+ *   - e_string_errno_t name##_append_n(name##_t* vector, const type* values,
+ *     size_t count)
+ *     adds count values at the end
+ *   - e_string_errno_t name##_insert_range(name##_t* vector, size_t index,
+ *     const type* values, size_t count)
+ *     adds count values before index (index can be the length)
+ *   - e_string_errno_t name##_erase_range(name##_t* vector, size_t index,
+ *     size_t count)
+ *     removes count elements from index
+ *   - size_t name##_erase_if(name##_t* vector,
+ *     bool (*predicate)(const type* element, void* context), void* context)
+ *     removes every element the predicate is true for, keeping the order of
+ *     the others, and returns the amount removed
+ *
+ * elements are read and written with vector->data[i], for i below
+ * vector->length. data can move on any function that adds elements.
+ *
+ * the functions that add elements return E_STRING_OUT_OF_MEMORY when the
+ * storage can not grow, and the range functions return E_STRING_OUT_OF_RANGE
+ * when the range is not inside the vector. the vector is then unchanged.
+ * values given to them must not point into the vector itself.
+ */
+#define E_VECTOR_PRIV_FUNCTIONS(name, type, small_capacity)                   \
+    static inline void name##_init(name##_t* vector)                          \
+    {                                                                         \
+        vector->data = name##_priv_small(vector);                             \
+        vector->length = 0;                                                   \
+        vector->capacity = (small_capacity);                                  \
+    }                                                                         \
+                                                                              \
+    static inline void name##_free(name##_t* vector)                          \
+    {                                                                         \
+        e_vector_release(vector->data, name##_priv_small(vector),             \
+                         vector->capacity, sizeof(type));                     \
+        name##_init(vector);                                                  \
+    }                                                                         \
+                                                                              \
+    static inline void name##_clear(name##_t* vector)                         \
+    {                                                                         \
+        vector->length = 0;                                                   \
+    }                                                                         \
+                                                                              \
+    static inline e_string_errno_t name##_reserve(name##_t* vector,           \
+                                                  const size_t capacity)      \
+    {                                                                         \
+        if (capacity <= vector->capacity) {                                   \
+            return E_STRING_SUCCESS;                                          \
+        }                                                                     \
+        return e_vector_grow((void**)&vector->data, &vector->capacity,        \
+                             name##_priv_small(vector), vector->length,       \
+                             sizeof(type), capacity);                         \
+    }                                                                         \
+                                                                              \
+    static inline e_string_errno_t name##_shrink(name##_t* vector)            \
+    {                                                                         \
+        return e_vector_shrink((void**)&vector->data, &vector->capacity,      \
+                               name##_priv_small(vector), (small_capacity),   \
+                               vector->length, sizeof(type));                 \
+    }                                                                         \
+                                                                              \
+    static inline e_string_errno_t name##_push(name##_t* vector,              \
+                                               const type value)              \
+    {                                                                         \
+        if (vector->length == vector->capacity                                \
+            && e_vector_grow((void**)&vector->data, &vector->capacity,        \
+                             name##_priv_small(vector), vector->length,       \
+                             sizeof(type), vector->length + 1)                \
+               != E_STRING_SUCCESS) {                                         \
+            return E_STRING_OUT_OF_MEMORY;                                    \
+        }                                                                     \
+        vector->data[vector->length++] = value;                               \
+        return E_STRING_SUCCESS;                                              \
+    }                                                                         \
+                                                                              \
+    static inline bool name##_pop(name##_t* vector, type* value)              \
+    {                                                                         \
+        if (vector->length == 0) {                                            \
+            return false;                                                     \
+        }                                                                     \
+        vector->length -= 1;                                                  \
+        if (value != NULL) {                                                  \
+            *value = vector->data[vector->length];                            \
+        }                                                                     \
+        return true;                                                          \
+    }                                                                         \
+                                                                              \
+    static inline e_string_errno_t name##_insert_range(name##_t* vector,      \
+                                                       const size_t index,    \
+                                                       const type* values,    \
+                                                       const size_t count)    \
+    {                                                                         \
+        if (index > vector->length) {                                         \
+            return E_STRING_OUT_OF_RANGE;                                     \
+        }                                                                     \
+        if (count > SIZE_MAX - vector->length) {                              \
+            return E_STRING_OUT_OF_MEMORY;                                    \
+        }                                                                     \
+        if (count == 0) {                                                     \
+            return E_STRING_SUCCESS;                                          \
+        }                                                                     \
+        if (name##_reserve(vector, vector->length + count)                    \
+            != E_STRING_SUCCESS) {                                            \
+            return E_STRING_OUT_OF_MEMORY;                                    \
+        }                                                                     \
+        memmove(vector->data + index + count, vector->data + index,           \
+                (vector->length - index) * sizeof(type));                     \
+        memcpy(vector->data + index, values, count * sizeof(type));           \
+        vector->length += count;                                              \
+        return E_STRING_SUCCESS;                                              \
+    }                                                                         \
+                                                                              \
+    static inline e_string_errno_t name##_append_n(name##_t* vector,          \
+                                                   const type* values,        \
+                                                   const size_t count)        \
+    {                                                                         \
+        return name##_insert_range(vector, vector->length, values, count);    \
+    }                                                                         \
+                                                                              \
+    static inline e_string_errno_t name##_erase_range(name##_t* vector,       \
+                                                      const size_t index,     \
+                                                      const size_t count)     \
+    {                                                                         \
+        if (index > vector->length || count > vector->length - index) {       \
+            return E_STRING_OUT_OF_RANGE;                                     \
+        }                                                                     \
+        if (count == 0) {                                                     \
+            return E_STRING_SUCCESS;                                          \
+        }                                                                     \
+        memmove(vector->data + index, vector->data + index + count,           \
+                (vector->length - index - count) * sizeof(type));             \
+        vector->length -= count;                                              \
+        return E_STRING_SUCCESS;                                              \
+    }                                                                         \
+                                                                              \
+    static inline size_t name##_erase_if(                                     \
+        name##_t* vector, bool (*predicate)(const type*, void*),              \
+        void* context)                                                        \
+    {                                                                         \
+        size_t kept = 0;                                                      \
+        while (kept < vector->length                                          \
+               && predicate(&vector->data[kept], context) == false) {         \
+            kept += 1;                                                        \
+        }                                                                     \
+        for (size_t i = kept + 1; i < vector->length; i++) {                  \
+            if (predicate(&vector->data[i], context) == false) {              \
+                vector->data[kept++] = vector->data[i];                       \
+            }                                                                 \
+        }                                                                     \
+        const size_t removed = vector->length - kept;                         \
+        vector->length = kept;                                                \
+        return removed;                                                       \
+    }
+
+#endif /* E_VECTOR_H */
\ No newline at end of file
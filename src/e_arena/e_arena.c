@@ -0,0 +1,182 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_arena implementation
+ *
+ * this module implements the region allocator declared on e_arena.h.
+ *
+ * chunks are never freed before e_arena_destroy. when the current chunk is
+ * full the allocation moves to the next one, which after a reset is a chunk
+ * kept from a previous round, or a new chunk linked right after the current.
+ * chunks are allocated and released through the allocator in use.
+ *
+ * usage: add #include "e_arena.h" to your file and link to e_arena library
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "e_arena.h"
+
+
+/* private function priv_default_allocate */
+static void* priv_default_allocate(void* context, const size_t size)
+{
+    (void)context;
+    return malloc(size);
+}
+
+/* private function priv_default_release */
+static void priv_default_release(void* context, void* memory,
+                                 const size_t size)
+{
+    (void)context;
+    (void)size;
+    free(memory);
+}
+
+static const e_arena_allocator_t e_arena_default_allocator = {
+    .allocate = priv_default_allocate,
+    .release = priv_default_release,
+    .context = NULL
+};
+
+/* private allocator in use */
+static e_arena_allocator_t e_arena_allocator = {
+    .allocate = priv_default_allocate,
+    .release = priv_default_release,
+    .context = NULL
+};
+
+/* private function priv_align
+ *
+ * offset of the first address at or after data + used with the alignment
+ */
+static inline size_t priv_align(const e_arena_chunk_t* chunk,
+                                const size_t alignment)
+{
+    const uintptr_t address = (uintptr_t)(chunk->data + chunk->used);
+    const uintptr_t aligned = (address + (alignment - 1))
+                            & ~(uintptr_t)(alignment - 1);
+    return chunk->used + (size_t)(aligned - address);
+}
+
+/* private function priv_fits
+ *
+ * checks if size bytes with the alignment fit in chunk, returning the offset
+ * where they start
+ */
+static inline bool priv_fits(const e_arena_chunk_t* chunk, const size_t size,
+                             const size_t alignment, size_t* offset)
+{
+    *offset = priv_align(chunk, alignment);
+    return *offset <= chunk->capacity && size <= chunk->capacity - *offset;
+}
+
+/* private function priv_new_chunk
+ *
+ * allocates a chunk that holds at least size bytes with the alignment, and
+ * links it right after the current chunk
+ */
+static e_arena_chunk_t* priv_new_chunk(e_arena_t* arena, const size_t size,
+                                       const size_t alignment)
+{
+    size_t capacity = arena->chunk_size;
+    if (size > SIZE_MAX - sizeof(e_arena_chunk_t) - alignment) {
+        return NULL;
+    }
+    if (size + alignment > capacity) {
+        capacity = size + alignment;
+    }
+
+    e_arena_chunk_t* chunk = e_arena_allocator.allocate(
+        e_arena_allocator.context, sizeof(e_arena_chunk_t) + capacity);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    chunk->capacity = capacity;
+    chunk->used = 0;
+
+    if (arena->current == NULL) {
+        chunk->next = NULL;
+        arena->head = chunk;
+    } else {
+        chunk->next = arena->current->next;
+        arena->current->next = chunk;
+    }
+    return chunk;
+}
+
+
+void e_arena_init(e_arena_t* arena, const size_t chunk_size)
+{
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->chunk_size = (chunk_size == 0) ? E_ARENA_DEFAULT_CHUNK_SIZE
+                                          : chunk_size;
+}
+
+
+void* e_arena_alloc(e_arena_t* arena, const size_t size, const size_t alignment)
+{
+    size_t offset;
+
+    /* fast path: bump the cursor of the current chunk */
+    e_arena_chunk_t* chunk = arena->current;
+    if (chunk != NULL && priv_fits(chunk, size, alignment, &offset)) {
+        chunk->used = offset + size;
+        return chunk->data + offset;
+    }
+
+    /* reuse the chunk kept after the current one by a reset */
+    if (chunk != NULL && chunk->next != NULL) {
+        chunk->next->used = 0;
+        if (priv_fits(chunk->next, size, alignment, &offset)) {
+            arena->current = chunk->next;
+            arena->current->used = offset + size;
+            return arena->current->data + offset;
+        }
+    }
+
+    chunk = priv_new_chunk(arena, size, alignment);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    arena->current = chunk;
+    offset = priv_align(chunk, alignment);
+    chunk->used = offset + size;
+    return chunk->data + offset;
+}
+
+
+void e_arena_reset(e_arena_t* arena)
+{
+    arena->current = arena->head;
+    if (arena->head != NULL) {
+        arena->head->used = 0;
+    }
+}
+
+
+void e_arena_destroy(e_arena_t* arena)
+{
+    e_arena_chunk_t* chunk = arena->head;
+    while (chunk != NULL) {
+        e_arena_chunk_t* next = chunk->next;
+        e_arena_allocator.release(e_arena_allocator.context, chunk,
+                                  sizeof(e_arena_chunk_t) + chunk->capacity);
+        chunk = next;
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+}
+
+
+void e_arena_set_allocator(const e_arena_allocator_t* allocator)
+{
+    e_arena_allocator = (allocator != NULL) ? *allocator
+                                            : e_arena_default_allocator;
+}
@@ -0,0 +1,846 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_bigint implementation
+ *
+ * this module implements arbitrary precision integers on 64bit limbs.
+ *
+ * the arithmetic is done by private functions on plain arrays of limbs,
+ * which know nothing about signs or memory: the public functions handle the
+ * sign, make room on the result and call them. products go through:
+ *   - schoolbook below E_BIGINT_KARATSUBA limbs, one row of multiply and
+ *     add per limb of the shorter operand
+ *   - Karatsuba below E_BIGINT_TOOM3 limbs, 3 half size products, using the
+ *     difference of the halves so every value stays unsigned
+ *   - Toom-3 above, 5 third size products on the points 0, 1, -1, 2 and
+ *     infinity, interpolated on two's complement limbs (the coefficients
+ *     are positive, only the steps between them can be negative)
+ *
+ * unbalanced operands are cut in pieces the size of the shorter one. every
+ * temporary limb comes from the scratch given by the caller, the amount
+ * used is computed by priv_scratch with the same recursion as priv_mul.
+ *
+ * usage: add #include "e_bigint.h" to your file and link to e_bigint library
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_bigint.h"
+
+/* balanced products of fewer limbs are schoolbook */
+#define E_BIGINT_KARATSUBA 32
+
+/* balanced products of this many limbs or more are Toom-3 */
+#define E_BIGINT_TOOM3 192
+
+/* largest amount of limbs of a number, so sizes in bytes never overflow */
+#define E_BIGINT_MAX_LIMBS (SIZE_MAX / sizeof(uint64_t) / 8)
+
+/* inverse of 3 modulo 2^64 */
+#define E_BIGINT_INVERSE_3 0xAAAAAAAAAAAAAAABu
+
+
+/* private function priv_allocate
+ *
+ * allocates limbs limbs with the e_string allocator
+ */
+static uint64_t* priv_allocate(const size_t limbs)
+{
+    const e_string_allocator_t* allocator = e_string_get_allocator();
+    return allocator->allocate(allocator->context, limbs * sizeof(uint64_t));
+}
+
+/* private function priv_release
+ *
+ * gives back limbs limbs to the e_string allocator
+ */
+static void priv_release(uint64_t* memory, const size_t limbs)
+{
+    if (memory != NULL) {
+        const e_string_allocator_t* allocator = e_string_get_allocator();
+        allocator->release(allocator->context, memory,
+                           limbs * sizeof(uint64_t));
+    }
+}
+
+/* private function priv_multiply_add
+ *
+ * 128bit value of a * b + c + d, which always fits, as its high and low
+ * 64 bits
+ */
+static inline uint64_t priv_multiply_add(const uint64_t a, const uint64_t b,
+                                         const uint64_t c, const uint64_t d,
+                                         uint64_t* low)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 priv_u128_t;
+    const priv_u128_t value = (priv_u128_t)a * b + c + d;
+    *low = (uint64_t)value;
+    return (uint64_t)(value >> 64);
+#else
+    const uint64_t a_high = a >> 32;
+    const uint64_t a_low = (uint32_t)a;
+    const uint64_t b_high = b >> 32;
+    const uint64_t b_low = (uint32_t)b;
+    const uint64_t middle_1 = a_high * b_low;
+    const uint64_t middle_2 = a_low * b_high;
+    const uint64_t low_low = a_low * b_low;
+    const uint64_t cross = (low_low >> 32) + (uint32_t)middle_1
+                           + (uint32_t)middle_2;
+    uint64_t high = a_high * b_high + (middle_1 >> 32) + (middle_2 >> 32)
+                    + (cross >> 32);
+    uint64_t sum = (cross << 32) | (uint32_t)low_low;
+    sum += c;
+    high += (sum < c);
+    sum += d;
+    high += (sum < d);
+    *low = sum;
+    return high;
+#endif
+}
+
+/* private function priv_normalize
+ *
+ * amount of limbs of the n limbs given without the leading zero limbs
+ */
+static inline size_t priv_normalize(const uint64_t* limbs, size_t n)
+{
+    while (n > 0 && limbs[n - 1] == 0) {
+        n -= 1;
+    }
+    return n;
+}
+
+/* private function priv_compare
+ *
+ * compares the an limbs of a with the bn limbs of b, leading zero limbs
+ * included, returning -1, 0 or 1
+ */
+static int priv_compare(const uint64_t* a, size_t an, const uint64_t* b,
+                        size_t bn)
+{
+    for (; an > bn; an--) {
+        if (a[an - 1] != 0) {
+            return 1;
+        }
+    }
+    for (; bn > an; bn--) {
+        if (b[bn - 1] != 0) {
+            return -1;
+        }
+    }
+    while (an > 0) {
+        an -= 1;
+        if (a[an] != b[an]) {
+            return (a[an] < b[an]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/* private function priv_add_1
+ *
+ * r = a + value on n limbs, returning the carry. r can be a.
+ */
+static uint64_t priv_add_1(uint64_t* r, const uint64_t* a, const size_t n,
+                           uint64_t value)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (value == 0 && r == a) {
+            return 0;
+        }
+        const uint64_t sum = a[i] + value;
+        value = (sum < value);
+        r[i] = sum;
+    }
+    return value;
+}
+
+/* private function priv_sub_1
+ *
+ * r = a - value on n limbs, returning the borrow. r can be a.
+ */
+static uint64_t priv_sub_1(uint64_t* r, const uint64_t* a, const size_t n,
+                           uint64_t value)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (value == 0 && r == a) {
+            return 0;
+        }
+        const uint64_t limb = a[i];
+        r[i] = limb - value;
+        value = (limb < value);
+    }
+    return value;
+}
+
+/* private function priv_add_n
+ *
+ * r = a + b on n limbs, returning the carry. r can be a or b.
+ */
+static uint64_t priv_add_n(uint64_t* r, const uint64_t* a, const uint64_t* b,
+                           const size_t n)
+{
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t sum = a[i] + carry;
+        carry = (sum < carry);
+        const uint64_t total = sum + b[i];
+        carry += (total < sum);
+        r[i] = total;
+    }
+    return carry;
+}
+
+/* private function priv_sub_n
+ *
+ * r = a - b on n limbs, returning the borrow. r can be a or b.
+ */
+static uint64_t priv_sub_n(uint64_t* r, const uint64_t* a, const uint64_t* b,
+                           const size_t n)
+{
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t limb = a[i];
+        const uint64_t subtrahend = b[i] + borrow;
+        borrow = (subtrahend < borrow);
+        borrow += (limb < subtrahend);
+        r[i] = limb - subtrahend;
+    }
+    return borrow;
+}
+
+/* private function priv_add
+ *
+ * r = a + b with a of an limbs and b of bn <= an limbs, returning the
+ * carry. r has an limbs and can be a or b.
+ */
+static uint64_t priv_add(uint64_t* r, const uint64_t* a, const size_t an,
+                         const uint64_t* b, const size_t bn)
+{
+    const uint64_t carry = priv_add_n(r, a, b, bn);
+    return priv_add_1(r + bn, a + bn, an - bn, carry);
+}
+
+/* private function priv_sub
+ *
+ * r = a - b with a of an limbs and b of bn <= an limbs, returning the
+ * borrow. r has an limbs and can be a or b.
+ */
+static uint64_t priv_sub(uint64_t* r, const uint64_t* a, const size_t an,
+                         const uint64_t* b, const size_t bn)
+{
+    const uint64_t borrow = priv_sub_n(r, a, b, bn);
+    return priv_sub_1(r + bn, a + bn, an - bn, borrow);
+}
+
+/* private function priv_add_into
+ *
+ * r += c with r of rn limbs and c of cn limbs, when the sum fits on rn
+ * limbs (the limbs of c past rn are then 0)
+ */
+static void priv_add_into(uint64_t* r, const size_t rn, const uint64_t* c,
+                          const size_t cn)
+{
+    priv_add(r, r, rn, c, (cn < rn) ? cn : rn);
+}
+
+/* private function priv_difference
+ *
+ * d = |x - y| with x of xn limbs and y of yn <= xn limbs, d of xn limbs.
+ * returns true when y is the larger one.
+ */
+static bool priv_difference(uint64_t* d, const uint64_t* x, const size_t xn,
+                            const uint64_t* y, const size_t yn)
+{
+    if (priv_compare(x, xn, y, yn) >= 0) {
+        priv_sub(d, x, xn, y, yn);
+        return false;
+    }
+
+    /* y > x, so the limbs of x past yn are 0 */
+    priv_sub_n(d, y, x, yn);
+    memset(d + yn, 0, (xn - yn) * sizeof(uint64_t));
+    return true;
+}
+
+/* private function priv_negate
+ *
+ * x = -x in two's complement on n limbs
+ */
+static void priv_negate(uint64_t* x, const size_t n)
+{
+    uint64_t carry = 1;
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t sum = ~x[i] + carry;
+        carry = (sum < carry);
+        x[i] = sum;
+    }
+}
+
+/* private function priv_half
+ *
+ * x = x / 2 in two's complement on n limbs, for an even x
+ */
+static void priv_half(uint64_t* x, const size_t n)
+{
+    for (size_t i = 0; i + 1 < n; i++) {
+        x[i] = (x[i] >> 1) | (x[i + 1] << 63);
+    }
+    x[n - 1] = (x[n - 1] >> 1) | (x[n - 1] & ((uint64_t)1 << 63));
+}
+
+/* private function priv_third
+ *
+ * x = x / 3 in two's complement on n limbs, for a multiple of 3. each limb
+ * of the quotient is the limb times the inverse of 3, and the high part of
+ * 3 times it is borrowed from the next limb.
+ */
+static void priv_third(uint64_t* x, const size_t n)
+{
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t limb = x[i];
+        const uint64_t quotient = (limb - borrow) * E_BIGINT_INVERSE_3;
+        borrow = (limb < borrow);
+        borrow += (quotient >= 0x5555555555555556u);
+        borrow += (quotient >= E_BIGINT_INVERSE_3);
+        x[i] = quotient;
+    }
+}
+
+/* private function priv_mul_1
+ *
+ * r = a * b on n limbs, returning the high limb
+ */
+static uint64_t priv_mul_1(uint64_t* r, const uint64_t* a, const size_t n,
+                           const uint64_t b)
+{
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry = priv_multiply_add(a[i], b, carry, 0, &r[i]);
+    }
+    return carry;
+}
+
+/* private function priv_addmul_1
+ *
+ * r += a * b on n limbs, returning the high limb
+ */
+static uint64_t priv_addmul_1(uint64_t* r, const uint64_t* a, const size_t n,
+                              const uint64_t b)
+{
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        carry = priv_multiply_add(a[i], b, r[i], carry, &r[i]);
+    }
+    return carry;
+}
+
+/* private function priv_schoolbook
+ *
+ * r = a * b with a of an >= bn >= 1 limbs, r of an + bn limbs which are
+ * not a or b
+ */
+static void priv_schoolbook(uint64_t* r, const uint64_t* a, const size_t an,
+                            const uint64_t* b, const size_t bn)
+{
+    r[an] = priv_mul_1(r, a, an, b[0]);
+    for (size_t i = 1; i < bn; i++) {
+        r[an + i] = priv_addmul_1(r + i, a, an, b[i]);
+    }
+}
+
+static void priv_mul_n(uint64_t* r, const uint64_t* a, const uint64_t* b,
+                       const size_t n, uint64_t* scratch);
+
+/* private function priv_karatsuba
+ *
+ * r = a * b on n limbs, cutting a = a1 x + a0 and b = b1 x + b0 with the
+ * low halves a0 and b0 having the extra limb of an odd n:
+ *   - a0 b0 and a1 b1 are written straight to their place on r
+ *   - the middle a0 b1 + a1 b0 is a0 b0 + a1 b1 - (a0 - a1)(b0 - b1),
+ *     multiplying the differences as positive and adding or subtracting
+ *     by their signs
+ *
+ * scratch holds the differences, whose limbs are later reused for the
+ * middle, and their product.
+ */
+static void priv_karatsuba(uint64_t* r, const uint64_t* a, const uint64_t* b,
+                           const size_t n, uint64_t* scratch)
+{
+    const size_t low = n - n / 2;
+    const size_t high = n / 2;
+    uint64_t* middle = scratch;
+    uint64_t* product = scratch + 2 * low + 1;
+    uint64_t* rest = product + 2 * low;
+
+    const bool a_negative = priv_difference(middle, a, low, a + low, high);
+    const bool b_negative = priv_difference(middle + low, b, low, b + low,
+                                            high);
+    priv_mul_n(product, middle, middle + low, low, rest);
+    priv_mul_n(r, a, b, low, rest);
+    priv_mul_n(r + 2 * low, a + low, b + low, high, rest);
+
+    uint64_t top = priv_add(middle, r, 2 * low, r + 2 * low, 2 * high);
+    if (a_negative == b_negative) {
+        top -= priv_sub_n(middle, middle, product, 2 * low);
+    } else {
+        top += priv_add_n(middle, middle, product, 2 * low);
+    }
+    middle[2 * low] = top;
+    priv_add_into(r + low, 2 * n - low, middle, 2 * low + 1);
+}
+
+/* private function priv_evaluate
+ *
+ * values of x2 t^2 + x1 t + x0 at t = 1, -1 and 2 for the k, k and s limbs
+ * pieces of x, on k + 1 limbs each. the value at -1 is stored positive,
+ * returns true when it is negative.
+ */
+static bool priv_evaluate(const uint64_t* x, const size_t k, const size_t s,
+                          uint64_t* one, uint64_t* minus_one, uint64_t* two)
+{
+    const uint64_t* x1 = x + k;
+    const uint64_t* x2 = x + 2 * k;
+
+    /* x0 + x2, then minus and plus x1 */
+    one[k] = priv_add(one, x, k, x2, s);
+    const bool negative = priv_difference(minus_one, one, k + 1, x1, k);
+    one[k] += priv_add_n(one, one, x1, k);
+
+    /* (2 x2 + x1) 2 + x0 */
+    memcpy(two, x2, s * sizeof(uint64_t));
+    memset(two + s, 0, (k + 1 - s) * sizeof(uint64_t));
+    priv_add_n(two, two, two, k + 1);
+    priv_add(two, two, k + 1, x1, k);
+    priv_add_n(two, two, two, k + 1);
+    priv_add(two, two, k + 1, x, k);
+    return negative;
+}
+
+/* private function priv_toom3
+ *
+ * r = a * b on n limbs, cutting a and b in 3 pieces of k, k and s limbs so
+ * the product is the polynomial c4 t^4 + ... + c0 at t = 2^(64 k):
+ *   - c0 = a0 b0 and c4 = a2 b2 are written straight to their place on r
+ *   - v1, vm1 and v2 are the products of the values at 1, -1 and 2, of
+ *     m = 2 k + 2 limbs, from which c1, c2 and c3 are interpolated modulo
+ *     2^(64 m) and added to r
+ */
+static void priv_toom3(uint64_t* r, const uint64_t* a, const uint64_t* b,
+                       const size_t n, uint64_t* scratch)
+{
+    const size_t k = (n + 2) / 3;
+    const size_t s = n - 2 * k;
+    const size_t m = 2 * k + 2;
+    uint64_t* a_one = scratch;
+    uint64_t* b_one = a_one + k + 1;
+    uint64_t* a_minus_one = b_one + k + 1;
+    uint64_t* b_minus_one = a_minus_one + k + 1;
+    uint64_t* a_two = b_minus_one + k + 1;
+    uint64_t* b_two = a_two + k + 1;
+    uint64_t* v1 = b_two + k + 1;
+    uint64_t* vm1 = v1 + m;
+    uint64_t* v2 = vm1 + m;
+    uint64_t* rest = v2 + m;
+
+    const bool a_negative = priv_evaluate(a, k, s, a_one, a_minus_one, a_two);
+    const bool b_negative = priv_evaluate(b, k, s, b_one, b_minus_one, b_two);
+    priv_mul_n(v1, a_one, b_one, k + 1, rest);
+    priv_mul_n(vm1, a_minus_one, b_minus_one, k + 1, rest);
+    if (a_negative != b_negative) {
+        priv_negate(vm1, m);
+    }
+    priv_mul_n(v2, a_two, b_two, k + 1, rest);
+    priv_mul_n(r, a, b, k, rest);
+    memset(r + 2 * k, 0, 2 * k * sizeof(uint64_t));
+    priv_mul_n(r + 4 * k, a + 2 * k, b + 2 * k, s, rest);
+
+    /* the comments give each value in terms of the coefficients */
+    const uint64_t* v0 = r;
+    const uint64_t* vinf = r + 4 * k;
+    priv_sub_n(v2, v2, vm1, m);
+    priv_third(v2, m);                         /* c1 + c2 + 3 c3 + 5 c4 */
+    priv_sub_n(v1, v1, vm1, m);
+    priv_half(v1, m);                          /* c1 + c3 */
+    priv_sub(vm1, vm1, m, v0, 2 * k);          /* -c1 + c2 - c3 + c4 */
+    priv_sub_n(v2, vm1, v2, m);
+    priv_half(v2, m);
+    priv_add(v2, v2, m, vinf, 2 * s);
+    priv_add(v2, v2, m, vinf, 2 * s);          /* -c1 - 2 c3 */
+    priv_add_n(vm1, vm1, v1, m);
+    priv_sub(vm1, vm1, m, vinf, 2 * s);        /* c2 */
+    priv_add_n(v2, v2, v1, m);                 /* -c3 */
+    priv_add_n(v1, v1, v2, m);                 /* c1 */
+    priv_negate(v2, m);                        /* c3 */
+
+    priv_add_into(r + k, 2 * n - k, v1, m);
+    priv_add_into(r + 2 * k, 2 * n - 2 * k, vm1, m);
+    priv_add_into(r + 3 * k, 2 * n - 3 * k, v2, m);
+}
+
+/* private function priv_mul_n
+ *
+ * r = a * b on n limbs, r of 2 n limbs which are not a, b or scratch
+ */
+static void priv_mul_n(uint64_t* r, const uint64_t* a, const uint64_t* b,
+                       const size_t n, uint64_t* scratch)
+{
+    if (n < E_BIGINT_KARATSUBA) {
+        priv_schoolbook(r, a, n, b, n);
+    } else if (n < E_BIGINT_TOOM3) {
+        priv_karatsuba(r, a, b, n, scratch);
+    } else {
+        priv_toom3(r, a, b, n, scratch);
+    }
+}
+
+/* private function priv_mul
+ *
+ * r = a * b with a of an >= bn >= 1 limbs, r of an + bn limbs which are
+ * not a, b or scratch. a longer a is cut in pieces of bn limbs, and the
+ * product of each piece is added to r.
+ */
+static void priv_mul(uint64_t* r, const uint64_t* a, const size_t an,
+                     const uint64_t* b, const size_t bn, uint64_t* scratch)
+{
+    if (bn < E_BIGINT_KARATSUBA) {
+        priv_schoolbook(r, a, an, b, bn);
+        return;
+    }
+
+    priv_mul_n(r, a, b, bn, scratch);
+    uint64_t* product = scratch;
+    uint64_t* rest = scratch + 2 * bn;
+    for (size_t start = bn; start < an; start += bn) {
+        const size_t piece = (an - start < bn) ? an - start : bn;
+        if (piece == bn) {
+            priv_mul_n(product, a + start, b, bn, rest);
+        } else {
+            priv_mul(product, b, bn, a + start, piece, rest);
+        }
+
+        /* the low bn limbs overlap the high limbs of the previous piece */
+        const uint64_t carry = priv_add_n(r + start, r + start, product, bn);
+        memcpy(r + bn + start, product + bn, piece * sizeof(uint64_t));
+        priv_add_1(r + bn + start, r + bn + start, piece, carry);
+    }
+}
+
+/* private function priv_scratch_n
+ *
+ * limbs of scratch used by priv_mul_n on n limbs
+ */
+static size_t priv_scratch_n(const size_t n)
+{
+    if (n < E_BIGINT_KARATSUBA) {
+        return 0;
+    }
+    if (n < E_BIGINT_TOOM3) {
+        const size_t low = n - n / 2;
+        const size_t low_scratch = priv_scratch_n(low);
+        const size_t high_scratch = priv_scratch_n(n / 2);
+        return 4 * low + 1 + ((low_scratch > high_scratch)
+                              ? low_scratch : high_scratch);
+    }
+    const size_t k = (n + 2) / 3;
+    const size_t piece_scratch = priv_scratch_n(k + 1);
+    const size_t top_scratch = priv_scratch_n(n - 2 * k);
+    return 12 * k + 12 + ((piece_scratch > top_scratch)
+                          ? piece_scratch : top_scratch);
+}
+
+/* private function priv_scratch
+ *
+ * limbs of scratch used by priv_mul on an >= bn limbs
+ */
+static size_t priv_scratch(const size_t an, const size_t bn)
+{
+    if (bn < E_BIGINT_KARATSUBA) {
+        return 0;
+    }
+    size_t limbs = priv_scratch_n(bn);
+    if (an == bn) {
+        return limbs;
+    }
+    if (an % bn != 0) {
+        const size_t last = priv_scratch(bn, an % bn);
+        limbs = (last > limbs) ? last : limbs;
+    }
+    return 2 * bn + limbs;
+}
+
+/* private function priv_grow_scratch
+ *
+ * makes room on scratch for limbs limbs, its contents are not kept
+ */
+static e_string_errno_t priv_grow_scratch(e_bigint_scratch_t* scratch,
+                                          const size_t limbs)
+{
+    if (limbs <= scratch->capacity) {
+        return E_STRING_SUCCESS;
+    }
+    uint64_t* memory = priv_allocate(limbs);
+    if (memory == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    priv_release(scratch->limbs, scratch->capacity);
+    scratch->limbs = memory;
+    scratch->capacity = limbs;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_add_signed
+ *
+ * result = a + b with the sign of b replaced by b_negative, so the same
+ * code adds and subtracts
+ */
+static e_string_errno_t priv_add_signed(e_bigint_t* result,
+                                        const e_bigint_t* a,
+                                        const e_bigint_t* b,
+                                        const bool b_negative)
+{
+    const bool a_negative = a->negative;
+    const bool swap = (a->length < b->length);
+    const e_bigint_t* x = (swap == true) ? b : a;
+    const e_bigint_t* y = (swap == true) ? a : b;
+    const size_t xn = x->length;
+    const size_t yn = y->length;
+
+    if (a_negative == b_negative) {
+        if (e_bigint_reserve(result, xn + 1) != E_STRING_SUCCESS) {
+            return E_STRING_OUT_OF_MEMORY;
+        }
+        /* the limbs are read after the reserve, result can be x or y */
+        const uint64_t carry = priv_add(result->limbs, x->limbs, xn,
+                                        y->limbs, yn);
+        result->limbs[xn] = carry;
+        result->length = xn + (size_t)carry;
+        result->negative = (result->length > 0) ? a_negative : false;
+        return E_STRING_SUCCESS;
+    }
+
+    /* different signs: the smaller magnitude is taken from the larger */
+    const int order = priv_compare(x->limbs, xn, y->limbs, yn);
+    if (order == 0) {
+        result->length = 0;
+        result->negative = false;
+        return E_STRING_SUCCESS;
+    }
+    const bool x_negative = (x == a) ? a_negative : b_negative;
+    const bool negative = (order > 0) ? x_negative : !x_negative;
+    if (e_bigint_reserve(result, xn) != E_STRING_SUCCESS) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    if (order > 0) {
+        priv_sub(result->limbs, x->limbs, xn, y->limbs, yn);
+    } else {
+        priv_sub_n(result->limbs, y->limbs, x->limbs, xn);
+    }
+    result->length = priv_normalize(result->limbs, xn);
+    result->negative = negative;
+    return E_STRING_SUCCESS;
+}
+
+
+void e_bigint_init(e_bigint_t* bigint)
+{
+    bigint->limbs = NULL;
+    bigint->length = 0;
+    bigint->capacity = 0;
+    bigint->negative = false;
+}
+
+
+void e_bigint_free(e_bigint_t* bigint)
+{
+    priv_release(bigint->limbs, bigint->capacity);
+    e_bigint_init(bigint);
+}
+
+
+e_string_errno_t e_bigint_reserve(e_bigint_t* bigint, const size_t limbs)
+{
+    if (limbs <= bigint->capacity) {
+        return E_STRING_SUCCESS;
+    }
+    if (limbs > E_BIGINT_MAX_LIMBS) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    size_t capacity = (bigint->capacity > E_BIGINT_MAX_LIMBS / 2)
+                      ? E_BIGINT_MAX_LIMBS : bigint->capacity * 2;
+    capacity = (capacity < limbs) ? limbs : capacity;
+    uint64_t* memory = NULL;
+    if (bigint->limbs == NULL) {
+        memory = priv_allocate(capacity);
+    } else {
+        const e_string_allocator_t* allocator = e_string_get_allocator();
+        memory = allocator->reallocate(allocator->context, bigint->limbs,
+                                       bigint->capacity * sizeof(uint64_t),
+                                       capacity * sizeof(uint64_t));
+    }
+    if (memory == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    bigint->limbs = memory;
+    bigint->capacity = capacity;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_bigint_set_uint64(e_bigint_t* bigint, const uint64_t number)
+{
+    return e_bigint_set_limbs(bigint, &number, 1, false);
+}
+
+
+e_string_errno_t e_bigint_set_int64(e_bigint_t* bigint, const int64_t number)
+{
+    const uint64_t magnitude = (number < 0) ? (uint64_t)0 - (uint64_t)number
+                                            : (uint64_t)number;
+    return e_bigint_set_limbs(bigint, &magnitude, 1, number < 0);
+}
+
+
+e_string_errno_t e_bigint_set_limbs(e_bigint_t* bigint, const uint64_t* limbs,
+                                    const size_t count, const bool negative)
+{
+    const size_t length = priv_normalize(limbs, count);
+    if (e_bigint_reserve(bigint, length) != E_STRING_SUCCESS) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    if (length > 0) {
+        memcpy(bigint->limbs, limbs, length * sizeof(uint64_t));
+    }
+    bigint->length = length;
+    bigint->negative = (length > 0) ? negative : false;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_bigint_copy(e_bigint_t* destination,
+                               const e_bigint_t* source)
+{
+    if (destination == source) {
+        return E_STRING_SUCCESS;
+    }
+    return e_bigint_set_limbs(destination, source->limbs, source->length,
+                              source->negative);
+}
+
+
+int e_bigint_compare(const e_bigint_t* a, const e_bigint_t* b)
+{
+    if (a->negative != b->negative) {
+        return (a->negative == true) ? -1 : 1;
+    }
+    const int order = priv_compare(a->limbs, a->length, b->limbs, b->length);
+    return (a->negative == true) ? -order : order;
+}
+
+
+e_string_errno_t e_bigint_add(e_bigint_t* result, const e_bigint_t* a,
+                              const e_bigint_t* b)
+{
+    return priv_add_signed(result, a, b, b->negative);
+}
+
+
+e_string_errno_t e_bigint_sub(e_bigint_t* result, const e_bigint_t* a,
+                              const e_bigint_t* b)
+{
+    return priv_add_signed(result, a, b,
+                           (b->length > 0) ? !b->negative : false);
+}
+
+
+e_string_errno_t e_bigint_mul(e_bigint_t* result, const e_bigint_t* a,
+                              const e_bigint_t* b,
+                              e_bigint_scratch_t* scratch)
+{
+    if (a->length == 0 || b->length == 0) {
+        result->length = 0;
+        result->negative = false;
+        return E_STRING_SUCCESS;
+    }
+
+    const bool swap = (a->length < b->length);
+    const e_bigint_t* x = (swap == true) ? b : a;
+    const e_bigint_t* y = (swap == true) ? a : b;
+    const size_t length = x->length + y->length;
+    const size_t limbs = e_bigint_scratch_limbs(x->length, y->length);
+    if (limbs == SIZE_MAX) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    e_bigint_scratch_t local;
+    e_bigint_scratch_init(&local);
+    e_bigint_scratch_t* used = (scratch != NULL) ? scratch : &local;
+    if (priv_grow_scratch(used, limbs) != E_STRING_SUCCESS
+        || e_bigint_reserve(result, length) != E_STRING_SUCCESS) {
+        e_bigint_scratch_free(&local);
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    /* when result is an operand, the product is made on scratch first */
+    const bool negative = (a->negative != b->negative);
+    const bool in_place = (result == a || result == b);
+    uint64_t* product = (in_place == true) ? used->limbs : result->limbs;
+    priv_mul(product, x->limbs, x->length, y->limbs, y->length,
+             used->limbs + length);
+    if (in_place == true) {
+        memcpy(result->limbs, product, length * sizeof(uint64_t));
+    }
+    result->length = priv_normalize(result->limbs, length);
+    result->negative = negative;
+    e_bigint_scratch_free(&local);
+    return E_STRING_SUCCESS;
+}
+
+
+void e_bigint_scratch_init(e_bigint_scratch_t* scratch)
+{
+    scratch->limbs = NULL;
+    scratch->capacity = 0;
+}
+
+
+void e_bigint_scratch_free(e_bigint_scratch_t* scratch)
+{
+    priv_release(scratch->limbs, scratch->capacity);
+    e_bigint_scratch_init(scratch);
+}
+
+
+size_t e_bigint_scratch_limbs(const size_t a_limbs, const size_t b_limbs)
+{
+    const size_t an = (a_limbs > b_limbs) ? a_limbs : b_limbs;
+    const size_t bn = (a_limbs > b_limbs) ? b_limbs : a_limbs;
+    if (an > E_BIGINT_MAX_LIMBS) {
+        return SIZE_MAX;
+    }
+    if (bn == 0) {
+        return 0;
+    }
+    /* room for the product of an in place e_bigint_mul, then priv_mul */
+    return an + bn + priv_scratch(an, bn);
+}
+
+
+e_string_errno_t e_bigint_scratch_reserve(e_bigint_scratch_t* scratch,
+                                          const size_t a_limbs,
+                                          const size_t b_limbs)
+{
+    const size_t limbs = e_bigint_scratch_limbs(a_limbs, b_limbs);
+    if (limbs == SIZE_MAX) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    return priv_grow_scratch(scratch, limbs);
+}
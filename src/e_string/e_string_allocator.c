@@ -0,0 +1,107 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_allocator implementation
+ *
+ * this module implements the allocator table used for e_string_t heap data.
+ * every allocation of the library goes through the private functions below,
+ * and the chunks of arenas through the same table (set on e_arena too).
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+
+/* private function priv_default_allocate */
+static void* priv_default_allocate(void* context, const size_t size)
+{
+    (void)context;
+    return malloc(size);
+}
+
+/* private function priv_default_reallocate */
+static void* priv_default_reallocate(void* context, void* memory,
+                                     const size_t old_size,
+                                     const size_t new_size)
+{
+    (void)context;
+    (void)old_size;
+    return realloc(memory, new_size);
+}
+
+/* private function priv_default_release */
+static void priv_default_release(void* context, void* memory,
+                                 const size_t size)
+{
+    (void)context;
+    (void)size;
+    free(memory);
+}
+
+static const e_string_allocator_t e_string_default_allocator = {
+    .allocate = priv_default_allocate,
+    .reallocate = priv_default_reallocate,
+    .release = priv_default_release,
+    .context = NULL
+};
+
+/* private allocator in use */
+static e_string_allocator_t e_string_allocator = {
+    .allocate = priv_default_allocate,
+    .reallocate = priv_default_reallocate,
+    .release = priv_default_release,
+    .context = NULL
+};
+
+
+void e_string_set_allocator(const e_string_allocator_t* allocator)
+{
+    e_string_allocator = (allocator != NULL) ? *allocator
+                                             : e_string_default_allocator;
+
+    /* arena chunks (builders, maps, intern pools, *_in strings) follow */
+    const e_arena_allocator_t chunks = {
+        .allocate = e_string_allocator.allocate,
+        .release = e_string_allocator.release,
+        .context = e_string_allocator.context
+    };
+    e_arena_set_allocator(&chunks);
+}
+
+
+const e_string_allocator_t* e_string_get_allocator(void)
+{
+    return &e_string_allocator;
+}
+
+
+void* e_string_allocate(const size_t size)
+{
+    return e_string_allocator.allocate(e_string_allocator.context, size);
+}
+
+
+void* e_string_reallocate(void* memory, const size_t old_size,
+                          const size_t new_size)
+{
+    if (memory == NULL) {
+        return e_string_allocate(new_size);
+    }
+    return e_string_allocator.reallocate(e_string_allocator.context, memory,
+                                         old_size, new_size);
+}
+
+
+void e_string_release(void* memory, const size_t size)
+{
+    if (memory != NULL) {
+        e_string_allocator.release(e_string_allocator.context, memory, size);
+    }
+}
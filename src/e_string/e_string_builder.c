@@ -0,0 +1,284 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_builder implementation
+ *
+ * this module implements a builder that assembles a string from segments
+ * without copying them until the end.
+ *
+ * a segment is a view on data borrowed from the caller, or on bytes copied
+ * into chunks of the arena of the builder. copies that follow each other on
+ * the same chunk extend the same segment, and borrowed views shorter than
+ * E_STRING_BUILDER_MIN_BORROW are copied as well, so small pieces (field
+ * names, separators, numbers) end up on a few segments.
+ *
+ * the segments are then either copied once into an e_string_t of the exact
+ * length, or given to writev in batches, so the bytes go from the pieces to
+ * the kernel without an intermediate buffer.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+/* writev is POSIX, and the library is built without extensions */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define E_STRING_BUILDER_POSIX 1
+#endif
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* bytes of the chunks copies are made into */
+#define E_STRING_BUILDER_CHUNK 4096
+
+/* views shorter than this are copied instead of borrowed */
+#define E_STRING_BUILDER_MIN_BORROW 64
+
+/* segments given to a single writev call */
+#define E_STRING_BUILDER_IOV 64
+
+/* cached flags kept by the builder */
+#define E_STRING_BUILDER_FLAGS (E_STRING_FLAG_UTF8 | E_STRING_FLAG_ASCII)
+
+
+/* private function priv_push
+ *
+ * adds a segment for length bytes of data, growing the segments by half
+ */
+static e_string_errno_t priv_push(e_string_builder_t* builder,
+                                  const uint8_t* data, const size_t length)
+{
+    if (builder->segment_count == builder->segment_capacity) {
+        const size_t capacity = (builder->segment_capacity < 8)
+                                ? 16 : builder->segment_capacity * 3 / 2;
+        e_string_view_t* segments = e_string_reallocate(
+            builder->segments,
+            builder->segment_capacity * sizeof(e_string_view_t),
+            capacity * sizeof(e_string_view_t));
+        if (segments == NULL) {
+            return E_STRING_OUT_OF_MEMORY;
+        }
+        builder->segments = segments;
+        builder->segment_capacity = capacity;
+    }
+
+    const e_string_view_t segment = { .data = data, .length = length };
+    builder->segments[builder->segment_count++] = segment;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_reserve
+ *
+ * returns length writable bytes at the end of the current chunk, taking a
+ * new chunk when they do not fit, or NULL when out of memory
+ */
+static uint8_t* priv_reserve(e_string_builder_t* builder, const size_t length)
+{
+    if (builder->chunk_capacity - builder->chunk_used < length) {
+        const size_t capacity = (length > E_STRING_BUILDER_CHUNK)
+                                ? length : E_STRING_BUILDER_CHUNK;
+        uint8_t* chunk = e_arena_alloc(&builder->arena, capacity, 1);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        builder->chunk = chunk;
+        builder->chunk_used = 0;
+        builder->chunk_capacity = capacity;
+    }
+    return builder->chunk + builder->chunk_used;
+}
+
+/* private function priv_commit
+ *
+ * adds the length bytes written at the end of the current chunk, extending
+ * the last segment when it ends right before them
+ */
+static e_string_errno_t priv_commit(e_string_builder_t* builder,
+                                    const size_t length, const uint32_t flags)
+{
+    uint8_t* start = builder->chunk + builder->chunk_used;
+    e_string_view_t* last = (builder->segment_count > 0)
+                            ? &builder->segments[builder->segment_count - 1]
+                            : NULL;
+    if (last != NULL && builder->chunk_used > 0
+        && last->data + last->length == start) {
+        last->length += length;
+    } else {
+        const e_string_errno_t result = priv_push(builder, start, length);
+        if (result != E_STRING_SUCCESS) {
+            return result;
+        }
+    }
+    builder->chunk_used += length;
+    builder->length += length;
+    builder->flags &= flags;
+    return E_STRING_SUCCESS;
+}
+
+
+void e_string_builder_init(e_string_builder_t* builder)
+{
+    const e_string_builder_t empty = { .flags = E_STRING_BUILDER_FLAGS };
+    *builder = empty;
+    e_arena_init(&builder->arena, 0);
+}
+
+
+void e_string_builder_free(e_string_builder_t* builder)
+{
+    e_string_release(builder->segments,
+                     builder->segment_capacity * sizeof(e_string_view_t));
+    e_arena_destroy(&builder->arena);
+    e_string_builder_init(builder);
+}
+
+
+void e_string_builder_reset(e_string_builder_t* builder)
+{
+    e_arena_reset(&builder->arena);
+    builder->segment_count = 0;
+    builder->length = 0;
+    builder->chunk = NULL;
+    builder->chunk_used = 0;
+    builder->chunk_capacity = 0;
+    builder->flags = E_STRING_BUILDER_FLAGS;
+}
+
+
+e_string_errno_t e_string_builder_append_view(e_string_builder_t* builder,
+                                              const e_string_view_t view)
+{
+    if (view.length < E_STRING_BUILDER_MIN_BORROW) {
+        return e_string_builder_append_copy(builder, view);
+    }
+
+    const e_string_errno_t result = priv_push(builder, view.data,
+                                              view.length);
+    if (result == E_STRING_SUCCESS) {
+        builder->length += view.length;
+        builder->flags &= view.flags;
+    }
+    return result;
+}
+
+
+e_string_errno_t e_string_builder_append_copy(e_string_builder_t* builder,
+                                              const e_string_view_t view)
+{
+    if (view.length == 0) {
+        return E_STRING_SUCCESS;
+    }
+
+    uint8_t* bytes = priv_reserve(builder, view.length);
+    if (bytes == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    memcpy(bytes, view.data, view.length);
+    return priv_commit(builder, view.length, view.flags);
+}
+
+
+e_string_errno_t e_string_builder_append(e_string_builder_t* builder,
+                                         const e_string_t* string)
+{
+    return e_string_builder_append_view(builder, e_string_view(string));
+}
+
+
+e_string_errno_t e_string_builder_append_cstr(e_string_builder_t* builder,
+                                              const char* cstr)
+{
+    return e_string_builder_append_copy(builder,
+                                        e_string_view_from_cstr(cstr));
+}
+
+
+e_string_errno_t e_string_builder_append_uint64(e_string_builder_t* builder,
+                                                const uint64_t number)
+{
+    const size_t length = e_string_digits(number);
+    uint8_t* bytes = priv_reserve(builder, length);
+    if (bytes == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    e_string_write_digits(bytes + length, number);
+    return priv_commit(builder, length, E_STRING_BUILDER_FLAGS);
+}
+
+
+e_string_errno_t e_string_builder_build(const e_string_builder_t* builder,
+                                        e_string_t* string)
+{
+    e_string_t result = e_string_with_length(NULL, builder->length);
+    if (e_string_length(&result) != builder->length) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    uint8_t* data = e_string_data_mut(&result);
+    for (size_t s = 0; s < builder->segment_count; s++) {
+        memcpy(data, builder->segments[s].data, builder->segments[s].length);
+        data += builder->segments[s].length;
+    }
+    if ((builder->flags & E_STRING_FLAG_ASCII) != 0) {
+        e_string_set_ascii(&result);
+    } else {
+        result.flags |= builder->flags & E_STRING_FLAG_UTF8;
+    }
+    *string = result;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_builder_write(const e_string_builder_t* builder,
+                                        const int fd)
+{
+#ifdef E_STRING_BUILDER_POSIX
+    struct iovec iov[E_STRING_BUILDER_IOV];
+    size_t segment = 0;
+    size_t offset = 0;
+    while (segment < builder->segment_count) {
+        /* the next batch starts offset bytes into segment */
+        int count = 0;
+        for (size_t s = segment; s < builder->segment_count
+             && count < E_STRING_BUILDER_IOV; s++) {
+            const size_t skip = (s == segment) ? offset : 0;
+            iov[count].iov_base = (void*)(builder->segments[s].data + skip);
+            iov[count].iov_len = builder->segments[s].length - skip;
+            count += 1;
+        }
+
+        const ssize_t written = writev(fd, iov, count);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written <= 0) {
+            return E_STRING_IO_ERROR;
+        }
+
+        /* skip what was written, writes can be partial */
+        size_t left = (size_t)written;
+        while (segment < builder->segment_count
+               && left >= builder->segments[segment].length - offset) {
+            left -= builder->segments[segment].length - offset;
+            segment += 1;
+            offset = 0;
+        }
+        offset += left;
+    }
+    return E_STRING_SUCCESS;
+#else
+    (void)builder;
+    (void)fd;
+    return E_STRING_IO_ERROR;
+#endif
+}
@@ -0,0 +1,584 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_find implementation
+ *
+ * this module implements substring search over e_string_t and views.
+ *
+ * the search depends on the needle length:
+ *   - 1 byte: memchr, or a backwards loop for rfind
+ *   - up to E_STRING_FIND_SHORT bytes: candidates are the positions where
+ *     both the first and the last byte of the needle match, found 32 at a
+ *     time with AVX2 (memchr on the first byte without it), and checked with
+ *     memcmp. the work per position is bounded by the needle length.
+ *   - longer needles: Two-Way (Crochemore-Perrin), linear on the worst case
+ *     with constant memory, jumping with memchr to the next position where
+ *     the first compared byte matches. rfind runs it over the mirrored data.
+ *
+ * matches that would split a UTF-8 codepoint are skipped, which only happens
+ * when the needle starts or ends in the middle of a codepoint. a needle
+ * starting in the middle of one never matches, and is not searched for.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+#ifdef E_STRING_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* longest needle searched with the first and last byte filter */
+#define E_STRING_FIND_SHORT 32
+
+
+/* e_string_two_way struct
+ *
+ * the critical factorization of a needle, computed once for a search
+ *
+ * PODs definition
+ *   - suffix: defines the start of the right half
+ *   - period: defines the period of needle, or the shift after a match of
+ *     the left half when needle is not periodic
+ *   - first: defines the first byte of the right half
+ *   - periodic: defines if the left half is a repetition of the period
+ *   - reverse: defines if needle and data are read from the end
+ */
+typedef struct e_string_two_way
+{
+    size_t suffix;
+    size_t period;
+    uint8_t first;
+    bool periodic;
+    bool reverse;
+} e_string_two_way_t;
+
+
+/* private function priv_boundary
+ *
+ * checks that offset of view is not inside a codepoint
+ */
+static inline bool priv_boundary(const e_string_view_t view,
+                                 const size_t offset)
+{
+    return offset == view.length || (view.data[offset] & 0xC0) != 0x80;
+}
+
+/* private function priv_at
+ *
+ * byte at index of length bytes of data, read from the end when reverse
+ */
+static inline uint8_t priv_at(const uint8_t* data, const size_t length,
+                              const size_t index, const bool reverse)
+{
+    return reverse ? data[length - 1 - index] : data[index];
+}
+
+/* private function priv_ends_codepoint
+ *
+ * checks that a match of needle_length bytes at shift j of data does not end
+ * inside a codepoint, data being read from the end when reverse. data ends
+ * where the searched view does.
+ */
+static inline bool priv_ends_codepoint(const uint8_t* data,
+                                       const size_t length,
+                                       const size_t needle_length,
+                                       const size_t j, const bool reverse)
+{
+    const size_t end = reverse ? length - j : j + needle_length;
+    return end == length || (data[end] & 0xC0) != 0x80;
+}
+
+/* private function priv_max_suffix
+ *
+ * computes the maximal suffix of needle for the byte order given by greater,
+ * returning its start minus one (SIZE_MAX for the whole needle) and storing
+ * its period on period
+ */
+static size_t priv_max_suffix(const uint8_t* needle, const size_t length,
+                              const bool reverse, const bool greater,
+                              size_t* period)
+{
+    size_t suffix = SIZE_MAX;
+    size_t j = 0;
+    size_t k = 1;
+    size_t p = 1;
+    while (j + k < length) {
+        const uint8_t a = priv_at(needle, length, j + k, reverse);
+        const uint8_t b = priv_at(needle, length, suffix + k, reverse);
+        if (greater ? (a < b) : (a > b)) {
+            j += k;
+            k = 1;
+            p = j - suffix;
+        } else if (a == b) {
+            if (k != p) {
+                k += 1;
+            } else {
+                j += p;
+                k = 1;
+            }
+        } else {
+            suffix = j;
+            j = suffix + 1;
+            k = 1;
+            p = 1;
+        }
+    }
+    *period = p;
+    return suffix;
+}
+
+/* private function priv_skip
+ *
+ * smallest shift from j on where the byte at offset of needle matches data,
+ * or SIZE_MAX when there is none: memchr jumps over the positions that would
+ * mismatch on the first byte Two-Way compares.
+ */
+static inline size_t priv_skip(const uint8_t* data, const size_t length,
+                               const size_t needle_length, const size_t j,
+                               const size_t offset, const uint8_t byte,
+                               const bool reverse)
+{
+    const size_t last_shift = length - needle_length;
+    if (reverse == false) {
+        const uint8_t* match = memchr(data + j + offset, byte,
+                                      last_shift - j + 1);
+        return (match == NULL) ? SIZE_MAX
+                               : (size_t)(match - data) - offset;
+    }
+    for (size_t shift = j; shift <= last_shift; shift++) {
+        if (data[length - 1 - shift - offset] == byte) {
+            return shift;
+        }
+    }
+    return SIZE_MAX;
+}
+
+/* private function priv_two_way_prepare
+ *
+ * computes the critical factorization of needle for Two-Way, reading it
+ * from the end when reverse
+ */
+static void priv_two_way_prepare(const uint8_t* needle,
+                                 const size_t needle_length,
+                                 const bool reverse, e_string_two_way_t* plan)
+{
+    /* the critical factorization splits needle at the later of both maximal
+     * suffixes, which is the start of the right half
+     */
+    size_t period;
+    size_t period_greater;
+    const size_t less = priv_max_suffix(needle, needle_length, reverse, false,
+                                        &period);
+    const size_t greater = priv_max_suffix(needle, needle_length, reverse, true,
+                                           &period_greater);
+    size_t suffix = less + 1;
+    if (greater + 1 > less + 1) {
+        suffix = greater + 1;
+        period = period_greater;
+    }
+
+    bool periodic = true;
+    for (size_t i = 0; i < suffix && periodic; i++) {
+        periodic = priv_at(needle, needle_length, i, reverse)
+                   == priv_at(needle, needle_length, i + period, reverse);
+    }
+    if (periodic == false) {
+        period = ((suffix > needle_length - suffix)
+                  ? suffix : needle_length - suffix) + 1;
+    }
+
+    /* the right half is compared first, from its first byte */
+    plan->suffix = suffix;
+    plan->period = period;
+    plan->first = priv_at(needle, needle_length, suffix, reverse);
+    plan->periodic = periodic;
+    plan->reverse = reverse;
+}
+
+/* private function priv_two_way
+ *
+ * Two-Way search of needle in data with the factorization of plan, both
+ * read from the end when plan is reverse, so the result is then the offset
+ * of the match counted from the end. matches ending inside a codepoint are
+ * shifted over as any other match, so the search stays linear. returns
+ * SIZE_MAX when needle is not found.
+ */
+static size_t priv_two_way(const uint8_t* data, const size_t length,
+                           const uint8_t* needle, const size_t needle_length,
+                           const e_string_two_way_t* plan)
+{
+    const size_t suffix = plan->suffix;
+    const size_t period = plan->period;
+    const uint8_t first = plan->first;
+    const bool reverse = plan->reverse;
+
+    size_t j = 0;
+    if (plan->periodic == true) {
+        /* the left half is a repetition of the period, so the part of the
+         * right half that already matched is remembered across shifts
+         */
+        size_t memory = 0;
+        while (j <= length - needle_length) {
+            if (memory == 0) {
+                j = priv_skip(data, length, needle_length, j, suffix,
+                              first, reverse);
+                if (j == SIZE_MAX) {
+                    return SIZE_MAX;
+                }
+            }
+            size_t i = (suffix > memory) ? suffix : memory;
+            while (i < needle_length
+                   && priv_at(needle, needle_length, i, reverse)
+                      == priv_at(data, length, i + j, reverse)) {
+                i += 1;
+            }
+            if (i < needle_length) {
+                j += i - suffix + 1;
+                memory = 0;
+                continue;
+            }
+            i = suffix - 1;
+            while (memory < i + 1
+                   && priv_at(needle, needle_length, i, reverse)
+                      == priv_at(data, length, i + j, reverse)) {
+                i -= 1;
+            }
+            if (i + 1 < memory + 1
+                && priv_ends_codepoint(data, length, needle_length, j,
+                                       reverse)) {
+                return j;
+            }
+            j += period;
+            memory = needle_length - period;
+        }
+        return SIZE_MAX;
+    }
+
+    while (j <= length - needle_length) {
+        j = priv_skip(data, length, needle_length, j, suffix, first, reverse);
+        if (j == SIZE_MAX) {
+            return SIZE_MAX;
+        }
+        size_t i = suffix;
+        while (i < needle_length
+               && priv_at(needle, needle_length, i, reverse)
+                  == priv_at(data, length, i + j, reverse)) {
+            i += 1;
+        }
+        if (i < needle_length) {
+            j += i - suffix + 1;
+            continue;
+        }
+        i = suffix - 1;
+        while (i != SIZE_MAX
+               && priv_at(needle, needle_length, i, reverse)
+                  == priv_at(data, length, i + j, reverse)) {
+            i -= 1;
+        }
+        if (i == SIZE_MAX
+            && priv_ends_codepoint(data, length, needle_length, j, reverse)) {
+            return j;
+        }
+        j += period;
+    }
+    return SIZE_MAX;
+}
+
+/* private function priv_find_short
+ *
+ * first and last byte filter without SIMD, needle has at least 2 bytes
+ */
+static size_t priv_find_short(const uint8_t* data, const size_t length,
+                              const uint8_t* needle, const size_t needle_length)
+{
+    const uint8_t last = needle[needle_length - 1];
+    const size_t last_start = length - needle_length;
+    size_t offset = 0;
+    while (offset <= last_start) {
+        const uint8_t* candidate = memchr(data + offset, needle[0],
+                                          last_start - offset + 1);
+        if (candidate == NULL) {
+            return SIZE_MAX;
+        }
+        offset = (size_t)(candidate - data);
+        if (candidate[needle_length - 1] == last
+            && memcmp(candidate + 1, needle + 1, needle_length - 2) == 0) {
+            return offset;
+        }
+        offset += 1;
+    }
+    return SIZE_MAX;
+}
+
+/* private function priv_rfind_short
+ *
+ * same as priv_find_short for the last match
+ */
+static size_t priv_rfind_short(const uint8_t* data, const size_t length,
+                               const uint8_t* needle,
+                               const size_t needle_length)
+{
+    const uint8_t first = needle[0];
+    const uint8_t last = needle[needle_length - 1];
+    for (size_t offset = length - needle_length + 1; offset-- > 0;) {
+        if (data[offset] == first && data[offset + needle_length - 1] == last
+            && memcmp(data + offset + 1, needle + 1, needle_length - 2) == 0) {
+            return offset;
+        }
+    }
+    return SIZE_MAX;
+}
+
+#ifdef E_STRING_X86_SIMD
+
+/* private function priv_find_avx2
+ *
+ * first and last byte filter over 32 positions per step, needle has at
+ * least 2 bytes. requires AVX2 at runtime
+ */
+__attribute__((target("avx2")))
+static size_t priv_find_avx2(const uint8_t* data, const size_t length,
+                             const uint8_t* needle, const size_t needle_length)
+{
+    const __m256i first = _mm256_set1_epi8((char)needle[0]);
+    const __m256i last = _mm256_set1_epi8((char)needle[needle_length - 1]);
+    size_t offset = 0;
+
+    /* the last bytes of 32 positions end at offset + needle_length + 31 */
+    for (; length - offset >= needle_length + 31; offset += 32) {
+        const __m256i starts = _mm256_loadu_si256((const __m256i*)(data
+                                                                   + offset));
+        const __m256i ends = _mm256_loadu_si256(
+            (const __m256i*)(data + offset + needle_length - 1));
+        uint32_t candidates = (uint32_t)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(starts, first),
+                             _mm256_cmpeq_epi8(ends, last)));
+        while (candidates != 0) {
+            const size_t position = offset
+                                  + (size_t)__builtin_ctz(candidates);
+            if (memcmp(data + position + 1, needle + 1, needle_length - 2)
+                == 0) {
+                return position;
+            }
+            candidates &= candidates - 1;
+        }
+    }
+
+    const size_t rest = priv_find_short(data + offset, length - offset,
+                                        needle, needle_length);
+    return (rest == SIZE_MAX) ? SIZE_MAX : offset + rest;
+}
+
+/* private function priv_rfind_avx2
+ *
+ * same as priv_find_avx2 for the last match, from the end of data
+ */
+__attribute__((target("avx2")))
+static size_t priv_rfind_avx2(const uint8_t* data, const size_t length,
+                              const uint8_t* needle, const size_t needle_length)
+{
+    const __m256i first = _mm256_set1_epi8((char)needle[0]);
+    const __m256i last = _mm256_set1_epi8((char)needle[needle_length - 1]);
+
+    /* positions not yet checked are the ones below end */
+    size_t end = length - needle_length + 1;
+    for (; end >= 32; end -= 32) {
+        const size_t offset = end - 32;
+        const __m256i starts = _mm256_loadu_si256((const __m256i*)(data
+                                                                   + offset));
+        const __m256i ends = _mm256_loadu_si256(
+            (const __m256i*)(data + offset + needle_length - 1));
+        uint32_t candidates = (uint32_t)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(starts, first),
+                             _mm256_cmpeq_epi8(ends, last)));
+        while (candidates != 0) {
+            const size_t bit = 31 - (size_t)__builtin_clz(candidates);
+            if (memcmp(data + offset + bit + 1, needle + 1, needle_length - 2)
+                == 0) {
+                return offset + bit;
+            }
+            candidates &= ~(1u << bit);
+        }
+    }
+    return priv_rfind_short(data, end + needle_length - 1, needle,
+                            needle_length);
+}
+
+#endif /* E_STRING_X86_SIMD */
+
+/* private function priv_find_bytes
+ *
+ * offset of the first occurrence of needle in data, or SIZE_MAX. needle is
+ * not empty and not longer than data, plan is its factorization when it is
+ * longer than E_STRING_FIND_SHORT.
+ */
+static size_t priv_find_bytes(const uint8_t* data, const size_t length,
+                              const uint8_t* needle, const size_t needle_length,
+                              const e_string_two_way_t* plan)
+{
+    if (needle_length == 1) {
+        const uint8_t* match = memchr(data, needle[0], length);
+        return (match == NULL) ? SIZE_MAX : (size_t)(match - data);
+    } else if (needle_length > E_STRING_FIND_SHORT) {
+        return priv_two_way(data, length, needle, needle_length, plan);
+    }
+#ifdef E_STRING_X86_SIMD
+    if (e_string_validate_engine_available(E_STRING_ENGINE_AVX2)) {
+        return priv_find_avx2(data, length, needle, needle_length);
+    }
+#endif
+    return priv_find_short(data, length, needle, needle_length);
+}
+
+/* private function priv_rfind_bytes
+ *
+ * same as priv_find_bytes for the last occurrence
+ */
+static size_t priv_rfind_bytes(const uint8_t* data, const size_t length,
+                               const uint8_t* needle,
+                               const size_t needle_length,
+                               const e_string_two_way_t* plan)
+{
+    if (needle_length == 1) {
+        for (size_t offset = length; offset-- > 0;) {
+            if (data[offset] == needle[0]) {
+                return offset;
+            }
+        }
+        return SIZE_MAX;
+    } else if (needle_length > E_STRING_FIND_SHORT) {
+        const size_t mirrored = priv_two_way(data, length, needle,
+                                             needle_length, plan);
+        return (mirrored == SIZE_MAX) ? SIZE_MAX
+                                      : length - needle_length - mirrored;
+    }
+#ifdef E_STRING_X86_SIMD
+    if (e_string_validate_engine_available(E_STRING_ENGINE_AVX2)) {
+        return priv_rfind_avx2(data, length, needle, needle_length);
+    }
+#endif
+    return priv_rfind_short(data, length, needle, needle_length);
+}
+
+
+size_t e_string_view_find(const e_string_view_t view,
+                          const e_string_view_t needle)
+{
+    if (needle.length == 0) {
+        return 0;
+    }
+
+    /* a needle starting inside a codepoint never matches on a boundary */
+    if (needle.length > view.length || (needle.data[0] & 0xC0) == 0x80) {
+        return E_STRING_NOT_FOUND;
+    }
+
+    /* matches rejected for ending inside a codepoint resume the search,
+     * the factorization of long needles is computed once for all of them */
+    e_string_two_way_t plan;
+    if (needle.length > E_STRING_FIND_SHORT) {
+        priv_two_way_prepare(needle.data, needle.length, false, &plan);
+    }
+    size_t offset = 0;
+    while (view.length - offset >= needle.length) {
+        const size_t match = priv_find_bytes(view.data + offset,
+                                             view.length - offset,
+                                             needle.data, needle.length,
+                                             &plan);
+        if (match == SIZE_MAX) {
+            break;
+        }
+        offset += match;
+        if (priv_boundary(view, offset)
+            && priv_boundary(view, offset + needle.length)) {
+            return offset;
+        }
+        offset += 1;
+    }
+    return E_STRING_NOT_FOUND;
+}
+
+
+size_t e_string_view_rfind(const e_string_view_t view,
+                           const e_string_view_t needle)
+{
+    if (needle.length == 0) {
+        return view.length;
+    }
+    if (needle.length > view.length || (needle.data[0] & 0xC0) == 0x80) {
+        return E_STRING_NOT_FOUND;
+    }
+
+    /* matches are searched for in data ending at end */
+    e_string_two_way_t plan;
+    if (needle.length > E_STRING_FIND_SHORT) {
+        priv_two_way_prepare(needle.data, needle.length, true, &plan);
+    }
+    size_t end = view.length;
+    while (end >= needle.length) {
+        const size_t match = priv_rfind_bytes(view.data, end, needle.data,
+                                              needle.length, &plan);
+        if (match == SIZE_MAX) {
+            break;
+        }
+        if (priv_boundary(view, match)
+            && priv_boundary(view, match + needle.length)) {
+            return match;
+        }
+        end = match + needle.length - 1;
+    }
+    return E_STRING_NOT_FOUND;
+}
+
+
+size_t e_string_view_count_occurrences(const e_string_view_t view,
+                                       const e_string_view_t needle)
+{
+    /* the empty needle is found between every two codepoints */
+    if (needle.length == 0) {
+        return e_string_view_utf8_length(view) + 1;
+    }
+
+    size_t count = 0;
+    size_t offset = 0;
+    for (;;) {
+        const e_string_view_t rest = {
+            .data = view.data + offset,
+            .length = view.length - offset
+        };
+        const size_t match = e_string_view_find(rest, needle);
+        if (match == E_STRING_NOT_FOUND) {
+            return count;
+        }
+        count += 1;
+        offset += match + needle.length;
+    }
+}
+
+
+size_t e_string_find(const e_string_t* string, const e_string_view_t needle)
+{
+    return e_string_view_find(e_string_view(string), needle);
+}
+
+
+size_t e_string_rfind(const e_string_t* string, const e_string_view_t needle)
+{
+    return e_string_view_rfind(e_string_view(string), needle);
+}
+
+
+size_t e_string_count_occurrences(const e_string_t* string,
+                                  const e_string_view_t needle)
+{
+    return e_string_view_count_occurrences(e_string_view(string), needle);
+}
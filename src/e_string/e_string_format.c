@@ -0,0 +1,367 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_format implementation
+ *
+ * this module implements the functions behind the e_format macros.
+ *
+ * the types of the arguments are resolved at compile time by _Generic, so
+ * the format itself only tells where each argument goes. it is read twice:
+ *   - a first pass checks the format and adds up the length of the output,
+ *     using the length of every argument (digits are counted without
+ *     dividing, cstr are measured once and the length is kept, floating
+ *     point numbers are written on a scratch buffer and copied later)
+ *   - a second pass writes the output straight into its final place
+ *
+ * so e_format grows the string at most once, and nothing is written when
+ * the format is not valid or the output does not fit.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/* private function priv_magnitude
+ *
+ * absolute value of number as unsigned, valid for INT64_MIN as well
+ */
+static inline uint64_t priv_magnitude(const int64_t number)
+{
+    return (number < 0) ? (uint64_t)0 - (uint64_t)number : (uint64_t)number;
+}
+
+/* private function priv_text
+ *
+ * gets the text of a cstr, string or view argument, returning false for
+ * the other types
+ */
+static bool priv_text(const e_format_arg_t* arg, e_string_view_t* text)
+{
+    switch (arg->type) {
+    case E_FORMAT_TYPE_CSTR:
+        *text = e_string_view_from_cstr(arg->value.cstr);
+        return true;
+    case E_FORMAT_TYPE_STRING:
+        *text = e_string_view(arg->value.string);
+        return true;
+    case E_FORMAT_TYPE_VIEW:
+        *text = arg->value.view;
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* private function priv_arg_length
+ *
+ * bytes the argument takes on the output, floating point numbers are
+ * written on scratch
+ */
+static size_t priv_arg_length(const e_format_arg_t* arg, uint8_t* scratch)
+{
+    switch (arg->type) {
+    case E_FORMAT_TYPE_CSTR:
+        return strlen(arg->value.cstr);
+    case E_FORMAT_TYPE_STRING:
+        return e_string_length(arg->value.string);
+    case E_FORMAT_TYPE_VIEW:
+        return arg->value.view.length;
+    case E_FORMAT_TYPE_BOOL:
+        return (arg->value.boolean == true) ? 4 : 5;
+    case E_FORMAT_TYPE_CHAR:
+        return 1;
+    case E_FORMAT_TYPE_UINT64:
+        return e_string_digits(arg->value.uint64);
+    case E_FORMAT_TYPE_INT64:
+        return e_string_digits(priv_magnitude(arg->value.int64))
+               + (arg->value.int64 < 0);
+    case E_FORMAT_TYPE_DOUBLE:
+        return e_string_write_float(scratch, arg->value.floating, false);
+    case E_FORMAT_TYPE_FLOAT:
+        return e_string_write_float(scratch, arg->value.floating, true);
+    default:
+        return 0;
+    }
+}
+
+/* private function priv_write_arg
+ *
+ * writes the length bytes of the argument on output, floating point
+ * numbers are copied from scratch
+ */
+static void priv_write_arg(const e_format_arg_t* arg, const uint8_t* scratch,
+                           uint8_t* output, const size_t length)
+{
+    switch (arg->type) {
+    case E_FORMAT_TYPE_CSTR:
+        memcpy(output, arg->value.cstr, length);
+        break;
+    case E_FORMAT_TYPE_STRING:
+        memcpy(output, e_string_data(arg->value.string), length);
+        break;
+    case E_FORMAT_TYPE_VIEW:
+        if (length > 0) {
+            memcpy(output, arg->value.view.data, length);
+        }
+        break;
+    case E_FORMAT_TYPE_BOOL:
+        memcpy(output, (arg->value.boolean == true) ? "true" : "false",
+               length);
+        break;
+    case E_FORMAT_TYPE_CHAR:
+        output[0] = (uint8_t)arg->value.character;
+        break;
+    case E_FORMAT_TYPE_UINT64:
+        e_string_write_digits(output + length, arg->value.uint64);
+        break;
+    case E_FORMAT_TYPE_INT64:
+        if (arg->value.int64 < 0) {
+            output[0] = '-';
+        }
+        e_string_write_digits(output + length,
+                              priv_magnitude(arg->value.int64));
+        break;
+    case E_FORMAT_TYPE_DOUBLE:
+    case E_FORMAT_TYPE_FLOAT:
+        memcpy(output, scratch, length);
+        break;
+    default:
+        break;
+    }
+}
+
+/* private function priv_rebase
+ *
+ * text moved from the old data of a string to data when it points into its
+ * old_length bytes or their terminator, or text itself when it does not
+ */
+static const void* priv_rebase(const void* text, const uintptr_t old_data,
+                               const size_t old_length, const uint8_t* data)
+{
+    const uintptr_t address = (uintptr_t)text;
+    if (address >= old_data && address - old_data <= old_length) {
+        return data + (address - old_data);
+    }
+    return text;
+}
+
+/* private function priv_find_brace
+ *
+ * index of the first { or } of format at or after start, or the length of
+ * format when there is none. 16 bytes are checked at once with SSE2, as
+ * most of a format is text copied as it is.
+ */
+static inline size_t priv_find_brace(const e_string_view_t format,
+                                     size_t start)
+{
+#if defined(__SSE2__)
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    for (; start + 16 <= format.length; start += 16) {
+        const __m128i bytes = _mm_loadu_si128(
+            (const __m128i*)(format.data + start));
+        const uint32_t mask = (uint32_t)_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, open),
+                         _mm_cmpeq_epi8(bytes, close)));
+        if (mask != 0) {
+#if defined(__GNUC__) || defined(__clang__)
+            return start + (size_t)__builtin_ctz(mask);
+#else
+            break;
+#endif
+        }
+    }
+#endif
+    while (start < format.length && format.data[start] != '{'
+           && format.data[start] != '}') {
+        start += 1;
+    }
+    return start;
+}
+
+/* private function priv_measure
+ *
+ * checks the format against the arguments, storing on lengths the length
+ * of every argument and on length the length of the whole output
+ */
+static e_string_errno_t priv_measure(const e_string_view_t format,
+                                     const e_format_arg_t* args,
+                                     const size_t count, size_t* lengths,
+                                     uint8_t (*scratch)[E_STRING_FLOAT_LENGTH],
+                                     size_t* length)
+{
+    size_t total = 0;
+    size_t next = 1;
+    size_t start = 0;
+    for (;;) {
+        const size_t brace = priv_find_brace(format, start);
+        total += brace - start;
+        if (brace == format.length) {
+            break;
+        }
+
+        /* {{ and }} are escapes, {} takes the next argument */
+        if (brace + 1 == format.length) {
+            return E_STRING_INVALID_FORMAT;
+        }
+        const uint8_t byte = format.data[brace];
+        const uint8_t following = format.data[brace + 1];
+        if (following == byte) {
+            total += 1;
+        } else if (byte == '{' && following == '}' && next < count) {
+            lengths[next] = priv_arg_length(&args[next], scratch[next]);
+            if (lengths[next] > SIZE_MAX - total) {
+                return E_STRING_OUT_OF_MEMORY;
+            }
+            total += lengths[next];
+            next += 1;
+        } else {
+            return E_STRING_INVALID_FORMAT;
+        }
+        start = brace + 2;
+    }
+
+    if (next != count) {
+        return E_STRING_INVALID_FORMAT;
+    }
+    *length = total;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_write
+ *
+ * writes the output of a format checked by priv_measure on output
+ */
+static void priv_write(const e_string_view_t format,
+                       const e_format_arg_t* args, const size_t* lengths,
+                       uint8_t (*scratch)[E_STRING_FLOAT_LENGTH],
+                       uint8_t* output)
+{
+    size_t next = 1;
+    size_t start = 0;
+    for (;;) {
+        const size_t brace = priv_find_brace(format, start);
+        if (brace > start) {
+            memcpy(output, format.data + start, brace - start);
+            output += brace - start;
+        }
+        if (brace == format.length) {
+            break;
+        }
+
+        if (format.data[brace + 1] == format.data[brace]) {
+            *output++ = format.data[brace];
+        } else {
+            priv_write_arg(&args[next], scratch[next], output,
+                           lengths[next]);
+            output += lengths[next];
+            next += 1;
+        }
+        start = brace + 2;
+    }
+}
+
+/* private function priv_prepare
+ *
+ * gets the format of the arguments and measures the output
+ */
+static e_string_errno_t priv_prepare(const e_format_arg_t* args,
+                                     const size_t count,
+                                     e_string_view_t* format, size_t* lengths,
+                                     uint8_t (*scratch)[E_STRING_FLOAT_LENGTH],
+                                     size_t* length)
+{
+    if (count == 0 || count > E_FORMAT_MAX_ARGS + 1
+        || priv_text(&args[0], format) == false) {
+        return E_STRING_INVALID_FORMAT;
+    }
+    return priv_measure(*format, args, count, lengths, scratch, length);
+}
+
+
+e_string_errno_t e_format_args(e_string_t* string,
+                               const e_format_arg_t* args,
+                               const size_t count)
+{
+    e_string_view_t format;
+    size_t lengths[E_FORMAT_MAX_ARGS + 1];
+    uint8_t scratch[E_FORMAT_MAX_ARGS + 1][E_STRING_FLOAT_LENGTH];
+    size_t length = 0;
+    const e_string_errno_t result = priv_prepare(args, count, &format,
+                                                 lengths, scratch, &length);
+    if (result != E_STRING_SUCCESS) {
+        return result;
+    }
+    const uintptr_t old_data = (uintptr_t)e_string_data(string);
+    if (e_string_reserve(string, length) != E_STRING_SUCCESS) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    /* string can be an argument, the format included: a string argument is
+     * read after growing, cstr and view ones pointing into string move with
+     * its data, and only bytes past its old length are written */
+    const size_t old_length = e_string_length(string);
+    const uint8_t* data = e_string_data(string);
+    const e_format_arg_t* written = args;
+    e_format_arg_t moved[E_FORMAT_MAX_ARGS + 1];
+    if ((uintptr_t)data != old_data) {
+        for (size_t i = 0; i < count; i++) {
+            moved[i] = args[i];
+            if (args[i].type == E_FORMAT_TYPE_CSTR) {
+                moved[i].value.cstr = priv_rebase(args[i].value.cstr,
+                                                  old_data, old_length, data);
+            } else if (args[i].type == E_FORMAT_TYPE_VIEW) {
+                moved[i].value.view.data = priv_rebase(args[i].value.view.data,
+                                                       old_data, old_length,
+                                                       data);
+            }
+        }
+        written = moved;
+        format.data = priv_rebase(format.data, old_data, old_length, data);
+    }
+    if (args[0].type == E_FORMAT_TYPE_STRING) {
+        format = e_string_view(args[0].value.string);
+    }
+    priv_write(format, written, lengths, scratch,
+               e_string_data_mut(string) + old_length);
+    e_string_set_length(string, old_length + length);
+    e_string_invalidate(string);
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_format_args_to(char* buffer, const size_t capacity,
+                                  size_t* length, const e_format_arg_t* args,
+                                  const size_t count)
+{
+    e_string_view_t format;
+    size_t lengths[E_FORMAT_MAX_ARGS + 1];
+    uint8_t scratch[E_FORMAT_MAX_ARGS + 1][E_STRING_FLOAT_LENGTH];
+    size_t output_length = 0;
+    const e_string_errno_t result = priv_prepare(args, count, &format,
+                                                 lengths, scratch,
+                                                 &output_length);
+    if (result != E_STRING_SUCCESS) {
+        return result;
+    }
+
+    *length = output_length;
+    if (output_length > capacity) {
+        return E_STRING_OUT_OF_RANGE;
+    }
+    priv_write(format, args, lengths, scratch, (uint8_t*)buffer);
+    return E_STRING_SUCCESS;
+}
@@ -0,0 +1,27 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_free implementation
+ *
+ * this module implements destructors of e_string_t.
+ * 
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stddef.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+
+void e_string_free(e_string_t* string)
+{
+    if ((string->flags & (E_STRING_FLAG_INLINE | E_STRING_FLAG_ARENA)) == 0) {
+        e_string_release(string->data, string->buffer_capacity);
+    }
+
+    const e_string_t empty = { .flags = E_STRING_FLAG_INLINE };
+    *string = empty;
+}
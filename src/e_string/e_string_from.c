@@ -6,180 +6,257 @@
 /* e_string_from implementation
  *
  * this module implements constructors of e_string_t.
+ *
+ * integers are formatted without snprintf nor temporary buffers: the amount
+ * of digits is computed first, so the string is created with its final size
+ * (inline when it fits), and the digits are written from the end to the start
+ * two at a time from a table of the 100 digit pairs.
  * 
  * usage: add #include "e_string.h" to your file and link to e_string library
  */
 
-#include <math.h>
 #include <stdint.h>
-#include <stdio.h>
-#include <stdlib.h>
 #include <string.h>
 
 #include "e_string.h"
+#include "e_string_private.h"
+
+
+/* private table of the decimal digit pairs 00 upto 99 */
+const char e_string_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* private table of the powers of 10 that fit in 64 bits */
+const uint64_t e_string_powers_of_10[20] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+/* private function priv_magnitude
+ *
+ * absolute value of number as unsigned, valid for INT64_MIN as well
+ */
+static inline uint64_t priv_magnitude(const int64_t number)
+{
+    return (number < 0) ? (uint64_t)0 - (uint64_t)number : (uint64_t)number;
+}
+
+/* private function priv_from_integer
+ *
+ * creates the string of a sign and a magnitude with a single allocation,
+ * or none when it fits inline
+ */
+static e_string_t priv_from_integer(e_arena_t* arena,
+                                    const uint64_t magnitude,
+                                    const bool negative)
+{
+    const size_t length = e_string_digits(magnitude) + negative;
+    e_string_t result = e_string_with_length(arena, length);
+    if (e_string_length(&result) != length) {
+        return result;
+    }
+    uint8_t* data = e_string_data_mut(&result);
+    if (negative == true) {
+        data[0] = '-';
+    }
+    e_string_write_digits(data + length, magnitude);
+    e_string_set_ascii(&result);
+    return result;
+}
 
 
-e_string_t e_string_from_cstr(const char* cstr)
+e_string_t e_string_with_length(e_arena_t* arena, const size_t length)
 {
+    if (length <= E_STRING_INLINE_CAPACITY) {
+        e_string_t result = {
+            .inline_length = (uint8_t)length,
+            .flags = E_STRING_FLAG_INLINE
+        };
+        return result;
+    }
 
-    const size_t input_length = strlen(cstr);
-    const size_t memory_buffer = input_length * sizeof(uint8_t);
+    const size_t memory_buffer = length * sizeof(uint8_t);
     
     e_string_t result = {
-        .data_length = input_length,
+        .data_length = length,
         .buffer_capacity = memory_buffer,
-        .data = malloc(memory_buffer)
+        .flags = (arena != NULL) ? E_STRING_FLAG_ARENA : 0
     };
+    result.data = (arena != NULL) ? e_arena_alloc(arena, memory_buffer, 1)
+                                  : e_string_allocate(memory_buffer);
 
-    for (size_t i = 0; i < input_length; i++) {
-        result.data[i] = cstr[i];
+    /* allocation failure is reported as an empty string */
+    if (result.data == NULL) {
+        result.data_length = 0;
+        result.buffer_capacity = 0;
     }
-    
+
     return result;
 }
 
 
-e_string_t e_string_from_uint64(const uint64_t number)
+e_string_t e_string_from_bytes(e_arena_t* arena,
+                               const uint8_t* bytes,
+                               const size_t length)
 {
-    /* define how many digits there are in number */
-    const int digits = (int)(log10(number) + 1);
-    char* cstr = calloc(digits, sizeof(uint8_t));
-    snprintf(cstr, digits, "%ju", number);
-
-    e_string_t result = e_string_from_cstr(cstr);
+    e_string_t result = e_string_with_length(arena, length);
+    memcpy(e_string_data_mut(&result), bytes, e_string_length(&result));
+    return result;
+}
 
-    free(cstr);
 
-    return result;
+e_string_t e_string_from_cstr(const char* cstr)
+{
+    return e_string_from_bytes(NULL, (const uint8_t*)cstr, strlen(cstr));
 }
 
-e_string_t e_string_from_uint32(const uint32_t number)
+e_string_t e_string_from_cstr_in(e_arena_t* arena, const char* cstr)
 {
-    /* define how many digits there are in number */
-    const int digits = (int)(log10(number) + 1);
-    char* cstr = calloc(digits, sizeof(uint8_t));
-    snprintf(cstr, digits, "%u", number);
+    return e_string_from_bytes(arena, (const uint8_t*)cstr, strlen(cstr));
+}
 
-    e_string_t result = e_string_from_cstr(cstr);
 
-    free(cstr);
+e_string_t e_string_from_uint64(const uint64_t number)
+{
+    return priv_from_integer(NULL, number, false);
+}
 
-    return result;
+e_string_t e_string_from_uint32(const uint32_t number)
+{
+    return priv_from_integer(NULL, number, false);
 }
 
 e_string_t e_string_from_uint16(const uint16_t number)
 {
-    /* define how many digits there are in number */
-    const int digits = (int)(log10(number) + 1);
-    char* cstr = calloc(digits, sizeof(uint8_t));
-    snprintf(cstr, digits, "%hu", number);
-
-    e_string_t result = e_string_from_cstr(cstr);
-
-    free(cstr);
-
-    return result;
+    return priv_from_integer(NULL, number, false);
 }
 
 e_string_t e_string_from_uint8(const uint8_t number)
 {
-    /* define how many digits there are in number */
-    const int digits = (int)(log10(number) + 1);
-    char* cstr = calloc(digits, sizeof(uint8_t));
-    snprintf(cstr, digits, "%hu", number);
-
-    e_string_t result = e_string_from_cstr(cstr);
-
-    free(cstr);
-
-    return result;
+    return priv_from_integer(NULL, number, false);
 }
 
 e_string_t e_string_from_int64(const int64_t number)
 {
-    /* define how many digits there are in number */
-    const int digits = (number < 0) ? (int)(log10(number) + 2)
-                                    : (int)(log10(number) + 1);
-    char* cstr = calloc(digits, sizeof(uint8_t));
-    snprintf(cstr, digits, "%jd", number);
-
-    e_string_t result = e_string_from_cstr(cstr);
-
-    free(cstr);
-
-    return result;
+    return priv_from_integer(NULL, priv_magnitude(number), number < 0);
 }
 
 e_string_t e_string_from_int32(const int32_t number)
 {
-    /* define how many digits there are in number */
-    const int digits = (number < 0) ? (int)(log10(number) + 2)
-                                    : (int)(log10(number) + 1);
-    char* cstr = calloc(digits, sizeof(uint8_t));
-    snprintf(cstr, digits, "%d", number);
-
-    e_string_t result = e_string_from_cstr(cstr);
-
-    free(cstr);
-
-    return result;
+    return priv_from_integer(NULL, priv_magnitude(number), number < 0);
 }
 
 e_string_t e_string_from_int16(const int16_t number)
 {
-    /* define how many digits there are in number */
-    const int digits = (number < 0) ? (int)(log10(number) + 2)
-                                    : (int)(log10(number) + 1);
-    char* cstr = calloc(digits, sizeof(uint8_t));
-    snprintf(cstr, digits, "%hd", number);
-
-    e_string_t result = e_string_from_cstr(cstr);
-
-    free(cstr);
-
-    return result;
+    return priv_from_integer(NULL, priv_magnitude(number), number < 0);
 }
 
 e_string_t e_string_from_int8(const int8_t number)
 {
-    /* define how many digits there are in number */
-    const int digits = (number < 0) ? (int)(log10(number) + 2)
-                                    : (int)(log10(number) + 1);
-    char* cstr = calloc(digits, sizeof(uint8_t));
-    snprintf(cstr, digits, "%hd", number);
-
-    e_string_t result = e_string_from_cstr(cstr);
+    return priv_from_integer(NULL, priv_magnitude(number), number < 0);
+}
 
-    free(cstr);
+e_string_t e_string_from_int(const int number)
+{
+    return priv_from_integer(NULL, priv_magnitude(number), number < 0);
+}
 
-    return result;
+e_string_t e_string_from_uint(const unsigned int number)
+{
+    return priv_from_integer(NULL, number, false);
 }
 
-e_string_t e_string_from_int(const int number)
+e_string_t e_string_from_uint64_in(e_arena_t* arena, const uint64_t number)
 {
-    /* define how many digits there are in number */
-    const int digits = (number < 0) ? (int)(log10(number) + 2)
-                                    : (int)(log10(number) + 1);
-    char* cstr = calloc(digits, sizeof(uint8_t));
-    snprintf(cstr, digits, "%d", number);
+    return priv_from_integer(arena, number, false);
+}
 
-    e_string_t result = e_string_from_cstr(cstr);
+e_string_t e_string_from_int64_in(e_arena_t* arena, const int64_t number)
+{
+    return priv_from_integer(arena, priv_magnitude(number), number < 0);
+}
 
-    free(cstr);
 
-    return result;
+/* E_STRING_FROM_ARRAY
+ *
+ * generates a bulk constructor for an integer type: a first pass adds up the
+ * digits of every number, so the whole array is written on a single buffer
+ * allocated once.
+ */
+#define E_STRING_FROM_ARRAY(NAME, TYPE, MAGNITUDE, NEGATIVE)                  \
+e_string_t NAME(const TYPE* numbers, const size_t count,                      \
+               const char* separator)                                         \
+{                                                                             \
+    const size_t separator_length = strlen(separator);                        \
+    size_t length = (count > 0) ? (count - 1) * separator_length : 0;         \
+    for (size_t i = 0; i < count; i++) {                                      \
+        length += e_string_digits(MAGNITUDE(numbers[i]))                      \
+                  + NEGATIVE(numbers[i]);                                     \
+    }                                                                         \
+                                                                              \
+    e_string_t result = e_string_with_length(NULL, length);                   \
+    if (e_string_length(&result) != length) {                                 \
+        return result;                                                        \
+    }                                                                         \
+                                                                              \
+    uint8_t* cursor = e_string_data_mut(&result);                             \
+    for (size_t i = 0; i < count; i++) {                                      \
+        if (i > 0) {                                                          \
+            memcpy(cursor, separator, separator_length);                      \
+            cursor += separator_length;                                       \
+        }                                                                     \
+        const uint64_t magnitude = MAGNITUDE(numbers[i]);                     \
+        if (NEGATIVE(numbers[i])) {                                           \
+            *cursor++ = '-';                                                  \
+        }                                                                     \
+        cursor += e_string_digits(magnitude);                                 \
+        e_string_write_digits(cursor, magnitude);                             \
+    }                                                                         \
+                                                                              \
+    e_string_set_ascii(&result);                                              \
+    return result;                                                            \
 }
 
-e_string_t e_string_from_uint(const unsigned int number)
-{
-    /* define how many digits there are in number */
-    const int digits = (int)(log10(number) + 1);
-    char* cstr = calloc(digits, sizeof(uint8_t));
-    snprintf(cstr, digits, "%u", number);
+#define E_STRING_UNSIGNED_MAGNITUDE(X) ((uint64_t)(X))
+#define E_STRING_UNSIGNED_NEGATIVE(X)  0
+#define E_STRING_SIGNED_MAGNITUDE(X)   priv_magnitude(X)
+#define E_STRING_SIGNED_NEGATIVE(X)    ((X) < 0)
 
-    e_string_t result = e_string_from_cstr(cstr);
+E_STRING_FROM_ARRAY(e_string_from_uint64_array, uint64_t,
+                    E_STRING_UNSIGNED_MAGNITUDE, E_STRING_UNSIGNED_NEGATIVE)
 
-    free(cstr);
+E_STRING_FROM_ARRAY(e_string_from_uint32_array, uint32_t,
+                    E_STRING_UNSIGNED_MAGNITUDE, E_STRING_UNSIGNED_NEGATIVE)
 
-    return result;
-}
\ No newline at end of file
+E_STRING_FROM_ARRAY(e_string_from_int64_array, int64_t,
+                    E_STRING_SIGNED_MAGNITUDE, E_STRING_SIGNED_NEGATIVE)
+
+E_STRING_FROM_ARRAY(e_string_from_int32_array, int32_t,
+                    E_STRING_SIGNED_MAGNITUDE, E_STRING_SIGNED_NEGATIVE)
@@ -0,0 +1,417 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_from_double implementation
+ *
+ * this module implements the floating point constructors of e_string_t.
+ *
+ * numbers are written with the fewest decimal digits that read back to the
+ * same value, using the Schubfach algorithm (Raffaello Giulietti): the
+ * decimal exponent k is found with integer logarithms, and the value and
+ * both ends of its rounding interval are scaled by 10^-k with a single
+ * 128bit multiplication each, from the table of the normalized powers of
+ * 10 of e_string_pow10.c.
+ * the shortest decimal inside the interval is then picked among the two
+ * candidates with one digit less and the closest one.
+ *
+ * float uses the same table, as the algorithm only depends on the interval
+ * of the value, so its shortest decimal is found from its own neighbours.
+ *
+ * the length of the output is computed from the digits and the exponent
+ * before writing, so the string is created once with its final size, and
+ * no locale nor snprintf is involved.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* bits of the fraction and exponent bias (with the fraction bits) of double */
+#define E_STRING_DOUBLE_FRACTION 52
+#define E_STRING_DOUBLE_BIAS     1075
+#define E_STRING_DOUBLE_MAX_BIASED 0x7FF
+
+/* bits of the fraction and exponent bias (with the fraction bits) of float */
+#define E_STRING_FLOAT_FRACTION 23
+#define E_STRING_FLOAT_BIAS     150
+#define E_STRING_FLOAT_MAX_BIASED 0xFF
+
+/* positions of the decimal point where the shortest format moves to the
+ * scientific notation, as ECMAScript Number.prototype.toString */
+#define E_STRING_FLOAT_FIXED_MAX 21
+#define E_STRING_FLOAT_FIXED_MIN -6
+
+
+/* e_string_decimal struct
+ *
+ * a floating point number as digits times 10^exponent
+ *
+ * PODs definition
+ *   - digits: defines the significant digits, without trailing zeros
+ *   - exponent: defines the power of 10 of the last digit
+ *   - count: defines the amount of digits (1 for zero)
+ *   - negative: defines if the sign bit is set
+ *   - kind: defines if the number is finite, infinite or not a number
+ */
+typedef struct e_string_decimal
+{
+    uint64_t digits;
+    int32_t exponent;
+    uint32_t count;
+    bool negative;
+    uint8_t kind;
+} e_string_decimal_t;
+
+#define E_STRING_DECIMAL_FINITE   0
+#define E_STRING_DECIMAL_INFINITE 1
+#define E_STRING_DECIMAL_NAN      2
+
+/* ways a decimal is laid out */
+#define E_STRING_LAYOUT_INTEGER    0   /* 1500 */
+#define E_STRING_LAYOUT_POINT      1   /* 1.5 */
+#define E_STRING_LAYOUT_LEADING    2   /* 0.0015 */
+#define E_STRING_LAYOUT_SCIENTIFIC 3   /* 1.5e+21 */
+
+
+/* private function priv_floor_shift
+ *
+ * value divided by 2^shift rounded down, also for negative values
+ */
+static inline int32_t priv_floor_shift(const int32_t value,
+                                       const unsigned shift)
+{
+    return (value >= 0) ? value >> shift
+                        : -(int32_t)((-(int64_t)value
+                                      + ((int64_t)1 << shift) - 1) >> shift);
+}
+
+/* private function priv_round_to_odd
+ *
+ * top 64 bits of the 192bit product of the table entry g and cp, with the
+ * lowest bit set when any of the discarded bits is set
+ */
+static inline uint64_t priv_round_to_odd(const uint64_t* g, const uint64_t cp)
+{
+    uint64_t low_high = 0;
+    uint64_t low_low = 0;
+    uint64_t high = 0;
+    uint64_t low = 0;
+    e_string_multiply(g[1], cp, &low_high, &low_low);
+    e_string_multiply(g[0], cp, &high, &low);
+    low += low_high;
+    high += (low < low_high);
+    return high | (low > 1);
+}
+
+/* private function priv_shortest
+ *
+ * shortest decimal, closest to the value when there are many, of the
+ * binary number c * 2^q. lower_closer tells if the previous number is
+ * closer than the next one, which is the case at powers of 2.
+ */
+static void priv_shortest(const uint64_t c, const int32_t q,
+                          const bool lower_closer, e_string_decimal_t* decimal)
+{
+    const bool even = (c & 1) == 0;
+    const uint64_t cbl = 4 * c - 2 + lower_closer;
+    const uint64_t cb = 4 * c;
+    const uint64_t cbr = 4 * c + 2;
+
+    /* k = floor(log10(2^q)), or floor(log10(3/4 * 2^q)) for a closer lower
+     * end, and h the shift that puts the scaled values on 2 extra bits */
+    const int32_t k = priv_floor_shift(q * 1262611
+                                       - (lower_closer ? 524031 : 0), 22);
+    const int32_t h = q + priv_floor_shift(-k * 1741647, 19) + 1;
+    const uint64_t* g = e_string_pow10_table[-k - E_STRING_POW10_MIN];
+
+    const uint64_t vbl = priv_round_to_odd(g, cbl << h);
+    const uint64_t vb = priv_round_to_odd(g, cb << h);
+    const uint64_t vbr = priv_round_to_odd(g, cbr << h);
+    const uint64_t lower = vbl + !even;
+    const uint64_t upper = vbr - !even;
+
+    /* one digit less, when a multiple of 10 is inside the interval */
+    const uint64_t s = vb / 4;
+    if (s >= 10) {
+        const uint64_t sp = s / 10;
+        const bool up_inside = lower <= 40 * sp;
+        const bool wp_inside = 40 * sp + 40 <= upper;
+        if (up_inside != wp_inside) {
+            decimal->digits = sp + wp_inside;
+            decimal->exponent = k + 1;
+            return;
+        }
+    }
+
+    /* otherwise the closest of s and s + 1 that is inside */
+    const bool u_inside = lower <= 4 * s;
+    const bool w_inside = 4 * s + 4 <= upper;
+    if (u_inside != w_inside) {
+        decimal->digits = s + w_inside;
+        decimal->exponent = k;
+        return;
+    }
+    const uint64_t middle = 4 * s + 2;
+    const bool round_up = vb > middle || (vb == middle && (s & 1) != 0);
+    decimal->digits = s + round_up;
+    decimal->exponent = k;
+}
+
+/* private function priv_decode
+ *
+ * finds the decimal of a number given by its sign, biased exponent and
+ * fraction bits, for a format of fraction_bits and bias
+ */
+static e_string_decimal_t priv_decode(const bool negative,
+                                      const uint32_t biased,
+                                      const uint64_t fraction,
+                                      const unsigned fraction_bits,
+                                      const int32_t bias,
+                                      const uint32_t max_biased)
+{
+    e_string_decimal_t decimal = { .negative = negative, .count = 1 };
+    if (biased == max_biased) {
+        decimal.kind = (fraction == 0) ? E_STRING_DECIMAL_INFINITE
+                                       : E_STRING_DECIMAL_NAN;
+        return decimal;
+    }
+    if (biased == 0 && fraction == 0) {
+        return decimal;
+    }
+
+    if (biased == 0) {
+        priv_shortest(fraction, 1 - bias, false, &decimal);
+    } else {
+        const uint64_t c = fraction | ((uint64_t)1 << fraction_bits);
+        const int32_t q = (int32_t)biased - bias;
+
+        /* integers are written as they are, no shorter digits are as close */
+        if (q <= 0 && -q <= (int32_t)fraction_bits
+            && (c & (((uint64_t)1 << -q) - 1)) == 0) {
+            decimal.digits = c >> -q;
+            decimal.exponent = 0;
+        } else {
+            priv_shortest(c, q, fraction == 0 && biased > 1, &decimal);
+        }
+    }
+
+    while (decimal.digits % 10 == 0) {
+        decimal.digits /= 10;
+        decimal.exponent += 1;
+    }
+    decimal.count = (uint32_t)e_string_digits(decimal.digits);
+    return decimal;
+}
+
+/* private function priv_decode_double
+ *
+ * finds the decimal of a double
+ */
+static e_string_decimal_t priv_decode_double(const double number)
+{
+    uint64_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+    return priv_decode((bits >> 63) != 0,
+                       (uint32_t)(bits >> E_STRING_DOUBLE_FRACTION)
+                       & E_STRING_DOUBLE_MAX_BIASED,
+                       bits & (((uint64_t)1 << E_STRING_DOUBLE_FRACTION) - 1),
+                       E_STRING_DOUBLE_FRACTION, E_STRING_DOUBLE_BIAS,
+                       E_STRING_DOUBLE_MAX_BIASED);
+}
+
+/* private function priv_decode_float
+ *
+ * finds the decimal of a float
+ */
+static e_string_decimal_t priv_decode_float(const float number)
+{
+    uint32_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+    return priv_decode((bits >> 31) != 0,
+                       (bits >> E_STRING_FLOAT_FRACTION)
+                       & E_STRING_FLOAT_MAX_BIASED,
+                       bits & ((1u << E_STRING_FLOAT_FRACTION) - 1),
+                       E_STRING_FLOAT_FRACTION, E_STRING_FLOAT_BIAS,
+                       E_STRING_FLOAT_MAX_BIASED);
+}
+
+/* private function priv_layout
+ *
+ * how a finite decimal is laid out on format, point being the position of
+ * the decimal point from the first digit
+ */
+static int priv_layout(const e_string_decimal_t* decimal,
+                       const e_string_float_format_t format,
+                       const int32_t point)
+{
+    if (format == E_STRING_FLOAT_SCIENTIFIC
+        || (format != E_STRING_FLOAT_FIXED
+            && (point > E_STRING_FLOAT_FIXED_MAX
+                || point <= E_STRING_FLOAT_FIXED_MIN))) {
+        return E_STRING_LAYOUT_SCIENTIFIC;
+    }
+    if (point >= (int32_t)decimal->count) {
+        return E_STRING_LAYOUT_INTEGER;
+    }
+    return (point > 0) ? E_STRING_LAYOUT_POINT : E_STRING_LAYOUT_LEADING;
+}
+
+/* private function priv_length
+ *
+ * bytes of the text of decimal on format
+ */
+static size_t priv_length(const e_string_decimal_t* decimal,
+                          const e_string_float_format_t format)
+{
+    if (decimal->kind == E_STRING_DECIMAL_NAN) {
+        return 3;
+    }
+    const size_t sign = decimal->negative;
+    if (decimal->kind == E_STRING_DECIMAL_INFINITE) {
+        return sign + 3;
+    }
+
+    const size_t count = decimal->count;
+    const int32_t point = decimal->exponent + (int32_t)count;
+    switch (priv_layout(decimal, format, point)) {
+    case E_STRING_LAYOUT_INTEGER:
+        return sign + (size_t)point;
+    case E_STRING_LAYOUT_POINT:
+        return sign + count + 1;
+    case E_STRING_LAYOUT_LEADING:
+        return sign + 2 + (size_t)-point + count;
+    default: {
+        const int32_t exponent = point - 1;
+        const uint64_t magnitude = (uint64_t)((exponent < 0) ? -exponent
+                                                             : exponent);
+        return sign + count + (count > 1) + 2 + e_string_digits(magnitude);
+    }
+    }
+}
+
+/* private function priv_write
+ *
+ * writes the text of decimal on format to output, which has the length
+ * given by priv_length
+ */
+static void priv_write(const e_string_decimal_t* decimal,
+                       const e_string_float_format_t format, uint8_t* output)
+{
+    if (decimal->kind == E_STRING_DECIMAL_NAN) {
+        memcpy(output, "nan", 3);
+        return;
+    }
+    if (decimal->negative == true) {
+        *output++ = '-';
+    }
+    if (decimal->kind == E_STRING_DECIMAL_INFINITE) {
+        memcpy(output, "inf", 3);
+        return;
+    }
+
+    const size_t count = decimal->count;
+    const int32_t point = decimal->exponent + (int32_t)count;
+    switch (priv_layout(decimal, format, point)) {
+    case E_STRING_LAYOUT_INTEGER:
+        e_string_write_digits(output + count, decimal->digits);
+        memset(output + count, '0', (size_t)point - count);
+        break;
+    case E_STRING_LAYOUT_POINT:
+        /* the digits are written one byte later, and the integer part is
+         * moved back in front of the point */
+        e_string_write_digits(output + count + 1, decimal->digits);
+        memmove(output, output + 1, (size_t)point);
+        output[point] = '.';
+        break;
+    case E_STRING_LAYOUT_LEADING:
+        output[0] = '0';
+        output[1] = '.';
+        memset(output + 2, '0', (size_t)-point);
+        e_string_write_digits(output + 2 + (size_t)-point + count,
+                              decimal->digits);
+        break;
+    default: {
+        e_string_write_digits(output + count + 1, decimal->digits);
+        output[0] = output[1];
+        output += 1;
+        if (count > 1) {
+            output[0] = '.';
+            output += count;
+        }
+        const int32_t exponent = point - 1;
+        const uint64_t magnitude = (uint64_t)((exponent < 0) ? -exponent
+                                                             : exponent);
+        const size_t digits = e_string_digits(magnitude);
+        output[0] = 'e';
+        output[1] = (exponent < 0) ? '-' : '+';
+        e_string_write_digits(output + 2 + digits, magnitude);
+        break;
+    }
+    }
+}
+
+/* private function priv_from_decimal
+ *
+ * creates the string of decimal on format with a single allocation, or
+ * none when it fits inline
+ */
+static e_string_t priv_from_decimal(const e_string_decimal_t* decimal,
+                                    const e_string_float_format_t format)
+{
+    const size_t length = priv_length(decimal, format);
+    e_string_t result = e_string_with_length(NULL, length);
+    if (e_string_length(&result) != length) {
+        return result;
+    }
+    priv_write(decimal, format, e_string_data_mut(&result));
+    e_string_set_ascii(&result);
+    return result;
+}
+
+
+size_t e_string_write_float(uint8_t* output, const double number,
+                            const bool single)
+{
+    const e_string_decimal_t decimal = (single == true)
+                                       ? priv_decode_float((float)number)
+                                       : priv_decode_double(number);
+    priv_write(&decimal, E_STRING_FLOAT_SHORTEST, output);
+    return priv_length(&decimal, E_STRING_FLOAT_SHORTEST);
+}
+
+
+e_string_t e_string_from_double(const double number)
+{
+    const e_string_decimal_t decimal = priv_decode_double(number);
+    return priv_from_decimal(&decimal, E_STRING_FLOAT_SHORTEST);
+}
+
+
+e_string_t e_string_from_float(const float number)
+{
+    const e_string_decimal_t decimal = priv_decode_float(number);
+    return priv_from_decimal(&decimal, E_STRING_FLOAT_SHORTEST);
+}
+
+
+e_string_t e_string_from_double_ex(const double number,
+                                   const e_string_float_format_t format)
+{
+    const e_string_decimal_t decimal = priv_decode_double(number);
+    return priv_from_decimal(&decimal, format);
+}
+
+
+e_string_t e_string_from_float_ex(const float number,
+                                  const e_string_float_format_t format)
+{
+    const e_string_decimal_t decimal = priv_decode_float(number);
+    return priv_from_decimal(&decimal, format);
+}
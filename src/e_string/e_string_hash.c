@@ -0,0 +1,392 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_hash implementation
+ *
+ * this module implements a seeded 64bit non-cryptographic hash of strings.
+ *
+ * data up to E_STRING_HASH_LONG bytes is hashed as wyhash does: unaligned
+ * 64bit reads folded with 64x64 -> 128bit multiplications ("mum"), three
+ * independent lanes of 16 bytes on the 48 bytes loop.
+ *
+ * longer data is accumulated on 8 lanes of 64bit, 64 bytes per stripe, as
+ * xxh3 does: each lane adds its data to the neighbour lane and the product
+ * of the low and high halves of its data mixed with a key. the lanes are
+ * scrambled every E_STRING_HASH_BLOCK bytes and folded with mum at the end.
+ *   - scalar: one lane at a time
+ *   - AVX2: 4 lanes per register, _mm256_mul_epu32 for the products, the
+ *     scramble stays scalar as it runs once per block
+ * both give the same hash, so hashes can be stored and compared between
+ * machines.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+#ifdef E_STRING_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* bytes hashed with the mum loop, longer data uses the lanes */
+#define E_STRING_HASH_LONG 256
+
+/* bytes of a stripe, and of the stripes between two scrambles */
+#define E_STRING_HASH_STRIPE 64
+#define E_STRING_HASH_BLOCK 1024
+
+/* strings hashed at once by e_string_hash64_batch */
+#define E_STRING_HASH_BATCH 8
+
+/* wyhash secret, used by the mum loop and the final fold */
+static const uint64_t priv_secret[4] = {
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL,
+    0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+};
+
+/* keys of the lanes: data keys, scramble keys and initial values */
+static const uint64_t priv_keys[3][8] = {
+    { 0x2cb0f69f4abea221ULL, 0x9417034723148989ULL, 0xdd555950609dfe03ULL,
+      0xdbafb150deb12800ULL, 0x7e789b2e6c442cb6ULL, 0xf41e5636c7e4f8c4ULL,
+      0x0959d150f8fba7e4ULL, 0xa97316f13cdb9eeaULL },
+    { 0x74cd8258f9520068ULL, 0x55c74a62e116868bULL, 0xd2f4c799a2023cbdULL,
+      0xdf98cb79a37b51b9ULL, 0x396f5885524f3905ULL, 0xaf1d56386ca3b276ULL,
+      0xa9ffbe6b5104e85aULL, 0x6bd0c51b9fd533b3ULL },
+    { 0x980ce91c50ab4b56ULL, 0x28ac395780fe62c5ULL, 0x768912e3a6bcedc7ULL,
+      0x50b3e8c9332c7c88ULL, 0xce3bbfe520bd47daULL, 0xcba6c8e8e0bb7c4fULL,
+      0xbf194db8434a346dULL, 0x7d8f2a7b60416d7fULL }
+};
+
+/* 32bit prime multiplied on the lanes by the scramble */
+#define E_STRING_HASH_PRIME 0x9E3779B1u
+
+
+/* private function priv_read64
+ *
+ * unaligned little endian 64bit read
+ */
+static inline uint64_t priv_read64(const uint8_t* data)
+{
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+/* private function priv_read32
+ *
+ * unaligned little endian 32bit read
+ */
+static inline uint64_t priv_read32(const uint8_t* data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+/* private function priv_mum
+ *
+ * full 128bit product of a and b, low half on a and high half on b
+ */
+static inline void priv_mum(uint64_t* a, uint64_t* b)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 priv_u128_t;
+    const priv_u128_t product = (priv_u128_t)*a * *b;
+    *a = (uint64_t)product;
+    *b = (uint64_t)(product >> 64);
+#else
+    const uint64_t a_high = *a >> 32;
+    const uint64_t a_low = (uint32_t)*a;
+    const uint64_t b_high = *b >> 32;
+    const uint64_t b_low = (uint32_t)*b;
+    const uint64_t high = a_high * b_high;
+    const uint64_t middle_1 = a_high * b_low;
+    const uint64_t middle_2 = a_low * b_high;
+    const uint64_t low = a_low * b_low;
+    const uint64_t cross = (low >> 32) + (uint32_t)middle_1
+                           + (uint32_t)middle_2;
+    *a = (cross << 32) | (uint32_t)low;
+    *b = high + (middle_1 >> 32) + (middle_2 >> 32) + (cross >> 32);
+#endif
+}
+
+/* private function priv_mix
+ *
+ * folds the 128bit product of a and b into 64 bits
+ */
+static inline uint64_t priv_mix(uint64_t a, uint64_t b)
+{
+    priv_mum(&a, &b);
+    return a ^ b;
+}
+
+/* private function priv_accumulate_scalar
+ *
+ * accumulates stripe_count stripes of data on the lanes
+ */
+static void priv_accumulate_scalar(uint64_t* lanes, const uint8_t* data,
+                                   const size_t stripe_count,
+                                   const uint64_t* keys)
+{
+    for (size_t stripe = 0; stripe < stripe_count; stripe++) {
+        const uint8_t* bytes = data + stripe * E_STRING_HASH_STRIPE;
+        for (size_t lane = 0; lane < 8; lane++) {
+            const uint64_t value = priv_read64(bytes + lane * 8);
+            const uint64_t keyed = value ^ keys[lane];
+            lanes[lane ^ 1] += value;
+            lanes[lane] += (keyed & 0xFFFFFFFFu) * (keyed >> 32);
+        }
+    }
+}
+
+/* private function priv_scramble_scalar
+ *
+ * spreads the high bits of the lanes over the low ones, which are the only
+ * ones multiplied by the accumulation
+ */
+static void priv_scramble_scalar(uint64_t* lanes)
+{
+    for (size_t lane = 0; lane < 8; lane++) {
+        uint64_t value = lanes[lane];
+        value ^= value >> 47;
+        value ^= priv_keys[1][lane];
+        lanes[lane] = value * E_STRING_HASH_PRIME;
+    }
+}
+
+#ifdef E_STRING_X86_SIMD
+
+/* private function priv_accumulate_avx2
+ *
+ * priv_accumulate_scalar with the 8 lanes on two registers
+ */
+__attribute__((target("avx2")))
+static void priv_accumulate_avx2(uint64_t* lanes, const uint8_t* data,
+                                 const size_t stripe_count,
+                                 const uint64_t* keys)
+{
+    __m256i low = _mm256_loadu_si256((const __m256i*)lanes);
+    __m256i high = _mm256_loadu_si256((const __m256i*)(lanes + 4));
+    const __m256i key_low = _mm256_loadu_si256((const __m256i*)keys);
+    const __m256i key_high = _mm256_loadu_si256((const __m256i*)(keys + 4));
+
+    for (size_t stripe = 0; stripe < stripe_count; stripe++) {
+        const uint8_t* bytes = data + stripe * E_STRING_HASH_STRIPE;
+        const __m256i value_low = _mm256_loadu_si256((const __m256i*)bytes);
+        const __m256i value_high = _mm256_loadu_si256(
+            (const __m256i*)(bytes + 32));
+        const __m256i keyed_low = _mm256_xor_si256(value_low, key_low);
+        const __m256i keyed_high = _mm256_xor_si256(value_high, key_high);
+        /* lane ^ 1 swaps the 64bit halves of each 128bit half */
+        low = _mm256_add_epi64(low, _mm256_shuffle_epi32(
+            value_low, _MM_SHUFFLE(1, 0, 3, 2)));
+        high = _mm256_add_epi64(high, _mm256_shuffle_epi32(
+            value_high, _MM_SHUFFLE(1, 0, 3, 2)));
+        low = _mm256_add_epi64(low, _mm256_mul_epu32(
+            keyed_low, _mm256_srli_epi64(keyed_low, 32)));
+        high = _mm256_add_epi64(high, _mm256_mul_epu32(
+            keyed_high, _mm256_srli_epi64(keyed_high, 32)));
+    }
+
+    _mm256_storeu_si256((__m256i*)lanes, low);
+    _mm256_storeu_si256((__m256i*)(lanes + 4), high);
+}
+
+#endif /* E_STRING_X86_SIMD */
+
+/* private function priv_accumulate
+ *
+ * priv_accumulate_avx2 when avx2, priv_accumulate_scalar otherwise
+ */
+static inline void priv_accumulate(uint64_t* lanes, const uint8_t* data,
+                                   const size_t stripe_count,
+                                   const uint64_t* keys, const bool avx2)
+{
+#ifdef E_STRING_X86_SIMD
+    if (avx2) {
+        priv_accumulate_avx2(lanes, data, stripe_count, keys);
+        return;
+    }
+#else
+    (void)avx2;
+#endif
+    priv_accumulate_scalar(lanes, data, stripe_count, keys);
+}
+
+/* private function priv_hash_long
+ *
+ * hashes data longer than E_STRING_HASH_LONG on the lanes: whole blocks
+ * first, then the whole stripes left, then the last 64 bytes of data
+ * (overlapping the previous stripe) with the scramble keys.
+ */
+static uint64_t priv_hash_long(const uint8_t* data, const size_t length,
+                               const uint64_t seed)
+{
+    bool avx2 = false;
+#ifdef E_STRING_X86_SIMD
+    avx2 = e_string_validate_engine_available(E_STRING_ENGINE_AVX2);
+#endif
+
+    uint64_t lanes[8];
+    for (size_t lane = 0; lane < 8; lane++) {
+        lanes[lane] = priv_keys[2][lane] ^ seed;
+    }
+
+    size_t index = 0;
+    for (; length - index > E_STRING_HASH_BLOCK; index += E_STRING_HASH_BLOCK) {
+        priv_accumulate(lanes, data + index,
+                        E_STRING_HASH_BLOCK / E_STRING_HASH_STRIPE,
+                        priv_keys[0], avx2);
+        priv_scramble_scalar(lanes);
+    }
+    priv_accumulate(lanes, data + index,
+                    (length - index - 1) / E_STRING_HASH_STRIPE,
+                    priv_keys[0], avx2);
+    priv_accumulate(lanes, data + length - E_STRING_HASH_STRIPE, 1,
+                    priv_keys[1], avx2);
+
+    uint64_t hash = (uint64_t)length * priv_secret[0];
+    for (size_t lane = 0; lane < 8; lane += 2) {
+        hash = priv_mix(lanes[lane] ^ priv_keys[2][lane] ^ hash,
+                        lanes[lane + 1] ^ priv_keys[2][lane + 1]);
+    }
+    return priv_mix(hash ^ priv_secret[2], seed ^ priv_secret[3]);
+}
+
+/* private function priv_hash
+ *
+ * wyhash of length bytes of data, or priv_hash_long for long data
+ */
+static inline uint64_t priv_hash(const uint8_t* data, const size_t length,
+                                 uint64_t seed)
+{
+    if (length > E_STRING_HASH_LONG) {
+        return priv_hash_long(data, length, seed);
+    }
+
+    seed ^= priv_mix(seed ^ priv_secret[0], priv_secret[1]);
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (length <= 16) {
+        if (length >= 4) {
+            const size_t middle = (length >> 3) << 2;
+            a = (priv_read32(data) << 32) | priv_read32(data + middle);
+            b = (priv_read32(data + length - 4) << 32)
+                | priv_read32(data + length - 4 - middle);
+        } else if (length > 0) {
+            a = ((uint64_t)data[0] << 16) | ((uint64_t)data[length >> 1] << 8)
+                | data[length - 1];
+        }
+    } else {
+        size_t rest = length;
+        const uint8_t* bytes = data;
+        if (rest > 48) {
+            uint64_t see_1 = seed;
+            uint64_t see_2 = seed;
+            do {
+                seed = priv_mix(priv_read64(bytes) ^ priv_secret[1],
+                                priv_read64(bytes + 8) ^ seed);
+                see_1 = priv_mix(priv_read64(bytes + 16) ^ priv_secret[2],
+                                 priv_read64(bytes + 24) ^ see_1);
+                see_2 = priv_mix(priv_read64(bytes + 32) ^ priv_secret[3],
+                                 priv_read64(bytes + 40) ^ see_2);
+                bytes += 48;
+                rest -= 48;
+            } while (rest > 48);
+            seed ^= see_1 ^ see_2;
+        }
+        while (rest > 16) {
+            seed = priv_mix(priv_read64(bytes) ^ priv_secret[1],
+                            priv_read64(bytes + 8) ^ seed);
+            bytes += 16;
+            rest -= 16;
+        }
+        a = priv_read64(bytes + rest - 16);
+        b = priv_read64(bytes + rest - 8);
+    }
+    a ^= priv_secret[1];
+    b ^= seed;
+    priv_mum(&a, &b);
+    return priv_mix(a ^ priv_secret[0] ^ length, b ^ priv_secret[1]);
+}
+
+/* private function priv_prefetch
+ *
+ * starts loading the data of the E_STRING_HASH_BATCH strings from index,
+ * inline data is already loaded with the strings themselves
+ */
+static inline void priv_prefetch(const e_string_t* strings, const size_t from,
+                                 const size_t count)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    for (size_t index = from;
+         index < count && index < from + E_STRING_HASH_BATCH; index++) {
+        if ((strings[index].flags & E_STRING_FLAG_INLINE) == 0) {
+            __builtin_prefetch(strings[index].data);
+        }
+    }
+#else
+    (void)strings;
+    (void)from;
+    (void)count;
+#endif
+}
+
+
+uint64_t e_string_view_hash64(const e_string_view_t view, const uint64_t seed)
+{
+    return priv_hash(view.data, view.length, seed);
+}
+
+
+uint64_t e_string_hash64(const e_string_t* string, const uint64_t seed)
+{
+    return priv_hash(e_string_data(string), e_string_length(string), seed);
+}
+
+
+void e_string_hash64_batch(const e_string_t* strings, const size_t count,
+                           const uint64_t seed, uint64_t* hashes)
+{
+    priv_prefetch(strings, 0, count);
+    for (size_t group = 0; group < count; group += E_STRING_HASH_BATCH) {
+        /* the data of the next group is loaded while this one is hashed */
+        const size_t next = group + E_STRING_HASH_BATCH;
+        priv_prefetch(strings, next, count);
+
+        const size_t end = (next < count) ? next : count;
+        for (size_t index = group; index < end; index++) {
+            hashes[index] = e_string_hash64(&strings[index], seed);
+        }
+    }
+}
+
+
+uint64_t e_string_key_hash(e_string_key_t* key)
+{
+    if (key->hashed == false) {
+        key->hash = e_string_hash64(&key->string, E_STRING_HASH_SEED);
+        key->hashed = true;
+    }
+    return key->hash;
+}
+
+
+void e_string_key_invalidate(e_string_key_t* key)
+{
+    key->hashed = false;
+}
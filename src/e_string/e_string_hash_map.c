@@ -0,0 +1,436 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_hash_map implementation
+ *
+ * this module implements an open addressing hash map with string keys, laid
+ * out as a SwissTable.
+ *
+ * every slot has a control byte: E_STRING_HASH_MAP_EMPTY, _DELETED, or the
+ * low 7 bits of the hash of its key (h2) when it is full. slots are probed
+ * in groups of 16, and the control bytes of a group are compared with h2
+ * at once (one SSE2 compare and movemask), so the keys themselves are only
+ * read for the few slots whose h2 match. the group a key starts on is
+ * given by the rest of the hash (h1), and the next groups are visited with
+ * triangular steps, which go through every group of a power of 2 table.
+ *
+ * a probe stops on a group that has an empty slot, so removing a key only
+ * leaves a tombstone (E_STRING_HASH_MAP_DELETED) when its group is full.
+ *
+ * keys too long to be inline are copied on the arena of the map, which can
+ * not release them one at a time. the bytes left by removed keys are
+ * counted, and once they outweigh the keys on map the slots are rebuilt
+ * with the keys copied on a new arena.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* slots of a group, compared at once */
+#define E_STRING_HASH_MAP_GROUP 16
+
+/* control bytes of slots that are not full, both have bit 7 set */
+#define E_STRING_HASH_MAP_EMPTY   0x80u
+#define E_STRING_HASH_MAP_DELETED 0xFEu
+
+
+/* private function priv_match
+ *
+ * bitmask of the control bytes of group equal to byte
+ */
+static inline uint32_t priv_match(const uint8_t* group, const uint8_t byte)
+{
+#if defined(__SSE2__)
+    const __m128i control = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(control, _mm_set1_epi8((char)byte)));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < E_STRING_HASH_MAP_GROUP; i++) {
+        mask |= (uint32_t)(group[i] == byte) << i;
+    }
+    return mask;
+#endif
+}
+
+/* private function priv_match_free
+ *
+ * bitmask of the control bytes of group that are empty or deleted
+ */
+static inline uint32_t priv_match_free(const uint8_t* group)
+{
+#if defined(__SSE2__)
+    return (uint32_t)_mm_movemask_epi8(
+        _mm_loadu_si128((const __m128i*)group));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < E_STRING_HASH_MAP_GROUP; i++) {
+        mask |= (uint32_t)(group[i] >> 7) << i;
+    }
+    return mask;
+#endif
+}
+
+/* private function priv_lowest
+ *
+ * index of the lowest bit set of mask, which is not 0
+ */
+static inline size_t priv_lowest(const uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_ctz(mask);
+#else
+    size_t index = 0;
+    while (((mask >> index) & 1) == 0) {
+        index += 1;
+    }
+    return index;
+#endif
+}
+
+/* private function priv_key
+ *
+ * key stored on slot
+ */
+static inline e_string_t* priv_key(const e_string_hash_map_t* map,
+                                   const size_t slot)
+{
+    return (e_string_t*)(map->slots + slot * map->slot_size);
+}
+
+/* private function priv_find
+ *
+ * slot of the key view with hash, or E_STRING_NOT_FOUND
+ */
+static size_t priv_find(const e_string_hash_map_t* map,
+                        const e_string_view_t view, const uint64_t hash)
+{
+    if (map->capacity == 0) {
+        return E_STRING_NOT_FOUND;
+    }
+
+    const size_t group_mask = map->capacity / E_STRING_HASH_MAP_GROUP - 1;
+    const uint8_t h2 = (uint8_t)(hash & 0x7F);
+    size_t group = (size_t)(hash >> 7) & group_mask;
+    for (size_t step = 1; step <= group_mask + 1; step++) {
+        const uint8_t* control = map->control
+                                 + group * E_STRING_HASH_MAP_GROUP;
+        for (uint32_t mask = priv_match(control, h2); mask != 0;
+             mask &= mask - 1) {
+            const size_t slot = group * E_STRING_HASH_MAP_GROUP
+                                + priv_lowest(mask);
+            const e_string_t* key = priv_key(map, slot);
+            if (e_string_length(key) == view.length
+                && (view.length == 0
+                    || memcmp(e_string_data(key), view.data,
+                              view.length) == 0)) {
+                return slot;
+            }
+        }
+        if (priv_match(control, E_STRING_HASH_MAP_EMPTY) != 0) {
+            break;
+        }
+        group = (group + step) & group_mask;
+    }
+    return E_STRING_NOT_FOUND;
+}
+
+/* private function priv_find_free
+ *
+ * first empty or deleted slot on the probe sequence of hash, the table
+ * always has empty slots
+ */
+static size_t priv_find_free(const uint8_t* control, const size_t capacity,
+                             const uint64_t hash)
+{
+    const size_t group_mask = capacity / E_STRING_HASH_MAP_GROUP - 1;
+    size_t group = (size_t)(hash >> 7) & group_mask;
+    for (size_t step = 1;; step++) {
+        const uint32_t mask = priv_match_free(
+            control + group * E_STRING_HASH_MAP_GROUP);
+        if (mask != 0) {
+            return group * E_STRING_HASH_MAP_GROUP + priv_lowest(mask);
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+/* private function priv_resize
+ *
+ * moves every key to new tables of capacity slots, dropping tombstones.
+ * when removed keys left bytes on the arena, the long keys are copied on a
+ * new one as well.
+ */
+static e_string_errno_t priv_resize(e_string_hash_map_t* map,
+                                    const size_t capacity)
+{
+    uint8_t* control = e_string_allocate(capacity);
+    uint8_t* slots = e_string_allocate(capacity * map->slot_size);
+    if (control == NULL || slots == NULL) {
+        e_string_release(control, capacity);
+        e_string_release(slots, capacity * map->slot_size);
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    memset(control, E_STRING_HASH_MAP_EMPTY, capacity);
+
+    const bool compact = map->dead_bytes > 0;
+    e_arena_t arena;
+    e_arena_init(&arena, map->arena.chunk_size);
+    for (size_t slot = 0; slot < map->capacity; slot++) {
+        if ((map->control[slot] & 0x80) == 0) {
+            const e_string_t* key = priv_key(map, slot);
+            const uint64_t hash = e_string_hash64(key, E_STRING_HASH_SEED);
+            const size_t target = priv_find_free(control, capacity, hash);
+            control[target] = (uint8_t)(hash & 0x7F);
+            memcpy(slots + target * map->slot_size, key, map->slot_size);
+            if (compact == false || e_string_is_inline(key) == true) {
+                continue;
+            }
+
+            e_string_t* moved = (e_string_t*)(slots
+                                              + target * map->slot_size);
+            moved->data = e_arena_alloc(&arena, key->buffer_capacity, 1);
+            if (moved->data == NULL) {
+                e_string_release(control, capacity);
+                e_string_release(slots, capacity * map->slot_size);
+                e_arena_destroy(&arena);
+                return E_STRING_OUT_OF_MEMORY;
+            }
+            memcpy(moved->data, key->data, key->data_length);
+        }
+    }
+
+    if (compact == true) {
+        e_arena_destroy(&map->arena);
+        map->arena = arena;
+        map->dead_bytes = 0;
+    }
+    e_string_release(map->control, map->capacity);
+    e_string_release(map->slots, map->capacity * map->slot_size);
+    map->control = control;
+    map->slots = slots;
+    map->capacity = capacity;
+    map->growth_left = capacity - capacity / 8 - map->count;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_capacity
+ *
+ * smallest table that holds count keys under the maximum load of 7/8
+ */
+static size_t priv_capacity(const size_t count)
+{
+    size_t capacity = E_STRING_HASH_MAP_GROUP;
+    while (capacity - capacity / 8 < count) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+/* private function priv_entry
+ *
+ * stores on value the value of the key view with hash, adding the key with
+ * a zeroed value when it is not there yet
+ */
+static e_string_errno_t priv_entry(e_string_hash_map_t* map,
+                                   const e_string_view_t view,
+                                   const uint64_t hash, void** value,
+                                   bool* inserted)
+{
+    size_t slot = priv_find(map, view, hash);
+    if (slot != E_STRING_NOT_FOUND) {
+        *value = (uint8_t*)priv_key(map, slot) + sizeof(e_string_t);
+        if (inserted != NULL) {
+            *inserted = false;
+        }
+        return E_STRING_SUCCESS;
+    }
+
+    const bool wasted = map->dead_bytes > map->key_bytes
+                        && map->dead_bytes >= map->arena.chunk_size;
+    if (map->growth_left == 0 || wasted == true) {
+        /* tables mostly made of tombstones, or rebuilt to drop removed
+         * keys from the arena, keep their size */
+        size_t capacity = map->capacity * 2;
+        if (map->capacity == 0) {
+            capacity = E_STRING_HASH_MAP_GROUP;
+        } else if (map->growth_left != 0
+                   || map->count * 16 <= map->capacity * 7) {
+            capacity = map->capacity;
+        }
+        const e_string_errno_t result = priv_resize(map, capacity);
+        if (result != E_STRING_SUCCESS) {
+            return result;
+        }
+    }
+
+    e_string_t key = e_string_from_bytes(&map->arena, view.data, view.length);
+    if (e_string_length(&key) != view.length) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    if (e_string_is_inline(&key) == false) {
+        map->key_bytes += key.buffer_capacity;
+    }
+    if ((view.flags & E_STRING_FLAG_ASCII) != 0) {
+        e_string_set_ascii(&key);
+    } else {
+        key.flags |= view.flags & E_STRING_FLAG_UTF8;
+    }
+
+    slot = priv_find_free(map->control, map->capacity, hash);
+    if (map->control[slot] == E_STRING_HASH_MAP_EMPTY) {
+        map->growth_left -= 1;
+    }
+    map->control[slot] = (uint8_t)(hash & 0x7F);
+    map->count += 1;
+
+    e_string_t* stored = priv_key(map, slot);
+    *stored = key;
+    *value = (uint8_t*)stored + sizeof(e_string_t);
+    memset(*value, 0, map->value_size);
+    if (inserted != NULL) {
+        *inserted = true;
+    }
+    return E_STRING_SUCCESS;
+}
+
+
+void e_string_hash_map_init(e_string_hash_map_t* map, const size_t value_size)
+{
+    const size_t align = sizeof(uint64_t);
+    const e_string_hash_map_t empty = {
+        .value_size = value_size,
+        .slot_size = (sizeof(e_string_t) + value_size + align - 1)
+                     / align * align
+    };
+    *map = empty;
+    e_arena_init(&map->arena, 0);
+}
+
+
+void e_string_hash_map_free(e_string_hash_map_t* map)
+{
+    e_string_release(map->control, map->capacity);
+    e_string_release(map->slots, map->capacity * map->slot_size);
+    e_arena_destroy(&map->arena);
+    e_string_hash_map_init(map, map->value_size);
+}
+
+
+e_string_errno_t e_string_hash_map_reserve(e_string_hash_map_t* map,
+                                           const size_t count)
+{
+    const size_t capacity = priv_capacity(count);
+    if (capacity <= map->capacity) {
+        return E_STRING_SUCCESS;
+    }
+    return priv_resize(map, capacity);
+}
+
+
+e_string_errno_t e_string_hash_map_entry(e_string_hash_map_t* map,
+                                         const e_string_view_t key,
+                                         void** value,
+                                         bool* inserted)
+{
+    return priv_entry(map, key, e_string_view_hash64(key, E_STRING_HASH_SEED),
+                      value, inserted);
+}
+
+
+e_string_errno_t e_string_hash_map_put(e_string_hash_map_t* map,
+                                       const e_string_view_t key,
+                                       const void* value)
+{
+    void* stored = NULL;
+    const e_string_errno_t result = e_string_hash_map_entry(map, key,
+                                                            &stored, NULL);
+    if (result == E_STRING_SUCCESS) {
+        memcpy(stored, value, map->value_size);
+    }
+    return result;
+}
+
+
+void* e_string_hash_map_get(const e_string_hash_map_t* map,
+                            const e_string_view_t key)
+{
+    const size_t slot = priv_find(map, key, e_string_view_hash64(
+        key, E_STRING_HASH_SEED));
+    return (slot == E_STRING_NOT_FOUND)
+           ? NULL : (uint8_t*)priv_key(map, slot) + sizeof(e_string_t);
+}
+
+
+void* e_string_hash_map_get_cstr(const e_string_hash_map_t* map,
+                                 const char* key)
+{
+    return e_string_hash_map_get(map, e_string_view_from_cstr(key));
+}
+
+
+void* e_string_hash_map_get_key(const e_string_hash_map_t* map,
+                                e_string_key_t* key)
+{
+    const size_t slot = priv_find(map, e_string_view(&key->string),
+                                  e_string_key_hash(key));
+    return (slot == E_STRING_NOT_FOUND)
+           ? NULL : (uint8_t*)priv_key(map, slot) + sizeof(e_string_t);
+}
+
+
+bool e_string_hash_map_remove(e_string_hash_map_t* map,
+                              const e_string_view_t key)
+{
+    const size_t slot = priv_find(map, key, e_string_view_hash64(
+        key, E_STRING_HASH_SEED));
+    if (slot == E_STRING_NOT_FOUND) {
+        return false;
+    }
+
+    const e_string_t* removed = priv_key(map, slot);
+    if (e_string_is_inline(removed) == false) {
+        map->key_bytes -= removed->buffer_capacity;
+        map->dead_bytes += removed->buffer_capacity;
+    }
+
+    /* no probe went past a group with an empty slot */
+    const size_t group = slot - slot % E_STRING_HASH_MAP_GROUP;
+    if (priv_match(map->control + group, E_STRING_HASH_MAP_EMPTY) != 0) {
+        map->control[slot] = E_STRING_HASH_MAP_EMPTY;
+        map->growth_left += 1;
+    } else {
+        map->control[slot] = E_STRING_HASH_MAP_DELETED;
+    }
+    map->count -= 1;
+    return true;
+}
+
+
+bool e_string_hash_map_next(const e_string_hash_map_t* map, size_t* cursor,
+                            const e_string_t** key, void** value)
+{
+    for (size_t slot = *cursor; slot < map->capacity; slot++) {
+        if ((map->control[slot] & 0x80) == 0) {
+            *key = priv_key(map, slot);
+            *value = (uint8_t*)priv_key(map, slot) + sizeof(e_string_t);
+            *cursor = slot + 1;
+            return true;
+        }
+    }
+    *cursor = map->capacity;
+    return false;
+}
@@ -0,0 +1,347 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_intern implementation
+ *
+ * this module implements a string interning pool shared by many threads.
+ *
+ * the pool is split in E_STRING_INTERN_SHARDS shards picked by the top bits
+ * of the hash, each with its own lock, so threads only wait on each other
+ * when they intern strings of the same shard at the same time. a shard has:
+ *   - an open addressing table of slots, each the high half of the hash
+ *     and the index of the entry plus one (0 for an empty slot)
+ *   - the entries, e_string_t on pages that double in size and never move,
+ *     so entries are stable and reading one takes no lock
+ *   - an arena for the data of entries that are not inline
+ *
+ * ids are the index of the entry on its shard followed by the shard bits.
+ * the amount of entries of a shard is published with release order after
+ * the entry is written, e_string_intern_get reads it with acquire order.
+ *
+ * it is built as the e_string_intern library, only where C11 threads exist.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string_intern
+ * library
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <threads.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* bits of an id that select the shard */
+#define E_STRING_INTERN_SHARD_BITS 6
+#define E_STRING_INTERN_SHARDS (1u << E_STRING_INTERN_SHARD_BITS)
+
+/* entries of the first page is 1 << E_STRING_INTERN_PAGE_BITS, every page
+ * has twice the entries of the previous one */
+#define E_STRING_INTERN_PAGE_BITS 8
+#define E_STRING_INTERN_PAGES 19
+
+/* entries a shard can hold, so no id is E_STRING_INTERN_NONE */
+#define E_STRING_INTERN_LIMIT (UINT32_MAX >> E_STRING_INTERN_SHARD_BITS)
+
+/* slots of a new table, a table grows when 3/4 of its slots are used */
+#define E_STRING_INTERN_MIN_SLOTS 64
+
+
+/* e_string_intern_shard struct
+ *
+ * a shard of e_string_intern_pool_t, padded so the locks of two shards do
+ * not share a cache line
+ */
+struct e_string_intern_shard
+{
+    mtx_t lock;
+    e_arena_t arena;
+    uint64_t* slots;
+    size_t slot_count;
+    e_string_t* pages[E_STRING_INTERN_PAGES];
+    _Atomic uint32_t count;
+    uint8_t padding[64];
+};
+
+/* private function priv_page
+ *
+ * finds the page of the entry of index and the offset of the entry on it
+ */
+static inline size_t priv_page(const uint32_t index, size_t* offset)
+{
+    const uint64_t position = (uint64_t)index
+                              + (1u << E_STRING_INTERN_PAGE_BITS);
+#if defined(__GNUC__) || defined(__clang__)
+    const size_t top = 63 - (size_t)__builtin_clzll(position);
+#else
+    size_t top = 0;
+    while ((position >> (top + 1)) != 0) {
+        top += 1;
+    }
+#endif
+    *offset = (size_t)(position - ((uint64_t)1 << top));
+    return top - E_STRING_INTERN_PAGE_BITS;
+}
+
+/* private function priv_page_size
+ *
+ * bytes of a page
+ */
+static inline size_t priv_page_size(const size_t page)
+{
+    return (sizeof(e_string_t) << E_STRING_INTERN_PAGE_BITS) << page;
+}
+
+/* private function priv_entry
+ *
+ * entry of index on shard
+ */
+static inline const e_string_t* priv_entry(
+    const struct e_string_intern_shard* shard, const uint32_t index)
+{
+    size_t offset = 0;
+    const size_t page = priv_page(index, &offset);
+    return &shard->pages[page][offset];
+}
+
+/* private function priv_lookup
+ *
+ * finds the slot of view on the table of shard: the slot holding it, or
+ * the empty slot where it would be stored. the table must not be full.
+ */
+static size_t priv_lookup(const struct e_string_intern_shard* shard,
+                          const e_string_view_t view, const uint64_t hash)
+{
+    const size_t mask = shard->slot_count - 1;
+    const uint64_t high = hash & 0xFFFFFFFF00000000ULL;
+    size_t slot = (size_t)(hash >> 32) & mask;
+    for (;; slot = (slot + 1) & mask) {
+        const uint64_t value = shard->slots[slot];
+        if (value == 0) {
+            return slot;
+        }
+        if ((value & 0xFFFFFFFF00000000ULL) == high) {
+            const e_string_t* entry = priv_entry(shard,
+                                                 (uint32_t)value - 1);
+            if (e_string_length(entry) == view.length
+                && (view.length == 0
+                    || memcmp(e_string_data(entry), view.data,
+                              view.length) == 0)) {
+                return slot;
+            }
+        }
+    }
+}
+
+/* private function priv_grow
+ *
+ * doubles the table of shard (or creates it), moving every slot to the
+ * position given by its high half of the hash
+ */
+static e_string_errno_t priv_grow(struct e_string_intern_shard* shard)
+{
+    const size_t slot_count = (shard->slot_count == 0)
+                              ? E_STRING_INTERN_MIN_SLOTS
+                              : shard->slot_count * 2;
+    uint64_t* slots = e_string_allocate(slot_count * sizeof(uint64_t));
+    if (slots == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    memset(slots, 0, slot_count * sizeof(uint64_t));
+
+    const size_t mask = slot_count - 1;
+    for (size_t i = 0; i < shard->slot_count; i++) {
+        const uint64_t value = shard->slots[i];
+        if (value != 0) {
+            size_t slot = (size_t)(value >> 32) & mask;
+            while (slots[slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = value;
+        }
+    }
+    e_string_release(shard->slots, shard->slot_count * sizeof(uint64_t));
+    shard->slots = slots;
+    shard->slot_count = slot_count;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_insert
+ *
+ * stores on index the entry of view on shard, adding it when it is new.
+ * called with the lock of shard held.
+ */
+static e_string_errno_t priv_insert(struct e_string_intern_shard* shard,
+                                    const e_string_view_t view,
+                                    const uint64_t hash, uint32_t* index)
+{
+    const uint32_t count = atomic_load_explicit(&shard->count,
+                                                memory_order_relaxed);
+    if ((size_t)(count + 1) * 4 > shard->slot_count * 3) {
+        const e_string_errno_t result = priv_grow(shard);
+        if (result != E_STRING_SUCCESS) {
+            return result;
+        }
+    }
+
+    const size_t slot = priv_lookup(shard, view, hash);
+    if (shard->slots[slot] != 0) {
+        *index = (uint32_t)shard->slots[slot] - 1;
+        return E_STRING_SUCCESS;
+    }
+    if (count >= E_STRING_INTERN_LIMIT) {
+        return E_STRING_OUT_OF_RANGE;
+    }
+
+    size_t offset = 0;
+    const size_t page = priv_page(count, &offset);
+    /* a page allocated for an entry that failed is kept for the next one */
+    if (offset == 0 && shard->pages[page] == NULL) {
+        shard->pages[page] = e_string_allocate(priv_page_size(page));
+        if (shard->pages[page] == NULL) {
+            return E_STRING_OUT_OF_MEMORY;
+        }
+    }
+    e_string_t entry = e_string_from_bytes(&shard->arena, view.data,
+                                           view.length);
+    if (e_string_length(&entry) != view.length) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    if ((view.flags & E_STRING_FLAG_ASCII) != 0) {
+        e_string_set_ascii(&entry);
+    } else {
+        entry.flags |= view.flags & E_STRING_FLAG_UTF8;
+    }
+
+    shard->pages[page][offset] = entry;
+    shard->slots[slot] = (hash & 0xFFFFFFFF00000000ULL) | (count + 1);
+    atomic_store_explicit(&shard->count, count + 1, memory_order_release);
+    *index = count;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_intern_pool_init(e_string_intern_pool_t* pool)
+{
+    pool->shards = e_string_allocate(E_STRING_INTERN_SHARDS
+                                     * sizeof(struct e_string_intern_shard));
+    if (pool->shards == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    for (size_t s = 0; s < E_STRING_INTERN_SHARDS; s++) {
+        struct e_string_intern_shard* shard = &pool->shards[s];
+        if (mtx_init(&shard->lock, mtx_plain) != thrd_success) {
+            for (size_t previous = 0; previous < s; previous++) {
+                mtx_destroy(&pool->shards[previous].lock);
+            }
+            e_string_release(pool->shards, E_STRING_INTERN_SHARDS
+                             * sizeof(struct e_string_intern_shard));
+            pool->shards = NULL;
+            return E_STRING_OUT_OF_MEMORY;
+        }
+        e_arena_init(&shard->arena, 0);
+        shard->slots = NULL;
+        shard->slot_count = 0;
+        for (size_t page = 0; page < E_STRING_INTERN_PAGES; page++) {
+            shard->pages[page] = NULL;
+        }
+        atomic_init(&shard->count, 0);
+    }
+    return E_STRING_SUCCESS;
+}
+
+
+void e_string_intern_pool_free(e_string_intern_pool_t* pool)
+{
+    if (pool->shards == NULL) {
+        return;
+    }
+
+    for (size_t s = 0; s < E_STRING_INTERN_SHARDS; s++) {
+        struct e_string_intern_shard* shard = &pool->shards[s];
+        mtx_destroy(&shard->lock);
+        e_arena_destroy(&shard->arena);
+        e_string_release(shard->slots, shard->slot_count * sizeof(uint64_t));
+        for (size_t page = 0; page < E_STRING_INTERN_PAGES; page++) {
+            if (shard->pages[page] != NULL) {
+                e_string_release(shard->pages[page], priv_page_size(page));
+            }
+        }
+    }
+    e_string_release(pool->shards, E_STRING_INTERN_SHARDS
+                     * sizeof(struct e_string_intern_shard));
+    pool->shards = NULL;
+}
+
+
+e_string_errno_t e_string_intern(e_string_intern_pool_t* pool,
+                                 const e_string_view_t view,
+                                 e_string_id_t* id)
+{
+    const uint64_t hash = e_string_view_hash64(view, E_STRING_HASH_SEED);
+    const size_t s = (size_t)(hash >> (64 - E_STRING_INTERN_SHARD_BITS));
+    struct e_string_intern_shard* shard = &pool->shards[s];
+
+    uint32_t index = 0;
+    mtx_lock(&shard->lock);
+    const e_string_errno_t result = priv_insert(shard, view, hash, &index);
+    mtx_unlock(&shard->lock);
+
+    if (result == E_STRING_SUCCESS) {
+        *id = (index << E_STRING_INTERN_SHARD_BITS) | (uint32_t)s;
+    }
+    return result;
+}
+
+
+e_string_id_t e_string_intern_find(e_string_intern_pool_t* pool,
+                                   const e_string_view_t view)
+{
+    const uint64_t hash = e_string_view_hash64(view, E_STRING_HASH_SEED);
+    const size_t s = (size_t)(hash >> (64 - E_STRING_INTERN_SHARD_BITS));
+    struct e_string_intern_shard* shard = &pool->shards[s];
+
+    e_string_id_t id = E_STRING_INTERN_NONE;
+    mtx_lock(&shard->lock);
+    if (shard->slot_count > 0) {
+        const uint64_t value = shard->slots[priv_lookup(shard, view, hash)];
+        if (value != 0) {
+            id = (((uint32_t)value - 1) << E_STRING_INTERN_SHARD_BITS)
+                 | (uint32_t)s;
+        }
+    }
+    mtx_unlock(&shard->lock);
+    return id;
+}
+
+
+const e_string_t* e_string_intern_get(const e_string_intern_pool_t* pool,
+                                      const e_string_id_t id)
+{
+    const struct e_string_intern_shard* shard =
+        &pool->shards[id & (E_STRING_INTERN_SHARDS - 1)];
+    const uint32_t index = id >> E_STRING_INTERN_SHARD_BITS;
+    const uint32_t count = atomic_load_explicit(&shard->count,
+                                                memory_order_acquire);
+    if (id == E_STRING_INTERN_NONE || index >= count) {
+        return NULL;
+    }
+    return priv_entry(shard, index);
+}
+
+
+size_t e_string_intern_pool_count(const e_string_intern_pool_t* pool)
+{
+    size_t count = 0;
+    for (size_t s = 0; s < E_STRING_INTERN_SHARDS; s++) {
+        count += atomic_load_explicit(&pool->shards[s].count,
+                                      memory_order_relaxed);
+    }
+    return count;
+}
@@ -0,0 +1,151 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_map implementation
+ *
+ * this module implements read-only memory mappings of files as views.
+ *
+ * the file is validated in windows of E_STRING_MAP_WINDOW bytes. before a
+ * window is validated the next one is requested with POSIX_MADV_WILLNEED, so
+ * the kernel reads it while the current one is checked. windows are moved
+ * back to the start of a codepoint, so each one is validated on its own with
+ * the engine picked by e_string_validate, including the US ASCII detection.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+/* mmap and friends are POSIX, and the library is built without extensions */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define E_STRING_MAP_POSIX 1
+#endif
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* bytes validated between two read ahead requests */
+#define E_STRING_MAP_WINDOW ((size_t)4 * 1024 * 1024)
+
+
+/* private function priv_window_end
+ *
+ * moves end back to the start of the codepoint it falls in, looking at most
+ * 3 bytes back. invalid data stays invalid whatever the split.
+ */
+static size_t priv_window_end(const uint8_t* data, const size_t start,
+                              size_t end, const size_t length)
+{
+    for (int back = 0; back < 3 && end > start && end < length; back++) {
+        if ((data[end] & 0xC0) != 0x80) {
+            break;
+        }
+        end -= 1;
+    }
+    return end;
+}
+
+/* private function priv_validate
+ *
+ * validates the mapped data window by window, reading the next one ahead
+ */
+static e_string_errno_t priv_validate(e_string_map_t* map)
+{
+    const uint8_t* data = map->view.data;
+    const size_t length = map->view.length;
+    bool ascii = true;
+    size_t start = 0;
+    for (size_t window = 0; start < length; window++) {
+        /* the window limits are page aligned, the split points are not */
+        const size_t limit = (window + 1) * E_STRING_MAP_WINDOW;
+#ifdef E_STRING_MAP_POSIX
+        if (limit < length) {
+            const size_t ahead = (length - limit < E_STRING_MAP_WINDOW)
+                               ? length - limit : E_STRING_MAP_WINDOW;
+            posix_madvise((uint8_t*)map->mapping + limit, ahead,
+                          POSIX_MADV_WILLNEED);
+        }
+#endif
+        const size_t end = priv_window_end(data, start,
+                                           (limit < length) ? limit : length,
+                                           length);
+        bool window_ascii = false;
+        if (e_string_validate_utf8(data + start, end - start,
+                                   E_STRING_ENGINE_AUTO, &window_ascii)
+            != E_STRING_SUCCESS) {
+            return E_STRING_INVALID_UTF8;
+        }
+        ascii = ascii && window_ascii;
+        start = end;
+    }
+
+    map->view.flags = E_STRING_FLAG_UTF8 | (ascii ? E_STRING_FLAG_ASCII : 0);
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_map_file(const char* path, e_string_map_t* map)
+{
+    static const uint8_t empty[1] = { 0 };
+    const e_string_map_t none = { .view = { .data = empty } };
+    *map = none;
+
+#ifdef E_STRING_MAP_POSIX
+    const int file = open(path, O_RDONLY);
+    if (file < 0) {
+        return E_STRING_IO_ERROR;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || S_ISREG(status.st_mode) == 0
+        || (uintmax_t)status.st_size > SIZE_MAX) {
+        close(file);
+        return E_STRING_IO_ERROR;
+    }
+
+    /* mmap refuses empty mappings, an empty file is an empty view */
+    const size_t length = (size_t)status.st_size;
+    if (length > 0) {
+        void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, file, 0);
+        if (mapping == MAP_FAILED) {
+            close(file);
+            return E_STRING_IO_ERROR;
+        }
+        posix_madvise(mapping, length, POSIX_MADV_SEQUENTIAL);
+        map->mapping = mapping;
+        map->mapping_length = length;
+        map->view.data = mapping;
+        map->view.length = length;
+    }
+
+    /* the mapping stays valid after the file is closed */
+    close(file);
+    return priv_validate(map);
+#else
+    (void)path;
+    return E_STRING_IO_ERROR;
+#endif
+}
+
+
+void e_string_unmap(e_string_map_t* map)
+{
+#ifdef E_STRING_MAP_POSIX
+    if (map->mapping != NULL) {
+        munmap(map->mapping, map->mapping_length);
+    }
+#endif
+    map->mapping = NULL;
+    map->mapping_length = 0;
+    map->view.length = 0;
+    map->view.flags = 0;
+}
@@ -0,0 +1,463 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_matcher implementation
+ *
+ * this module implements multi-pattern matching with an Aho-Corasick
+ * automaton, so a text is scanned once whatever the amount of patterns.
+ *
+ * the automaton is built in two steps:
+ *   - a trie of the patterns, with sibling lists, is walked breadth first to
+ *     find the failure links and to number the states by depth
+ *   - the states are laid out compactly: bytes are mapped to classes (one per
+ *     byte used by the patterns, and one for every other byte), the states
+ *     closest to the root, which most bytes go through, get dense rows of
+ *     complete transitions, and deeper states keep their few edges and a
+ *     failure link
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* memory given to dense transition rows, filled from the root down */
+#define E_STRING_MATCHER_DENSE_BYTES (128 * 1024)
+
+/* marks the end of the lists of the trie */
+#define E_STRING_MATCHER_NONE UINT32_MAX
+
+
+/* private struct priv_trie
+ *
+ * temporary trie of the patterns, where children and the patterns ending on
+ * a state are linked lists
+ */
+typedef struct priv_trie
+{
+    uint8_t* label;
+    uint32_t* first_child;
+    uint32_t* next_sibling;
+    uint32_t* first_end;
+    uint32_t* next_end;
+    uint32_t* fail;
+    uint32_t* order;
+    uint32_t* renumber;
+    size_t capacity;
+    size_t pattern_count;
+    uint32_t state_count;
+} priv_trie_t;
+
+/* private function priv_trie_free
+ *
+ * releases every array of trie
+ */
+static void priv_trie_free(priv_trie_t* trie)
+{
+    const size_t states = trie->capacity;
+    e_string_release(trie->label, states * sizeof(uint8_t));
+    e_string_release(trie->first_child, states * sizeof(uint32_t));
+    e_string_release(trie->next_sibling, states * sizeof(uint32_t));
+    e_string_release(trie->first_end, states * sizeof(uint32_t));
+    e_string_release(trie->next_end, trie->pattern_count * sizeof(uint32_t));
+    e_string_release(trie->fail, states * sizeof(uint32_t));
+    e_string_release(trie->order, states * sizeof(uint32_t));
+    e_string_release(trie->renumber, states * sizeof(uint32_t));
+}
+
+/* private function priv_trie_child
+ *
+ * child of state with label, or E_STRING_MATCHER_NONE
+ */
+static uint32_t priv_trie_child(const priv_trie_t* trie, const uint32_t state,
+                                const uint8_t label)
+{
+    uint32_t child = trie->first_child[state];
+    while (child != E_STRING_MATCHER_NONE && trie->label[child] != label) {
+        child = trie->next_sibling[child];
+    }
+    return child;
+}
+
+/* private function priv_trie_build
+ *
+ * inserts every pattern, as byte classes, and computes the failure links
+ * and the breadth first order of the states
+ */
+static e_string_errno_t priv_trie_build(priv_trie_t* trie,
+                                        const e_string_t* patterns,
+                                        const size_t pattern_count,
+                                        const uint8_t* byte_classes)
+{
+    size_t states = 1;
+    for (size_t p = 0; p < pattern_count; p++) {
+        states += e_string_length(&patterns[p]);
+    }
+    if (states >= E_STRING_MATCHER_NONE) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    trie->capacity = states;
+    trie->pattern_count = pattern_count;
+    trie->label = e_string_allocate(states * sizeof(uint8_t));
+    trie->first_child = e_string_allocate(states * sizeof(uint32_t));
+    trie->next_sibling = e_string_allocate(states * sizeof(uint32_t));
+    trie->first_end = e_string_allocate(states * sizeof(uint32_t));
+    trie->next_end = e_string_allocate(pattern_count * sizeof(uint32_t));
+    trie->fail = e_string_allocate(states * sizeof(uint32_t));
+    trie->order = e_string_allocate(states * sizeof(uint32_t));
+    trie->renumber = e_string_allocate(states * sizeof(uint32_t));
+    if (trie->label == NULL || trie->first_child == NULL
+        || trie->next_sibling == NULL || trie->first_end == NULL
+        || (trie->next_end == NULL && pattern_count > 0)
+        || trie->fail == NULL || trie->order == NULL
+        || trie->renumber == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    trie->state_count = 1;
+    trie->first_child[0] = E_STRING_MATCHER_NONE;
+    trie->first_end[0] = E_STRING_MATCHER_NONE;
+
+    /* patterns are inserted from the last, so the lists of the patterns
+     * ending on a state are sorted by pattern index
+     */
+    for (size_t p = pattern_count; p-- > 0;) {
+        const uint8_t* data = e_string_data(&patterns[p]);
+        const size_t length = e_string_length(&patterns[p]);
+        uint32_t state = 0;
+        for (size_t i = 0; i < length; i++) {
+            const uint8_t label = byte_classes[data[i]];
+            uint32_t child = priv_trie_child(trie, state, label);
+            if (child == E_STRING_MATCHER_NONE) {
+                child = trie->state_count++;
+                trie->label[child] = label;
+                trie->first_child[child] = E_STRING_MATCHER_NONE;
+                trie->first_end[child] = E_STRING_MATCHER_NONE;
+                trie->next_sibling[child] = trie->first_child[state];
+                trie->first_child[state] = child;
+            }
+            state = child;
+        }
+        trie->next_end[p] = trie->first_end[state];
+        trie->first_end[state] = (uint32_t)p;
+    }
+
+    /* breadth first: the failure link of a child extends the longest proper
+     * suffix of its parent that has a child with the same label
+     */
+    size_t head = 0;
+    size_t tail = 0;
+    trie->order[tail++] = 0;
+    trie->fail[0] = 0;
+    while (head < tail) {
+        const uint32_t state = trie->order[head++];
+        trie->renumber[state] = (uint32_t)(head - 1);
+        for (uint32_t child = trie->first_child[state];
+             child != E_STRING_MATCHER_NONE;
+             child = trie->next_sibling[child]) {
+            uint32_t fail = 0;
+            if (state != 0) {
+                uint32_t suffix = trie->fail[state];
+                for (;;) {
+                    fail = priv_trie_child(trie, suffix, trie->label[child]);
+                    if (fail != E_STRING_MATCHER_NONE || suffix == 0) {
+                        break;
+                    }
+                    suffix = trie->fail[suffix];
+                }
+                fail = (fail == E_STRING_MATCHER_NONE) ? 0 : fail;
+            }
+            trie->fail[child] = fail;
+            trie->order[tail++] = child;
+        }
+    }
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_layout
+ *
+ * lays out the automaton of trie on matcher, numbering states breadth first
+ */
+static e_string_errno_t priv_layout(e_string_matcher_t* matcher,
+                                    const priv_trie_t* trie)
+{
+    /* the root is always dense, so every failure chain ends on a row */
+    const uint32_t states = trie->state_count;
+    const size_t row_bytes = matcher->class_count * sizeof(uint32_t);
+    uint32_t dense_count = 1;
+    while (dense_count < states
+           && (dense_count + 1) * row_bytes <= E_STRING_MATCHER_DENSE_BYTES) {
+        dense_count += 1;
+    }
+    uint32_t edge_count = 0;
+    for (uint32_t s = 0; s < states; s++) {
+        const uint32_t state = trie->order[s];
+        for (uint32_t child = trie->first_child[state];
+             child != E_STRING_MATCHER_NONE && s >= dense_count;
+             child = trie->next_sibling[child]) {
+            edge_count += 1;
+        }
+    }
+    const size_t output_count = trie->pattern_count;
+
+    matcher->state_count = states;
+    matcher->dense_count = dense_count;
+    matcher->edge_count = edge_count;
+    matcher->dense = e_string_allocate((size_t)dense_count
+                                       * matcher->class_count
+                                       * sizeof(uint32_t));
+    matcher->states = e_string_allocate(states
+                                        * sizeof(e_string_matcher_state_t));
+    matcher->edge_classes = e_string_allocate(edge_count * sizeof(uint8_t));
+    matcher->edge_targets = e_string_allocate(edge_count * sizeof(uint32_t));
+    matcher->output_start = e_string_allocate((states + 1) * sizeof(uint32_t));
+    matcher->outputs = e_string_allocate(output_count * sizeof(uint32_t));
+    if (matcher->dense == NULL || matcher->states == NULL
+        || (edge_count > 0 && (matcher->edge_classes == NULL
+                               || matcher->edge_targets == NULL))
+        || matcher->output_start == NULL
+        || (output_count > 0 && matcher->outputs == NULL)) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    uint32_t edge = 0;
+    uint32_t output = 0;
+    for (uint32_t s = 0; s < states; s++) {
+        const uint32_t state = trie->order[s];
+        e_string_matcher_state_t* laid = &matcher->states[s];
+        laid->fail = trie->renumber[trie->fail[state]];
+        laid->edges = edge;
+        laid->edge_count = 0;
+
+        if (s < dense_count) {
+            /* missing transitions follow the failure link, whose row is
+             * complete already as it is closer to the root
+             */
+            uint32_t* row = matcher->dense + (size_t)s * matcher->class_count;
+            for (uint32_t c = 0; c < matcher->class_count; c++) {
+                row[c] = (s == 0) ? 0
+                       : matcher->dense[(size_t)laid->fail
+                                        * matcher->class_count + c];
+            }
+            for (uint32_t child = trie->first_child[state];
+                 child != E_STRING_MATCHER_NONE;
+                 child = trie->next_sibling[child]) {
+                row[trie->label[child]] = trie->renumber[child];
+            }
+        } else {
+            for (uint32_t child = trie->first_child[state];
+                 child != E_STRING_MATCHER_NONE;
+                 child = trie->next_sibling[child]) {
+                matcher->edge_classes[edge] = trie->label[child];
+                matcher->edge_targets[edge] = trie->renumber[child];
+                edge += 1;
+            }
+            laid->edge_count = edge - laid->edges;
+        }
+
+        matcher->output_start[s] = output;
+        for (uint32_t p = trie->first_end[state]; p != E_STRING_MATCHER_NONE;
+             p = trie->next_end[p]) {
+            matcher->outputs[output++] = p;
+        }
+
+        /* the closest state of the failure chain with matches, itself first */
+        laid->output = (matcher->output_start[s] != output) ? s
+                     : (s == 0) ? 0 : matcher->states[laid->fail].output;
+    }
+    matcher->output_start[states] = output;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_next
+ *
+ * transition of state on a byte of class
+ */
+static inline uint32_t priv_next(const e_string_matcher_t* matcher,
+                                 uint32_t state, const uint8_t class)
+{
+    while (state >= matcher->dense_count) {
+        const e_string_matcher_state_t* laid = &matcher->states[state];
+        const uint32_t end = laid->edges + laid->edge_count;
+        for (uint32_t edge = laid->edges; edge < end; edge++) {
+            if (matcher->edge_classes[edge] == class) {
+                return matcher->edge_targets[edge];
+            }
+        }
+        state = laid->fail;
+    }
+    return matcher->dense[(size_t)state * matcher->class_count + class];
+}
+
+
+e_string_errno_t e_string_matcher_build(e_string_matcher_t* matcher,
+                                        const e_string_t* patterns,
+                                        const size_t pattern_count)
+{
+    const e_string_matcher_t empty = { .class_count = 1 };
+    *matcher = empty;
+
+    size_t max_length = 0;
+    bool used[256] = { false };
+    for (size_t p = 0; p < pattern_count; p++) {
+        const uint8_t* data = e_string_data(&patterns[p]);
+        const size_t length = e_string_length(&patterns[p]);
+        if (length == 0) {
+            return E_STRING_INVALID_BUFFER;
+        }
+        for (size_t i = 0; i < length; i++) {
+            used[data[i]] = true;
+        }
+        max_length = (length > max_length) ? length : max_length;
+    }
+
+    /* class 0 is every byte that no pattern uses */
+    for (size_t byte = 0; byte < 256; byte++) {
+        matcher->byte_classes[byte] = used[byte]
+                                    ? (uint8_t)matcher->class_count++ : 0;
+    }
+    if (matcher->class_count > 256) {
+        /* every byte is used: classes are the bytes themselves */
+        for (size_t byte = 0; byte < 256; byte++) {
+            matcher->byte_classes[byte] = (uint8_t)byte;
+        }
+        matcher->class_count = 256;
+    }
+
+    priv_trie_t trie = { 0 };
+    e_string_errno_t result = priv_trie_build(&trie, patterns, pattern_count,
+                                              matcher->byte_classes);
+    if (result == E_STRING_SUCCESS) {
+        result = priv_layout(matcher, &trie);
+    }
+    priv_trie_free(&trie);
+
+    matcher->pattern_count = pattern_count;
+    if (result == E_STRING_SUCCESS) {
+        matcher->pattern_lengths = e_string_allocate(pattern_count
+                                                     * sizeof(size_t));
+        if (matcher->pattern_lengths == NULL && pattern_count > 0) {
+            result = E_STRING_OUT_OF_MEMORY;
+        }
+    }
+    if (result != E_STRING_SUCCESS) {
+        e_string_matcher_free(matcher);
+        return result;
+    }
+    for (size_t p = 0; p < pattern_count; p++) {
+        matcher->pattern_lengths[p] = e_string_length(&patterns[p]);
+    }
+    matcher->max_length = max_length;
+    return E_STRING_SUCCESS;
+}
+
+
+void e_string_matcher_free(e_string_matcher_t* matcher)
+{
+    const size_t states = matcher->state_count;
+    e_string_release(matcher->dense, (size_t)matcher->dense_count
+                                     * matcher->class_count * sizeof(uint32_t));
+    e_string_release(matcher->states, states * sizeof(e_string_matcher_state_t));
+    e_string_release(matcher->edge_classes,
+                     matcher->edge_count * sizeof(uint8_t));
+    e_string_release(matcher->edge_targets,
+                     matcher->edge_count * sizeof(uint32_t));
+    e_string_release(matcher->output_start, (states + 1) * sizeof(uint32_t));
+    e_string_release(matcher->outputs,
+                     matcher->pattern_count * sizeof(uint32_t));
+    e_string_release(matcher->pattern_lengths,
+                     matcher->pattern_count * sizeof(size_t));
+
+    const e_string_matcher_t empty = { .class_count = 1 };
+    *matcher = empty;
+}
+
+
+bool e_string_matcher_find(const e_string_matcher_t* matcher,
+                           const e_string_view_t text,
+                           const size_t from,
+                           e_string_match_t* match)
+{
+    if (matcher->state_count == 0) {
+        return false;
+    }
+
+    /* once a match is known, only a match starting earlier, or at the same
+     * offset for an earlier pattern, can beat it, and it ends no later than
+     * the best start plus the longest pattern
+     */
+    e_string_match_t best = { .offset = SIZE_MAX };
+    size_t end = text.length;
+    uint32_t state = 0;
+    for (size_t i = from; i < end; i++) {
+        state = priv_next(matcher, state,
+                          matcher->byte_classes[text.data[i]]);
+        for (uint32_t found = matcher->states[state].output; found != 0;
+             found = matcher->states[matcher->states[found].fail].output) {
+            for (uint32_t o = matcher->output_start[found];
+                 o < matcher->output_start[found + 1]; o++) {
+                const uint32_t pattern = matcher->outputs[o];
+                const size_t length = matcher->pattern_lengths[pattern];
+                const size_t offset = i + 1 - length;
+                if (offset < best.offset
+                    || (offset == best.offset && pattern < best.pattern)) {
+                    best.pattern = pattern;
+                    best.offset = offset;
+                    best.length = length;
+                }
+            }
+        }
+        if (best.offset != SIZE_MAX
+            && best.offset + matcher->max_length < end) {
+            end = best.offset + matcher->max_length;
+        }
+    }
+
+    if (best.offset == SIZE_MAX) {
+        return false;
+    }
+    *match = best;
+    return true;
+}
+
+
+size_t e_string_matcher_find_all(const e_string_matcher_t* matcher,
+                                 const e_string_view_t text,
+                                 e_string_match_callback_t callback,
+                                 void* context)
+{
+    if (matcher->state_count == 0) {
+        return 0;
+    }
+
+    size_t count = 0;
+    uint32_t state = 0;
+    for (size_t i = 0; i < text.length; i++) {
+        state = priv_next(matcher, state,
+                          matcher->byte_classes[text.data[i]]);
+        for (uint32_t found = matcher->states[state].output; found != 0;
+             found = matcher->states[matcher->states[found].fail].output) {
+            for (uint32_t o = matcher->output_start[found];
+                 o < matcher->output_start[found + 1]; o++) {
+                const uint32_t pattern = matcher->outputs[o];
+                const e_string_match_t match = {
+                    .pattern = pattern,
+                    .offset = i + 1 - matcher->pattern_lengths[pattern],
+                    .length = matcher->pattern_lengths[pattern]
+                };
+                count += 1;
+                if (callback != NULL && callback(&match, context) == false) {
+                    return count;
+                }
+            }
+        }
+    }
+    return count;
+}
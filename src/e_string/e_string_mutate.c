@@ -0,0 +1,206 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_mutate implementation
+ *
+ * this module implements the functions that change e_string_t in place.
+ *
+ * growth at least doubles the capacity, so a string built by n appends is
+ * reallocated O(log n) times. the cached flags of the appended data are
+ * merged with the ones of the string, so a string built from validated
+ * pieces or codepoints never needs to be validated again.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* flags cached by e_string_t, as opposed to the layout flags */
+#define E_STRING_FLAGS_CACHE (E_STRING_FLAG_UTF8 | E_STRING_FLAG_ASCII \
+                              | E_STRING_FLAG_COUNTED)
+
+
+/* private function priv_grow
+ *
+ * makes the capacity at least required, at least doubling it, moving the
+ * data from inline or arena storage to the heap
+ */
+static e_string_errno_t priv_grow(e_string_t* string, const size_t required)
+{
+    const size_t capacity = e_string_capacity(string);
+    if (required <= capacity) {
+        return E_STRING_SUCCESS;
+    }
+
+    size_t new_capacity = (capacity > SIZE_MAX / 2) ? SIZE_MAX : capacity * 2;
+    if (new_capacity < 2 * E_STRING_INLINE_CAPACITY) {
+        new_capacity = 2 * E_STRING_INLINE_CAPACITY;
+    }
+    if (new_capacity < required) {
+        new_capacity = required;
+    }
+
+    const size_t length = e_string_length(string);
+    if ((string->flags & (E_STRING_FLAG_INLINE | E_STRING_FLAG_ARENA)) != 0) {
+        uint8_t* data = e_string_allocate(new_capacity);
+        if (data == NULL) {
+            return E_STRING_OUT_OF_MEMORY;
+        }
+        memcpy(data, e_string_data(string), length);
+        string->flags &= ~(uint32_t)(E_STRING_FLAG_INLINE | E_STRING_FLAG_ARENA);
+        string->data_length = length;
+        string->buffer_capacity = new_capacity;
+        string->data = data;
+        return E_STRING_SUCCESS;
+    }
+
+    uint8_t* data = e_string_reallocate(string->data, string->buffer_capacity,
+                                        new_capacity);
+    if (data == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    string->buffer_capacity = new_capacity;
+    string->data = data;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_append
+ *
+ * appends length bytes whose cached flags and codepoint count are known,
+ * flags is 0 when nothing is known about bytes
+ */
+static e_string_errno_t priv_append(e_string_t* string,
+                                    const uint8_t* bytes,
+                                    const size_t length,
+                                    const uint32_t flags,
+                                    const uint32_t codepoint_count)
+{
+    if (length == 0) {
+        return E_STRING_SUCCESS;
+    }
+    if (e_string_reserve(string, length) != E_STRING_SUCCESS) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    const size_t old_length = e_string_length(string);
+    if (old_length == 0) {
+        /* an empty string is known to be valid */
+        e_string_set_ascii(string);
+    }
+    memcpy(e_string_data_mut(string) + old_length, bytes, length);
+    e_string_set_length(string, old_length + length);
+
+    /* the result keeps what is known about both parts */
+    const uint32_t cache = string->flags & flags & E_STRING_FLAGS_CACHE;
+    const bool counted = (cache & E_STRING_FLAG_COUNTED) != 0
+                      && string->codepoint_count <= UINT32_MAX - codepoint_count;
+    string->codepoint_count = counted ? string->codepoint_count
+                                        + codepoint_count
+                                      : 0;
+    string->flags = (string->flags & E_STRING_FLAGS_LAYOUT)
+                  | (cache & ~(uint32_t)E_STRING_FLAG_COUNTED)
+                  | (counted ? E_STRING_FLAG_COUNTED : 0);
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_reserve(e_string_t* string, const size_t additional)
+{
+    const size_t length = e_string_length(string);
+    if (additional > SIZE_MAX - length) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    return priv_grow(string, length + additional);
+}
+
+
+e_string_errno_t e_string_push_codepoint(e_string_t* string,
+                                         const uint32_t codepoint)
+{
+    if (codepoint < 0x80) {
+        if (e_string_utf8_is_ascii((uint8_t)codepoint, true) == false) {
+            return E_STRING_INVALID_UTF8;
+        }
+    } else if (codepoint > 0x10FFFF
+               || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        return E_STRING_INVALID_UTF8;
+    }
+
+    uint8_t bytes[4];
+    const size_t length = e_string_utf8_encode(codepoint, bytes);
+    const uint32_t flags = E_STRING_FLAG_UTF8 | E_STRING_FLAG_COUNTED
+                         | ((length == 1) ? E_STRING_FLAG_ASCII : 0);
+    return priv_append(string, bytes, length, flags, 1);
+}
+
+
+e_string_errno_t e_string_append(e_string_t* string, const e_string_t* other)
+{
+    /* other can be string itself, so its data is read after growing */
+    const size_t length = e_string_length(other);
+    if (e_string_reserve(string, length) != E_STRING_SUCCESS) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    return priv_append(string, e_string_data(other), length,
+                       other->flags, other->codepoint_count);
+}
+
+
+e_string_errno_t e_string_append_cstr(e_string_t* string, const char* cstr)
+{
+    return priv_append(string, (const uint8_t*)cstr, strlen(cstr), 0, 0);
+}
+
+
+e_string_errno_t e_string_shrink_to_fit(e_string_t* string)
+{
+    if (e_string_is_inline(string) == true) {
+        return E_STRING_SUCCESS;
+    }
+
+    const size_t length = string->data_length;
+    if (length <= E_STRING_INLINE_CAPACITY) {
+        uint8_t* data = string->data;
+        const size_t capacity = string->buffer_capacity;
+        const bool arena = (string->flags & E_STRING_FLAG_ARENA) != 0;
+
+        /* data lives outside of the struct, so it survives the layout change */
+        memmove(string->inline_data, data, length);
+        string->inline_length = (uint8_t)length;
+        string->flags = (string->flags & ~(uint32_t)E_STRING_FLAG_ARENA)
+                      | E_STRING_FLAG_INLINE;
+        if (arena == false) {
+            e_string_release(data, capacity);
+        }
+        return E_STRING_SUCCESS;
+    }
+
+    if ((string->flags & E_STRING_FLAG_ARENA) != 0
+        || string->buffer_capacity == length) {
+        return E_STRING_SUCCESS;
+    }
+
+    uint8_t* data = e_string_reallocate(string->data, string->buffer_capacity,
+                                        length);
+    if (data == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    string->buffer_capacity = length;
+    string->data = data;
+    return E_STRING_SUCCESS;
+}
+
+
+void e_string_clear(e_string_t* string)
+{
+    e_string_set_length(string, 0);
+    string->flags &= E_STRING_FLAGS_LAYOUT;
+    e_string_set_ascii(string);
+}
@@ -0,0 +1,342 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string private header
+ *
+ * this header declares the functions shared between e_string translation
+ * units that are not part of the public api.
+ *
+ * usage: add #include "e_string_private.h" to e_string source files only
+ */
+
+#ifndef E_STRING_PRIVATE_H
+#define E_STRING_PRIVATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "e_arena.h"
+#include "e_string.h"
+
+/* E_STRING_X86_SIMD
+ *
+ * defined when the compiler can build x86 SIMD kernels through target
+ * attributes, the kernels are only called after checking CPUID at runtime.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__GNUC__) || defined(__clang__))
+#define E_STRING_X86_SIMD 1
+#endif
+
+
+/* private function e_string_data_mut
+ *
+ * returns a writable pointer to the start of the data on any layout
+ */
+static inline uint8_t* e_string_data_mut(e_string_t* string)
+{
+    return ((string->flags & E_STRING_FLAG_INLINE) != 0)
+           ? string->inline_data : string->data;
+}
+
+/* private function e_string_set_ascii
+ *
+ * caches that a string is known to be valid US ASCII, so the codepoint count
+ * is the data length.
+ */
+static inline void e_string_set_ascii(e_string_t* string)
+{
+    const size_t length = e_string_length(string);
+    string->flags |= E_STRING_FLAG_UTF8 | E_STRING_FLAG_ASCII;
+    if (length <= UINT32_MAX) {
+        string->flags |= E_STRING_FLAG_COUNTED;
+        string->codepoint_count = (uint32_t)length;
+    }
+}
+
+/* private function e_string_set_length
+ *
+ * stores the length of the data on the current layout
+ */
+static inline void e_string_set_length(e_string_t* string, const size_t length)
+{
+    if ((string->flags & E_STRING_FLAG_INLINE) != 0) {
+        string->inline_length = (uint8_t)length;
+    } else {
+        string->data_length = length;
+    }
+}
+
+/* private function e_string_utf8_encode
+ *
+ * writes the UTF-8 encoding of codepoint on bytes and returns its length,
+ * codepoint must be a Unicode scalar value (checked by the caller).
+ */
+static inline size_t e_string_utf8_encode(const uint32_t codepoint,
+                                          uint8_t* bytes)
+{
+    if (codepoint < 0x80) {
+        bytes[0] = (uint8_t)codepoint;
+        return 1;
+    } else if (codepoint < 0x800) {
+        bytes[0] = (uint8_t)(0xC0 | (codepoint >> 6));
+        bytes[1] = (uint8_t)(0x80 | (codepoint & 0x3F));
+        return 2;
+    } else if (codepoint < 0x10000) {
+        bytes[0] = (uint8_t)(0xE0 | (codepoint >> 12));
+        bytes[1] = (uint8_t)(0x80 | ((codepoint >> 6) & 0x3F));
+        bytes[2] = (uint8_t)(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+    bytes[0] = (uint8_t)(0xF0 | (codepoint >> 18));
+    bytes[1] = (uint8_t)(0x80 | ((codepoint >> 12) & 0x3F));
+    bytes[2] = (uint8_t)(0x80 | ((codepoint >> 6) & 0x3F));
+    bytes[3] = (uint8_t)(0x80 | (codepoint & 0x3F));
+    return 4;
+}
+
+/* private tables e_string_digit_pairs and e_string_powers_of_10
+ *
+ * the decimal digit pairs 00 upto 99, and the powers of 10 that fit in 64
+ * bits, defined on e_string_from.c
+ */
+extern const char e_string_digit_pairs[201];
+extern const uint64_t e_string_powers_of_10[20];
+
+/* private function e_string_digits
+ *
+ * amount of decimal digits of number, without branches: the bit length times
+ * log10(2) (1233 / 4096) gives the digits up to one less, which is fixed by a
+ * single comparison against the power of 10 table. zero is counted as 1 as
+ * it is compared as 1.
+ */
+static inline size_t e_string_digits(const uint64_t number)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    const unsigned bits = 64 - (unsigned)__builtin_clzll(number | 1);
+#else
+    unsigned bits = 1;
+    while (bits < 64 && (number >> bits) != 0) {
+        bits += 1;
+    }
+#endif
+    const unsigned approx = (bits * 1233) >> 12;
+    return approx + ((number | 1) >= e_string_powers_of_10[approx]);
+}
+
+/* private function e_string_write_digits
+ *
+ * writes the digits of number ending right before end, two at a time
+ */
+static inline void e_string_write_digits(uint8_t* end, uint64_t number)
+{
+    while (number >= 100) {
+        const size_t pair = (size_t)(number % 100) * 2;
+        number /= 100;
+        end -= 2;
+        memcpy(end, e_string_digit_pairs + pair, 2);
+    }
+    if (number >= 10) {
+        end -= 2;
+        memcpy(end, e_string_digit_pairs + number * 2, 2);
+    } else {
+        end -= 1;
+        *end = (uint8_t)('0' + number);
+    }
+}
+
+/* private function e_string_multiply
+ *
+ * full 128bit product of a and b, as its high and low 64 bits
+ */
+static inline void e_string_multiply(const uint64_t a, const uint64_t b,
+                                     uint64_t* high, uint64_t* low)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 e_string_u128_t;
+    const e_string_u128_t product = (e_string_u128_t)a * b;
+    *high = (uint64_t)(product >> 64);
+    *low = (uint64_t)product;
+#else
+    const uint64_t a_high = a >> 32;
+    const uint64_t a_low = (uint32_t)a;
+    const uint64_t b_high = b >> 32;
+    const uint64_t b_low = (uint32_t)b;
+    const uint64_t middle_1 = a_high * b_low;
+    const uint64_t middle_2 = a_low * b_high;
+    const uint64_t low_low = a_low * b_low;
+    const uint64_t cross = (low_low >> 32) + (uint32_t)middle_1
+                           + (uint32_t)middle_2;
+    *low = (cross << 32) | (uint32_t)low_low;
+    *high = a_high * b_high + (middle_1 >> 32) + (middle_2 >> 32)
+            + (cross >> 32);
+#endif
+}
+
+/* private table e_string_pow10_table
+ *
+ * 10^k scaled by a power of 2 into [2^127, 2^128), rounded down and plus 1,
+ * as its high and low 64 bits, for k from E_STRING_POW10_MIN upto
+ * E_STRING_POW10_MAX. defined on e_string_pow10.c
+ */
+#define E_STRING_POW10_MIN -342
+#define E_STRING_POW10_MAX 326
+extern const uint64_t e_string_pow10_table[E_STRING_POW10_MAX
+                                           - E_STRING_POW10_MIN + 1][2];
+
+/* E_STRING_FLOAT_LENGTH
+ *
+ * bytes of the longest shortest text of a double, e_string_write_float
+ * never writes more.
+ */
+#define E_STRING_FLOAT_LENGTH 32
+
+/* private function e_string_write_float
+ *
+ * writes the shortest text of number (of float when single is true, which
+ * number then holds exactly) on output and returns its length
+ */
+size_t e_string_write_float(uint8_t* output, const double number,
+                            const bool single);
+
+/* private function e_string_allocate
+ *
+ * allocates memory with the allocator set by e_string_set_allocator
+ */
+void* e_string_allocate(const size_t size);
+
+/* private function e_string_reallocate
+ *
+ * resizes memory with the allocator set by e_string_set_allocator
+ */
+void* e_string_reallocate(void* memory, const size_t old_size,
+                          const size_t new_size);
+
+/* private function e_string_release
+ *
+ * releases memory with the allocator set by e_string_set_allocator
+ */
+void e_string_release(void* memory, const size_t size);
+
+/* private function e_string_with_length
+ *
+ * creates a e_string_t of length bytes with undefined data, inline when it
+ * fits. otherwise the data is taken from arena, or from the e_string allocator
+ * when arena is NULL. on allocation failure an empty string is returned.
+ */
+e_string_t e_string_with_length(e_arena_t* arena, const size_t length);
+
+/* private function e_string_from_bytes
+ *
+ * creates a e_string_t holding a copy of bytes, inline when it fits
+ */
+e_string_t e_string_from_bytes(e_arena_t* arena,
+                               const uint8_t* bytes,
+                               const size_t length);
+
+/* private function e_string_validate_utf8
+ *
+ * delegates UTF-8 validation of raw data to the given engine, this is the
+ * entry point for modules that validate data outside of an e_string_t.
+ *
+ * on success ascii tells if all the data is US ASCII, every engine below
+ * reports it the same way. ascii can be NULL if the caller does not need it.
+ */
+e_string_errno_t e_string_validate_utf8(const uint8_t* data,
+                                        const size_t length,
+                                        e_string_engine_t engine,
+                                        bool* ascii);
+
+/* private function e_string_validate_engine_available
+ *
+ * checks if the running CPU supports the instruction set of the engine
+ */
+bool e_string_validate_engine_available(const e_string_engine_t engine);
+
+/* private function e_string_utf8_count
+ *
+ * counts the codepoints of UTF-8 data as its non-continuation bytes, with
+ * the widest SIMD kernel supported by the running CPU.
+ */
+size_t e_string_utf8_count(const uint8_t* data, const size_t length);
+
+/* private function e_string_utf8_skip
+ *
+ * returns the offset of the codepoint that comes count codepoints after the
+ * start of UTF-8 data, or length if data has no more than count codepoints.
+ */
+size_t e_string_utf8_skip(const uint8_t* data, const size_t length,
+                          const size_t count);
+
+/* private function e_string_validate_utf8_offset
+ *
+ * returns the offset of the first invalid codepoint in data, or length if all
+ * the data is valid UTF-8.
+ */
+size_t e_string_validate_utf8_offset(const uint8_t* data, const size_t length);
+
+/* private function e_string_validate_utf8_scalar
+ *
+ * byte by byte validation based on e_string_utf8_is_* predicates, this is the
+ * reference implementation that all other engines must match.
+ */
+e_string_errno_t e_string_validate_utf8_scalar(const uint8_t* data,
+                                               const size_t length,
+                                               bool* ascii);
+
+/* private function e_string_validate_utf8_dfa
+ *
+ * branch-free validation with a single table load per byte, gives the same
+ * latency for any mix of scripts.
+ */
+e_string_errno_t e_string_validate_utf8_dfa(const uint8_t* data,
+                                            const size_t length,
+                                            bool* ascii);
+
+/* private function e_string_validate_utf8_dfa_run
+ *
+ * runs the automaton over data starting at the given state and returns the
+ * final state, used to carry partial sequences between chunks.
+ *   - E_STRING_DFA_ACCEPT: data ended on a codepoint boundary
+ *   - E_STRING_DFA_REJECT: invalid data found
+ *   - any other value: data ended in the middle of a valid sequence
+ */
+#define E_STRING_DFA_ACCEPT 0
+#define E_STRING_DFA_REJECT 6
+uint32_t e_string_validate_utf8_dfa_run(uint32_t state,
+                                        const uint8_t* data,
+                                        const size_t length);
+
+#ifdef E_STRING_X86_SIMD
+
+/* private function e_string_validate_utf8_sse42
+ *
+ * 16 bytes per step validation kernel, requires SSE4.2 at runtime.
+ */
+e_string_errno_t e_string_validate_utf8_sse42(const uint8_t* data,
+                                              const size_t length,
+                                              bool* ascii);
+
+/* private function e_string_validate_utf8_avx2
+ *
+ * 32 bytes per step validation kernel, requires AVX2 at runtime.
+ */
+e_string_errno_t e_string_validate_utf8_avx2(const uint8_t* data,
+                                             const size_t length,
+                                             bool* ascii);
+
+/* private function e_string_validate_utf8_avx512
+ *
+ * 64 bytes per step validation kernel, requires AVX-512 F and BW at runtime.
+ */
+e_string_errno_t e_string_validate_utf8_avx512(const uint8_t* data,
+                                               const size_t length,
+                                               bool* ascii);
+
+#endif /* E_STRING_X86_SIMD */
+
+#endif /* E_STRING_PRIVATE_H */
@@ -0,0 +1,722 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_sort implementation
+ *
+ * this module implements a most significant digit radix sort of strings on
+ * cached prefix keys.
+ *
+ * strings are not compared or moved while sorting: each one gets a record
+ * holding its index and a key, the 8 bytes of the string at the current
+ * depth loaded big endian (padded with zeros), so comparing keys compares
+ * 8 bytes of the strings at once. records are distributed on the bytes of
+ * the key, one byte per level, and:
+ *   - ranges of up to E_STRING_SORT_INSERTION records are insertion sorted
+ *   - ranges whose keys are all equal hold strings equal up to depth + 8:
+ *     the ones ending there come first (by length), and the others get the
+ *     keys of the next 8 bytes
+ *   - the largest bucket of a level is sorted by looping instead of
+ *     recursion, so the stack stays small even on long common prefixes
+ *
+ * records are distributed in place (American flag sort) by e_string_sort,
+ * and through a scratch array that keeps their order by the stable sorts.
+ *
+ * with more than one thread, the first levels are split on the calling
+ * thread until there are a few ranges per thread, and the threads then take
+ * the ranges largest first from a shared counter. the strings are moved to
+ * their place at the end, each once: copied in order by the threads when
+ * there is memory for a copy, or following the cycles of the permutation.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* without C11 threads (E_STRING_HAS_THREADS is set by the build where they
+ * exist) every sort runs on the calling thread */
+#if defined(E_STRING_HAS_THREADS) && !defined(__STDC_NO_THREADS__) \
+    && !defined(__STDC_NO_ATOMICS__)
+#define E_STRING_SORT_THREADS
+#include <stdatomic.h>
+#include <threads.h>
+#endif
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* ranges of up to this amount of records are insertion sorted */
+#define E_STRING_SORT_INSERTION 32
+
+/* ranges are split for threads while larger than this */
+#define E_STRING_SORT_PARALLEL_MIN 4096
+
+/* ranges split for each thread */
+#define E_STRING_SORT_TASKS_PER_THREAD 8
+
+/* strings a thread loads or copies at once */
+#define E_STRING_SORT_BLOCK ((size_t)1 << 16)
+
+/* threads used at most */
+#define E_STRING_SORT_MAX_THREADS 256
+
+/* bytes of a key, there is one level per byte */
+#define E_STRING_SORT_KEY_BYTES 8
+
+/* counter the threads take their work from */
+#if defined(E_STRING_SORT_THREADS)
+typedef atomic_size_t e_string_sort_counter_t;
+#else
+typedef size_t e_string_sort_counter_t;
+#endif
+
+
+/* e_string_sort_record struct
+ *
+ * a string being sorted
+ *
+ * PODs definition
+ *   - key: defines the 8 bytes of the string at the current depth
+ *   - index: defines the position of the string on the input
+ */
+typedef struct e_string_sort_record
+{
+    uint64_t key;
+    size_t index;
+} e_string_sort_record_t;
+
+/* e_string_sort_task struct
+ *
+ * a range of records equal on the bytes before depth + level
+ */
+typedef struct e_string_sort_task
+{
+    size_t start;
+    size_t count;
+    size_t depth;
+    unsigned level;
+} e_string_sort_task_t;
+
+/* e_string_sort_context struct
+ *
+ * the state shared by every thread of a sort
+ *
+ * PODs definition
+ *   - strings: defines the strings being sorted
+ *   - count: defines the amount of strings
+ *   - threads: defines the amount of threads sharing the work
+ *   - output: defines where the strings are copied in order
+ *   - records: defines a record for each string
+ *   - scratch: defines the records distributed by the stable sort, NULL
+ *     for the in place one
+ *   - tasks: defines the ranges left for the threads
+ *   - task_count: defines the amount of tasks
+ *   - next_task: defines the next task a thread takes
+ *   - next_block: defines the next block of records a thread loads
+ */
+typedef struct e_string_sort_context
+{
+    const e_string_t* strings;
+    size_t count;
+    size_t threads;
+    e_string_t* output;
+    e_string_sort_record_t* records;
+    e_string_sort_record_t* scratch;
+    e_string_sort_task_t* tasks;
+    size_t task_count;
+    e_string_sort_counter_t next_task;
+    e_string_sort_counter_t next_block;
+} e_string_sort_context_t;
+
+
+/* private function priv_key
+ *
+ * 8 bytes of string from depth as a big endian number, padded with zeros
+ */
+static inline uint64_t priv_key(const e_string_t* string, const size_t depth)
+{
+    const size_t length = e_string_length(string);
+    if (length <= depth) {
+        return 0;
+    }
+
+    const uint8_t* data = e_string_data(string) + depth;
+    uint64_t key = 0;
+    if (length - depth >= E_STRING_SORT_KEY_BYTES) {
+        memcpy(&key, data, sizeof(key));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        key = __builtin_bswap64(key);
+#endif
+        return key;
+    }
+    for (size_t i = 0; i < length - depth; i++) {
+        key |= (uint64_t)data[i] << (56 - 8 * i);
+    }
+    return key;
+}
+
+/* private function priv_compare
+ *
+ * order of the strings of two records equal on the bytes before depth
+ */
+static inline int priv_compare(const e_string_sort_context_t* context,
+                               const e_string_sort_record_t* a,
+                               const e_string_sort_record_t* b,
+                               const size_t depth)
+{
+    if (a->key != b->key) {
+        return (a->key < b->key) ? -1 : 1;
+    }
+
+    const e_string_t* first = &context->strings[a->index];
+    const e_string_t* second = &context->strings[b->index];
+    const size_t first_length = e_string_length(first);
+    const size_t second_length = e_string_length(second);
+    const size_t shortest = (first_length < second_length) ? first_length
+                                                           : second_length;
+    if (shortest > depth) {
+        const int order = memcmp(e_string_data(first) + depth,
+                                 e_string_data(second) + depth,
+                                 shortest - depth);
+        if (order != 0) {
+            return order;
+        }
+    }
+    return (first_length > second_length) - (first_length < second_length);
+}
+
+/* private function priv_insertion
+ *
+ * sorts count records from depth by insertion, keeping the order of equal
+ * strings
+ */
+static void priv_insertion(const e_string_sort_context_t* context,
+                           e_string_sort_record_t* records,
+                           const size_t count, const size_t depth)
+{
+    for (size_t i = 1; i < count; i++) {
+        const e_string_sort_record_t record = records[i];
+        size_t j = i;
+        while (j > 0 && priv_compare(context, &records[j - 1], &record,
+                                     depth) > 0) {
+            records[j] = records[j - 1];
+            j -= 1;
+        }
+        records[j] = record;
+    }
+}
+
+/* private function priv_distribute
+ *
+ * orders count records on the byte of the key at shift, storing on bounds
+ * where each of the 256 buckets starts (and bounds[256] = count). returns
+ * false without moving anything when every record is on the same bucket.
+ */
+static bool priv_distribute(const e_string_sort_context_t* context,
+                            e_string_sort_record_t* records,
+                            e_string_sort_record_t* scratch,
+                            const size_t count, const unsigned shift,
+                            size_t* bounds)
+{
+    size_t counts[256] = { 0 };
+    for (size_t i = 0; i < count; i++) {
+        counts[(records[i].key >> shift) & 0xFF] += 1;
+    }
+
+    size_t total = 0;
+    for (size_t b = 0; b < 256; b++) {
+        bounds[b] = total;
+        total += counts[b];
+        if (counts[b] == count) {
+            return false;
+        }
+    }
+    bounds[256] = count;
+
+    size_t next[256];
+    memcpy(next, bounds, sizeof(next));
+    if (context->scratch != NULL) {
+        for (size_t i = 0; i < count; i++) {
+            scratch[next[(records[i].key >> shift) & 0xFF]++] = records[i];
+        }
+        memcpy(records, scratch, count * sizeof(e_string_sort_record_t));
+        return true;
+    }
+
+    /* American flag sort: each record is swapped into its bucket */
+    for (size_t b = 0; b < 256; b++) {
+        while (next[b] < bounds[b + 1]) {
+            e_string_sort_record_t record = records[next[b]];
+            size_t bucket = (record.key >> shift) & 0xFF;
+            while (bucket != b) {
+                const e_string_sort_record_t other = records[next[bucket]];
+                records[next[bucket]++] = record;
+                record = other;
+                bucket = (record.key >> shift) & 0xFF;
+            }
+            records[next[b]++] = record;
+        }
+    }
+    return true;
+}
+
+/* private function priv_split_ended
+ *
+ * moves the strings of count records with equal keys that end before
+ * depth + 8 to the front, ordered by length, and loads the keys at
+ * depth + 8 for the others. returns the amount that ended.
+ */
+static size_t priv_split_ended(const e_string_sort_context_t* context,
+                               e_string_sort_record_t* records,
+                               e_string_sort_record_t* scratch,
+                               const size_t count, const size_t depth)
+{
+    /* keys are reused: the length past depth for the strings that end,
+     * 9 for the others, which are then after them */
+    for (size_t i = 0; i < count; i++) {
+        const size_t length = e_string_length(
+            &context->strings[records[i].index]);
+        records[i].key = (length - depth <= E_STRING_SORT_KEY_BYTES)
+                         ? length - depth : E_STRING_SORT_KEY_BYTES + 1;
+    }
+    size_t bounds[257];
+    priv_distribute(context, records, scratch, count, 0, bounds);
+
+    size_t ended = 0;
+    while (ended < count && records[ended].key <= E_STRING_SORT_KEY_BYTES) {
+        ended += 1;
+    }
+    for (size_t i = ended; i < count; i++) {
+        records[i].key = priv_key(&context->strings[records[i].index],
+                                  depth + E_STRING_SORT_KEY_BYTES);
+    }
+    return ended;
+}
+
+/* private function priv_step
+ *
+ * sorts the records of task one level further, storing on subtasks the
+ * ranges that still need to be sorted. returns the amount of subtasks.
+ */
+static size_t priv_step(const e_string_sort_context_t* context,
+                        const e_string_sort_task_t task,
+                        e_string_sort_task_t* subtasks)
+{
+    e_string_sort_record_t* records = context->records + task.start;
+    e_string_sort_record_t* scratch = (context->scratch != NULL)
+                                      ? context->scratch + task.start : NULL;
+    if (task.count <= E_STRING_SORT_INSERTION) {
+        priv_insertion(context, records, task.count, task.depth);
+        return 0;
+    }
+
+    /* the bytes every key agrees on are skipped without distributing */
+    uint64_t differ = 0;
+    for (size_t i = 1; i < task.count; i++) {
+        differ |= records[i].key ^ records[0].key;
+    }
+    unsigned level = task.level;
+    while (level < E_STRING_SORT_KEY_BYTES
+           && ((differ >> (56 - 8 * level)) & 0xFF) == 0) {
+        level += 1;
+    }
+
+    if (level == E_STRING_SORT_KEY_BYTES) {
+        const size_t ended = priv_split_ended(context, records, scratch,
+                                              task.count, task.depth);
+        const e_string_sort_task_t next = {
+            .start = task.start + ended,
+            .count = task.count - ended,
+            .depth = task.depth + E_STRING_SORT_KEY_BYTES,
+            .level = 0
+        };
+        subtasks[0] = next;
+        return (next.count > 1) ? 1 : 0;
+    }
+
+    size_t bounds[257];
+    priv_distribute(context, records, scratch, task.count, 56 - 8 * level,
+                    bounds);
+
+    size_t amount = 0;
+    for (size_t b = 0; b < 256; b++) {
+        if (bounds[b + 1] - bounds[b] > 1) {
+            const e_string_sort_task_t next = {
+                .start = task.start + bounds[b],
+                .count = bounds[b + 1] - bounds[b],
+                .depth = task.depth,
+                .level = level + 1
+            };
+            subtasks[amount++] = next;
+        }
+    }
+    return amount;
+}
+
+/* private function priv_sort_task
+ *
+ * sorts the records of task, recursing on every range but the largest
+ */
+static void priv_sort_task(const e_string_sort_context_t* context,
+                           e_string_sort_task_t task)
+{
+    e_string_sort_task_t subtasks[256];
+    for (;;) {
+        const size_t amount = priv_step(context, task, subtasks);
+        if (amount == 0) {
+            return;
+        }
+
+        size_t largest = 0;
+        for (size_t i = 1; i < amount; i++) {
+            if (subtasks[i].count > subtasks[largest].count) {
+                largest = i;
+            }
+        }
+        for (size_t i = 0; i < amount; i++) {
+            if (i != largest) {
+                priv_sort_task(context, subtasks[i]);
+            }
+        }
+        task = subtasks[largest];
+    }
+}
+
+/* private function priv_compare_tasks
+ *
+ * qsort order of tasks, largest first
+ */
+static int priv_compare_tasks(const void* a, const void* b)
+{
+    const size_t first = ((const e_string_sort_task_t*)a)->count;
+    const size_t second = ((const e_string_sort_task_t*)b)->count;
+    return (first < second) - (first > second);
+}
+
+/* private function priv_split
+ *
+ * splits the largest tasks of context until there are target of them or
+ * they are small. tasks must have room for target + 255 tasks.
+ */
+static void priv_split(e_string_sort_context_t* context, const size_t target)
+{
+    e_string_sort_task_t subtasks[256];
+    while (context->task_count > 0 && context->task_count < target) {
+        size_t largest = 0;
+        for (size_t i = 1; i < context->task_count; i++) {
+            if (context->tasks[i].count > context->tasks[largest].count) {
+                largest = i;
+            }
+        }
+        const e_string_sort_task_t task = context->tasks[largest];
+        if (task.count < E_STRING_SORT_PARALLEL_MIN) {
+            break;
+        }
+
+        const size_t amount = priv_step(context, task, subtasks);
+        context->tasks[largest] = context->tasks[--context->task_count];
+        for (size_t i = 0; i < amount; i++) {
+            context->tasks[context->task_count++] = subtasks[i];
+        }
+    }
+    qsort(context->tasks, context->task_count, sizeof(e_string_sort_task_t),
+          priv_compare_tasks);
+}
+
+/* private function priv_reset
+ *
+ * sets counter to 0, before the threads sharing it are started
+ */
+static inline void priv_reset(e_string_sort_counter_t* counter)
+{
+#if defined(E_STRING_SORT_THREADS)
+    atomic_init(counter, 0);
+#else
+    *counter = 0;
+#endif
+}
+
+/* private function priv_take
+ *
+ * returns counter and adds amount to it, at once for every thread
+ */
+static inline size_t priv_take(e_string_sort_counter_t* counter,
+                               const size_t amount)
+{
+#if defined(E_STRING_SORT_THREADS)
+    return atomic_fetch_add(counter, amount);
+#else
+    const size_t value = *counter;
+    *counter += amount;
+    return value;
+#endif
+}
+
+/* private function priv_load
+ *
+ * thread body making the records of blocks of E_STRING_SORT_BLOCK strings
+ */
+static int priv_load(void* argument)
+{
+    e_string_sort_context_t* context = argument;
+    for (;;) {
+        const size_t start = priv_take(&context->next_block,
+                                       E_STRING_SORT_BLOCK);
+        if (start >= context->count) {
+            return 0;
+        }
+        const size_t end = (context->count - start > E_STRING_SORT_BLOCK)
+                           ? start + E_STRING_SORT_BLOCK : context->count;
+        for (size_t i = start; i < end; i++) {
+            context->records[i].key = priv_key(&context->strings[i], 0);
+            context->records[i].index = i;
+        }
+    }
+}
+
+/* private function priv_work
+ *
+ * thread body sorting the tasks of context
+ */
+static int priv_work(void* argument)
+{
+    e_string_sort_context_t* context = argument;
+    for (;;) {
+        const size_t task = priv_take(&context->next_task, 1);
+        if (task >= context->task_count) {
+            return 0;
+        }
+        priv_sort_task(context, context->tasks[task]);
+    }
+}
+
+/* private function priv_gather
+ *
+ * thread body copying blocks of the strings to output in sorted order
+ */
+static int priv_gather(void* argument)
+{
+    e_string_sort_context_t* context = argument;
+    for (;;) {
+        const size_t start = priv_take(&context->next_block,
+                                       E_STRING_SORT_BLOCK);
+        if (start >= context->count) {
+            return 0;
+        }
+        const size_t end = (context->count - start > E_STRING_SORT_BLOCK)
+                           ? start + E_STRING_SORT_BLOCK : context->count;
+        for (size_t i = start; i < end; i++) {
+            context->output[i] = context->strings[context->records[i].index];
+        }
+    }
+}
+
+/* private function priv_run
+ *
+ * runs body on threads - 1 new threads and on the calling one, a thread
+ * that can not be created leaves its work to the others
+ */
+static void priv_run(int (*body)(void*), e_string_sort_context_t* context)
+{
+#if defined(E_STRING_SORT_THREADS)
+    thrd_t workers[E_STRING_SORT_MAX_THREADS];
+    size_t started = 0;
+    for (size_t t = 1; t < context->threads; t++) {
+        if (thrd_create(&workers[started], body, context) == thrd_success) {
+            started += 1;
+        }
+    }
+    body(context);
+    for (size_t t = 0; t < started; t++) {
+        thrd_join(workers[t], NULL);
+    }
+#else
+    body(context);
+#endif
+}
+
+/* private function priv_sort_records
+ *
+ * sorts the records of context, with one record for each string
+ */
+static e_string_errno_t priv_sort_records(e_string_sort_context_t* context)
+{
+    const size_t task_capacity = context->threads
+                                 * E_STRING_SORT_TASKS_PER_THREAD + 256;
+    context->tasks = e_string_allocate(task_capacity
+                                       * sizeof(e_string_sort_task_t));
+    if (context->tasks == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    priv_reset(&context->next_block);
+    priv_run(priv_load, context);
+
+    const e_string_sort_task_t all = { .start = 0, .count = context->count };
+    context->tasks[0] = all;
+    context->task_count = 1;
+    if (context->threads > 1) {
+        priv_split(context,
+                   context->threads * E_STRING_SORT_TASKS_PER_THREAD);
+    }
+    priv_reset(&context->next_task);
+    priv_run(priv_work, context);
+
+    e_string_release(context->tasks,
+                     task_capacity * sizeof(e_string_sort_task_t));
+    context->tasks = NULL;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_prepare
+ *
+ * prepares context to sort count strings on threads threads, allocating
+ * the records and the scratch of the stable order
+ */
+static e_string_errno_t priv_prepare(e_string_sort_context_t* context,
+                                     const e_string_t* strings,
+                                     const size_t count, size_t threads,
+                                     const bool stable)
+{
+    if (count > SIZE_MAX / (2 * sizeof(e_string_t))) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    threads = (threads == 0) ? 1 : threads;
+    threads = (threads > E_STRING_SORT_MAX_THREADS)
+              ? E_STRING_SORT_MAX_THREADS : threads;
+#if !defined(E_STRING_SORT_THREADS)
+    threads = 1;
+#endif
+    const e_string_sort_context_t empty = {
+        .strings = strings,
+        .count = count,
+        .threads = (count < E_STRING_SORT_PARALLEL_MIN) ? 1 : threads
+    };
+    *context = empty;
+
+    const size_t size = count * sizeof(e_string_sort_record_t);
+    context->records = e_string_allocate(size);
+    context->scratch = (stable == true) ? e_string_allocate(size) : NULL;
+    if (context->records == NULL
+        || (stable == true && context->scratch == NULL)) {
+        e_string_release(context->records, size);
+        e_string_release(context->scratch, size);
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_permute
+ *
+ * moves each string to its place without extra memory: position i takes
+ * the string of records[i], following each cycle of the permutation and
+ * marking the positions done
+ */
+static void priv_permute(e_string_t* strings,
+                         e_string_sort_record_t* records, const size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].index == i) {
+            continue;
+        }
+        const e_string_t first = strings[i];
+        size_t position = i;
+        for (;;) {
+            const size_t source = records[position].index;
+            records[position].index = position;
+            if (source == i) {
+                strings[position] = first;
+                break;
+            }
+            strings[position] = strings[source];
+            position = source;
+        }
+    }
+}
+
+/* private function priv_sort_strings
+ *
+ * sorts strings, moving each one once to its place
+ */
+static e_string_errno_t priv_sort_strings(e_string_t* strings,
+                                          const size_t count,
+                                          const size_t threads,
+                                          const bool stable)
+{
+    if (count < 2) {
+        return E_STRING_SUCCESS;
+    }
+
+    e_string_sort_context_t context;
+    if (priv_prepare(&context, strings, count, threads, stable)
+        != E_STRING_SUCCESS) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    const size_t size = count * sizeof(e_string_sort_record_t);
+    const e_string_errno_t result = priv_sort_records(&context);
+    e_string_release(context.scratch, size);
+    if (result != E_STRING_SUCCESS) {
+        e_string_release(context.records, size);
+        return result;
+    }
+
+    /* copying the strings in order is faster than following the cycles,
+     * and shared by the threads, when there is memory for a copy */
+    context.output = e_string_allocate(count * sizeof(e_string_t));
+    if (context.output != NULL) {
+        priv_reset(&context.next_block);
+        priv_run(priv_gather, &context);
+        memcpy(strings, context.output, count * sizeof(e_string_t));
+        e_string_release(context.output, count * sizeof(e_string_t));
+    } else {
+        priv_permute(strings, context.records, count);
+    }
+    e_string_release(context.records, size);
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_sort(e_string_t* strings, const size_t count,
+                               const size_t threads)
+{
+    return priv_sort_strings(strings, count, threads, false);
+}
+
+
+e_string_errno_t e_string_sort_stable(e_string_t* strings, const size_t count,
+                                      const size_t threads)
+{
+    return priv_sort_strings(strings, count, threads, true);
+}
+
+
+e_string_errno_t e_string_sort_indices(const e_string_t* strings,
+                                       const size_t count, size_t* indices,
+                                       const size_t threads)
+{
+    if (count == 0) {
+        return E_STRING_SUCCESS;
+    }
+
+    e_string_sort_context_t context;
+    if (priv_prepare(&context, strings, count, threads, true)
+        != E_STRING_SUCCESS) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    const size_t size = count * sizeof(e_string_sort_record_t);
+    const e_string_errno_t result = priv_sort_records(&context);
+    if (result == E_STRING_SUCCESS) {
+        for (size_t i = 0; i < count; i++) {
+            indices[i] = context.records[i].index;
+        }
+    }
+    e_string_release(context.records, size);
+    e_string_release(context.scratch, size);
+    return result;
+}
@@ -0,0 +1,493 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_table implementation
+ *
+ * this module implements a packed column of strings: one blob for the
+ * bytes and one array for the offsets, both growing by doubling.
+ *
+ * offsets are 32bit while the blob is below 4 GiB, which is the common case
+ * and halves their memory, and are widened once to 64bit when it grows
+ * past it.
+ *
+ * the serialized form is the memory of the table itself behind a header, so
+ * a serialized table can be used where it lies (a buffer, a mmapped file)
+ * after checking its structure. such a table is borrowed, and it is copied
+ * to memory of its own on the first change.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <errno.h>
+#include <unistd.h>
+#define E_STRING_TABLE_POSIX 1
+#endif
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* "ESTABLE1" read on a little endian machine */
+#define E_STRING_TABLE_MAGIC 0x31454C4241545345ULL
+
+/* offsets and capacity of a table on its first append */
+#define E_STRING_TABLE_MIN_OFFSETS 64
+#define E_STRING_TABLE_MIN_DATA    1024
+
+/* cached flags kept by the table */
+#define E_STRING_TABLE_FLAGS (E_STRING_FLAG_UTF8 | E_STRING_FLAG_ASCII)
+
+
+/* e_string_table_header struct
+ *
+ * the first bytes of a serialized table
+ *
+ * PODs definition
+ *   - magic: defines E_STRING_TABLE_MAGIC, which also tells the byte order
+ *   - offset_width: defines the bytes of each offset, 4 or 8
+ *   - reserved: defines 0
+ *   - count: defines the amount of strings, there are count + 1 offsets
+ *   - data_length: defines the bytes of the blob after the offsets
+ */
+typedef struct e_string_table_header
+{
+    uint64_t magic;
+    uint32_t offset_width;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t data_length;
+} e_string_table_header_t;
+
+/* private function priv_offset
+ *
+ * offset i of table
+ */
+static inline size_t priv_offset(const e_string_table_t* table,
+                                 const size_t i)
+{
+    if (table->offset_width == sizeof(uint32_t)) {
+        return ((const uint32_t*)table->offsets)[i];
+    }
+    return (size_t)((const uint64_t*)table->offsets)[i];
+}
+
+/* private function priv_offsets_size
+ *
+ * bytes of the count + 1 offsets of table as serialized, padded to 8
+ */
+static inline size_t priv_offsets_size(const e_string_table_t* table)
+{
+    const size_t size = (table->count + 1) * table->offset_width;
+    return (size + 7) & ~(size_t)7;
+}
+
+/* private function priv_own
+ *
+ * copies the borrowed memory of table into memory of its own
+ */
+static e_string_errno_t priv_own(e_string_table_t* table)
+{
+    const size_t offsets_size = (table->count + 1) * table->offset_width;
+    void* offsets = e_string_allocate(offsets_size);
+    uint8_t* data = e_string_allocate((table->data_length > 0)
+                                      ? table->data_length : 1);
+    if (offsets == NULL || data == NULL) {
+        e_string_release(offsets, offsets_size);
+        e_string_release(data, (table->data_length > 0)
+                               ? table->data_length : 1);
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    memcpy(offsets, table->offsets, offsets_size);
+    if (table->data_length > 0) {
+        memcpy(data, table->data, table->data_length);
+    }
+    table->offsets = offsets;
+    table->offset_capacity = table->count + 1;
+    table->data = data;
+    table->data_capacity = (table->data_length > 0) ? table->data_length : 1;
+    table->borrowed = false;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_widen
+ *
+ * turns the 32bit offsets of table into 64bit ones
+ */
+static e_string_errno_t priv_widen(e_string_table_t* table)
+{
+    uint64_t* offsets = e_string_allocate(table->offset_capacity
+                                          * sizeof(uint64_t));
+    if (offsets == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    const uint32_t* narrow = table->offsets;
+    for (size_t i = 0; i <= table->count; i++) {
+        offsets[i] = narrow[i];
+    }
+    e_string_release(table->offsets,
+                     table->offset_capacity * sizeof(uint32_t));
+    table->offsets = offsets;
+    table->offset_width = sizeof(uint64_t);
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_grow_offsets
+ *
+ * makes room for at least capacity offsets, at least doubling them
+ */
+static e_string_errno_t priv_grow_offsets(e_string_table_t* table,
+                                          const size_t capacity)
+{
+    if (capacity <= table->offset_capacity) {
+        return E_STRING_SUCCESS;
+    }
+
+    size_t new_capacity = (table->offset_capacity < E_STRING_TABLE_MIN_OFFSETS)
+                          ? E_STRING_TABLE_MIN_OFFSETS
+                          : table->offset_capacity * 2;
+    if (new_capacity < capacity) {
+        new_capacity = capacity;
+    }
+    if (new_capacity > SIZE_MAX / table->offset_width) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    void* offsets = e_string_reallocate(table->offsets,
+                                        table->offset_capacity
+                                        * table->offset_width,
+                                        new_capacity * table->offset_width);
+    if (offsets == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    if (table->offset_capacity == 0) {
+        memset(offsets, 0, table->offset_width);
+    }
+    table->offsets = offsets;
+    table->offset_capacity = new_capacity;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_grow_data
+ *
+ * makes room for at least capacity bytes of data, at least doubling them
+ */
+static e_string_errno_t priv_grow_data(e_string_table_t* table,
+                                       const size_t capacity)
+{
+    if (capacity <= table->data_capacity) {
+        return E_STRING_SUCCESS;
+    }
+
+    size_t new_capacity = (table->data_capacity < E_STRING_TABLE_MIN_DATA)
+                          ? E_STRING_TABLE_MIN_DATA
+                          : (table->data_capacity > SIZE_MAX / 2)
+                            ? SIZE_MAX : table->data_capacity * 2;
+    if (new_capacity < capacity) {
+        new_capacity = capacity;
+    }
+    uint8_t* data = e_string_reallocate(table->data, table->data_capacity,
+                                        new_capacity);
+    if (data == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    table->data = data;
+    table->data_capacity = new_capacity;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_prepare
+ *
+ * makes room for count more strings holding bytes more bytes, owning the
+ * memory and widening the offsets when needed
+ */
+static e_string_errno_t priv_prepare(e_string_table_t* table,
+                                     const size_t count, const size_t bytes)
+{
+    if (table->borrowed == true && priv_own(table) != E_STRING_SUCCESS) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    if (count > SIZE_MAX - table->count - 1
+        || bytes > SIZE_MAX - table->data_length) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    if (table->offset_width == sizeof(uint32_t)
+        && table->data_length + bytes > UINT32_MAX) {
+        if (table->offset_capacity == 0) {
+            table->offset_width = sizeof(uint64_t);
+        } else if (priv_widen(table) != E_STRING_SUCCESS) {
+            return E_STRING_OUT_OF_MEMORY;
+        }
+    }
+    if (priv_grow_offsets(table, table->count + count + 1)
+            != E_STRING_SUCCESS
+        || priv_grow_data(table, table->data_length + bytes)
+            != E_STRING_SUCCESS) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_write_all
+ *
+ * writes length bytes of data on fd, continuing after partial writes
+ */
+#ifdef E_STRING_TABLE_POSIX
+static e_string_errno_t priv_write_all(const int fd, const uint8_t* data,
+                                       size_t length)
+{
+    while (length > 0) {
+        const ssize_t written = write(fd, data, length);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written <= 0) {
+            return E_STRING_IO_ERROR;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return E_STRING_SUCCESS;
+}
+#endif
+
+/* private function priv_header
+ *
+ * header of the serialized table
+ */
+static e_string_table_header_t priv_header(const e_string_table_t* table)
+{
+    const e_string_table_header_t header = {
+        .magic = E_STRING_TABLE_MAGIC,
+        .offset_width = table->offset_width,
+        .reserved = 0,
+        .count = table->count,
+        .data_length = table->data_length
+    };
+    return header;
+}
+
+
+void e_string_table_init(e_string_table_t* table)
+{
+    const e_string_table_t empty = {
+        .offset_width = sizeof(uint32_t),
+        .flags = E_STRING_TABLE_FLAGS
+    };
+    *table = empty;
+}
+
+
+void e_string_table_free(e_string_table_t* table)
+{
+    if (table->borrowed == false) {
+        e_string_release(table->data, table->data_capacity);
+        e_string_release(table->offsets,
+                         table->offset_capacity * table->offset_width);
+    }
+    e_string_table_init(table);
+}
+
+
+e_string_errno_t e_string_table_reserve(e_string_table_t* table,
+                                        const size_t count,
+                                        const size_t bytes)
+{
+    return priv_prepare(table, count, bytes);
+}
+
+
+e_string_errno_t e_string_table_append_view(e_string_table_t* table,
+                                            const e_string_view_t view)
+{
+    const uint8_t* data = view.data;
+    if (table->count + 1 >= table->offset_capacity
+        || view.length > table->data_capacity - table->data_length
+        || (table->offset_width == sizeof(uint32_t)
+            && view.length > UINT32_MAX - table->data_length)
+        || table->borrowed == true) {
+        /* view can be a string of table itself, so it is moved along with
+         * the data when growing */
+        const uintptr_t old_data = (uintptr_t)table->data;
+        const uintptr_t address = (uintptr_t)view.data;
+        const bool inside = view.length > 0 && address >= old_data
+                            && address - old_data < table->data_length;
+        const e_string_errno_t result = priv_prepare(table, 1, view.length);
+        if (result != E_STRING_SUCCESS) {
+            return result;
+        }
+        if (inside == true) {
+            data = table->data + (address - old_data);
+        }
+    }
+
+    if (view.length > 0) {
+        memcpy(table->data + table->data_length, data, view.length);
+    }
+    table->data_length += view.length;
+    table->count += 1;
+    if (table->offset_width == sizeof(uint32_t)) {
+        ((uint32_t*)table->offsets)[table->count] =
+            (uint32_t)table->data_length;
+    } else {
+        ((uint64_t*)table->offsets)[table->count] = table->data_length;
+    }
+    table->flags &= view.flags;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_table_append(e_string_table_t* table,
+                                       const e_string_t* string)
+{
+    return e_string_table_append_view(table, e_string_view(string));
+}
+
+
+e_string_errno_t e_string_table_validate(e_string_table_t* table)
+{
+    if ((table->flags & E_STRING_FLAG_UTF8) != 0) {
+        return E_STRING_SUCCESS;
+    }
+
+    bool ascii = false;
+    const e_string_errno_t result = e_string_validate_utf8(
+        table->data, table->data_length, E_STRING_ENGINE_AUTO, &ascii);
+    if (result != E_STRING_SUCCESS) {
+        return result;
+    }
+
+    /* on ASCII data every byte starts a codepoint */
+    if (ascii == false) {
+        for (size_t i = 0; i < table->count; i++) {
+            const size_t start = priv_offset(table, i);
+            if (start < table->data_length
+                && (table->data[start] & 0xC0) == 0x80) {
+                return E_STRING_INVALID_UTF8;
+            }
+        }
+    }
+    table->flags |= E_STRING_FLAG_UTF8 | (ascii ? E_STRING_FLAG_ASCII : 0);
+    return E_STRING_SUCCESS;
+}
+
+
+size_t e_string_table_serialized_length(const e_string_table_t* table)
+{
+    return sizeof(e_string_table_header_t) + priv_offsets_size(table)
+           + table->data_length;
+}
+
+
+e_string_errno_t e_string_table_serialize(const e_string_table_t* table,
+                                          uint8_t* buffer,
+                                          const size_t capacity,
+                                          size_t* length)
+{
+    *length = e_string_table_serialized_length(table);
+    if (*length > capacity) {
+        return E_STRING_OUT_OF_RANGE;
+    }
+
+    const e_string_table_header_t header = priv_header(table);
+    memcpy(buffer, &header, sizeof(header));
+    buffer += sizeof(header);
+
+    /* an empty table has no offsets yet, its only offset is 0 */
+    const size_t offsets_size = priv_offsets_size(table);
+    memset(buffer, 0, offsets_size);
+    if (table->offsets != NULL) {
+        memcpy(buffer, table->offsets, (table->count + 1)
+                                       * table->offset_width);
+    }
+    buffer += offsets_size;
+    if (table->data_length > 0) {
+        memcpy(buffer, table->data, table->data_length);
+    }
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_table_write(const e_string_table_t* table,
+                                      const int fd)
+{
+#ifdef E_STRING_TABLE_POSIX
+    const e_string_table_header_t header = priv_header(table);
+    const uint8_t zeros[8] = { 0 };
+    const size_t offsets_size = (table->count + 1) * table->offset_width;
+    const uint8_t* offsets = (table->offsets != NULL) ? table->offsets
+                                                      : zeros;
+    if (priv_write_all(fd, (const uint8_t*)&header, sizeof(header))
+            != E_STRING_SUCCESS
+        || priv_write_all(fd, offsets, offsets_size) != E_STRING_SUCCESS
+        || priv_write_all(fd, zeros, priv_offsets_size(table) - offsets_size)
+            != E_STRING_SUCCESS
+        || priv_write_all(fd, table->data, table->data_length)
+            != E_STRING_SUCCESS) {
+        return E_STRING_IO_ERROR;
+    }
+    return E_STRING_SUCCESS;
+#else
+    (void)table;
+    (void)fd;
+    return E_STRING_IO_ERROR;
+#endif
+}
+
+
+e_string_errno_t e_string_table_deserialize(e_string_table_t* table,
+                                            const void* memory,
+                                            const size_t length)
+{
+    e_string_table_header_t header;
+    if (memory == NULL || ((uintptr_t)memory & 7) != 0
+        || length < sizeof(header)) {
+        return E_STRING_INVALID_BUFFER;
+    }
+    memcpy(&header, memory, sizeof(header));
+    if (header.magic != E_STRING_TABLE_MAGIC
+        || (header.offset_width != sizeof(uint32_t)
+            && header.offset_width != sizeof(uint64_t))
+        || header.count >= (length - sizeof(header)) / header.offset_width
+        || header.data_length > length) {
+        return E_STRING_INVALID_BUFFER;
+    }
+
+    e_string_table_t result = {
+        .data_length = (size_t)header.data_length,
+        .offsets = (uint8_t*)memory + sizeof(header),
+        .count = (size_t)header.count,
+        .offset_width = header.offset_width,
+        .flags = 0,
+        .borrowed = true
+    };
+    const size_t offsets_size = priv_offsets_size(&result);
+    if (offsets_size > length - sizeof(header)
+        || length - sizeof(header) - offsets_size != result.data_length) {
+        return E_STRING_INVALID_BUFFER;
+    }
+    result.data = (uint8_t*)memory + sizeof(header) + offsets_size;
+    result.data_capacity = result.data_length;
+    result.offset_capacity = result.count + 1;
+
+    /* offsets go from 0 to the end of the blob without going back */
+    size_t previous = 0;
+    for (size_t i = 0; i <= result.count; i++) {
+        const size_t offset = priv_offset(&result, i);
+        if (offset < previous || (i == 0 && offset != 0)) {
+            return E_STRING_INVALID_BUFFER;
+        }
+        previous = offset;
+    }
+    if (previous != result.data_length) {
+        return E_STRING_INVALID_BUFFER;
+    }
+    *table = result;
+    return E_STRING_SUCCESS;
+}
@@ -0,0 +1,733 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_to_number implementation
+ *
+ * this module implements the parsers of numbers written on e_string_t and
+ * e_string_view_t, which read length delimited data in place: no NUL, no
+ * copy and no locale.
+ *
+ * digits are read 8 at a time when the data allows it: the 8 bytes are
+ * loaded as a single 64bit word, checked to all be digits with two masks
+ * (SWAR), and turned into their value with three multiplications.
+ *
+ * doubles are read as a 64bit decimal significand w (the first 19 digits)
+ * and a decimal exponent q, then:
+ *   - when w and 10^q are both exact doubles, w * 10^q or w / 10^-q is
+ *     already correctly rounded (Clinger fast path)
+ *   - otherwise w is multiplied by the 128bit truncation of 5^q from the
+ *     table of e_string_pow10.c, which is always precise enough to round
+ *     correctly (Eisel-Lemire, as shown by Mushtak and Lemire)
+ *   - when more than 19 digits are given, w and w + 1 bound the value. if
+ *     they round differently, the digits are compared against the point
+ *     halfway between both candidates with big integers.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <float.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* significant digits always held by a uint64_t */
+#define E_STRING_TO_DIGITS 19
+
+/* bits of the fraction and exponent bias of double */
+#define E_STRING_TO_FRACTION 52
+#define E_STRING_TO_BIAS     1023
+#define E_STRING_TO_INFINITE 0x7FF
+
+/* decimal exponents read exactly by the Clinger fast path */
+#define E_STRING_TO_EXACT_POWER 22
+
+/* decimal exponents of the powers of 5 that are rounded up on the table */
+#define E_STRING_TO_ROUNDED_UP -27
+
+/* decimal exponents where a halfway product can be exact */
+#define E_STRING_TO_EVEN_MIN -4
+#define E_STRING_TO_EVEN_MAX 23
+
+/* digits kept by the slow path, more digits can not move a halfway point */
+#define E_STRING_TO_BIG_DIGITS 768
+
+/* 64bit limbs of the big integers of the slow path */
+#define E_STRING_TO_BIG_LIMBS 64
+
+/* largest power of 5 that fits in 64 bits */
+#define E_STRING_TO_POW5_27 7450580596923828125ULL
+
+
+/* e_string_decimal struct
+ *
+ * the parts of a decimal number found on the data
+ *
+ * PODs definition
+ *   - w: defines the first E_STRING_TO_DIGITS significant digits
+ *   - q: defines the power of 10 of the last digit of w
+ *   - exponent: defines the power of 10 of the last digit of the data
+ *   - integer_start, integer_end: defines the digits before the point
+ *   - fraction_start, fraction_end: defines the digits after the point
+ *   - negative: defines if a minus sign was found
+ *   - truncated: defines if there are more digits than w holds
+ */
+typedef struct e_string_decimal
+{
+    uint64_t w;
+    int64_t q;
+    int64_t exponent;
+    size_t integer_start;
+    size_t integer_end;
+    size_t fraction_start;
+    size_t fraction_end;
+    bool negative;
+    bool truncated;
+} e_string_decimal_t;
+
+/* e_string_big struct
+ *
+ * an unsigned big integer of the slow path, least significant limb first
+ */
+typedef struct e_string_big
+{
+    uint64_t limbs[E_STRING_TO_BIG_LIMBS];
+    size_t count;
+} e_string_big_t;
+
+/* private table of the powers of 10 that are exact doubles */
+static const double e_string_exact_powers[E_STRING_TO_EXACT_POWER + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+/* private function priv_read64
+ *
+ * reads 8 bytes as a little endian word
+ */
+static inline uint64_t priv_read64(const uint8_t* data)
+{
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+/* private function priv_is_eight_digits
+ *
+ * checks if the 8 bytes of word are all ASCII digits: the high nibbles
+ * must be 3, and must stay 3 after adding 6 to every byte
+ */
+static inline bool priv_is_eight_digits(const uint64_t word)
+{
+    return ((word & 0xF0F0F0F0F0F0F0F0ULL)
+            | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL)
+               >> 4)) == 0x3333333333333333ULL;
+}
+
+/* private function priv_eight_digits
+ *
+ * value of the 8 digits of word, the first digit on the lowest byte: pairs,
+ * then groups of 4, then the whole number are joined by multiplications
+ */
+static inline uint64_t priv_eight_digits(uint64_t word)
+{
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t multiplier_1 = 100 + (1000000ULL << 32);
+    const uint64_t multiplier_2 = 1 + (10000ULL << 32);
+    word -= 0x3030303030303030ULL;
+    word = (word * 10) + (word >> 8);
+    word = (((word & mask) * multiplier_1)
+            + (((word >> 16) & mask) * multiplier_2)) >> 32;
+    return word;
+}
+
+/* private function priv_is_digit
+ *
+ * checks if byte is an ASCII digit
+ */
+static inline bool priv_is_digit(const uint8_t byte)
+{
+    return (uint8_t)(byte - '0') < 10;
+}
+
+/* private function priv_scan_digits
+ *
+ * adds to value (which wraps around) the digits of data from start, and
+ * returns the index after the last one
+ */
+static inline size_t priv_scan_digits(const uint8_t* data, const size_t length,
+                                      size_t start, uint64_t* value)
+{
+    uint64_t result = *value;
+    while (start + 8 <= length && priv_is_eight_digits(priv_read64(data + start))) {
+        result = result * 100000000ULL
+                 + priv_eight_digits(priv_read64(data + start));
+        start += 8;
+    }
+    while (start < length && priv_is_digit(data[start]) == true) {
+        result = result * 10 + (uint64_t)(data[start] - '0');
+        start += 1;
+    }
+    *value = result;
+    return start;
+}
+
+/* private function priv_parse_unsigned
+ *
+ * reads the digits of data from start upto the end as a uint64_t
+ */
+static e_string_errno_t priv_parse_unsigned(const uint8_t* data,
+                                            const size_t length, size_t start,
+                                            uint64_t* number)
+{
+    if (start == length) {
+        return E_STRING_INVALID_NUMBER;
+    }
+    while (start < length && data[start] == '0') {
+        start += 1;
+    }
+
+    uint64_t value = 0;
+    const size_t end = priv_scan_digits(data, length, start, &value);
+    if (end != length) {
+        return E_STRING_INVALID_NUMBER;
+    }
+
+    /* 20 digits can overflow, the value of the first 19 is checked */
+    const size_t digits = end - start;
+    if (digits > E_STRING_TO_DIGITS + 1) {
+        return E_STRING_OUT_OF_RANGE;
+    }
+    if (digits == E_STRING_TO_DIGITS + 1) {
+        uint64_t head = 0;
+        priv_scan_digits(data, end - 1, start, &head);
+        const uint64_t last = (uint64_t)(data[end - 1] - '0');
+        if (head > (UINT64_MAX - last) / 10) {
+            return E_STRING_OUT_OF_RANGE;
+        }
+    }
+    *number = value;
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_floor_shift
+ *
+ * value divided by 2^shift rounded down, also for negative values
+ */
+static inline int64_t priv_floor_shift(const int64_t value,
+                                       const unsigned shift)
+{
+    return (value >= 0) ? value >> shift
+                        : -((-value + ((int64_t)1 << shift) - 1) >> shift);
+}
+
+/* private function priv_leading_zeros
+ *
+ * amount of leading zero bits of value, which is not 0
+ */
+static inline unsigned priv_leading_zeros(const uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_clzll(value);
+#else
+    unsigned zeros = 0;
+    while ((value << zeros) >> 63 == 0) {
+        zeros += 1;
+    }
+    return zeros;
+#endif
+}
+
+/* private function priv_eisel_lemire
+ *
+ * bits of the double closest to w * 10^q, rounding ties to even
+ */
+static uint64_t priv_eisel_lemire(uint64_t w, const int64_t q)
+{
+    if (w == 0 || q < E_STRING_POW10_MIN) {
+        return 0;
+    }
+    if (q > 308) {
+        return (uint64_t)E_STRING_TO_INFINITE << E_STRING_TO_FRACTION;
+    }
+
+    /* the table holds 5^q rounded down, except where it is rounded up */
+    const uint64_t* entry = e_string_pow10_table[q - E_STRING_POW10_MIN];
+    uint64_t power_high = entry[0];
+    uint64_t power_low = entry[1];
+    if (q < E_STRING_TO_ROUNDED_UP || q >= 0) {
+        power_high -= (power_low == 0);
+        power_low -= 1;
+    }
+
+    const unsigned zeros = priv_leading_zeros(w);
+    w <<= zeros;
+    uint64_t high = 0;
+    uint64_t low = 0;
+    e_string_multiply(w, power_high, &high, &low);
+    if ((high & 0x1FF) == 0x1FF) {
+        uint64_t second_high = 0;
+        uint64_t second_low = 0;
+        e_string_multiply(w, power_low, &second_high, &second_low);
+        low += second_high;
+        high += (low < second_high);
+    }
+
+    const unsigned upper = (unsigned)(high >> 63);
+    const unsigned shift = upper + 64 - E_STRING_TO_FRACTION - 3;
+    uint64_t mantissa = high >> shift;
+    int64_t power2 = priv_floor_shift((152170 + 65536) * q, 16) + 63
+                     + upper - zeros + E_STRING_TO_BIAS;
+
+    if (power2 <= 0) {
+        /* subnormal, or zero when even the last bit is shifted out */
+        if (-power2 + 1 >= 64) {
+            return 0;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        return mantissa;
+    }
+
+    /* a product that is exactly halfway rounds to even */
+    if (low <= 1 && q >= E_STRING_TO_EVEN_MIN && q <= E_STRING_TO_EVEN_MAX
+        && (mantissa & 3) == 1 && (mantissa << shift) == high) {
+        mantissa &= ~(uint64_t)1;
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= ((uint64_t)2 << E_STRING_TO_FRACTION)) {
+        mantissa = (uint64_t)1 << E_STRING_TO_FRACTION;
+        power2 += 1;
+    }
+    mantissa &= ~((uint64_t)1 << E_STRING_TO_FRACTION);
+    if (power2 >= E_STRING_TO_INFINITE) {
+        return (uint64_t)E_STRING_TO_INFINITE << E_STRING_TO_FRACTION;
+    }
+    return ((uint64_t)power2 << E_STRING_TO_FRACTION) | mantissa;
+}
+
+/* private function priv_big_multiply
+ *
+ * multiplies big by factor, returning false when it does not fit
+ */
+static bool priv_big_multiply(e_string_big_t* big, const uint64_t factor)
+{
+    uint64_t carry = 0;
+    for (size_t i = 0; i < big->count; i++) {
+        uint64_t high = 0;
+        uint64_t low = 0;
+        e_string_multiply(big->limbs[i], factor, &high, &low);
+        low += carry;
+        high += (low < carry);
+        big->limbs[i] = low;
+        carry = high;
+    }
+    if (carry != 0) {
+        if (big->count == E_STRING_TO_BIG_LIMBS) {
+            return false;
+        }
+        big->limbs[big->count++] = carry;
+    }
+    return true;
+}
+
+/* private function priv_big_add
+ *
+ * adds value to big, returning false when it does not fit
+ */
+static bool priv_big_add(e_string_big_t* big, uint64_t value)
+{
+    for (size_t i = 0; i < big->count && value != 0; i++) {
+        big->limbs[i] += value;
+        value = (big->limbs[i] < value);
+    }
+    if (value != 0) {
+        if (big->count == E_STRING_TO_BIG_LIMBS) {
+            return false;
+        }
+        big->limbs[big->count++] = value;
+    }
+    return true;
+}
+
+/* private function priv_big_pow5
+ *
+ * multiplies big by 5^exponent, returning false when it does not fit
+ */
+static bool priv_big_pow5(e_string_big_t* big, int64_t exponent)
+{
+    for (; exponent >= 27; exponent -= 27) {
+        if (priv_big_multiply(big, E_STRING_TO_POW5_27) == false) {
+            return false;
+        }
+    }
+    uint64_t factor = 1;
+    for (; exponent > 0; exponent -= 1) {
+        factor *= 5;
+    }
+    return priv_big_multiply(big, factor);
+}
+
+/* private function priv_big_shift
+ *
+ * multiplies big by 2^bits, returning false when it does not fit
+ */
+static bool priv_big_shift(e_string_big_t* big, const int64_t bits)
+{
+    const size_t limbs = (size_t)bits / 64;
+    const unsigned rest = (unsigned)(bits % 64);
+    if (big->count + limbs + 1 > E_STRING_TO_BIG_LIMBS) {
+        return false;
+    }
+
+    big->limbs[big->count] = 0;
+    for (size_t i = big->count + 1; i-- > 0;) {
+        const uint64_t below = (rest != 0 && i > 0)
+                               ? big->limbs[i - 1] >> (64 - rest) : 0;
+        big->limbs[i + limbs] = (big->limbs[i] << rest) | below;
+    }
+    for (size_t i = 0; i < limbs; i++) {
+        big->limbs[i] = 0;
+    }
+    big->count += limbs + 1;
+    while (big->count > 0 && big->limbs[big->count - 1] == 0) {
+        big->count -= 1;
+    }
+    return true;
+}
+
+/* private function priv_big_compare
+ *
+ * sign of a - b
+ */
+static int priv_big_compare(const e_string_big_t* a, const e_string_big_t* b)
+{
+    if (a->count != b->count) {
+        return (a->count > b->count) ? 1 : -1;
+    }
+    for (size_t i = a->count; i-- > 0;) {
+        if (a->limbs[i] != b->limbs[i]) {
+            return (a->limbs[i] > b->limbs[i]) ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/* private function priv_slow
+ *
+ * bits of the double closest to the digits of decimal, given the bits of
+ * the candidate below the value: the digits are compared against the
+ * point halfway to the next double
+ */
+static uint64_t priv_slow(const uint8_t* data,
+                          const e_string_decimal_t* decimal,
+                          const uint64_t below)
+{
+    /* the significant digits, 19 at a time, with a last 1 standing for the
+     * nonzero digits that are dropped */
+    e_string_big_t digits = { .count = 0 };
+    uint64_t chunk = 0;
+    size_t chunk_digits = 0;
+    size_t kept = 0;
+    size_t dropped = 0;
+    bool nonzero_dropped = false;
+    bool significant = false;
+    for (size_t i = decimal->integer_start; i < decimal->fraction_end; i++) {
+        if (i == decimal->integer_end) {
+            i = decimal->fraction_start;
+            if (i == decimal->fraction_end) {
+                break;
+            }
+        }
+        const uint8_t digit = (uint8_t)(data[i] - '0');
+        significant = significant || digit != 0;
+        if (significant == false) {
+            continue;
+        }
+        if (kept == E_STRING_TO_BIG_DIGITS) {
+            nonzero_dropped = nonzero_dropped || digit != 0;
+            dropped += 1;
+            continue;
+        }
+        chunk = chunk * 10 + digit;
+        chunk_digits += 1;
+        kept += 1;
+        if (chunk_digits == E_STRING_TO_DIGITS) {
+            priv_big_multiply(&digits, 10000000000000000000ULL);
+            priv_big_add(&digits, chunk);
+            chunk = 0;
+            chunk_digits = 0;
+        }
+    }
+    uint64_t scale = 1;
+    for (size_t i = 0; i < chunk_digits; i++) {
+        scale *= 10;
+    }
+    priv_big_multiply(&digits, scale);
+    priv_big_add(&digits, chunk);
+    int64_t exponent = decimal->exponent + (int64_t)dropped;
+    if (nonzero_dropped == true) {
+        priv_big_multiply(&digits, 10);
+        priv_big_add(&digits, 1);
+        exponent -= 1;
+    }
+
+    /* halfway = (2 * m + 1) * 2^(e - 1), for the candidate m * 2^e */
+    const uint64_t biased = below >> E_STRING_TO_FRACTION;
+    const uint64_t fraction = below & (((uint64_t)1 << E_STRING_TO_FRACTION)
+                                       - 1);
+    const uint64_t m = (biased == 0)
+                       ? fraction
+                       : fraction | ((uint64_t)1 << E_STRING_TO_FRACTION);
+    const int64_t e = ((biased == 0) ? 1 : (int64_t)biased)
+                      - E_STRING_TO_BIAS - E_STRING_TO_FRACTION;
+    e_string_big_t halfway = { .limbs = { 2 * m + 1 }, .count = 1 };
+
+    /* digits * 5^exponent * 2^exponent against halfway * 2^(e - 1) */
+    if (exponent >= 0) {
+        priv_big_pow5(&digits, exponent);
+    } else {
+        priv_big_pow5(&halfway, -exponent);
+    }
+    if (exponent > e - 1) {
+        priv_big_shift(&digits, exponent - (e - 1));
+    } else if (exponent < e - 1) {
+        priv_big_shift(&halfway, (e - 1) - exponent);
+    }
+
+    const int order = priv_big_compare(&digits, &halfway);
+    if (order > 0 || (order == 0 && (below & 1) != 0)) {
+        return below + 1;
+    }
+    return below;
+}
+
+/* private function priv_parse_decimal
+ *
+ * finds the parts of the decimal number of data, rejecting anything that
+ * is not [+-]digits[.digits][(e|E)[+-]digits] with at least one digit on
+ * the significand
+ */
+static e_string_errno_t priv_parse_decimal(const uint8_t* data,
+                                           const size_t length,
+                                           size_t start,
+                                           e_string_decimal_t* decimal)
+{
+    uint64_t w = 0;
+    decimal->integer_start = start;
+    start = priv_scan_digits(data, length, start, &w);
+    decimal->integer_end = start;
+    if (start < length && data[start] == '.') {
+        start += 1;
+    }
+    decimal->fraction_start = start;
+    start = priv_scan_digits(data, length, start, &w);
+    decimal->fraction_end = start;
+
+    const size_t integer_digits = decimal->integer_end
+                                  - decimal->integer_start;
+    const size_t fraction_digits = decimal->fraction_end
+                                   - decimal->fraction_start;
+    if (integer_digits + fraction_digits == 0) {
+        return E_STRING_INVALID_NUMBER;
+    }
+
+    /* exponents beyond any double are kept large but without overflow */
+    int64_t exponent = 0;
+    if (start < length && (data[start] | 0x20) == 'e') {
+        start += 1;
+        const bool negative = start < length && data[start] == '-';
+        if (start < length && (data[start] == '-' || data[start] == '+')) {
+            start += 1;
+        }
+        if (start == length || priv_is_digit(data[start]) == false) {
+            return E_STRING_INVALID_NUMBER;
+        }
+        for (; start < length && priv_is_digit(data[start]) == true;
+             start++) {
+            if (exponent < 0x10000000) {
+                exponent = exponent * 10 + (data[start] - '0');
+            }
+        }
+        exponent = (negative == true) ? -exponent : exponent;
+    }
+    if (start != length) {
+        return E_STRING_INVALID_NUMBER;
+    }
+    decimal->exponent = exponent - (int64_t)fraction_digits;
+    decimal->w = w;
+    decimal->q = decimal->exponent;
+    decimal->truncated = false;
+    if (integer_digits + fraction_digits <= E_STRING_TO_DIGITS) {
+        return E_STRING_SUCCESS;
+    }
+
+    /* w wrapped around: leading zeros are skipped, and when there are
+     * still too many digits w is read again from the first 19 */
+    size_t i = decimal->integer_start;
+    size_t significant = integer_digits + fraction_digits;
+    for (;; i++) {
+        if (i == decimal->integer_end) {
+            i = decimal->fraction_start;
+        }
+        if (i == decimal->fraction_end || data[i] != '0') {
+            break;
+        }
+        significant -= 1;
+    }
+    if (significant <= E_STRING_TO_DIGITS) {
+        return E_STRING_SUCCESS;
+    }
+
+    decimal->truncated = true;
+    decimal->w = 0;
+    for (size_t used = 0; used < E_STRING_TO_DIGITS; i++) {
+        if (i == decimal->integer_end) {
+            i = decimal->fraction_start;
+        }
+        decimal->w = decimal->w * 10 + (uint64_t)(data[i] - '0');
+        used += 1;
+    }
+    decimal->q = decimal->exponent
+                 + (int64_t)(significant - E_STRING_TO_DIGITS);
+    return E_STRING_SUCCESS;
+}
+
+/* private function priv_match_word
+ *
+ * checks if data from start upto the end is word, ignoring ASCII case
+ */
+static bool priv_match_word(const uint8_t* data, const size_t length,
+                            const size_t start, const char* word)
+{
+    const size_t word_length = strlen(word);
+    if (length - start != word_length) {
+        return false;
+    }
+    for (size_t i = 0; i < word_length; i++) {
+        if ((data[start + i] | 0x20) != (uint8_t)word[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+e_string_errno_t e_string_view_to_uint64(const e_string_view_t view,
+                                         uint64_t* number)
+{
+    const size_t start = (view.length > 0 && view.data[0] == '+') ? 1 : 0;
+    return priv_parse_unsigned(view.data, view.length, start, number);
+}
+
+
+e_string_errno_t e_string_view_to_int64(const e_string_view_t view,
+                                        int64_t* number)
+{
+    const bool negative = view.length > 0 && view.data[0] == '-';
+    const size_t start = (view.length > 0
+                          && (view.data[0] == '-' || view.data[0] == '+'))
+                         ? 1 : 0;
+    uint64_t magnitude = 0;
+    const e_string_errno_t result = priv_parse_unsigned(view.data,
+                                                        view.length, start,
+                                                        &magnitude);
+    if (result != E_STRING_SUCCESS) {
+        return result;
+    }
+
+    const uint64_t limit = (uint64_t)INT64_MAX + negative;
+    if (magnitude > limit) {
+        return E_STRING_OUT_OF_RANGE;
+    }
+    *number = (negative == true) ? (int64_t)(0 - magnitude)
+                                 : (int64_t)magnitude;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_view_to_double(const e_string_view_t view,
+                                         double* number)
+{
+    const uint8_t* data = view.data;
+    const bool negative = view.length > 0 && data[0] == '-';
+    const size_t start = (view.length > 0
+                          && (data[0] == '-' || data[0] == '+')) ? 1 : 0;
+    uint64_t bits = 0;
+
+    e_string_decimal_t decimal;
+    const e_string_errno_t result = priv_parse_decimal(data, view.length,
+                                                       start, &decimal);
+    if (result != E_STRING_SUCCESS) {
+        if (priv_match_word(data, view.length, start, "inf") == true
+            || priv_match_word(data, view.length, start, "infinity") == true) {
+            bits = (uint64_t)E_STRING_TO_INFINITE << E_STRING_TO_FRACTION;
+        } else if (priv_match_word(data, view.length, start, "nan") == true) {
+            bits = ((uint64_t)E_STRING_TO_INFINITE << E_STRING_TO_FRACTION)
+                   | ((uint64_t)1 << (E_STRING_TO_FRACTION - 1));
+        } else {
+            return result;
+        }
+        bits |= (uint64_t)negative << 63;
+        memcpy(number, &bits, sizeof(bits));
+        return E_STRING_SUCCESS;
+    }
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    /* w and 10^q are exact, a single operation rounds correctly */
+    if (decimal.truncated == false && decimal.w <= ((uint64_t)1 << 53)
+        && decimal.q >= -E_STRING_TO_EXACT_POWER
+        && decimal.q <= E_STRING_TO_EXACT_POWER) {
+        double value = (double)decimal.w;
+        if (decimal.q < 0) {
+            value /= e_string_exact_powers[-decimal.q];
+        } else {
+            value *= e_string_exact_powers[decimal.q];
+        }
+        *number = (negative == true) ? -value : value;
+        return E_STRING_SUCCESS;
+    }
+#endif
+
+    bits = priv_eisel_lemire(decimal.w, decimal.q);
+    if (decimal.truncated == true
+        && priv_eisel_lemire(decimal.w + 1, decimal.q) != bits) {
+        bits = priv_slow(data, &decimal, bits);
+    }
+
+    const bool infinite = (bits >> E_STRING_TO_FRACTION)
+                          == E_STRING_TO_INFINITE;
+    bits |= (uint64_t)negative << 63;
+    memcpy(number, &bits, sizeof(bits));
+    return (infinite == true) ? E_STRING_OUT_OF_RANGE : E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_to_uint64(const e_string_t* string,
+                                    uint64_t* number)
+{
+    return e_string_view_to_uint64(e_string_view(string), number);
+}
+
+
+e_string_errno_t e_string_to_int64(const e_string_t* string, int64_t* number)
+{
+    return e_string_view_to_int64(e_string_view(string), number);
+}
+
+
+e_string_errno_t e_string_to_double(const e_string_t* string, double* number)
+{
+    return e_string_view_to_double(e_string_view(string), number);
+}
@@ -0,0 +1,673 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_transcode implementation
+ *
+ * this module implements the conversion of e_string_t from and to UTF-16LE
+ * and UTF-32, validating the data on the same pass that converts it.
+ *
+ * the data is converted by blocks: with AVX2 a block is checked at once and
+ *   - US ASCII blocks are narrowed or widened with a single vector operation
+ *   - UTF-8 blocks of 3 byte codepoints (most of the BMP) are decoded and
+ *     checked with a shuffle and a few compares
+ *   - UTF-16 and UTF-32 blocks with no surrogates and no rejected control
+ *     codepoints are encoded without checking each unit again
+ *   - any other block is converted unit by unit with every check, and the
+ *     next block is tried with SIMD again
+ * without AVX2 every block takes the checked path.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+#ifdef E_STRING_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* units converted by the checked path before trying SIMD again */
+#define E_STRING_SCALAR_RUN 32
+
+
+/* private function priv_le16
+ *
+ * swaps a UTF-16LE code unit to host byte order and back
+ */
+static inline uint16_t priv_le16(const uint16_t unit)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return (uint16_t)((unit >> 8) | (unit << 8));
+#else
+    return unit;
+#endif
+}
+
+/* private function priv_allowed
+ *
+ * checks that codepoint is a Unicode scalar value accepted by
+ * e_string_validate
+ */
+static inline bool priv_allowed(const uint32_t codepoint)
+{
+    if (codepoint < 0x80) {
+        return e_string_utf8_is_ascii((uint8_t)codepoint, true);
+    }
+    return codepoint <= 0x10FFFF
+           && (codepoint < 0xD800 || codepoint > 0xDFFF);
+}
+
+/* private function priv_decode_checked
+ *
+ * decodes the codepoint at the start of length bytes of data, following the
+ * same rules as e_string_validate. returns the length of its encoding, or 0
+ * when the data is not valid.
+ */
+static inline size_t priv_decode_checked(const uint8_t* data,
+                                         const size_t length,
+                                         uint32_t* codepoint)
+{
+    const uint8_t lead = data[0];
+    if (lead < 0x80) {
+        *codepoint = lead;
+        return e_string_utf8_is_ascii(lead, true) ? 1 : 0;
+    }
+
+    /* the second byte range excludes overlong forms, surrogates and
+     * codepoints above 0x10FFFF
+     */
+    size_t size;
+    uint8_t low = 0x80;
+    uint8_t high = 0xBF;
+    uint32_t value;
+    if (lead < 0xC2) {
+        return 0;
+    } else if (lead < 0xE0) {
+        size = 2;
+        value = lead & 0x1F;
+    } else if (lead < 0xF0) {
+        size = 3;
+        value = lead & 0x0F;
+        low = (lead == 0xE0) ? 0xA0 : low;
+        high = (lead == 0xED) ? 0x9F : high;
+    } else if (lead < 0xF5) {
+        size = 4;
+        value = lead & 0x07;
+        low = (lead == 0xF0) ? 0x90 : low;
+        high = (lead == 0xF4) ? 0x8F : high;
+    } else {
+        return 0;
+    }
+
+    if (length < size || data[1] < low || data[1] > high) {
+        return 0;
+    }
+    value = (value << 6) | (data[1] & 0x3F);
+    if (size > 2) {
+        if ((data[2] & 0xC0) != 0x80) {
+            return 0;
+        }
+        value = (value << 6) | (data[2] & 0x3F);
+    }
+    if (size > 3) {
+        if ((data[3] & 0xC0) != 0x80) {
+            return 0;
+        }
+        value = (value << 6) | (data[3] & 0x3F);
+    }
+    *codepoint = value;
+    return size;
+}
+
+/* private function priv_decode_utf16
+ *
+ * decodes the codepoint at the start of remaining UTF-16LE units, returning
+ * the amount of units used, or 0 when they are not valid
+ */
+static inline size_t priv_decode_utf16(const uint16_t* units,
+                                       const size_t remaining,
+                                       uint32_t* codepoint)
+{
+    const uint32_t unit = priv_le16(units[0]);
+    if (unit < 0xD800 || unit > 0xDFFF) {
+        *codepoint = unit;
+        return priv_allowed(unit) ? 1 : 0;
+    }
+    if (unit > 0xDBFF || remaining < 2) {
+        return 0;
+    }
+    const uint32_t low = priv_le16(units[1]);
+    if (low < 0xDC00 || low > 0xDFFF) {
+        return 0;
+    }
+    *codepoint = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+    return 2;
+}
+
+/* private function priv_cache
+ *
+ * caches on string what the conversion found out about its data
+ */
+static void priv_cache(e_string_t* string, const bool ascii,
+                       const size_t codepoints)
+{
+    if (ascii == true) {
+        e_string_set_ascii(string);
+        return;
+    }
+    string->flags |= E_STRING_FLAG_UTF8;
+    if (codepoints <= UINT32_MAX) {
+        string->flags |= E_STRING_FLAG_COUNTED;
+        string->codepoint_count = (uint32_t)codepoints;
+    }
+}
+
+/* private function priv_finish
+ *
+ * trims the worst case buffer of a converted string to its written length
+ */
+static void priv_finish(e_string_t* string, const size_t written,
+                        const size_t codepoints)
+{
+    e_string_set_length(string, written);
+    priv_cache(string, written == codepoints, codepoints);
+
+    /* the string stays usable with its larger buffer if this fails */
+    (void)e_string_shrink_to_fit(string);
+}
+
+#ifdef E_STRING_X86_SIMD
+
+/* private function priv_control_avx2
+ *
+ * marks the lanes of 16bit units that are control codepoints rejected by
+ * e_string_validate: below 0x20 except tab, line feed and carriage return,
+ * and delete
+ */
+__attribute__((target("avx2")))
+static inline __m256i priv_control_avx2(const __m256i units)
+{
+    const __m256i below = _mm256_cmpeq_epi16(
+        _mm256_min_epu16(units, _mm256_set1_epi16(0x1F)), units);
+    const __m256i allowed = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi16(units, _mm256_set1_epi16(0x09)),
+                        _mm256_cmpeq_epi16(units, _mm256_set1_epi16(0x0A))),
+        _mm256_cmpeq_epi16(units, _mm256_set1_epi16(0x0D)));
+    return _mm256_or_si256(_mm256_andnot_si256(allowed, below),
+                           _mm256_cmpeq_epi16(units, _mm256_set1_epi16(0x7F)));
+}
+
+/* private function priv_control32_avx2
+ *
+ * same as priv_control_avx2 for 32bit units
+ */
+__attribute__((target("avx2")))
+static inline __m256i priv_control32_avx2(const __m256i units)
+{
+    const __m256i below = _mm256_cmpeq_epi32(
+        _mm256_min_epu32(units, _mm256_set1_epi32(0x1F)), units);
+    const __m256i allowed = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi32(units, _mm256_set1_epi32(0x09)),
+                        _mm256_cmpeq_epi32(units, _mm256_set1_epi32(0x0A))),
+        _mm256_cmpeq_epi32(units, _mm256_set1_epi32(0x0D)));
+    return _mm256_or_si256(_mm256_andnot_si256(allowed, below),
+                           _mm256_cmpeq_epi32(units, _mm256_set1_epi32(0x7F)));
+}
+
+/* private function priv_ascii_bytes_avx2
+ *
+ * checks that 32 bytes are US ASCII accepted by e_string_validate
+ */
+__attribute__((target("avx2")))
+static inline bool priv_ascii_bytes_avx2(const __m256i bytes)
+{
+    if (_mm256_movemask_epi8(bytes) != 0) {
+        return false;
+    }
+    /* with bit 7 clear on every byte, signed compares are unsigned ones */
+    const __m256i below = _mm256_cmpgt_epi8(_mm256_set1_epi8(0x20), bytes);
+    const __m256i allowed = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x09)),
+                        _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x0A))),
+        _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x0D)));
+    const __m256i control = _mm256_or_si256(
+        _mm256_andnot_si256(allowed, below),
+        _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(0x7F)));
+    return _mm256_movemask_epi8(control) == 0;
+}
+
+/* private function priv_bmp_bytes_avx2
+ *
+ * decodes 24 bytes holding 8 codepoints of 3 bytes each, with every check of
+ * e_string_validate, into 32bit lanes of codepoints. returns false when the
+ * bytes are anything else. reads 28 bytes.
+ */
+__attribute__((target("avx2")))
+static inline bool priv_bmp_bytes_avx2(const uint8_t* data,
+                                       __m256i* codepoints)
+{
+    /* each 3 byte sequence is moved to a 32bit lane as 0, lead, 2nd, 3rd */
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1,
+                                             8, 7, 6, -1, 11, 10, 9, -1,
+                                             2, 1, 0, -1, 5, 4, 3, -1,
+                                             8, 7, 6, -1, 11, 10, 9, -1);
+    const __m256i bytes = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)data)),
+        _mm_loadu_si128((const __m128i*)(data + 12)), 1);
+    const __m256i lanes = _mm256_shuffle_epi8(bytes, shuffle);
+
+    const __m256i shape = _mm256_cmpeq_epi32(
+        _mm256_and_si256(lanes, _mm256_set1_epi32(0x00F0C0C0)),
+        _mm256_set1_epi32(0x00E08080));
+    const __m256i value = _mm256_or_si256(
+        _mm256_or_si256(
+            _mm256_and_si256(_mm256_srli_epi32(lanes, 4),
+                             _mm256_set1_epi32(0xF000)),
+            _mm256_and_si256(_mm256_srli_epi32(lanes, 2),
+                             _mm256_set1_epi32(0x0FC0))),
+        _mm256_and_si256(lanes, _mm256_set1_epi32(0x3F)));
+
+    /* overlong forms are below 0x800, and surrogates are not scalar values */
+    const __m256i long_enough = _mm256_cmpgt_epi32(value,
+                                                   _mm256_set1_epi32(0x7FF));
+    const __m256i surrogates = _mm256_cmpeq_epi32(
+        _mm256_and_si256(value, _mm256_set1_epi32(0xF800)),
+        _mm256_set1_epi32(0xD800));
+    const __m256i valid = _mm256_andnot_si256(
+        surrogates, _mm256_and_si256(shape, long_enough));
+    if ((uint32_t)_mm256_movemask_epi8(valid) != 0xFFFFFFFFu) {
+        return false;
+    }
+    *codepoints = value;
+    return true;
+}
+
+/* private function priv_from_utf16_avx2
+ *
+ * converts blocks of 16 units from index until a block needs the checked
+ * path or less than 16 units remain, requires AVX2 at runtime
+ */
+__attribute__((target("avx2")))
+static void priv_from_utf16_avx2(const uint16_t* units, const size_t count,
+                                 size_t* index, uint8_t* bytes,
+                                 size_t* written)
+{
+    const __m256i surrogate_mask = _mm256_set1_epi16((short)0xF800);
+    const __m256i surrogate = _mm256_set1_epi16((short)0xD800);
+    const __m256i ascii_max = _mm256_set1_epi16(0x7F);
+    size_t i = *index;
+    size_t w = *written;
+    while (count - i >= 16) {
+        const __m256i block = _mm256_loadu_si256((const __m256i*)(units + i));
+        const __m256i surrogates = _mm256_cmpeq_epi16(
+            _mm256_and_si256(block, surrogate_mask), surrogate);
+        const __m256i rejected = _mm256_or_si256(surrogates,
+                                                 priv_control_avx2(block));
+        if (_mm256_testz_si256(rejected, rejected) == 0) {
+            break;
+        }
+
+        const __m256i ascii = _mm256_cmpeq_epi16(
+            _mm256_min_epu16(block, ascii_max), block);
+        if ((uint32_t)_mm256_movemask_epi8(ascii) == 0xFFFFFFFFu) {
+            const __m128i narrow = _mm_packus_epi16(
+                _mm256_castsi256_si128(block),
+                _mm256_extracti128_si256(block, 1));
+            _mm_storeu_si128((__m128i*)(bytes + w), narrow);
+            w += 16;
+        } else {
+            /* BMP units with no surrogates are all scalar values */
+            for (size_t k = 0; k < 16; k++) {
+                w += e_string_utf8_encode(units[i + k], bytes + w);
+            }
+        }
+        i += 16;
+    }
+    *index = i;
+    *written = w;
+}
+
+/* private function priv_from_utf32_avx2
+ *
+ * same as priv_from_utf16_avx2 for blocks of 8 UTF-32 units
+ */
+__attribute__((target("avx2")))
+static void priv_from_utf32_avx2(const uint32_t* units, const size_t count,
+                                 size_t* index, uint8_t* bytes,
+                                 size_t* written)
+{
+    const __m256i surrogate_mask = _mm256_set1_epi32((int)0xFFFFF800);
+    const __m256i surrogate = _mm256_set1_epi32(0xD800);
+    const __m256i unicode_max = _mm256_set1_epi32(0x10FFFF);
+    const __m256i ascii_max = _mm256_set1_epi32(0x7F);
+    size_t i = *index;
+    size_t w = *written;
+    while (count - i >= 8) {
+        const __m256i block = _mm256_loadu_si256((const __m256i*)(units + i));
+        const __m256i surrogates = _mm256_cmpeq_epi32(
+            _mm256_and_si256(block, surrogate_mask), surrogate);
+        const __m256i in_range = _mm256_cmpeq_epi32(
+            _mm256_min_epu32(block, unicode_max), block);
+        const __m256i rejected = _mm256_or_si256(
+            _mm256_or_si256(surrogates, priv_control32_avx2(block)),
+            _mm256_andnot_si256(in_range, _mm256_set1_epi32(-1)));
+        if (_mm256_testz_si256(rejected, rejected) == 0) {
+            break;
+        }
+
+        const __m256i ascii = _mm256_cmpeq_epi32(
+            _mm256_min_epu32(block, ascii_max), block);
+        if ((uint32_t)_mm256_movemask_epi8(ascii) == 0xFFFFFFFFu) {
+            const __m128i narrow = _mm_packus_epi32(
+                _mm256_castsi256_si128(block),
+                _mm256_extracti128_si256(block, 1));
+            _mm_storel_epi64((__m128i*)(bytes + w),
+                             _mm_packus_epi16(narrow, narrow));
+            w += 8;
+        } else {
+            for (size_t k = 0; k < 8; k++) {
+                w += e_string_utf8_encode(units[i + k], bytes + w);
+            }
+        }
+        i += 8;
+    }
+    *index = i;
+    *written = w;
+}
+
+/* private function priv_to_utf16_avx2
+ *
+ * converts blocks of 32 US ASCII bytes or of 8 codepoints of 3 bytes from
+ * index until a block holds anything else or less than 32 bytes remain,
+ * requires AVX2 at runtime
+ */
+__attribute__((target("avx2")))
+static void priv_to_utf16_avx2(const uint8_t* data, const size_t length,
+                               size_t* index, uint16_t* units,
+                               size_t* written)
+{
+    size_t i = *index;
+    size_t w = *written;
+    while (length - i >= 32) {
+        const __m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i codepoints;
+        if (priv_ascii_bytes_avx2(block) == false) {
+            if (priv_bmp_bytes_avx2(data + i, &codepoints) == false) {
+                break;
+            }
+            _mm_storeu_si128((__m128i*)(units + w), _mm_packus_epi32(
+                _mm256_castsi256_si128(codepoints),
+                _mm256_extracti128_si256(codepoints, 1)));
+            i += 24;
+            w += 8;
+            continue;
+        }
+        _mm256_storeu_si256((__m256i*)(units + w),
+                            _mm256_cvtepu8_epi16(_mm256_castsi256_si128(block)));
+        _mm256_storeu_si256((__m256i*)(units + w + 16),
+                            _mm256_cvtepu8_epi16(
+                                _mm256_extracti128_si256(block, 1)));
+        i += 32;
+        w += 32;
+    }
+    *index = i;
+    *written = w;
+}
+
+/* private function priv_to_utf32_avx2
+ *
+ * same as priv_to_utf16_avx2 for UTF-32 units
+ */
+__attribute__((target("avx2")))
+static void priv_to_utf32_avx2(const uint8_t* data, const size_t length,
+                               size_t* index, uint32_t* units,
+                               size_t* written)
+{
+    size_t i = *index;
+    size_t w = *written;
+    while (length - i >= 32) {
+        const __m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i codepoints;
+        if (priv_ascii_bytes_avx2(block) == false) {
+            if (priv_bmp_bytes_avx2(data + i, &codepoints) == false) {
+                break;
+            }
+            _mm256_storeu_si256((__m256i*)(units + w), codepoints);
+            i += 24;
+            w += 8;
+            continue;
+        }
+        const __m128i low = _mm256_castsi256_si128(block);
+        const __m128i high = _mm256_extracti128_si256(block, 1);
+        _mm256_storeu_si256((__m256i*)(units + w), _mm256_cvtepu8_epi32(low));
+        _mm256_storeu_si256((__m256i*)(units + w + 8),
+                            _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+        _mm256_storeu_si256((__m256i*)(units + w + 16),
+                            _mm256_cvtepu8_epi32(high));
+        _mm256_storeu_si256((__m256i*)(units + w + 24),
+                            _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+        i += 32;
+        w += 32;
+    }
+    *index = i;
+    *written = w;
+}
+
+#endif /* E_STRING_X86_SIMD */
+
+
+e_string_errno_t e_string_from_utf16le(const uint16_t* units,
+                                       const size_t count,
+                                       e_string_t* string)
+{
+    const e_string_t empty = { .flags = E_STRING_FLAG_INLINE };
+    *string = empty;
+
+    /* a code unit takes up to 3 bytes, a surrogate pair 4 bytes */
+    if (count > SIZE_MAX / 3) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    e_string_t result = e_string_with_length(NULL, count * 3);
+    if (e_string_length(&result) != count * 3) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    uint8_t* bytes = e_string_data_mut(&result);
+
+#ifdef E_STRING_X86_SIMD
+    const bool simd = e_string_validate_engine_available(E_STRING_ENGINE_AVX2);
+#endif
+    size_t index = 0;
+    size_t written = 0;
+    size_t pairs = 0;
+    while (index < count) {
+#ifdef E_STRING_X86_SIMD
+        if (simd == true) {
+            priv_from_utf16_avx2(units, count, &index, bytes, &written);
+        }
+#endif
+        const size_t stop = (count - index > E_STRING_SCALAR_RUN)
+                          ? index + E_STRING_SCALAR_RUN : count;
+        while (index < stop) {
+            uint32_t codepoint;
+            const size_t used = priv_decode_utf16(units + index, count - index,
+                                                  &codepoint);
+            if (used == 0) {
+                e_string_free(&result);
+                return E_STRING_INVALID_UNICODE;
+            }
+            written += e_string_utf8_encode(codepoint, bytes + written);
+            pairs += used - 1;
+            index += used;
+        }
+    }
+
+    priv_finish(&result, written, count - pairs);
+    *string = result;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_from_utf32(const uint32_t* units,
+                                     const size_t count,
+                                     e_string_t* string)
+{
+    const e_string_t empty = { .flags = E_STRING_FLAG_INLINE };
+    *string = empty;
+
+    if (count > SIZE_MAX / 4) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    e_string_t result = e_string_with_length(NULL, count * 4);
+    if (e_string_length(&result) != count * 4) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    uint8_t* bytes = e_string_data_mut(&result);
+
+#ifdef E_STRING_X86_SIMD
+    const bool simd = e_string_validate_engine_available(E_STRING_ENGINE_AVX2);
+#endif
+    size_t index = 0;
+    size_t written = 0;
+    while (index < count) {
+#ifdef E_STRING_X86_SIMD
+        if (simd == true) {
+            priv_from_utf32_avx2(units, count, &index, bytes, &written);
+        }
+#endif
+        const size_t stop = (count - index > E_STRING_SCALAR_RUN)
+                          ? index + E_STRING_SCALAR_RUN : count;
+        for (; index < stop; index++) {
+            if (priv_allowed(units[index]) == false) {
+                e_string_free(&result);
+                return E_STRING_INVALID_UNICODE;
+            }
+            written += e_string_utf8_encode(units[index], bytes + written);
+        }
+    }
+
+    priv_finish(&result, written, count);
+    *string = result;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_to_utf16le(e_string_t* string,
+                                     uint16_t* units,
+                                     const size_t capacity,
+                                     size_t* count)
+{
+    const uint8_t* data = e_string_data(string);
+    const size_t length = e_string_length(string);
+    if (capacity < length) {
+        /* every codepoint takes a unit, and 4 byte ones take two */
+        const e_string_errno_t valid = e_string_validate(string);
+        if (valid != E_STRING_SUCCESS) {
+            return valid;
+        }
+        size_t needed = e_string_utf8_length(string);
+        for (size_t i = 0; i < length; i++) {
+            needed += data[i] >= 0xF0;
+        }
+        *count = needed;
+        if (needed > capacity) {
+            return E_STRING_INVALID_BUFFER;
+        }
+    }
+
+#ifdef E_STRING_X86_SIMD
+    const bool simd = e_string_validate_engine_available(E_STRING_ENGINE_AVX2);
+#endif
+    size_t index = 0;
+    size_t written = 0;
+    size_t pairs = 0;
+    while (index < length) {
+#ifdef E_STRING_X86_SIMD
+        if (simd == true) {
+            priv_to_utf16_avx2(data, length, &index, units, &written);
+        }
+#endif
+        const size_t stop = (length - index > E_STRING_SCALAR_RUN)
+                          ? index + E_STRING_SCALAR_RUN : length;
+        while (index < stop) {
+            uint32_t codepoint;
+            const size_t used = priv_decode_checked(data + index,
+                                                    length - index, &codepoint);
+            if (used == 0) {
+                return E_STRING_INVALID_UTF8;
+            }
+            if (codepoint < 0x10000) {
+                units[written++] = priv_le16((uint16_t)codepoint);
+            } else {
+                const uint32_t offset = codepoint - 0x10000;
+                units[written++] = priv_le16((uint16_t)(0xD800 + (offset >> 10)));
+                units[written++] = priv_le16((uint16_t)(0xDC00
+                                                        + (offset & 0x3FF)));
+                pairs += 1;
+            }
+            index += used;
+        }
+    }
+
+    if ((string->flags & E_STRING_FLAG_UTF8) == 0) {
+        priv_cache(string, written == length, written - pairs);
+    }
+    *count = written;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_to_utf32(e_string_t* string,
+                                   uint32_t* units,
+                                   const size_t capacity,
+                                   size_t* count)
+{
+    const uint8_t* data = e_string_data(string);
+    const size_t length = e_string_length(string);
+    if (capacity < length) {
+        const e_string_errno_t valid = e_string_validate(string);
+        if (valid != E_STRING_SUCCESS) {
+            return valid;
+        }
+        *count = e_string_utf8_length(string);
+        if (*count > capacity) {
+            return E_STRING_INVALID_BUFFER;
+        }
+    }
+
+#ifdef E_STRING_X86_SIMD
+    const bool simd = e_string_validate_engine_available(E_STRING_ENGINE_AVX2);
+#endif
+    size_t index = 0;
+    size_t written = 0;
+    while (index < length) {
+#ifdef E_STRING_X86_SIMD
+        if (simd == true) {
+            priv_to_utf32_avx2(data, length, &index, units, &written);
+        }
+#endif
+        const size_t stop = (length - index > E_STRING_SCALAR_RUN)
+                          ? index + E_STRING_SCALAR_RUN : length;
+        while (index < stop) {
+            const size_t used = priv_decode_checked(data + index,
+                                                    length - index,
+                                                    units + written);
+            if (used == 0) {
+                return E_STRING_INVALID_UTF8;
+            }
+            written += 1;
+            index += used;
+        }
+    }
+
+    if ((string->flags & E_STRING_FLAG_UTF8) == 0) {
+        priv_cache(string, written == length, written);
+    }
+    *count = written;
+    return E_STRING_SUCCESS;
+}
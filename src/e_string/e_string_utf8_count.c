@@ -0,0 +1,190 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_utf8_count implementation
+ *
+ * this module implements codepoint counting of UTF-8 data.
+ *
+ * every codepoint has exactly one byte that is not a continuation byte
+ * (10xxxxxx), so counting codepoints of valid data is counting the bytes
+ * that are greater than 0xBF as signed integers: a single compare per vector.
+ *   - scalar: 8 bytes per step, continuation bytes found with bit tricks
+ *   - AVX2: 32 bytes per step, compare results accumulated on 8bit lanes for
+ *     up to 255 steps and then summed with _mm256_sad_epu8
+ *   - AVX-512: 64 bytes per step, popcount of the compare mask
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+#ifdef E_STRING_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* bytes counted at once by e_string_utf8_skip before going byte by byte */
+#define E_STRING_SKIP_BLOCK 4096
+
+
+/* private function priv_popcount
+ *
+ * amount of bits set in word
+ */
+static inline size_t priv_popcount(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (size_t)__builtin_popcountll(word);
+#else
+    size_t count = 0;
+    while (word != 0) {
+        word &= word - 1;
+        count += 1;
+    }
+    return count;
+#endif
+}
+
+/* private function priv_leads
+ *
+ * amount of non-continuation bytes in 8 bytes of data: a continuation byte
+ * has bit 7 set and bit 6 clear, bit 6 is moved over bit 7 to find them.
+ */
+static inline size_t priv_leads(const uint8_t* data)
+{
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    const uint64_t continuation = word & ~(word << 1) & 0x8080808080808080ULL;
+    return 8 - priv_popcount(continuation);
+}
+
+/* private function priv_count_scalar
+ *
+ * counts 8 bytes per step, and the tail byte by byte
+ */
+static size_t priv_count_scalar(const uint8_t* data, const size_t length)
+{
+    size_t count = 0;
+    size_t index = 0;
+    for (; length - index >= 8; index += 8) {
+        count += priv_leads(data + index);
+    }
+    for (; index < length; index++) {
+        count += (data[index] & 0xC0) != 0x80;
+    }
+    return count;
+}
+
+#ifdef E_STRING_X86_SIMD
+
+/* private function priv_count_avx2
+ *
+ * counts 32 bytes per step, requires AVX2 at runtime
+ */
+__attribute__((target("avx2")))
+static size_t priv_count_avx2(const uint8_t* data, const size_t length)
+{
+    const __m256i limit = _mm256_set1_epi8(-65); /* 0xBF */
+    size_t count = 0;
+    size_t index = 0;
+    while (length - index >= 32) {
+        /* 8bit lanes overflow after 255 steps */
+        size_t steps = (length - index) / 32;
+        steps = (steps > 255) ? 255 : steps;
+
+        __m256i partial = _mm256_setzero_si256();
+        for (size_t step = 0; step < steps; step++, index += 32) {
+            const __m256i bytes = _mm256_loadu_si256((const __m256i*)(data
+                                                                      + index));
+            partial = _mm256_sub_epi8(partial, _mm256_cmpgt_epi8(bytes, limit));
+        }
+        const __m256i sums = _mm256_sad_epu8(partial, _mm256_setzero_si256());
+        count += (size_t)_mm256_extract_epi64(sums, 0)
+               + (size_t)_mm256_extract_epi64(sums, 1)
+               + (size_t)_mm256_extract_epi64(sums, 2)
+               + (size_t)_mm256_extract_epi64(sums, 3);
+    }
+    return count + priv_count_scalar(data + index, length - index);
+}
+
+/* private function priv_count_avx512
+ *
+ * counts 64 bytes per step, requires AVX-512 F and BW at runtime
+ */
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static size_t priv_count_avx512(const uint8_t* data, const size_t length)
+{
+    const __m512i limit = _mm512_set1_epi8(-65); /* 0xBF */
+    size_t count = 0;
+    size_t index = 0;
+    for (; length - index >= 64; index += 64) {
+        const __m512i bytes = _mm512_loadu_si512((const void*)(data + index));
+        count += (size_t)_mm_popcnt_u64(_mm512_cmpgt_epi8_mask(bytes, limit));
+    }
+    return count + priv_count_scalar(data + index, length - index);
+}
+
+#endif /* E_STRING_X86_SIMD */
+
+
+size_t e_string_utf8_count(const uint8_t* data, const size_t length)
+{
+#ifdef E_STRING_X86_SIMD
+    if (length >= 64
+        && e_string_validate_engine_available(E_STRING_ENGINE_AVX512)) {
+        return priv_count_avx512(data, length);
+    } else if (length >= 32
+               && e_string_validate_engine_available(E_STRING_ENGINE_AVX2)) {
+        return priv_count_avx2(data, length);
+    }
+#endif
+    return priv_count_scalar(data, length);
+}
+
+
+size_t e_string_utf8_skip(const uint8_t* data, const size_t length,
+                          const size_t count)
+{
+    size_t remaining = count;
+    size_t index = 0;
+
+    /* whole blocks are skipped with the SIMD count, then 8 bytes at once.
+     * a block of valid data has at least a codepoint every 4 bytes, so it is
+     * not counted when it surely holds the codepoint looked for.
+     */
+    while (remaining >= E_STRING_SKIP_BLOCK / 4
+           && length - index >= E_STRING_SKIP_BLOCK) {
+        const size_t leads = e_string_utf8_count(data + index,
+                                                 E_STRING_SKIP_BLOCK);
+        if (leads > remaining) {
+            break;
+        }
+        remaining -= leads;
+        index += E_STRING_SKIP_BLOCK;
+    }
+    while (length - index >= 8) {
+        const size_t leads = priv_leads(data + index);
+        if (leads > remaining) {
+            break;
+        }
+        remaining -= leads;
+        index += 8;
+    }
+
+    /* the codepoint starts at the lead byte after remaining others */
+    for (; index < length; index++) {
+        if ((data[index] & 0xC0) != 0x80) {
+            if (remaining == 0) {
+                return index;
+            }
+            remaining -= 1;
+        }
+    }
+    return length;
+}
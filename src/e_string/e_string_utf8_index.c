@@ -0,0 +1,192 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_utf8_index implementation
+ *
+ * this module implements codepoint access of e_string_t: counting, random
+ * access by codepoint position and codepoint slicing.
+ *
+ * positions are turned into byte offsets by e_string_utf8_skip, either from
+ * the start of the data or from the closest checkpoint of a sparse index.
+ * the data is always validated first (a cached check), so codepoints are
+ * decoded without checking them again.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+
+/* private function priv_decode
+ *
+ * decodes the codepoint of valid UTF-8 data starting at data
+ */
+static inline uint32_t priv_decode(const uint8_t* data)
+{
+    const uint32_t lead = data[0];
+    if (lead < 0x80) {
+        return lead;
+    } else if (lead < 0xE0) {
+        return ((lead & 0x1F) << 6) | (data[1] & 0x3F);
+    } else if (lead < 0xF0) {
+        return ((lead & 0x0F) << 12) | ((uint32_t)(data[1] & 0x3F) << 6)
+             | (data[2] & 0x3F);
+    }
+    return ((lead & 0x07) << 18) | ((uint32_t)(data[1] & 0x3F) << 12)
+         | ((uint32_t)(data[2] & 0x3F) << 6) | (data[3] & 0x3F);
+}
+
+/* private function priv_locate
+ *
+ * byte offset of the codepoint at position, or the data length when string
+ * has no more than position codepoints. string must be validated.
+ */
+static size_t priv_locate(const e_string_t* string,
+                          const e_string_index_t* index,
+                          const size_t position)
+{
+    const uint8_t* data = e_string_data(string);
+    const size_t length = e_string_length(string);
+    if ((string->flags & E_STRING_FLAG_ASCII) != 0) {
+        return (position < length) ? position : length;
+    }
+
+    size_t base = 0;
+    size_t remaining = position;
+    if (index != NULL && index->checkpoint_count > 0) {
+        const size_t checkpoint = position / index->stride;
+        if (checkpoint >= index->checkpoint_count) {
+            return length;
+        }
+        base = index->offsets[checkpoint];
+        remaining = position % index->stride;
+    }
+    return base + e_string_utf8_skip(data + base, length - base, remaining);
+}
+
+
+size_t e_string_utf8_length(e_string_t* string)
+{
+    if ((string->flags & E_STRING_FLAG_COUNTED) != 0) {
+        return string->codepoint_count;
+    }
+
+    const size_t count = e_string_utf8_count(e_string_data(string),
+                                             e_string_length(string));
+
+    /* only the count of data known to be valid is cached */
+    if ((string->flags & E_STRING_FLAG_UTF8) != 0 && count <= UINT32_MAX) {
+        string->codepoint_count = (uint32_t)count;
+        string->flags |= E_STRING_FLAG_COUNTED;
+    }
+    return count;
+}
+
+
+size_t e_string_view_utf8_length(const e_string_view_t view)
+{
+    if ((view.flags & E_STRING_FLAG_ASCII) != 0) {
+        return view.length;
+    }
+    return e_string_utf8_count(view.data, view.length);
+}
+
+
+e_string_errno_t e_string_index_build(e_string_index_t* index,
+                                      e_string_t* string,
+                                      const size_t stride)
+{
+    const e_string_index_t empty = {
+        .stride = (stride == 0) ? E_STRING_INDEX_DEFAULT_STRIDE : stride
+    };
+    *index = empty;
+
+    const e_string_errno_t valid = e_string_validate(string);
+    if (valid != E_STRING_SUCCESS) {
+        return valid;
+    }
+    index->codepoint_count = e_string_utf8_length(string);
+    if ((string->flags & E_STRING_FLAG_ASCII) != 0
+        || index->codepoint_count == 0) {
+        return E_STRING_SUCCESS;
+    }
+
+    /* one checkpoint for each started stride, found stride by stride */
+    const size_t checkpoints = (index->codepoint_count - 1) / index->stride + 1;
+    size_t* offsets = e_string_allocate(checkpoints * sizeof(size_t));
+    if (offsets == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    const uint8_t* data = e_string_data(string);
+    const size_t length = e_string_length(string);
+    offsets[0] = 0;
+    for (size_t i = 1; i < checkpoints; i++) {
+        const size_t base = offsets[i - 1];
+        offsets[i] = base + e_string_utf8_skip(data + base, length - base,
+                                               index->stride);
+    }
+    index->offsets = offsets;
+    index->checkpoint_count = checkpoints;
+    return E_STRING_SUCCESS;
+}
+
+
+void e_string_index_free(e_string_index_t* index)
+{
+    e_string_release(index->offsets, index->checkpoint_count * sizeof(size_t));
+    index->offsets = NULL;
+    index->checkpoint_count = 0;
+    index->codepoint_count = 0;
+}
+
+
+e_string_errno_t e_string_char_at(e_string_t* string,
+                                  const e_string_index_t* index,
+                                  const size_t position,
+                                  uint32_t* codepoint)
+{
+    const e_string_errno_t valid = e_string_validate(string);
+    if (valid != E_STRING_SUCCESS) {
+        return valid;
+    }
+
+    const size_t offset = priv_locate(string, index, position);
+    if (offset >= e_string_length(string)) {
+        return E_STRING_OUT_OF_RANGE;
+    }
+    *codepoint = priv_decode(e_string_data(string) + offset);
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_utf8_substr(e_string_t* string,
+                                      const e_string_index_t* index,
+                                      const size_t start,
+                                      const size_t count,
+                                      e_string_view_t* view)
+{
+    const e_string_errno_t valid = e_string_validate(string);
+    if (valid != E_STRING_SUCCESS) {
+        return valid;
+    }
+
+    /* both ends are codepoint boundaries, so the view keeps the flags */
+    const e_string_view_t whole = e_string_view(string);
+    const size_t begin = priv_locate(string, index, start);
+    size_t end;
+    if ((string->flags & E_STRING_FLAG_ASCII) != 0) {
+        end = (count < whole.length - begin) ? begin + count : whole.length;
+    } else {
+        end = begin + e_string_utf8_skip(whole.data + begin,
+                                         whole.length - begin, count);
+    }
+    *view = e_string_view_substr(whole, begin, end - begin);
+    return E_STRING_SUCCESS;
+}
@@ -0,0 +1,136 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_utf8_stream implementation
+ *
+ * this module implements incremental UTF-8 validation of chunked data.
+ *
+ * each chunk is split in three parts: the bytes that close a sequence left
+ * open by the previous chunk, the body that ends on a codepoint boundary and
+ * a tail with the start of a sequence that continues on the next chunk.
+ * the body is validated with the engine picked by e_string_validate, while
+ * the few bytes around the boundaries go through the DFA engine, which keeps
+ * the state of a partial sequence without storing its bytes.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+
+/* private function priv_body_end
+ *
+ * returns where the last complete codepoint of data ends, looking back at
+ * most 3 bytes for a lead byte whose sequence does not fit in the chunk.
+ */
+static size_t priv_body_end(const uint8_t* data,
+                            const size_t start,
+                            const size_t length)
+{
+    for (size_t back = 1; back <= 3 && back <= length - start; back++) {
+        const uint8_t byte = data[length - back];
+        if (byte < 0x80) {
+            /* US ASCII never opens a sequence */
+            break;
+        }
+        if (byte >= 0xC0) {
+            const size_t needed = (byte >= 0xF0) ? 4 : (byte >= 0xE0) ? 3 : 2;
+            return (needed > back) ? length - back : length;
+        }
+    }
+    return length;
+}
+
+/* private function priv_fail
+ *
+ * records the first error found on the stream
+ */
+static e_string_errno_t priv_fail(e_string_utf8_stream_t* stream,
+                                  const size_t error_offset)
+{
+    stream->status = E_STRING_INVALID_UTF8;
+    stream->error_offset = error_offset;
+    return E_STRING_INVALID_UTF8;
+}
+
+
+void e_string_utf8_stream_init(e_string_utf8_stream_t* stream)
+{
+    stream->offset = 0;
+    stream->error_offset = 0;
+    stream->sequence_offset = 0;
+    stream->state = E_STRING_DFA_ACCEPT;
+    stream->status = E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_utf8_stream_feed(e_string_utf8_stream_t* stream,
+                                           const uint8_t* data,
+                                           const size_t length)
+{
+    if (stream->status != E_STRING_SUCCESS) {
+        return stream->status;
+    }
+
+    /* close the sequence left open by the previous chunk */
+    size_t index = 0;
+    while (index < length
+           && stream->state != E_STRING_DFA_ACCEPT
+           && stream->state != E_STRING_DFA_REJECT) {
+        stream->state = e_string_validate_utf8_dfa_run(stream->state,
+                                                       data + index, 1);
+        index += 1;
+    }
+    if (stream->state == E_STRING_DFA_REJECT) {
+        return priv_fail(stream, stream->sequence_offset);
+    } else if (stream->state != E_STRING_DFA_ACCEPT) {
+        /* the whole chunk was part of the open sequence */
+        stream->offset += length;
+        return E_STRING_SUCCESS;
+    }
+
+    /* validate the body with the fastest engine */
+    const size_t body_end = priv_body_end(data, index, length);
+    const uint8_t* body = data + index;
+    const size_t body_length = body_end - index;
+    if (e_string_validate_utf8(body, body_length, E_STRING_ENGINE_AUTO, NULL)
+        != E_STRING_SUCCESS) {
+        return priv_fail(stream, stream->offset + index
+                                 + e_string_validate_utf8_offset(body,
+                                                                 body_length));
+    }
+
+    /* keep the state of the sequence that continues on the next chunk */
+    if (body_end < length) {
+        stream->sequence_offset = stream->offset + body_end;
+        stream->state = e_string_validate_utf8_dfa_run(E_STRING_DFA_ACCEPT,
+                                                       data + body_end,
+                                                       length - body_end);
+        if (stream->state == E_STRING_DFA_REJECT) {
+            return priv_fail(stream, stream->sequence_offset);
+        }
+    }
+
+    stream->offset += length;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_string_utf8_stream_finish(e_string_utf8_stream_t* stream)
+{
+    if (stream->status != E_STRING_SUCCESS) {
+        return stream->status;
+    }
+
+    /* data ended in the middle of a sequence */
+    if (stream->state != E_STRING_DFA_ACCEPT) {
+        return priv_fail(stream, stream->sequence_offset);
+    }
+    return E_STRING_SUCCESS;
+}
@@ -15,6 +15,7 @@
 #include <stdint.h>
 
 #include "e_string.h"
+#include "e_string_private.h"
 
 
 /* private function e_string_validate_buffer
@@ -24,27 +25,28 @@
 e_string_errno_t e_string_validate_buffer(const e_string_t* string)
 {
     e_string_errno_t result = E_STRING_SUCCESS;
-    if (string->buffer_capacity < string->data_length)
+    if (e_string_capacity(string) < e_string_length(string))
     {
         result = E_STRING_INVALID_BUFFER;
     }
     return result;
 }
 
-/* private function e_string_validate_utf8
+/* private function e_string_validate_utf8_offset
  *
  * checks if data is of correct UTF-8 encoding, based on definitions of W3
  * https://www.w3.org/International/questions/qa-forms-utf-8
+ *
+ * returns the offset of the first invalid codepoint, or length if all the
+ * data is valid.
  * 
  * TODO: segment byte-checking on more pure and simple functions
  */
-e_string_errno_t e_string_validate_utf8(const e_string_t* string)
+size_t e_string_validate_utf8_offset(const uint8_t* data, const size_t length)
 {
-    e_string_errno_t result = E_STRING_SUCCESS;
-
     size_t index = 0;
-    while (index < string->data_length) {
-        const uint8_t u8_1st = string->data[index];
+    while (index < length) {
+        const uint8_t u8_1st = data[index];
         bool ascii = e_string_utf8_is_ascii(u8_1st, true);
         if (ascii == true) {
             index += 1;
@@ -52,12 +54,11 @@ e_string_errno_t e_string_validate_utf8(const e_string_t* string)
         }
 
         /* sanity checking if data still has 2 uint8_t */
-        if (string->data_length - index < 2) {
-            result = E_STRING_INVALID_UTF8;
-            break;
+        if (length - index < 2) {
+            return index;
         }
 
-        const uint8_t u8_2nd = string->data[index + 1];
+        const uint8_t u8_2nd = data[index + 1];
         bool non_overlong = e_string_utf8_is_non_overlong(u8_1st, u8_2nd);
         if (non_overlong == true) {
             index += 2;
@@ -65,12 +66,11 @@ e_string_errno_t e_string_validate_utf8(const e_string_t* string)
         }
         
         /* sanity checking if data still has 3 uint8_t */
-        if (string->data_length - index < 3) {
-            result = E_STRING_INVALID_UTF8;
-            break;
+        if (length - index < 3) {
+            return index;
         }
 
-        const uint8_t u8_3rd = string->data[index + 2];
+        const uint8_t u8_3rd = data[index + 2];
         bool exc_overl = e_string_utf8_is_excluding_overlong(u8_1st,
                                                              u8_2nd,
                                                              u8_3rd);
@@ -87,12 +87,11 @@ e_string_errno_t e_string_validate_utf8(const e_string_t* string)
         }
 
         /* sanity checking if data still has 4 uint8_t */
-        if (string->data_length - index < 4) {
-            result = E_STRING_INVALID_UTF8;
-            break;
+        if (length - index < 4) {
+            return index;
         }
 
-        const uint8_t u8_4th = string->data[index + 3];
+        const uint8_t u8_4th = data[index + 3];
         bool plane_1to3 = e_string_utf8_is_plane_1to3(u8_1st,
                                                       u8_2nd, 
                                                       u8_3rd,
@@ -111,20 +110,151 @@ e_string_errno_t e_string_validate_utf8(const e_string_t* string)
         }
 
         /* if no condition was evaluated than we have an invalid utf8 byte */
-        result = E_STRING_INVALID_UTF8;
-        break;
+        return index;
     }
 
-    return result;
+    return length;
+}
+
+
+/* private function e_string_validate_utf8_scalar
+ *
+ * checks if data is of correct UTF-8 encoding, byte by byte
+ */
+e_string_errno_t e_string_validate_utf8_scalar(const uint8_t* data,
+                                               const size_t length,
+                                               bool* ascii)
+{
+    if (e_string_validate_utf8_offset(data, length) != length) {
+        return E_STRING_INVALID_UTF8;
+    }
+
+    uint8_t merged = 0;
+    for (size_t index = 0; index < length; index++) {
+        merged |= data[index];
+    }
+    *ascii = (merged < 0x80);
+    return E_STRING_SUCCESS;
+}
+
+
+/* private function e_string_validate_engine_available
+ *
+ * checks if the running CPU supports the instruction set of the engine
+ */
+bool e_string_validate_engine_available(const e_string_engine_t engine)
+{
+    switch (engine) {
+    case E_STRING_ENGINE_AUTO:
+    case E_STRING_ENGINE_SCALAR:
+    case E_STRING_ENGINE_DFA:
+        return true;
+#ifdef E_STRING_X86_SIMD
+    case E_STRING_ENGINE_SSE42:
+        return __builtin_cpu_supports("sse4.2");
+    case E_STRING_ENGINE_AVX2:
+        return __builtin_cpu_supports("avx2");
+    case E_STRING_ENGINE_AVX512:
+        return __builtin_cpu_supports("avx512f")
+            && __builtin_cpu_supports("avx512bw");
+#endif
+    default:
+        return false;
+    }
+}
+
+/* private function e_string_validate_engine_resolve
+ *
+ * picks the widest engine supported by the running CPU, short data is kept on
+ * the scalar engine as it does not fill a single vector.
+ */
+e_string_engine_t e_string_validate_engine_resolve(const size_t length)
+{
+    if (length < 16) {
+        return E_STRING_ENGINE_SCALAR;
+    } else if (e_string_validate_engine_available(E_STRING_ENGINE_AVX512)) {
+        return E_STRING_ENGINE_AVX512;
+    } else if (e_string_validate_engine_available(E_STRING_ENGINE_AVX2)) {
+        return E_STRING_ENGINE_AVX2;
+    } else if (e_string_validate_engine_available(E_STRING_ENGINE_SSE42)) {
+        return E_STRING_ENGINE_SSE42;
+    }
+    return E_STRING_ENGINE_SCALAR;
+}
+
+/* private function e_string_validate_utf8
+ *
+ * delegates UTF-8 validation to the given engine
+ */
+e_string_errno_t e_string_validate_utf8(const uint8_t* data,
+                                        const size_t length,
+                                        e_string_engine_t engine,
+                                        bool* ascii)
+{
+    bool ignored = false;
+    if (ascii == NULL) {
+        ascii = &ignored;
+    }
+
+    if (engine == E_STRING_ENGINE_AUTO) {
+        engine = e_string_validate_engine_resolve(length);
+    } else if (e_string_validate_engine_available(engine) == false) {
+        return E_STRING_UNSUPPORTED_ENGINE;
+    }
+
+    switch (engine) {
+    case E_STRING_ENGINE_DFA:
+        return e_string_validate_utf8_dfa(data, length, ascii);
+#ifdef E_STRING_X86_SIMD
+    case E_STRING_ENGINE_SSE42:
+        return e_string_validate_utf8_sse42(data, length, ascii);
+    case E_STRING_ENGINE_AVX2:
+        return e_string_validate_utf8_avx2(data, length, ascii);
+    case E_STRING_ENGINE_AVX512:
+        return e_string_validate_utf8_avx512(data, length, ascii);
+#endif
+    default:
+        return e_string_validate_utf8_scalar(data, length, ascii);
+    }
 }
 
 
-e_string_errno_t e_string_validate(const e_string_t* string)
+e_string_errno_t e_string_validate(e_string_t* string)
 {
     if (e_string_validate_buffer(string) == E_STRING_INVALID_BUFFER) {
         return E_STRING_INVALID_BUFFER;
-    } else if (e_string_validate_utf8(string) == E_STRING_INVALID_UTF8) {
+    } else if ((string->flags & E_STRING_FLAG_UTF8) != 0) {
+        return E_STRING_SUCCESS;
+    }
+
+    bool ascii = false;
+    if (e_string_validate_utf8(e_string_data(string), e_string_length(string),
+                               E_STRING_ENGINE_AUTO, &ascii)
+        != E_STRING_SUCCESS) {
         return E_STRING_INVALID_UTF8;
     }
+
+    string->flags |= E_STRING_FLAG_UTF8;
+    if (ascii == true) {
+        e_string_set_ascii(string);
+    }
     return E_STRING_SUCCESS;
-}
\ No newline at end of file
+}
+
+
+e_string_errno_t e_string_validate_ex(const e_string_t* string,
+                                      const e_string_engine_t engine)
+{
+    if (e_string_validate_buffer(string) == E_STRING_INVALID_BUFFER) {
+        return E_STRING_INVALID_BUFFER;
+    }
+    return e_string_validate_utf8(e_string_data(string),
+                                  e_string_length(string), engine, NULL);
+}
+
+
+void e_string_invalidate(e_string_t* string)
+{
+    string->codepoint_count = 0;
+    string->flags &= E_STRING_FLAGS_LAYOUT;
+}
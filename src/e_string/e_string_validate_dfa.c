@@ -0,0 +1,155 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_validate_dfa implementation
+ *
+ * this module implements a branch-free UTF-8 validation engine based on a
+ * deterministic finite automaton, in the spirit of Bjoern Hoehrmann "Flexible
+ * and Economical UTF-8 Decoder".
+ *
+ * instead of a byte class table plus a transition table, each byte indexes a
+ * single 64 bit row holding the next state for every current state, with each
+ * state encoded as the bit offset of its 6 bits inside the row. a step is a
+ * single table load and a shift: state = (row[byte] >> state) & 63.
+ *
+ * the transitions are derived from the W3C ranges of e_string_utf8_is_*
+ * predicates, including the US ASCII control codepoints rejected with sanity,
+ * so the result is always the same as e_string_validate_utf8_scalar.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* automaton states, as bit offsets inside a row */
+#define E_DFA_ACCEPT E_STRING_DFA_ACCEPT /* at a codepoint boundary */
+#define E_DFA_REJECT E_STRING_DFA_REJECT /* invalid data found, absorbing */
+#define E_DFA_CONT_1 12  /* 1 continuation byte 0x80..0xBF missing */
+#define E_DFA_CONT_2 18  /* 2 continuation bytes 0x80..0xBF missing */
+#define E_DFA_E0     24  /* after 0xE0, next byte 0xA0..0xBF */
+#define E_DFA_ED     30  /* after 0xED, next byte 0x80..0x9F */
+#define E_DFA_CONT_3 36  /* 3 continuation bytes 0x80..0xBF missing */
+#define E_DFA_F0     42  /* after 0xF0, next byte 0x90..0xBF */
+#define E_DFA_F4     48  /* after 0xF4, next byte 0x80..0x8F */
+
+/* E_DFA_ROW
+ *
+ * packs the next state of every current state, in the order of the states
+ * defined above.
+ */
+#define E_DFA_ROW(accept, cont_1, cont_2, e0, ed, cont_3, f0, f4)     \
+    (  ((uint64_t)(accept)       << E_DFA_ACCEPT)                     \
+     | ((uint64_t)E_DFA_REJECT   << E_DFA_REJECT)                     \
+     | ((uint64_t)(cont_1)       << E_DFA_CONT_1)                     \
+     | ((uint64_t)(cont_2)       << E_DFA_CONT_2)                     \
+     | ((uint64_t)(e0)           << E_DFA_E0)                         \
+     | ((uint64_t)(ed)           << E_DFA_ED)                         \
+     | ((uint64_t)(cont_3)       << E_DFA_CONT_3)                     \
+     | ((uint64_t)(f0)           << E_DFA_F0)                         \
+     | ((uint64_t)(f4)           << E_DFA_F4))
+
+#define R E_DFA_REJECT
+
+/* byte classes, one row for each */
+#define ASC E_DFA_ROW(E_DFA_ACCEPT, R, R, R, R, R, R, R)      /* TAB LF CR 0x20..0x7E */
+#define CTL E_DFA_ROW(R, R, R, R, R, R, R, R)                 /* other 0x00..0x7F */
+#define C80 E_DFA_ROW(R, E_DFA_ACCEPT, E_DFA_CONT_1,          /* 0x80..0x8F */ \
+                      R, E_DFA_CONT_1, E_DFA_CONT_2, R, E_DFA_CONT_2)
+#define C90 E_DFA_ROW(R, E_DFA_ACCEPT, E_DFA_CONT_1,          /* 0x90..0x9F */ \
+                      R, E_DFA_CONT_1, E_DFA_CONT_2, E_DFA_CONT_2, R)
+#define CA0 E_DFA_ROW(R, E_DFA_ACCEPT, E_DFA_CONT_1,          /* 0xA0..0xBF */ \
+                      E_DFA_CONT_1, R, E_DFA_CONT_2, E_DFA_CONT_2, R)
+#define INV E_DFA_ROW(R, R, R, R, R, R, R, R)                 /* 0xC0 0xC1 0xF5..0xFF */
+#define L2  E_DFA_ROW(E_DFA_CONT_1, R, R, R, R, R, R, R)      /* 0xC2..0xDF */
+#define LE0 E_DFA_ROW(E_DFA_E0, R, R, R, R, R, R, R)          /* 0xE0 */
+#define L3  E_DFA_ROW(E_DFA_CONT_2, R, R, R, R, R, R, R)      /* 0xE1..0xEC 0xEE 0xEF */
+#define LED E_DFA_ROW(E_DFA_ED, R, R, R, R, R, R, R)          /* 0xED */
+#define LF0 E_DFA_ROW(E_DFA_F0, R, R, R, R, R, R, R)          /* 0xF0 */
+#define L4  E_DFA_ROW(E_DFA_CONT_3, R, R, R, R, R, R, R)      /* 0xF1..0xF3 */
+#define LF4 E_DFA_ROW(E_DFA_F4, R, R, R, R, R, R, R)          /* 0xF4 */
+
+static const uint64_t e_string_dfa_rows[256] = {
+    /* 0x00 */ CTL, CTL, CTL, CTL, CTL, CTL, CTL, CTL,
+               CTL, ASC, ASC, CTL, CTL, ASC, CTL, CTL,
+    /* 0x10 */ CTL, CTL, CTL, CTL, CTL, CTL, CTL, CTL,
+               CTL, CTL, CTL, CTL, CTL, CTL, CTL, CTL,
+    /* 0x20 */ ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+               ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+    /* 0x30 */ ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+               ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+    /* 0x40 */ ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+               ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+    /* 0x50 */ ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+               ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+    /* 0x60 */ ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+               ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+    /* 0x70 */ ASC, ASC, ASC, ASC, ASC, ASC, ASC, ASC,
+               ASC, ASC, ASC, ASC, ASC, ASC, ASC, CTL,
+    /* 0x80 */ C80, C80, C80, C80, C80, C80, C80, C80,
+               C80, C80, C80, C80, C80, C80, C80, C80,
+    /* 0x90 */ C90, C90, C90, C90, C90, C90, C90, C90,
+               C90, C90, C90, C90, C90, C90, C90, C90,
+    /* 0xA0 */ CA0, CA0, CA0, CA0, CA0, CA0, CA0, CA0,
+               CA0, CA0, CA0, CA0, CA0, CA0, CA0, CA0,
+    /* 0xB0 */ CA0, CA0, CA0, CA0, CA0, CA0, CA0, CA0,
+               CA0, CA0, CA0, CA0, CA0, CA0, CA0, CA0,
+    /* 0xC0 */ INV, INV, L2,  L2,  L2,  L2,  L2,  L2,
+               L2,  L2,  L2,  L2,  L2,  L2,  L2,  L2,
+    /* 0xD0 */ L2,  L2,  L2,  L2,  L2,  L2,  L2,  L2,
+               L2,  L2,  L2,  L2,  L2,  L2,  L2,  L2,
+    /* 0xE0 */ LE0, L3,  L3,  L3,  L3,  L3,  L3,  L3,
+               L3,  L3,  L3,  L3,  L3,  LED, L3,  L3,
+    /* 0xF0 */ LF0, L4,  L4,  L4,  LF4, INV, INV, INV,
+               INV, INV, INV, INV, INV, INV, INV, INV
+};
+
+#undef R
+#undef ASC
+#undef CTL
+#undef C80
+#undef C90
+#undef CA0
+#undef INV
+#undef L2
+#undef LE0
+#undef L3
+#undef LED
+#undef LF0
+#undef L4
+#undef LF4
+
+
+uint32_t e_string_validate_utf8_dfa_run(uint32_t state,
+                                        const uint8_t* data,
+                                        const size_t length)
+{
+    uint64_t next = state;
+    for (size_t index = 0; index < length; index++) {
+        next = (e_string_dfa_rows[data[index]] >> next) & 63;
+    }
+    return (uint32_t)next;
+}
+
+
+e_string_errno_t e_string_validate_utf8_dfa(const uint8_t* data,
+                                            const size_t length,
+                                            bool* ascii)
+{
+    /* bits of every byte are merged off the state dependency chain */
+    uint64_t state = E_DFA_ACCEPT;
+    uint8_t merged = 0;
+    for (size_t index = 0; index < length; index++) {
+        state = (e_string_dfa_rows[data[index]] >> state) & 63;
+        merged |= data[index];
+    }
+    *ascii = (merged < 0x80);
+
+    /* the reject state is absorbing, and a sequence left open is an error */
+    return (state == E_DFA_ACCEPT) ? E_STRING_SUCCESS : E_STRING_INVALID_UTF8;
+}
@@ -0,0 +1,455 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_validate_simd implementation
+ *
+ * this module implements SIMD kernels for UTF-8 validation of e_string_t.
+ *
+ * the kernels follow the lookup algorithm from John Keiser and Daniel Lemire
+ * "Validating UTF-8 In Less Than One Instruction Per Byte" (2021), where each
+ * byte is classified together with its predecessor through three 16 entries
+ * nibble tables. on top of it the kernels reject the same US ASCII control
+ * codepoints that e_string_utf8_is_ascii rejects with sanity enabled, so the
+ * result is always the same as e_string_validate_utf8_scalar.
+ *
+ * the tail of the data is copied into a vector padded with spaces, so any
+ * truncated multi-byte sequence at the end is reported as too short.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+#ifdef E_STRING_X86_SIMD
+
+#include <immintrin.h>
+
+/* error classes of the lookup algorithm, each one is a bit in the tables.
+ * the tables are given as char arguments, so the top bit is cast to char */
+#define E_UTF8_TOO_SHORT      (1 << 0) /* 11______ 0_______ or 11______ 11______ */
+#define E_UTF8_TOO_LONG       (1 << 1) /* 0_______ 10______ */
+#define E_UTF8_OVERLONG_3     (1 << 2) /* 11100000 100_____ */
+#define E_UTF8_TOO_LARGE      (1 << 3) /* 11110100 1001____ and above */
+#define E_UTF8_SURROGATE      (1 << 4) /* 11101101 101_____ */
+#define E_UTF8_OVERLONG_2     (1 << 5) /* 1100000_ 10______ */
+#define E_UTF8_TOO_LARGE_1000 (1 << 6) /* 11110101 1000____ and above */
+#define E_UTF8_OVERLONG_4     (1 << 6) /* 11110000 1000____ */
+#define E_UTF8_TWO_CONTS      ((char)0x80) /* 10______ 10______ */
+#define E_UTF8_CARRY          (E_UTF8_TOO_SHORT | E_UTF8_TOO_LONG \
+                              | E_UTF8_TWO_CONTS)
+
+/* table indexed by the high nibble of the previous byte */
+#define E_UTF8_BYTE_1_HIGH                                                    \
+    E_UTF8_TOO_LONG, E_UTF8_TOO_LONG, E_UTF8_TOO_LONG, E_UTF8_TOO_LONG,       \
+    E_UTF8_TOO_LONG, E_UTF8_TOO_LONG, E_UTF8_TOO_LONG, E_UTF8_TOO_LONG,       \
+    E_UTF8_TWO_CONTS, E_UTF8_TWO_CONTS, E_UTF8_TWO_CONTS, E_UTF8_TWO_CONTS,   \
+    E_UTF8_TOO_SHORT | E_UTF8_OVERLONG_2,                                     \
+    E_UTF8_TOO_SHORT,                                                         \
+    E_UTF8_TOO_SHORT | E_UTF8_OVERLONG_3 | E_UTF8_SURROGATE,                  \
+    E_UTF8_TOO_SHORT | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000               \
+                     | E_UTF8_OVERLONG_4
+
+/* table indexed by the low nibble of the previous byte */
+#define E_UTF8_BYTE_1_LOW                                                     \
+    E_UTF8_CARRY | E_UTF8_OVERLONG_3 | E_UTF8_OVERLONG_2 | E_UTF8_OVERLONG_4, \
+    E_UTF8_CARRY | E_UTF8_OVERLONG_2,                                         \
+    E_UTF8_CARRY,                                                             \
+    E_UTF8_CARRY,                                                             \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE,                                          \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000,                  \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000,                  \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000,                  \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000,                  \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000,                  \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000,                  \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000,                  \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000,                  \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000                   \
+                 | E_UTF8_SURROGATE,                                          \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000,                  \
+    E_UTF8_CARRY | E_UTF8_TOO_LARGE | E_UTF8_TOO_LARGE_1000
+
+/* table indexed by the high nibble of the current byte */
+#define E_UTF8_BYTE_2_HIGH                                                    \
+    E_UTF8_TOO_SHORT, E_UTF8_TOO_SHORT, E_UTF8_TOO_SHORT, E_UTF8_TOO_SHORT,   \
+    E_UTF8_TOO_SHORT, E_UTF8_TOO_SHORT, E_UTF8_TOO_SHORT, E_UTF8_TOO_SHORT,   \
+    E_UTF8_TOO_LONG | E_UTF8_OVERLONG_2 | E_UTF8_TWO_CONTS                    \
+                    | E_UTF8_OVERLONG_3 | E_UTF8_TOO_LARGE_1000               \
+                    | E_UTF8_OVERLONG_4,                                      \
+    E_UTF8_TOO_LONG | E_UTF8_OVERLONG_2 | E_UTF8_TWO_CONTS                    \
+                    | E_UTF8_OVERLONG_3 | E_UTF8_TOO_LARGE,                   \
+    E_UTF8_TOO_LONG | E_UTF8_OVERLONG_2 | E_UTF8_TWO_CONTS                    \
+                    | E_UTF8_SURROGATE | E_UTF8_TOO_LARGE,                    \
+    E_UTF8_TOO_LONG | E_UTF8_OVERLONG_2 | E_UTF8_TWO_CONTS                    \
+                    | E_UTF8_SURROGATE | E_UTF8_TOO_LARGE,                    \
+    E_UTF8_TOO_SHORT, E_UTF8_TOO_SHORT, E_UTF8_TOO_SHORT, E_UTF8_TOO_SHORT
+
+/* the largest byte allowed on the last three positions of a vector without
+ * starting a sequence that continues on the next vector */
+#define E_UTF8_INCOMPLETE_LAST3 (char)0xEF, (char)0xDF, (char)0xBF
+
+/* padding used for the tail, a space is valid ASCII even with sanity on */
+#define E_UTF8_PADDING 0x20
+
+
+/* SSE4.2 KERNEL **************************************************************/
+
+__attribute__((target("sse4.2")))
+static inline __m128i priv_sse42_control(const __m128i input)
+{
+    /* bytes 0x00 upto 0x1F except TAB, LF and CR, plus DEL */
+    const __m128i low = _mm_cmpeq_epi8(_mm_min_epu8(input, _mm_set1_epi8(0x1F)),
+                                       input);
+    const __m128i allowed = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(input, _mm_set1_epi8(0x09)),
+                     _mm_cmpeq_epi8(input, _mm_set1_epi8(0x0A))),
+        _mm_cmpeq_epi8(input, _mm_set1_epi8(0x0D)));
+    const __m128i del = _mm_cmpeq_epi8(input, _mm_set1_epi8(0x7F));
+    return _mm_or_si128(_mm_andnot_si128(allowed, low), del);
+}
+
+__attribute__((target("sse4.2")))
+static inline __m128i priv_sse42_check(const __m128i input,
+                                       const __m128i prev_input)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+
+    const __m128i byte_1_high = _mm_shuffle_epi8(
+        _mm_setr_epi8(E_UTF8_BYTE_1_HIGH),
+        _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    const __m128i byte_1_low = _mm_shuffle_epi8(
+        _mm_setr_epi8(E_UTF8_BYTE_1_LOW),
+        _mm_and_si128(prev1, nibble));
+    const __m128i byte_2_high = _mm_shuffle_epi8(
+        _mm_setr_epi8(E_UTF8_BYTE_2_HIGH),
+        _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    const __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high,
+                                                        byte_1_low),
+                                          byte_2_high);
+
+    /* 3rd and 4th bytes of a sequence must be continuation bytes */
+    const __m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+    const __m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+    const __m128i third = _mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80));
+    const __m128i fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80));
+    const __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth),
+                                         _mm_set1_epi8((char)0x80));
+    return _mm_xor_si128(must23, special);
+}
+
+__attribute__((target("sse4.2")))
+static inline __m128i priv_sse42_incomplete(const __m128i input)
+{
+    const __m128i max = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                      -1, -1, -1, -1, -1,
+                                      E_UTF8_INCOMPLETE_LAST3);
+    return _mm_subs_epu8(input, max);
+}
+
+__attribute__((target("sse4.2")))
+static inline int priv_sse42_step(const __m128i input,
+                                  __m128i* prev_input,
+                                  __m128i* prev_incomplete,
+                                  __m128i* error)
+{
+    const int non_ascii = _mm_movemask_epi8(input);
+    *error = _mm_or_si128(*error, priv_sse42_control(input));
+    if (non_ascii == 0) {
+        /* pure ASCII, only a sequence left open before can be an error */
+        *error = _mm_or_si128(*error, *prev_incomplete);
+        *prev_incomplete = _mm_setzero_si128();
+    } else {
+        *error = _mm_or_si128(*error, priv_sse42_check(input, *prev_input));
+        *prev_incomplete = priv_sse42_incomplete(input);
+    }
+    *prev_input = input;
+    return non_ascii;
+}
+
+__attribute__((target("sse4.2")))
+e_string_errno_t e_string_validate_utf8_sse42(const uint8_t* data,
+                                              const size_t length,
+                                              bool* ascii)
+{
+    __m128i prev_input = _mm_setzero_si128();
+    __m128i prev_incomplete = _mm_setzero_si128();
+    __m128i error = _mm_setzero_si128();
+    int non_ascii = 0;
+
+    size_t index = 0;
+    for (; index + 16 <= length; index += 16) {
+        const __m128i input = _mm_loadu_si128((const __m128i*)(data + index));
+        non_ascii |= priv_sse42_step(input, &prev_input, &prev_incomplete,
+                                     &error);
+    }
+
+    /* the tail always runs, so a sequence open at the end is detected */
+    uint8_t tail[16];
+    memset(tail, E_UTF8_PADDING, sizeof(tail));
+    memcpy(tail, data + index, length - index);
+    non_ascii |= priv_sse42_step(_mm_loadu_si128((const __m128i*)tail),
+                                 &prev_input, &prev_incomplete, &error);
+
+    *ascii = (non_ascii == 0);
+    return _mm_testz_si128(error, error) ? E_STRING_SUCCESS
+                                         : E_STRING_INVALID_UTF8;
+}
+
+
+/* AVX2 KERNEL ****************************************************************/
+
+__attribute__((target("avx2")))
+static inline __m256i priv_avx2_prev(const __m256i input,
+                                     const __m256i prev_input,
+                                     const int shift)
+{
+    /* alignr works per 128-bit lane, so the lane below is moved up first */
+    const __m256i below = _mm256_permute2x128_si256(prev_input, input, 0x21);
+    switch (shift) {
+    case 1:  return _mm256_alignr_epi8(input, below, 15);
+    case 2:  return _mm256_alignr_epi8(input, below, 14);
+    default: return _mm256_alignr_epi8(input, below, 13);
+    }
+}
+
+__attribute__((target("avx2")))
+static inline __m256i priv_avx2_control(const __m256i input)
+{
+    const __m256i low = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(input, _mm256_set1_epi8(0x1F)), input);
+    const __m256i allowed = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(input, _mm256_set1_epi8(0x09)),
+                        _mm256_cmpeq_epi8(input, _mm256_set1_epi8(0x0A))),
+        _mm256_cmpeq_epi8(input, _mm256_set1_epi8(0x0D)));
+    const __m256i del = _mm256_cmpeq_epi8(input, _mm256_set1_epi8(0x7F));
+    return _mm256_or_si256(_mm256_andnot_si256(allowed, low), del);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i priv_avx2_check(const __m256i input,
+                                      const __m256i prev_input)
+{
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i prev1 = priv_avx2_prev(input, prev_input, 1);
+
+    const __m256i byte_1_high = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(E_UTF8_BYTE_1_HIGH, E_UTF8_BYTE_1_HIGH),
+        _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    const __m256i byte_1_low = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(E_UTF8_BYTE_1_LOW, E_UTF8_BYTE_1_LOW),
+        _mm256_and_si256(prev1, nibble));
+    const __m256i byte_2_high = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(E_UTF8_BYTE_2_HIGH, E_UTF8_BYTE_2_HIGH),
+        _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    const __m256i special = _mm256_and_si256(
+        _mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+    const __m256i prev2 = priv_avx2_prev(input, prev_input, 2);
+    const __m256i prev3 = priv_avx2_prev(input, prev_input, 3);
+    const __m256i third = _mm256_subs_epu8(prev2,
+                                           _mm256_set1_epi8(0xE0 - 0x80));
+    const __m256i fourth = _mm256_subs_epu8(prev3,
+                                            _mm256_set1_epi8(0xF0 - 0x80));
+    const __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                            _mm256_set1_epi8((char)0x80));
+    return _mm256_xor_si256(must23, special);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i priv_avx2_incomplete(const __m256i input)
+{
+    const __m256i max = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1, -1, -1, -1,
+                                         -1, -1, -1, -1, -1,
+                                         E_UTF8_INCOMPLETE_LAST3);
+    return _mm256_subs_epu8(input, max);
+}
+
+__attribute__((target("avx2")))
+static inline int priv_avx2_step(const __m256i input,
+                                 __m256i* prev_input,
+                                 __m256i* prev_incomplete,
+                                 __m256i* error)
+{
+    const int non_ascii = _mm256_movemask_epi8(input);
+    *error = _mm256_or_si256(*error, priv_avx2_control(input));
+    if (non_ascii == 0) {
+        *error = _mm256_or_si256(*error, *prev_incomplete);
+        *prev_incomplete = _mm256_setzero_si256();
+    } else {
+        *error = _mm256_or_si256(*error, priv_avx2_check(input, *prev_input));
+        *prev_incomplete = priv_avx2_incomplete(input);
+    }
+    *prev_input = input;
+    return non_ascii;
+}
+
+__attribute__((target("avx2")))
+e_string_errno_t e_string_validate_utf8_avx2(const uint8_t* data,
+                                             const size_t length,
+                                             bool* ascii)
+{
+    __m256i prev_input = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    __m256i error = _mm256_setzero_si256();
+    int non_ascii = 0;
+
+    size_t index = 0;
+    for (; index + 32 <= length; index += 32) {
+        const __m256i input = _mm256_loadu_si256((const __m256i*)(data + index));
+        non_ascii |= priv_avx2_step(input, &prev_input, &prev_incomplete,
+                                    &error);
+    }
+
+    uint8_t tail[32];
+    memset(tail, E_UTF8_PADDING, sizeof(tail));
+    memcpy(tail, data + index, length - index);
+    non_ascii |= priv_avx2_step(_mm256_loadu_si256((const __m256i*)tail),
+                                &prev_input, &prev_incomplete, &error);
+
+    *ascii = (non_ascii == 0);
+    return _mm256_testz_si256(error, error) ? E_STRING_SUCCESS
+                                            : E_STRING_INVALID_UTF8;
+}
+
+
+/* AVX-512 KERNEL *************************************************************/
+
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i priv_avx512_prev(const __m512i input,
+                                       const __m512i prev_input,
+                                       const int shift)
+{
+    /* lanes of input moved up by one, the lowest lane taken from prev_input */
+    const __m512i below = _mm512_permutex2var_epi64(
+        input, _mm512_set_epi64(5, 4, 3, 2, 1, 0, 15, 14), prev_input);
+    switch (shift) {
+    case 1:  return _mm512_alignr_epi8(input, below, 15);
+    case 2:  return _mm512_alignr_epi8(input, below, 14);
+    default: return _mm512_alignr_epi8(input, below, 13);
+    }
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i priv_avx512_table(const __m128i table)
+{
+    return _mm512_broadcast_i32x4(table);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static inline __mmask64 priv_avx512_control(const __m512i input)
+{
+    const __mmask64 low = _mm512_cmple_epu8_mask(input, _mm512_set1_epi8(0x1F));
+    const __mmask64 allowed =
+          _mm512_cmpeq_epi8_mask(input, _mm512_set1_epi8(0x09))
+        | _mm512_cmpeq_epi8_mask(input, _mm512_set1_epi8(0x0A))
+        | _mm512_cmpeq_epi8_mask(input, _mm512_set1_epi8(0x0D));
+    const __mmask64 del = _mm512_cmpeq_epi8_mask(input, _mm512_set1_epi8(0x7F));
+    return (low & ~allowed) | del;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i priv_avx512_check(const __m512i input,
+                                        const __m512i prev_input)
+{
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+    const __m512i prev1 = priv_avx512_prev(input, prev_input, 1);
+
+    const __m512i byte_1_high = _mm512_shuffle_epi8(
+        priv_avx512_table(_mm_setr_epi8(E_UTF8_BYTE_1_HIGH)),
+        _mm512_and_si512(_mm512_srli_epi16(prev1, 4), nibble));
+    const __m512i byte_1_low = _mm512_shuffle_epi8(
+        priv_avx512_table(_mm_setr_epi8(E_UTF8_BYTE_1_LOW)),
+        _mm512_and_si512(prev1, nibble));
+    const __m512i byte_2_high = _mm512_shuffle_epi8(
+        priv_avx512_table(_mm_setr_epi8(E_UTF8_BYTE_2_HIGH)),
+        _mm512_and_si512(_mm512_srli_epi16(input, 4), nibble));
+    const __m512i special = _mm512_and_si512(
+        _mm512_and_si512(byte_1_high, byte_1_low), byte_2_high);
+
+    const __m512i prev2 = priv_avx512_prev(input, prev_input, 2);
+    const __m512i prev3 = priv_avx512_prev(input, prev_input, 3);
+    const __m512i third = _mm512_subs_epu8(prev2,
+                                           _mm512_set1_epi8(0xE0 - 0x80));
+    const __m512i fourth = _mm512_subs_epu8(prev3,
+                                            _mm512_set1_epi8(0xF0 - 0x80));
+    const __m512i must23 = _mm512_and_si512(_mm512_or_si512(third, fourth),
+                                            _mm512_set1_epi8((char)0x80));
+    return _mm512_xor_si512(must23, special);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static inline __m512i priv_avx512_incomplete(const __m512i input)
+{
+    /* only the last three bytes of the vector can open a sequence */
+    const __m512i max = _mm512_mask_blend_epi8(
+        0xE000000000000000ULL,
+        _mm512_set1_epi8(-1),
+        priv_avx512_table(_mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0,
+                                        0, 0, 0, 0, 0,
+                                        E_UTF8_INCOMPLETE_LAST3)));
+    return _mm512_subs_epu8(input, max);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static inline __mmask64 priv_avx512_step(const __m512i input,
+                                         __m512i* prev_input,
+                                         __m512i* prev_incomplete,
+                                         __m512i* error,
+                                         __mmask64* control)
+{
+    const __mmask64 non_ascii = _mm512_movepi8_mask(input);
+    *control |= priv_avx512_control(input);
+    if (non_ascii == 0) {
+        *error = _mm512_or_si512(*error, *prev_incomplete);
+        *prev_incomplete = _mm512_setzero_si512();
+    } else {
+        *error = _mm512_or_si512(*error,
+                                 priv_avx512_check(input, *prev_input));
+        *prev_incomplete = priv_avx512_incomplete(input);
+    }
+    *prev_input = input;
+    return non_ascii;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+e_string_errno_t e_string_validate_utf8_avx512(const uint8_t* data,
+                                               const size_t length,
+                                               bool* ascii)
+{
+    __m512i prev_input = _mm512_setzero_si512();
+    __m512i prev_incomplete = _mm512_setzero_si512();
+    __m512i error = _mm512_setzero_si512();
+    __mmask64 control = 0;
+    __mmask64 non_ascii = 0;
+
+    size_t index = 0;
+    for (; index + 64 <= length; index += 64) {
+        const __m512i input = _mm512_loadu_si512(data + index);
+        non_ascii |= priv_avx512_step(input, &prev_input, &prev_incomplete,
+                                      &error, &control);
+    }
+
+    /* masked load fills the lanes past the end with the padding byte */
+    const __mmask64 tail = (length - index == 0)
+                         ? 0 : (~0ULL >> (64 - (length - index)));
+    const __m512i input = _mm512_mask_loadu_epi8(
+        _mm512_set1_epi8(E_UTF8_PADDING), tail, data + index);
+    non_ascii |= priv_avx512_step(input, &prev_input, &prev_incomplete,
+                                  &error, &control);
+
+    *ascii = (non_ascii == 0);
+    return (_mm512_test_epi8_mask(error, error) == 0 && control == 0)
+         ? E_STRING_SUCCESS : E_STRING_INVALID_UTF8;
+}
+
+#endif /* E_STRING_X86_SIMD */
@@ -0,0 +1,238 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_view implementation
+ *
+ * this module implements non-owning views over UTF-8 data.
+ *
+ * every derived view goes through priv_slice, which keeps the UTF-8 flag
+ * when both ends of the part are codepoint boundaries: the part of valid
+ * UTF-8 data made of whole codepoints is valid as well, so a single O(1)
+ * check replaces a new validation.
+ *
+ * usage: add #include "e_string.h" to your file and link to e_string library
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "e_string_private.h"
+
+/* flags carried by views */
+#define E_STRING_VIEW_FLAGS (E_STRING_FLAG_UTF8 | E_STRING_FLAG_ASCII)
+
+
+/* private function priv_is_boundary
+ *
+ * checks if a codepoint starts at offset, the end of data is a boundary
+ */
+static inline bool priv_is_boundary(const e_string_view_t view,
+                                    const size_t offset)
+{
+    return offset == view.length || (view.data[offset] & 0xC0) != 0x80;
+}
+
+/* private function priv_slice
+ *
+ * returns the bytes from start up to end of view, keeping what is known
+ */
+static inline e_string_view_t priv_slice(const e_string_view_t view,
+                                         const size_t start,
+                                         const size_t end)
+{
+    e_string_view_t result = {
+        .data = view.data + start,
+        .length = end - start,
+        .flags = view.flags
+    };
+    if ((view.flags & E_STRING_FLAG_ASCII) == 0
+        && (priv_is_boundary(view, start) == false
+            || priv_is_boundary(view, end) == false)) {
+        result.flags = 0;
+    }
+    return result;
+}
+
+/* private function priv_is_space
+ *
+ * checks if byte is US ASCII white space
+ */
+static inline bool priv_is_space(const uint8_t byte)
+{
+    return byte == ' ' || byte == '\t' || byte == '\n' || byte == '\r';
+}
+
+
+e_string_view_t e_string_view(const e_string_t* string)
+{
+    const e_string_view_t result = {
+        .data = e_string_data(string),
+        .length = e_string_length(string),
+        .flags = string->flags & E_STRING_VIEW_FLAGS
+    };
+    return result;
+}
+
+
+e_string_view_t e_string_view_from_bytes(const uint8_t* data,
+                                         const size_t length)
+{
+    const e_string_view_t result = { .data = data, .length = length };
+    return result;
+}
+
+
+e_string_view_t e_string_view_from_cstr(const char* cstr)
+{
+    return e_string_view_from_bytes((const uint8_t*)cstr, strlen(cstr));
+}
+
+
+e_string_t e_string_from_view(const e_string_view_t view)
+{
+    e_string_t result = e_string_from_bytes(NULL, view.data, view.length);
+    if (e_string_length(&result) != view.length) {
+        return result;
+    }
+
+    if ((view.flags & E_STRING_FLAG_ASCII) != 0) {
+        e_string_set_ascii(&result);
+    } else {
+        result.flags |= view.flags & E_STRING_FLAG_UTF8;
+    }
+    return result;
+}
+
+
+e_string_errno_t e_string_view_validate(e_string_view_t* view)
+{
+    if ((view->flags & E_STRING_FLAG_UTF8) != 0) {
+        return E_STRING_SUCCESS;
+    }
+
+    bool ascii = false;
+    const e_string_errno_t result = e_string_validate_utf8(view->data,
+                                                           view->length,
+                                                           E_STRING_ENGINE_AUTO,
+                                                           &ascii);
+    if (result == E_STRING_SUCCESS) {
+        view->flags |= E_STRING_FLAG_UTF8 | (ascii ? E_STRING_FLAG_ASCII : 0);
+    }
+    return result;
+}
+
+
+e_string_view_t e_string_view_substr(const e_string_view_t view,
+                                     const size_t offset,
+                                     const size_t length)
+{
+    const size_t start = (offset < view.length) ? offset : view.length;
+    const size_t end = (length < view.length - start) ? start + length
+                                                      : view.length;
+    return priv_slice(view, start, end);
+}
+
+
+e_string_view_t e_string_view_trim_start(const e_string_view_t view)
+{
+    size_t start = 0;
+    while (start < view.length && priv_is_space(view.data[start])) {
+        start += 1;
+    }
+    return priv_slice(view, start, view.length);
+}
+
+
+e_string_view_t e_string_view_trim_end(const e_string_view_t view)
+{
+    size_t end = view.length;
+    while (end > 0 && priv_is_space(view.data[end - 1])) {
+        end -= 1;
+    }
+    return priv_slice(view, 0, end);
+}
+
+
+e_string_view_t e_string_view_trim(const e_string_view_t view)
+{
+    return e_string_view_trim_end(e_string_view_trim_start(view));
+}
+
+
+bool e_string_view_equals(const e_string_view_t view,
+                          const e_string_view_t other)
+{
+    return view.length == other.length
+        && (view.length == 0
+            || memcmp(view.data, other.data, view.length) == 0);
+}
+
+
+bool e_string_view_starts_with(const e_string_view_t view,
+                               const e_string_view_t prefix)
+{
+    return prefix.length <= view.length
+        && (prefix.length == 0
+            || memcmp(view.data, prefix.data, prefix.length) == 0);
+}
+
+
+bool e_string_view_ends_with(const e_string_view_t view,
+                             const e_string_view_t suffix)
+{
+    return suffix.length <= view.length
+        && (suffix.length == 0
+            || memcmp(view.data + view.length - suffix.length, suffix.data,
+                      suffix.length) == 0);
+}
+
+
+bool e_string_view_split_once(const e_string_view_t view,
+                              const e_string_view_t delimiter,
+                              e_string_view_t* before,
+                              e_string_view_t* after)
+{
+    if (delimiter.length == 0) {
+        return false;
+    }
+
+    const size_t offset = e_string_view_find(view, delimiter);
+    if (offset == E_STRING_NOT_FOUND) {
+        return false;
+    }
+    *before = priv_slice(view, 0, offset);
+    *after = priv_slice(view, offset + delimiter.length, view.length);
+    return true;
+}
+
+
+void e_string_split_init(e_string_split_t* split,
+                         const e_string_view_t view,
+                         const e_string_view_t delimiter)
+{
+    split->rest = view;
+    split->delimiter = delimiter;
+    split->done = false;
+}
+
+
+bool e_string_split_next(e_string_split_t* split, e_string_view_t* part)
+{
+    if (split->done == true) {
+        return false;
+    }
+
+    e_string_view_t after;
+    if (e_string_view_split_once(split->rest, split->delimiter, part, &after)
+        == true) {
+        split->rest = after;
+    } else {
+        *part = split->rest;
+        split->done = true;
+    }
+    return true;
+}
@@ -0,0 +1,119 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_vector implementation
+ *
+ * this module implements the storage management shared by every vector
+ * type declared with E_VECTOR_DECLARE. the generated functions handle the
+ * elements, these only see bytes.
+ *
+ * usage: add #include "e_vector.h" to your file and link to e_vector library
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "e_vector.h"
+
+
+/* private function priv_allocate
+ *
+ * allocates memory with the e_string allocator
+ */
+static void* priv_allocate(const size_t size)
+{
+    const e_string_allocator_t* allocator = e_string_get_allocator();
+    return allocator->allocate(allocator->context, size);
+}
+
+/* private function priv_reallocate
+ *
+ * resizes memory with the e_string allocator
+ */
+static void* priv_reallocate(void* memory, const size_t old_size,
+                             const size_t new_size)
+{
+    const e_string_allocator_t* allocator = e_string_get_allocator();
+    return allocator->reallocate(allocator->context, memory, old_size,
+                                 new_size);
+}
+
+
+e_string_errno_t e_vector_grow(void** data, size_t* capacity, void* small,
+                               const size_t length, const size_t element_size,
+                               const size_t minimum)
+{
+    const size_t limit = SIZE_MAX / element_size;
+    if (minimum > limit) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+
+    size_t new_capacity = (*capacity > limit / 2) ? limit : *capacity * 2;
+    if (new_capacity < minimum) {
+        new_capacity = minimum;
+    }
+    if (new_capacity < 4) {
+        new_capacity = 4;
+    }
+
+    void* memory = NULL;
+    if (*data == NULL || *data == small) {
+        memory = priv_allocate(new_capacity * element_size);
+        if (memory != NULL && length > 0) {
+            memcpy(memory, *data, length * element_size);
+        }
+    } else {
+        memory = priv_reallocate(*data, *capacity * element_size,
+                                 new_capacity * element_size);
+    }
+    if (memory == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    *data = memory;
+    *capacity = new_capacity;
+    return E_STRING_SUCCESS;
+}
+
+
+e_string_errno_t e_vector_shrink(void** data, size_t* capacity, void* small,
+                                 const size_t small_capacity,
+                                 const size_t length,
+                                 const size_t element_size)
+{
+    if (*data == NULL || *data == small || *capacity == length) {
+        return E_STRING_SUCCESS;
+    }
+
+    if (length <= small_capacity || length == 0) {
+        if (length > 0) {
+            memcpy(small, *data, length * element_size);
+        }
+        e_vector_release(*data, small, *capacity, element_size);
+        *data = small;
+        *capacity = small_capacity;
+        return E_STRING_SUCCESS;
+    }
+
+    void* memory = priv_reallocate(*data, *capacity * element_size,
+                                   length * element_size);
+    if (memory == NULL) {
+        return E_STRING_OUT_OF_MEMORY;
+    }
+    *data = memory;
+    *capacity = length;
+    return E_STRING_SUCCESS;
+}
+
+
+void e_vector_release(void* data, const void* small, const size_t capacity,
+                      const size_t element_size)
+{
+    if (data != NULL && data != small) {
+        const e_string_allocator_t* allocator = e_string_get_allocator();
+        allocator->release(allocator->context, data,
+                           capacity * element_size);
+    }
+}
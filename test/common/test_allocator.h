@@ -0,0 +1,98 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* counting allocator for testing
+ *
+ * an e_string allocator counting allocations, reallocations and the bytes
+ * still allocated, so a test can check that memory goes through it, that
+ * sizes given back match the allocated ones and that nothing is leaked.
+ *
+ * usage: add #include "test_allocator.h" to the test, call
+ * test_allocator_install at the start of main and return
+ * test_allocator_check at its end
+ */
+
+#ifndef TEST_ALLOCATOR_H
+#define TEST_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "e_string.h"
+
+/* test_counter structure
+ *
+ * PODs definition
+ *   - allocations: defines the amount of allocate calls
+ *   - reallocations: defines the amount of reallocate calls
+ *   - live_bytes: defines the bytes allocated and not released yet
+ */
+typedef struct test_counter
+{
+    size_t allocations;
+    size_t reallocations;
+    size_t live_bytes;
+} test_counter_t;
+
+static test_counter_t counter;
+
+static void* test_allocate(void* context, const size_t size)
+{
+    test_counter_t* tally = context;
+    tally->allocations += 1;
+    tally->live_bytes += size;
+    return malloc(size);
+}
+
+static void* test_reallocate(void* context, void* memory,
+                             const size_t old_size, const size_t new_size)
+{
+    test_counter_t* tally = context;
+    tally->reallocations += 1;
+    tally->live_bytes += new_size - old_size;
+    return realloc(memory, new_size);
+}
+
+static void test_release(void* context, void* memory, const size_t size)
+{
+    test_counter_t* tally = context;
+    tally->live_bytes -= size;
+    free(memory);
+}
+
+/* test_allocator_install
+ *
+ * makes the counting allocator the e_string one
+ */
+static void test_allocator_install(void)
+{
+    const e_string_allocator_t allocator = {
+        .allocate = test_allocate,
+        .reallocate = test_reallocate,
+        .release = test_release,
+        .context = &counter
+    };
+    e_string_set_allocator(&allocator);
+}
+
+/* test_allocator_check
+ *
+ * restores the default allocator and returns EXIT_FAILURE, reporting it
+ * for module, when bytes were leaked
+ */
+static int test_allocator_check(const char* module)
+{
+    e_string_set_allocator(NULL);
+    if (counter.live_bytes != 0
+        || e_string_get_allocator()->context != NULL) {
+        fprintf(stdout, "%s %s %zu\n", module, u8"leaked bytes",
+                counter.live_bytes);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+#endif /* TEST_ALLOCATOR_H */
@@ -0,0 +1,35 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* failure reporting for testing
+ *
+ * usage: add #include "test_fail.h" to the test and call test_fail when a
+ * check does not hold. tests writing a temporary file set test_file at the
+ * start of main, so it is removed on failure.
+ */
+
+#ifndef TEST_FAIL_H
+#define TEST_FAIL_H
+
+#include <stdlib.h>
+#include <stdio.h>
+
+/* file removed by test_fail, NULL when the test writes none */
+static const char* test_file = NULL;
+
+/* test_fail
+ *
+ * reports the failure and stops the test executable
+ */
+_Noreturn static void test_fail(void)
+{
+    if (test_file != NULL) {
+        remove(test_file);
+    }
+    fprintf(stdout, "%s\n", u8"FAIL");
+    exit(EXIT_FAILURE);
+}
+
+#endif /* TEST_FAIL_H */
@@ -0,0 +1,162 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_arena namespace testing */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_arena.h"
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_arena] Testing alignment and bump allocation");
+
+    e_arena_t arena;
+    e_arena_init(&arena, 128);
+    uint8_t* byte = e_arena_alloc(&arena, 1, 1);
+    uint64_t* word = e_arena_alloc(&arena, sizeof(uint64_t), 8);
+    uint8_t* next = e_arena_alloc(&arena, 3, 1);
+    void* wide = e_arena_alloc(&arena, 16, 64);
+    if (byte == NULL || word == NULL || next == NULL || wide == NULL
+        || (uintptr_t)word % 8 != 0
+        || (uintptr_t)wide % 64 != 0
+        || next != (uint8_t*)(word + 1)
+        || arena.head != arena.current) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    e_arena_destroy(&arena);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_arena] Testing chunks are chained and oversized allocations");
+
+    e_arena_t arena;
+    e_arena_init(&arena, 64);
+    uint8_t* blocks[64];
+    for (size_t i = 0; i < 64; i++) {
+        blocks[i] = e_arena_alloc(&arena, 24, 8);
+        memset(blocks[i], (int)i, 24);
+    }
+    uint8_t* large = e_arena_alloc(&arena, 4096, 16);
+    memset(large, 0xAB, 4096);
+
+    for (size_t i = 0; i < 64; i++) {
+        for (size_t j = 0; j < 24; j++) {
+            if (blocks[i][j] != (uint8_t)i) {
+                fprintf(stdout, "%s\n", u8"FAIL");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    if (large == NULL || (uintptr_t)large % 16 != 0
+        || arena.current->capacity < 4096) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    e_arena_destroy(&arena);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_arena] Testing reset reuses the chunks");
+
+    e_arena_t arena;
+    e_arena_init(&arena, 256);
+    uint8_t* first[32];
+    size_t chunks = 0;
+    for (size_t i = 0; i < 32; i++) {
+        first[i] = e_arena_alloc(&arena, 40, 1);
+    }
+    for (e_arena_chunk_t* c = arena.head; c != NULL; c = c->next) {
+        chunks += 1;
+    }
+
+    /* the same sequence of allocations gets the same memory back */
+    for (int round = 0; round < 4; round++) {
+        e_arena_reset(&arena);
+        for (size_t i = 0; i < 32; i++) {
+            if (e_arena_alloc(&arena, 40, 1) != first[i]) {
+                fprintf(stdout, "%s\n", u8"FAIL");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    size_t after = 0;
+    for (e_arena_chunk_t* c = arena.head; c != NULL; c = c->next) {
+        after += 1;
+    }
+
+    e_arena_destroy(&arena);
+    if (chunks < 2 || after != chunks
+        || arena.head != NULL || arena.current != NULL) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+static size_t chunk_bytes = 0;
+
+static void* test_allocate(void* context, const size_t size)
+{
+    (void)context;
+    chunk_bytes += size;
+    return malloc(size);
+}
+
+static void test_release(void* context, void* memory, const size_t size)
+{
+    (void)context;
+    chunk_bytes -= size;
+    free(memory);
+}
+
+void test_4(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_arena] Testing chunks go through the allocator");
+
+    const e_arena_allocator_t allocator = {
+        .allocate = test_allocate,
+        .release = test_release
+    };
+    e_arena_set_allocator(&allocator);
+
+    e_arena_t arena;
+    e_arena_init(&arena, 256);
+    if (e_arena_alloc(&arena, 100, 8) == NULL
+        || e_arena_alloc(&arena, 1000, 8) == NULL
+        || chunk_bytes < 1100) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    e_arena_destroy(&arena);
+    e_arena_set_allocator(NULL);
+    if (chunk_bytes != 0) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    test_4();
+    return EXIT_SUCCESS;
+}
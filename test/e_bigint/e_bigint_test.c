@@ -0,0 +1,302 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_bigint testing
+ *
+ * products are checked against a naive product on 32bit digits, over sizes
+ * on both sides of every algorithm threshold. every test runs on a counting
+ * e_string allocator, which checks that nothing is leaked and that a
+ * reserved scratch is not allocated again.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_bigint.h"
+#include "test_allocator.h"
+#include "test_fail.h"
+
+static uint64_t test_state = 0x9E3779B97F4A7C15u;
+
+/* private function priv_random
+ *
+ * xorshift64 generator, so the runs are repeatable
+ */
+static uint64_t priv_random(void)
+{
+    test_state ^= test_state << 13;
+    test_state ^= test_state >> 7;
+    test_state ^= test_state << 17;
+    return test_state;
+}
+
+/* private function priv_fill
+ *
+ * sets bigint to n random limbs, or to n limbs of all ones when ones is
+ * true (every addition then carries)
+ */
+static void priv_fill(e_bigint_t* bigint, const size_t n, const bool ones,
+                      const bool negative)
+{
+    uint64_t* limbs = malloc(n * sizeof(uint64_t));
+    for (size_t i = 0; i < n; i++) {
+        limbs[i] = (ones == true) ? UINT64_MAX : priv_random();
+    }
+    limbs[n - 1] |= 1;
+    if (e_bigint_set_limbs(bigint, limbs, n, negative) != E_STRING_SUCCESS) {
+        test_fail();
+    }
+    free(limbs);
+}
+
+/* private function priv_naive
+ *
+ * magnitude of a * b on 32bit digits, as an + bn limbs on product
+ */
+static void priv_naive(const e_bigint_t* a, const e_bigint_t* b,
+                       uint64_t* product)
+{
+    const size_t an = a->length * 2;
+    const size_t bn = b->length * 2;
+    uint32_t* digits = calloc(an + bn, sizeof(uint32_t));
+    for (size_t i = 0; i < an; i++) {
+        const uint64_t x = (uint32_t)(a->limbs[i / 2] >> (32 * (i % 2)));
+        uint64_t carry = 0;
+        for (size_t j = 0; j < bn; j++) {
+            const uint64_t y = (uint32_t)(b->limbs[j / 2] >> (32 * (j % 2)));
+            const uint64_t sum = x * y + digits[i + j] + carry;
+            digits[i + j] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+        digits[i + bn] = (uint32_t)carry;
+    }
+    for (size_t i = 0; i < (an + bn) / 2; i++) {
+        product[i] = digits[2 * i] | ((uint64_t)digits[2 * i + 1] << 32);
+    }
+    free(digits);
+}
+
+/* private function priv_check_product
+ *
+ * fails when product is not a * b
+ */
+static void priv_check_product(const e_bigint_t* product, const e_bigint_t* a,
+                               const e_bigint_t* b)
+{
+    const size_t length = a->length + b->length;
+    uint64_t* expected = malloc(length * sizeof(uint64_t));
+    priv_naive(a, b, expected);
+    size_t expected_length = length;
+    while (expected_length > 0 && expected[expected_length - 1] == 0) {
+        expected_length -= 1;
+    }
+    if (product->length != expected_length
+        || product->negative != (a->negative != b->negative)
+        || memcmp(product->limbs, expected,
+                  expected_length * sizeof(uint64_t)) != 0) {
+        test_fail();
+    }
+    free(expected);
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_bigint] Testing signed add, sub and compare");
+
+    e_bigint_t a;
+    e_bigint_t b;
+    e_bigint_t c;
+    e_bigint_init(&a);
+    e_bigint_init(&b);
+    e_bigint_init(&c);
+
+    /* 2^128 - 1 + 1 carries into a new limb, and back */
+    const uint64_t ones[2] = { UINT64_MAX, UINT64_MAX };
+    if (e_bigint_set_limbs(&a, ones, 2, false) != E_STRING_SUCCESS
+        || e_bigint_set_uint64(&b, 1) != E_STRING_SUCCESS
+        || e_bigint_add(&c, &a, &b) != E_STRING_SUCCESS
+        || c.length != 3 || c.limbs[0] != 0 || c.limbs[1] != 0
+        || c.limbs[2] != 1 || c.negative == true
+        || e_bigint_sub(&c, &c, &b) != E_STRING_SUCCESS
+        || e_bigint_compare(&c, &a) != 0) {
+        test_fail();
+    }
+
+    /* the signs: -5 + 3, 3 - 5, -5 - -5, 3 - -5 in place */
+    if (e_bigint_set_int64(&a, -5) != E_STRING_SUCCESS
+        || e_bigint_set_int64(&b, 3) != E_STRING_SUCCESS
+        || e_bigint_add(&c, &a, &b) != E_STRING_SUCCESS
+        || c.length != 1 || c.limbs[0] != 2 || c.negative == false
+        || e_bigint_sub(&c, &b, &a) != E_STRING_SUCCESS
+        || c.length != 1 || c.limbs[0] != 8 || c.negative == true
+        || e_bigint_sub(&c, &a, &a) != E_STRING_SUCCESS
+        || c.length != 0 || c.negative == true
+        || e_bigint_sub(&b, &b, &a) != E_STRING_SUCCESS
+        || b.limbs[0] != 8 || b.negative == true) {
+        test_fail();
+    }
+
+    /* order: -5 < 0 < 8, and INT64_MIN keeps its magnitude */
+    if (e_bigint_compare(&a, &c) >= 0 || e_bigint_compare(&b, &c) <= 0
+        || e_bigint_compare(&a, &b) >= 0 || e_bigint_compare(&b, &a) <= 0
+        || e_bigint_set_int64(&a, INT64_MIN) != E_STRING_SUCCESS
+        || a.limbs[0] != (uint64_t)1 << 63 || a.negative == false) {
+        test_fail();
+    }
+
+    /* x + y - y == x on long numbers, a borrow running through every limb */
+    priv_fill(&a, 300, false, true);
+    priv_fill(&b, 120, true, false);
+    if (e_bigint_add(&c, &a, &b) != E_STRING_SUCCESS
+        || e_bigint_sub(&c, &c, &b) != E_STRING_SUCCESS
+        || e_bigint_compare(&c, &a) != 0) {
+        test_fail();
+    }
+
+    e_bigint_free(&a);
+    e_bigint_free(&b);
+    e_bigint_free(&c);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_bigint] Testing multiplication against a naive product");
+
+    /* around the Karatsuba and Toom-3 thresholds, and deep recursions */
+    static const size_t sizes[] = { 1, 2, 7, 31, 32, 33, 63, 64, 65, 100,
+                                    191, 192, 193, 200, 383, 384, 385, 577,
+                                    1000 };
+    const size_t count = sizeof(sizes) / sizeof(sizes[0]);
+
+    e_bigint_t a;
+    e_bigint_t b;
+    e_bigint_t c;
+    e_bigint_scratch_t scratch;
+    e_bigint_init(&a);
+    e_bigint_init(&b);
+    e_bigint_init(&c);
+    e_bigint_scratch_init(&scratch);
+    for (size_t i = 0; i < count; i++) {
+        for (int kind = 0; kind < 2; kind++) {
+            priv_fill(&a, sizes[i], kind == 1, i % 2 == 0);
+            priv_fill(&b, sizes[i], kind == 1, i % 3 == 0);
+            if (e_bigint_mul(&c, &a, &b, &scratch) != E_STRING_SUCCESS) {
+                test_fail();
+            }
+            priv_check_product(&c, &a, &b);
+        }
+    }
+
+    /* unbalanced operands are cut in pieces, NULL scratch as well */
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < i; j += 3) {
+            priv_fill(&a, sizes[i], false, false);
+            priv_fill(&b, sizes[j], j % 2 == 0, true);
+            if (e_bigint_mul(&c, &b, &a, NULL) != E_STRING_SUCCESS) {
+                test_fail();
+            }
+            priv_check_product(&c, &b, &a);
+        }
+    }
+
+    /* in place, and by zero */
+    e_bigint_t expected;
+    e_bigint_init(&expected);
+    priv_fill(&a, 700, false, false);
+    priv_fill(&b, 450, false, true);
+    if (e_bigint_mul(&expected, &a, &b, &scratch) != E_STRING_SUCCESS
+        || e_bigint_mul(&a, &a, &b, &scratch) != E_STRING_SUCCESS
+        || e_bigint_compare(&a, &expected) != 0
+        || e_bigint_set_uint64(&c, 0) != E_STRING_SUCCESS
+        || e_bigint_mul(&b, &b, &c, &scratch) != E_STRING_SUCCESS
+        || b.length != 0 || b.negative == true) {
+        test_fail();
+    }
+
+    e_bigint_free(&expected);
+    e_bigint_free(&a);
+    e_bigint_free(&b);
+    e_bigint_free(&c);
+    e_bigint_scratch_free(&scratch);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_bigint] Testing reserved scratch and large identities");
+
+    e_bigint_t a;
+    e_bigint_t b;
+    e_bigint_t sum;
+    e_bigint_t difference;
+    e_bigint_t left;
+    e_bigint_t right;
+    e_bigint_t square;
+    e_bigint_scratch_t scratch;
+    e_bigint_init(&a);
+    e_bigint_init(&b);
+    e_bigint_init(&sum);
+    e_bigint_init(&difference);
+    e_bigint_init(&left);
+    e_bigint_init(&right);
+    e_bigint_init(&square);
+    e_bigint_scratch_init(&scratch);
+
+    /* (a + b)(a - b) == a^2 - b^2 on 100K bit numbers */
+    const size_t n = 1600;
+    priv_fill(&a, n, false, false);
+    priv_fill(&b, n, false, true);
+    if (e_bigint_add(&sum, &a, &b) != E_STRING_SUCCESS
+        || e_bigint_sub(&difference, &a, &b) != E_STRING_SUCCESS
+        || e_bigint_scratch_reserve(&scratch, n, n) != E_STRING_SUCCESS
+        || e_bigint_scratch_reserve(&scratch, sum.length, difference.length)
+           != E_STRING_SUCCESS
+        || e_bigint_reserve(&left, 2 * n + 2) != E_STRING_SUCCESS
+        || e_bigint_reserve(&right, 2 * n + 2) != E_STRING_SUCCESS
+        || e_bigint_reserve(&square, 2 * n + 2) != E_STRING_SUCCESS) {
+        test_fail();
+    }
+
+    /* nothing is allocated once the scratch and results have room */
+    const size_t allocations = counter.allocations + counter.reallocations;
+    if (e_bigint_mul(&left, &sum, &difference, &scratch) != E_STRING_SUCCESS
+        || e_bigint_mul(&right, &a, &a, &scratch) != E_STRING_SUCCESS
+        || e_bigint_mul(&square, &b, &b, &scratch) != E_STRING_SUCCESS
+        || counter.allocations + counter.reallocations != allocations
+        || e_bigint_sub(&right, &right, &square) != E_STRING_SUCCESS
+        || e_bigint_compare(&left, &right) != 0) {
+        test_fail();
+    }
+    priv_check_product(&left, &sum, &difference);
+
+    e_bigint_free(&a);
+    e_bigint_free(&b);
+    e_bigint_free(&sum);
+    e_bigint_free(&difference);
+    e_bigint_free(&left);
+    e_bigint_free(&right);
+    e_bigint_free(&square);
+    e_bigint_scratch_free(&scratch);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_allocator_install();
+
+    test_1();
+    test_2();
+    test_3();
+
+    return test_allocator_check(u8"[e_bigint]");
+}
@@ -0,0 +1,170 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_builder testing
+ *
+ * built strings and written files are compared with the same pieces joined
+ * by hand. files are written on the working directory and removed
+ * afterwards.
+ */
+
+/* fileno is POSIX, the tests are built without extensions */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_fail.h"
+
+#define TEST_FILE "e_string_builder_test.tmp"
+
+/* private function priv_equals
+ *
+ * checks if string holds length bytes of data
+ */
+static bool priv_equals(const e_string_t* string, const char* data,
+                        const size_t length)
+{
+    return e_string_length(string) == length
+           && memcmp(e_string_data(string), data, length) == 0;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_builder] Testing a response built from pieces");
+
+    e_string_t body = e_string_from_cstr(
+        "{\"status\":\"ok\",\"items\":[1,2,3],\"message\":\"everything is fine, "
+        "nothing to report\"}");
+    e_string_validate(&body);
+
+    e_string_builder_t builder;
+    e_string_builder_init(&builder);
+    e_string_builder_append_cstr(&builder, "HTTP/1.1 200 OK\r\n");
+    e_string_builder_append_cstr(&builder, "Content-Length: ");
+    e_string_builder_append_uint64(&builder, e_string_length(&body));
+    e_string_builder_append_view(&builder, e_string_view_from_cstr("\r\n\r\n"));
+    e_string_builder_append(&builder, &body);
+    e_string_builder_append_uint64(&builder, 0);
+    e_string_builder_append_uint64(&builder, UINT64_MAX);
+
+    /* the copies before the body share one segment, the body is borrowed */
+    char expected[512];
+    const int length = snprintf(expected, sizeof(expected),
+                                "HTTP/1.1 200 OK\r\nContent-Length: %zu\r\n\r\n"
+                                "%.*s0%llu", e_string_length(&body),
+                                (int)e_string_length(&body),
+                                (const char*)e_string_data(&body),
+                                (unsigned long long)UINT64_MAX);
+    if (builder.length != (size_t)length || builder.segment_count != 3
+        || builder.segments[1].data != e_string_data(&body)) {
+        test_fail();
+    }
+
+    e_string_t response;
+    if (e_string_builder_build(&builder, &response) != E_STRING_SUCCESS
+        || priv_equals(&response, expected, (size_t)length) == false
+        || e_string_capacity(&response) != (size_t)length
+        || (response.flags & E_STRING_FLAG_UTF8) != 0) {
+        test_fail();
+    }
+    e_string_free(&response);
+
+    /* reset keeps the memory, and known flags reach the built string */
+    e_string_builder_reset(&builder);
+    e_string_t empty;
+    e_string_builder_build(&builder, &empty);
+    if (builder.length != 0 || e_string_length(&empty) != 0) {
+        test_fail();
+    }
+    e_string_builder_append(&builder, &body);
+    e_string_builder_append_uint64(&builder, 42);
+    e_string_builder_build(&builder, &response);
+    if ((response.flags & E_STRING_FLAG_ASCII) == 0
+        || e_string_length(&response) != e_string_length(&body) + 2) {
+        test_fail();
+    }
+
+    e_string_free(&response);
+    e_string_free(&empty);
+    e_string_free(&body);
+    e_string_builder_free(&builder);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_builder] Testing writev of many segments");
+
+    /* borrowed rows between copied separators, more segments than a
+     * single writev call takes */
+    char rows[300][80];
+    e_string_builder_t builder;
+    e_string_builder_init(&builder);
+    size_t total = 0;
+    char* expected = malloc(300 * 80 + 10000);
+    for (size_t i = 0; i < 300; i++) {
+        const int length = snprintf(rows[i], sizeof(rows[i]),
+                                    "row %03zu: the quick brown fox jumps "
+                                    "over the lazy dog, again and again", i);
+        e_string_builder_append_view(&builder, e_string_view_from_bytes(
+            (const uint8_t*)rows[i], (size_t)length));
+        e_string_builder_append_cstr(&builder, (i % 2 == 0) ? ",\n" : ";\n");
+        memcpy(expected + total, rows[i], (size_t)length);
+        memcpy(expected + total + length, (i % 2 == 0) ? ",\n" : ";\n", 2);
+        total += (size_t)length + 2;
+    }
+    /* a copy larger than a chunk */
+    char* large = malloc(10000);
+    memset(large, 'x', 10000);
+    e_string_builder_append_copy(&builder, e_string_view_from_bytes(
+        (const uint8_t*)large, 10000));
+    memcpy(expected + total, large, 10000);
+    total += 10000;
+    free(large);
+
+    if (builder.segment_count != 601 || builder.length != total) {
+        test_fail();
+    }
+
+    FILE* file = fopen(TEST_FILE, "wb");
+    if (file == NULL
+        || e_string_builder_write(&builder, fileno(file)) != E_STRING_SUCCESS) {
+        test_fail();
+    }
+    fclose(file);
+
+    char* read = malloc(total + 1);
+    file = fopen(TEST_FILE, "rb");
+    if (file == NULL || fread(read, 1, total + 1, file) != total
+        || memcmp(read, expected, total) != 0) {
+        test_fail();
+    }
+    fclose(file);
+    remove(TEST_FILE);
+
+    if (e_string_builder_write(&builder, -1) != E_STRING_IO_ERROR) {
+        test_fail();
+    }
+
+    free(read);
+    free(expected);
+    e_string_builder_free(&builder);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_file = TEST_FILE;
+    test_1();
+    test_2();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,229 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_find testing
+ *
+ * searches are checked against a naive search on random data of a small
+ * alphabet, so needles of every length repeat often and have short periods.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_fail.h"
+
+/* private function priv_naive
+ *
+ * first (or last when reverse) occurrence of needle in view, byte by byte
+ */
+static size_t priv_naive(const e_string_view_t view,
+                         const e_string_view_t needle, const bool reverse)
+{
+    size_t found = E_STRING_NOT_FOUND;
+    for (size_t i = 0; i + needle.length <= view.length; i++) {
+        if (memcmp(view.data + i, needle.data, needle.length) == 0) {
+            found = i;
+            if (reverse == false) {
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_find] Testing keyword lookups on log lines");
+
+    e_string_t line = e_string_from_cstr(
+        "2023-06-01T10:00:00Z ERROR [db] connection lost, retrying; "
+        "2023-06-01T10:00:01Z WARN [db] connection restored after ERROR");
+    const e_string_view_t error = e_string_view_from_cstr("ERROR");
+    if (e_string_find(&line, error) != 21
+        || e_string_rfind(&line, error) != e_string_length(&line) - 5
+        || e_string_count_occurrences(&line, error) != 2
+        || e_string_find(&line, e_string_view_from_cstr("[db] connection r"))
+           != 85
+        || e_string_find(&line, e_string_view_from_cstr("FATAL"))
+           != E_STRING_NOT_FOUND
+        || e_string_rfind(&line, e_string_view_from_cstr("FATAL"))
+           != E_STRING_NOT_FOUND
+        || e_string_count_occurrences(&line, e_string_view_from_cstr("FATAL"))
+           != 0
+        || e_string_count_occurrences(&line, e_string_view_from_cstr("2023"))
+           != 2) {
+        test_fail();
+    }
+
+    /* empty needles and needles longer than the data */
+    const e_string_view_t empty = e_string_view_from_cstr("");
+    e_string_t short_line = e_string_from_cstr("ok");
+    if (e_string_find(&line, empty) != 0
+        || e_string_rfind(&line, empty) != e_string_length(&line)
+        || e_string_count_occurrences(&short_line, empty) != 3
+        || e_string_find(&short_line, error) != E_STRING_NOT_FOUND
+        || e_string_rfind(&short_line, error) != E_STRING_NOT_FOUND) {
+        test_fail();
+    }
+
+    e_string_free(&line);
+    e_string_free(&short_line);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_find] Testing every needle length against a naive search");
+
+    const size_t length = 4000;
+    uint8_t* data = malloc(length);
+    uint32_t seed = 7;
+    for (size_t i = 0; i < length; i++) {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = "aab"[(seed >> 16) % 3];
+    }
+    const e_string_view_t view = e_string_view_from_bytes(data, length);
+
+    /* needles from the data itself, and ones made of the same letters */
+    uint8_t made[100];
+    for (size_t needle_length = 1; needle_length < 100; needle_length++) {
+        for (size_t start = 0; start < length - needle_length;
+             start += 397 + needle_length) {
+            e_string_view_t needle = e_string_view_substr(view, start,
+                                                          needle_length);
+            for (size_t kind = 0; kind < 2; kind++) {
+                if (kind == 1) {
+                    for (size_t i = 0; i < needle_length; i++) {
+                        made[i] = (i % 5 == 4) ? 'b' : 'a';
+                    }
+                    needle = e_string_view_from_bytes(made, needle_length);
+                }
+                const size_t first = priv_naive(view, needle, false);
+                if (e_string_view_find(view, needle) != first
+                    || e_string_view_rfind(view, needle)
+                       != priv_naive(view, needle, true)
+                    || (kind == 0 && first > start)) {
+                    test_fail();
+                }
+
+                /* non-overlapping count, by repeated naive searches */
+                size_t count = 0;
+                size_t offset = 0;
+                for (;;) {
+                    const e_string_view_t rest = e_string_view_substr(
+                        view, offset, length);
+                    const size_t match = priv_naive(rest, needle, false);
+                    if (match == E_STRING_NOT_FOUND) {
+                        break;
+                    }
+                    count += 1;
+                    offset += match + needle_length;
+                }
+                if (e_string_view_count_occurrences(view, needle) != count) {
+                    test_fail();
+                }
+            }
+        }
+    }
+
+    /* a needle that almost matches everywhere stays linear with Two-Way */
+    memset(data, 'a', length);
+    memset(made, 'a', 99);
+    made[0] = 'b';
+    const e_string_view_t late = e_string_view_from_bytes(made, 99);
+    if (e_string_view_find(view, late) != E_STRING_NOT_FOUND
+        || e_string_view_rfind(view, late) != E_STRING_NOT_FOUND) {
+        test_fail();
+    }
+    data[length - 99] = 'b';
+    if (e_string_view_find(view, late) != length - 99
+        || e_string_view_rfind(view, late) != length - 99) {
+        test_fail();
+    }
+
+    free(data);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_find] Testing matches on codepoint boundaries only");
+
+    e_string_t text = e_string_from_cstr(u8"日本語 日本語 日本語 日本語 日本語 日本語");
+    const size_t length = e_string_length(&text);
+
+    /* \x97\xA5 are the last bytes of 日, \xA5\xE6 join 日 and 本 */
+    if (e_string_find(&text, e_string_view_from_cstr(u8"本")) != 3
+        || e_string_rfind(&text, e_string_view_from_cstr(u8"本")) != length - 6
+        || e_string_count_occurrences(&text, e_string_view_from_cstr(u8"語"))
+           != 6
+        || e_string_find(&text, e_string_view_from_cstr("\x97\xA5"))
+           != E_STRING_NOT_FOUND
+        || e_string_rfind(&text, e_string_view_from_cstr("\xA5\xE6"))
+           != E_STRING_NOT_FOUND
+        || e_string_count_occurrences(&text, e_string_view_from_cstr("\xE6"))
+           != 0
+        || e_string_count_occurrences(&text, e_string_view_from_cstr(""))
+           != 24) {
+        test_fail();
+    }
+
+    /* the same with Two-Way: the needle starts inside the first 日 */
+    const e_string_view_t inside = e_string_view_from_cstr(
+        u8"\x97\xA5本語 日本語 日本語 日本語");
+    const e_string_view_t whole = e_string_view_from_cstr(
+        u8"日本語 日本語 日本語 日本語");
+    if (e_string_find(&text, inside) != E_STRING_NOT_FOUND
+        || e_string_rfind(&text, inside) != E_STRING_NOT_FOUND
+        || e_string_find(&text, whole) != 0
+        || e_string_rfind(&text, whole) != 20
+        || e_string_count_occurrences(&text, whole) != 1) {
+        test_fail();
+    }
+
+    /* long needles whose byte matches are almost all inside codepoints */
+    uint8_t repeated[3000];
+    uint8_t needle[290];
+    for (size_t i = 0; i < sizeof(repeated); i++) {
+        repeated[i] = (uint8_t)"\xE4\xBD\xA0"[i % 3];
+    }
+    for (size_t i = 0; i < sizeof(needle); i++) {
+        needle[i] = (uint8_t)"\xBD\xA0\xE4"[i % 3];
+    }
+    /* the haystack ends on a lead byte, where the match ending inside a
+     * codepoint is the last one */
+    const e_string_view_t haystack = e_string_view_from_bytes(
+        repeated, sizeof(repeated) - 2);
+    const e_string_view_t starts_inside = e_string_view_from_bytes(
+        needle, sizeof(needle));
+    const e_string_view_t ends_inside = e_string_view_from_bytes(
+        repeated, sizeof(needle) - 1);
+    if (e_string_view_find(haystack, starts_inside) != E_STRING_NOT_FOUND
+        || e_string_view_rfind(haystack, starts_inside) != E_STRING_NOT_FOUND
+        || e_string_view_find(haystack, ends_inside)
+           != haystack.length - ends_inside.length
+        || e_string_view_rfind(haystack, ends_inside)
+           != haystack.length - ends_inside.length) {
+        test_fail();
+    }
+
+    e_string_free(&text);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_format testing
+ *
+ * every test runs on a counting allocator, which checks that formatting
+ * grows the string once and that nothing is leaked.
+ */
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_allocator.h"
+#include "test_fail.h"
+
+/* private function priv_equals
+ *
+ * checks if string holds exactly the bytes of cstr
+ */
+static bool priv_equals(const e_string_t* string, const char* cstr)
+{
+    return e_string_length(string) == strlen(cstr)
+           && memcmp(e_string_data(string), cstr, strlen(cstr)) == 0;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ", u8"[e_format] Testing every argument type");
+
+    e_string_t name = e_string_from_cstr("request");
+    const char* method = "GET";
+    const e_string_view_t path = e_string_view_from_cstr("/index.html");
+    e_string_t line = e_string_from_cstr("");
+
+    const size_t allocations = counter.allocations;
+    if (e_format(&line, "{} {} {}: {} bytes, {} ms, ok={}, tag={}, {}",
+                 &name, method, path, (uint64_t)UINT64_MAX, (int64_t)-25,
+                 (bool)true, (char)'x', (const char*)"done") != E_STRING_SUCCESS
+        || priv_equals(&line, "request GET /index.html: "
+                              "18446744073709551615 bytes, -25 ms, ok=true, "
+                              "tag=x, done") == false
+        || counter.allocations + counter.reallocations != allocations + 1) {
+        test_fail();
+    }
+
+    /* every integer width, the limits and zero */
+    e_string_clear(&line);
+    if (e_format(&line, "{} {} {} {} {} {} {} {} {} {}",
+                 (uint8_t)255, (uint16_t)65535, (uint32_t)4294967295u,
+                 (int8_t)-128, (int16_t)-32768, (int32_t)INT32_MIN,
+                 (int64_t)INT64_MIN, 0, (uint64_t)0, (bool)false)
+        != E_STRING_SUCCESS
+        || priv_equals(&line, "255 65535 4294967295 -128 -32768 -2147483648 "
+                              "-9223372036854775808 0 0 false") == false) {
+        test_fail();
+    }
+
+    /* every standard integer type, whichever intN_t they alias */
+    e_string_clear(&line);
+    if (e_format(&line, "{} {} {} {} {} {}", (long long)LLONG_MIN,
+                 (unsigned long long)ULLONG_MAX, (long)-7, (unsigned long)7,
+                 (short)-3, (unsigned short)3)
+        != E_STRING_SUCCESS
+        || priv_equals(&line, "-9223372036854775808 18446744073709551615 "
+                              "-7 7 -3 3") == false) {
+        test_fail();
+    }
+
+    /* floating point numbers take their shortest text */
+    e_string_clear(&line);
+    if (e_format(&line, "{} {} {} {}", 0.1 + 0.2, 0.1f, -1e300, 1.0 / 0.0)
+        != E_STRING_SUCCESS
+        || priv_equals(&line, "0.30000000000000004 0.1 -1e+300 inf")
+           == false) {
+        test_fail();
+    }
+
+    /* escapes, appending and formats without arguments */
+    e_string_clear(&line);
+    if (e_format(&line, "{{{}}}", 7) != E_STRING_SUCCESS
+        || e_format(&line, " {{}} ") != E_STRING_SUCCESS
+        || e_format(&line, "") != E_STRING_SUCCESS
+        || priv_equals(&line, "{7} {} ") == false
+        || (line.flags & E_STRING_FLAG_UTF8) != 0) {
+        test_fail();
+    }
+
+    e_string_free(&line);
+    e_string_free(&name);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ", u8"[e_format] Testing invalid formats");
+
+    e_string_t line = e_string_from_cstr("kept");
+    if (e_format(&line, "{} {}", 1) != E_STRING_INVALID_FORMAT
+        || e_format(&line, "{}", 1, 2) != E_STRING_INVALID_FORMAT
+        || e_format(&line, "{", 1) != E_STRING_INVALID_FORMAT
+        || e_format(&line, "}") != E_STRING_INVALID_FORMAT
+        || e_format(&line, "{x}", 1) != E_STRING_INVALID_FORMAT
+        || e_format(&line, "} {}", 1) != E_STRING_INVALID_FORMAT
+        || e_format(&line, 42) != E_STRING_INVALID_FORMAT
+        || priv_equals(&line, "kept") == false) {
+        test_fail();
+    }
+
+    /* the most arguments a format takes */
+    if (e_format(&line, ":{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}",
+                 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, (char)'a', (char)'b', (char)'c',
+                 (char)'d', (char)'e', (char)'f')
+        != E_STRING_SUCCESS
+        || priv_equals(&line, "kept:0123456789abcdef") == false) {
+        test_fail();
+    }
+
+    e_string_free(&line);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_format] Testing formatting a string into itself");
+
+    /* the string is the output and an argument */
+    e_string_t text = e_string_from_cstr("ab");
+    for (size_t i = 0; i < 4; i++) {
+        if (e_format(&text, "[{}]", &text) != E_STRING_SUCCESS) {
+            test_fail();
+        }
+    }
+    if (e_string_length(&text) != 62
+        || memcmp(e_string_data(&text), "ab[ab][ab[ab]][ab[ab][ab[ab]]]", 30)
+           != 0) {
+        test_fail();
+    }
+
+    /* the string is the output and the format */
+    e_string_t format = e_string_from_cstr("x{}");
+    if (e_format(&format, &format, 5) != E_STRING_SUCCESS
+        || priv_equals(&format, "x{}x5") == false) {
+        test_fail();
+    }
+
+    /* views of the string move with its data when it grows */
+    e_string_t heap = e_string_from_cstr(
+        "0123456789012345678901234567890123456789");
+    const e_string_view_t whole = e_string_view(&heap);
+    const e_string_view_t tail = e_string_view_substr(whole, 30, 10);
+    if (e_format(&heap, "[{}]{}", whole, tail) != E_STRING_SUCCESS
+        || priv_equals(&heap, "0123456789012345678901234567890123456789"
+                              "[0123456789012345678901234567890123456789]"
+                              "0123456789") == false) {
+        test_fail();
+    }
+
+    e_string_free(&heap);
+    e_string_free(&format);
+    e_string_free(&text);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_4(void)
+{
+    fprintf(stdout, "%s ... ", u8"[e_format] Testing formatting into a buffer");
+
+    char buffer[32];
+    size_t length = 0;
+    if (e_format_to(buffer, sizeof(buffer), &length, "id={} name={}",
+                    (int64_t)-1, "abc") != E_STRING_SUCCESS
+        || length != 14 || memcmp(buffer, "id=-1 name=abc", 14) != 0) {
+        test_fail();
+    }
+
+    memset(buffer, '#', sizeof(buffer));
+    if (e_format_to(buffer, 10, &length, "{} and {}", "twelve", "more")
+        != E_STRING_OUT_OF_RANGE
+        || length != 15 || buffer[0] != '#'
+        || e_format_to(buffer, 15, &length, "{} and {}", "twelve", "more")
+           != E_STRING_SUCCESS
+        || memcmp(buffer, "twelve and more#", 16) != 0) {
+        test_fail();
+    }
+
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_allocator_install();
+
+    test_1();
+    test_2();
+    test_3();
+    test_4();
+
+    return test_allocator_check(u8"[e_format]");
+}
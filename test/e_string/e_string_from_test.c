@@ -0,0 +1,346 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_from constructors testing */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+
+/* private function priv_check
+ *
+ * checks string holds expected on the expected layout, and that accessors
+ * and validation work on it
+ */
+static bool priv_check(e_string_t* string, const char* expected,
+                       const bool inline_layout)
+{
+    const size_t length = strlen(expected);
+    return e_string_is_inline(string) == inline_layout
+        && e_string_length(string) == length
+        && e_string_capacity(string) >= length
+        && memcmp(e_string_data(string), expected, length) == 0
+        && e_string_validate(string) == E_STRING_SUCCESS;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_from] Testing short cstr is stored inline");
+
+    e_string_t empty = e_string_from_cstr("");
+    e_string_t key = e_string_from_cstr("user_id");
+    e_string_t full = e_string_from_cstr(u8"exactly 23 bytes: ção");
+    if (sizeof(e_string_t) != 32
+        || E_STRING_INLINE_CAPACITY != 23
+        || priv_check(&empty, "", true) == false
+        || priv_check(&key, "user_id", true) == false
+        || priv_check(&full, u8"exactly 23 bytes: ção", true) == false) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    e_string_free(&empty);
+    e_string_free(&key);
+    e_string_free(&full);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_from] Testing long cstr is stored on the heap");
+
+    const char* text = u8"this one is longer than the inline buffer 你好";
+    e_string_t string = e_string_from_cstr(text);
+    if (priv_check(&string, text, false) == false) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    e_string_free(&string);
+    if (e_string_length(&string) != 0 || e_string_is_inline(&string) == false) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_from] Testing inline strings survive copies");
+
+    e_string_t original = e_string_from_cstr("copy me");
+    e_string_t copy = original;
+    original.inline_data[0] = 'X';
+    if (priv_check(&copy, "copy me", true) == false) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+
+    /* invalid data is found on the inline layout as well */
+    e_string_t invalid = e_string_from_cstr("ab\xC3");
+    e_string_invalidate(&invalid);
+    if (e_string_is_inline(&invalid) == false
+        || e_string_validate(&invalid) != E_STRING_INVALID_UTF8) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_4(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_from] Testing integers against snprintf");
+
+    char expected[32];
+    for (int digits = 0; digits < 20; digits++) {
+        uint64_t power = 1;
+        for (int i = 0; i < digits; i++) {
+            power *= 10;
+        }
+        const uint64_t values[] = { power - 1, power, power + 1 };
+        for (size_t v = 0; v < 3; v++) {
+            e_string_t unsigned_string = e_string_from_uint64(values[v]);
+            snprintf(expected, sizeof(expected), "%" PRIu64, values[v]);
+            e_string_t signed_string = e_string_from_int64(-(int64_t)(values[v] / 2));
+            char expected_signed[32];
+            snprintf(expected_signed, sizeof(expected_signed), "%" PRId64,
+                     -(int64_t)(values[v] / 2));
+            if (priv_check(&unsigned_string, expected, true) == false
+                || priv_check(&signed_string, expected_signed, true) == false
+                || unsigned_string.codepoint_count != strlen(expected)) {
+                fprintf(stdout, "%s %s\n", u8"FAIL", expected);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+
+    e_string_t min64 = e_string_from_int64(INT64_MIN);
+    e_string_t max64 = e_string_from_uint64(UINT64_MAX);
+    e_string_t min32 = e_string_from_int32(INT32_MIN);
+    e_string_t min8 = e_string_from_int8(INT8_MIN);
+    e_string_t max16 = e_string_from_uint16(UINT16_MAX);
+    e_string_t zero = e_string_from_uint8(0);
+    e_string_t generic = e_string_from(-42);
+    e_string_t generic_cstr = e_string_from("literal");
+    e_string_t generic_long_long = e_string_from(-42LL);
+    e_string_t generic_unsigned_long = e_string_from(42UL);
+    if (priv_check(&min64, "-9223372036854775808", true) == false
+        || priv_check(&max64, "18446744073709551615", true) == false
+        || priv_check(&min32, "-2147483648", true) == false
+        || priv_check(&min8, "-128", true) == false
+        || priv_check(&max16, "65535", true) == false
+        || priv_check(&zero, "0", true) == false
+        || priv_check(&generic, "-42", true) == false
+        || priv_check(&generic_cstr, "literal", true) == false
+        || priv_check(&generic_long_long, "-42", true) == false
+        || priv_check(&generic_unsigned_long, "42", true) == false) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_5(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_from] Testing integer arrays");
+
+    const int64_t signed_numbers[] = { 0, -1, 42, INT64_MIN, 1000000 };
+    const uint32_t unsigned_numbers[] = { 7, 4294967295u, 10 };
+    e_string_t joined = e_string_from_int64_array(signed_numbers, 5, ", ");
+    e_string_t packed = e_string_from_uint32_array(unsigned_numbers, 3, "");
+    e_string_t empty = e_string_from_int32_array(NULL, 0, ",");
+    if (priv_check(&joined, "0, -1, 42, -9223372036854775808, 1000000",
+                   false) == false
+        || priv_check(&packed, "7429496729510", true) == false
+        || priv_check(&empty, "", true) == false
+        || joined.flags != (E_STRING_FLAG_UTF8 | E_STRING_FLAG_ASCII
+                            | E_STRING_FLAG_COUNTED)) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    e_string_free(&joined);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_6(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_from] Testing arena constructors");
+
+    e_arena_t arena;
+    e_arena_init(&arena, 256);
+    const char* long_text = u8"a string that does not fit inline: 日本語";
+
+    e_string_t key = e_string_from_cstr_in(&arena, "key");
+    e_string_t first = e_string_from_cstr_in(&arena, long_text);
+    e_string_t second = e_string_from_cstr_in(&arena, long_text);
+    e_string_t number = e_string_from_int64_in(&arena, INT64_MIN);
+    e_string_t unsigned_number = e_string_from_uint64_in(&arena, UINT64_MAX);
+    if (priv_check(&key, "key", true) == false
+        || priv_check(&first, long_text, false) == false
+        || priv_check(&second, long_text, false) == false
+        || priv_check(&number, "-9223372036854775808", true) == false
+        || priv_check(&unsigned_number, "18446744073709551615", true) == false
+        || (first.flags & E_STRING_FLAG_ARENA) == 0
+        || second.data != first.data + first.data_length) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+
+    /* free leaves the data to the arena, reset hands the memory out again */
+    const uint8_t* reused = first.data;
+    e_string_free(&first);
+    e_string_free(&second);
+    e_arena_reset(&arena);
+    e_string_t again = e_string_from_cstr_in(&arena, long_text);
+    if (priv_check(&first, "", true) == false
+        || again.data != reused) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+
+    e_arena_destroy(&arena);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_7(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_from] Testing floating point numbers");
+
+    /* known shortest texts, on every format */
+    const struct {
+        double number;
+        const char* shortest;
+        const char* fixed;
+        const char* scientific;
+    } doubles[] = {
+        { 1.5, "1.5", "1.5", "1.5e+0" },
+        { 0.1, "0.1", "0.1", "1e-1" },
+        { 0.3, "0.3", "0.3", "3e-1" },
+        { 0.1 + 0.2, "0.30000000000000004", "0.30000000000000004",
+          "3.0000000000000004e-1" },
+        { 100.0, "100", "100", "1e+2" },
+        { 123456.789, "123456.789", "123456.789", "1.23456789e+5" },
+        { 1e21, "1e+21", "1000000000000000000000", "1e+21" },
+        { 1e20, "100000000000000000000", "100000000000000000000", "1e+20" },
+        { 0.000001, "0.000001", "0.000001", "1e-6" },
+        { 1.5e-7, "1.5e-7", "0.00000015", "1.5e-7" },
+        { -2.5e-300, "-2.5e-300", NULL, "-2.5e-300" },
+        { 5e-324, "5e-324", NULL, "5e-324" },
+        { 1.7976931348623157e308, "1.7976931348623157e+308", NULL,
+          "1.7976931348623157e+308" },
+        { 9007199254740993.0, "9007199254740992", "9007199254740992",
+          "9.007199254740992e+15" },
+        { 0.0, "0", "0", "0e+0" },
+        { -0.0, "-0", "-0", "-0e+0" },
+        { 1.0 / 0.0, "inf", "inf", "inf" },
+        { -1.0 / 0.0, "-inf", "-inf", "-inf" },
+        { 0.0 / 0.0, "nan", "nan", "nan" }
+    };
+    for (size_t i = 0; i < sizeof(doubles) / sizeof(doubles[0]); i++) {
+        e_string_t shortest = e_string_from_double(doubles[i].number);
+        e_string_t fixed = e_string_from_double_ex(doubles[i].number,
+                                                   E_STRING_FLOAT_FIXED);
+        e_string_t scientific = e_string_from_double_ex(
+            doubles[i].number, E_STRING_FLOAT_SCIENTIFIC);
+        const size_t length = strlen(doubles[i].shortest);
+        if (priv_check(&shortest, doubles[i].shortest,
+                       length <= E_STRING_INLINE_CAPACITY) == false
+            || (doubles[i].fixed != NULL
+                && (e_string_length(&fixed) != strlen(doubles[i].fixed)
+                    || memcmp(e_string_data(&fixed), doubles[i].fixed,
+                              strlen(doubles[i].fixed)) != 0))
+            || e_string_length(&scientific) != strlen(doubles[i].scientific)
+            || memcmp(e_string_data(&scientific), doubles[i].scientific,
+                      strlen(doubles[i].scientific)) != 0) {
+            fprintf(stdout, "%s %s\n", u8"FAIL", doubles[i].shortest);
+            exit(EXIT_FAILURE);
+        }
+        e_string_free(&shortest);
+        e_string_free(&fixed);
+        e_string_free(&scientific);
+    }
+
+    /* fixed texts of the extremes are positional and read back */
+    e_string_t tiny = e_string_from_double_ex(5e-324, E_STRING_FLOAT_FIXED);
+    e_string_t huge = e_string_from_double_ex(1.7976931348623157e308,
+                                              E_STRING_FLOAT_FIXED);
+    if (e_string_length(&tiny) != 326 || e_string_length(&huge) != 309
+        || memcmp(e_string_data(&tiny) + 323, "005", 3) != 0
+        || memcmp(e_string_data(&huge), "17976931348623157000", 20) != 0) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    e_string_free(&tiny);
+    e_string_free(&huge);
+
+    /* random bits read back exactly, and shortest texts take at most 25
+     * bytes for doubles and 22 bytes for floats */
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    char text[400];
+    for (size_t i = 0; i < 100000; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        double number;
+        memcpy(&number, &state, sizeof(number));
+        if (number != number) {
+            continue;
+        }
+        e_string_t string = (i % 2 == 0)
+                            ? e_string_from_double(number)
+                            : e_string_from_double_ex(number,
+                                                      E_STRING_FLOAT_FIXED);
+        memcpy(text, e_string_data(&string), e_string_length(&string));
+        text[e_string_length(&string)] = '\0';
+        if (strtod(text, NULL) != number
+            || (i % 2 == 0 && e_string_length(&string) > 25)) {
+            fprintf(stdout, "%s %s\n", u8"FAIL", text);
+            exit(EXIT_FAILURE);
+        }
+        e_string_free(&string);
+
+        const uint32_t bits = (uint32_t)(state >> 32);
+        float single;
+        memcpy(&single, &bits, sizeof(single));
+        if (single != single) {
+            continue;
+        }
+        string = e_string_from(single);
+        memcpy(text, e_string_data(&string), e_string_length(&string));
+        text[e_string_length(&string)] = '\0';
+        if (strtof(text, NULL) != single || e_string_length(&string) > 22) {
+            fprintf(stdout, "%s %s\n", u8"FAIL", text);
+            exit(EXIT_FAILURE);
+        }
+        e_string_free(&string);
+    }
+
+    e_string_t generic = e_string_from(0.1f);
+    if (priv_check(&generic, "0.1", true) == false) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    test_4();
+    test_5();
+    test_6();
+    test_7();
+    return EXIT_SUCCESS;
+}
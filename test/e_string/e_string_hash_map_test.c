@@ -0,0 +1,240 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_hash_map testing
+ *
+ * the map is checked against an array of the expected value of every key,
+ * while keys are added, overwritten and removed in a random order.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_fail.h"
+
+/* private function priv_name
+ *
+ * writes the key of number on name, long keys are not inline
+ */
+static void priv_name(char* name, const size_t size, const size_t number)
+{
+    snprintf(name, size, (number % 4 == 0) ? "symbol::namespace::%zu" : "s%zu",
+             number);
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_hash_map] Testing a symbol table");
+
+    e_string_hash_map_t map;
+    e_string_hash_map_init(&map, sizeof(uint32_t));
+    if (e_string_hash_map_get_cstr(&map, "main") != NULL
+        || e_string_hash_map_remove(&map, e_string_view_from_cstr("main"))) {
+        test_fail();
+    }
+
+    const char* symbols[5] = { "main", "", "printf",
+                               "a_symbol_name_that_is_not_inline", "exit" };
+    for (uint32_t i = 0; i < 5; i++) {
+        if (e_string_hash_map_put(&map, e_string_view_from_cstr(symbols[i]),
+                                  &i) != E_STRING_SUCCESS) {
+            test_fail();
+        }
+    }
+    for (uint32_t i = 0; i < 5; i++) {
+        const uint32_t* value = e_string_hash_map_get_cstr(&map, symbols[i]);
+        if (value == NULL || *value != i) {
+            test_fail();
+        }
+    }
+
+    /* the same key through a view, a string and a key with cached hash */
+    e_string_t string = e_string_from_cstr("a_symbol_name_that_is_not_inline");
+    e_string_key_t key = { .string = e_string_from_cstr("printf") };
+    const uint32_t* by_string = e_string_hash_map_get(&map,
+                                                      e_string_view(&string));
+    const uint32_t* by_key = e_string_hash_map_get_key(&map, &key);
+    e_string_key_t copy = { .string = key.string };
+    if (by_string == NULL || *by_string != 3 || by_key == NULL || *by_key != 2
+        || e_string_hash_map_get_key(&map, &key) != by_key
+        || e_string_hash_map_get_key(&map, &copy) != by_key
+        || e_string_hash_map_get_cstr(&map, "print") != NULL
+        || map.count != 5) {
+        test_fail();
+    }
+
+    /* counting with entries */
+    const char* words[6] = { "exit", "main", "exit", "new", "exit", "new" };
+    for (size_t i = 0; i < 6; i++) {
+        uint32_t* value = NULL;
+        bool inserted = false;
+        e_string_hash_map_entry(&map, e_string_view_from_cstr(words[i]),
+                                (void**)&value, &inserted);
+        if (inserted != (i == 3) || (inserted && *value != 0)) {
+            test_fail();
+        }
+        *value += 10;
+    }
+    if (*(uint32_t*)e_string_hash_map_get_cstr(&map, "exit") != 34
+        || *(uint32_t*)e_string_hash_map_get_cstr(&map, "new") != 20
+        || map.count != 6) {
+        test_fail();
+    }
+
+    /* every key is visited once */
+    size_t cursor = 0;
+    size_t visited = 0;
+    const e_string_t* name = NULL;
+    void* value = NULL;
+    while (e_string_hash_map_next(&map, &cursor, &name, &value)) {
+        if (e_string_hash_map_get(&map, e_string_view(name)) != value) {
+            test_fail();
+        }
+        visited += 1;
+    }
+    if (visited != 6) {
+        test_fail();
+    }
+
+    e_string_free(&string);
+    e_string_free(&key.string);
+    e_string_hash_map_free(&map);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_hash_map] Testing random adds and removes");
+
+    const size_t numbers = 50000;
+    uint64_t* expected = calloc(numbers, sizeof(uint64_t));
+    e_string_hash_map_t map;
+    e_string_hash_map_init(&map, sizeof(uint64_t));
+
+    char name[48];
+    uint32_t seed = 11;
+    size_t count = 0;
+    for (size_t step = 0; step < 400000; step++) {
+        seed = seed * 1103515245u + 12345u;
+        const size_t number = (seed >> 8) % numbers;
+        priv_name(name, sizeof(name), number);
+        const e_string_view_t key = e_string_view_from_cstr(name);
+        if ((seed >> 4) % 3 == 0) {
+            const bool removed = e_string_hash_map_remove(&map, key);
+            if (removed != (expected[number] != 0)) {
+                test_fail();
+            }
+            count -= removed ? 1 : 0;
+            expected[number] = 0;
+        } else {
+            const uint64_t value = step + 1;
+            count += (expected[number] == 0) ? 1 : 0;
+            expected[number] = value;
+            if (e_string_hash_map_put(&map, key, &value) != E_STRING_SUCCESS) {
+                test_fail();
+            }
+        }
+    }
+
+    if (map.count != count) {
+        test_fail();
+    }
+    for (size_t number = 0; number < numbers; number++) {
+        priv_name(name, sizeof(name), number);
+        const uint64_t* value = e_string_hash_map_get_cstr(&map, name);
+        if ((expected[number] == 0) != (value == NULL)
+            || (value != NULL && *value != expected[number])) {
+            test_fail();
+        }
+    }
+
+    /* removing and adding back keeps the table from filling with
+     * tombstones, and reserve makes room at once */
+    const size_t capacity = map.capacity;
+    for (size_t round = 0; round < 20; round++) {
+        for (size_t number = 0; number < numbers; number += 2) {
+            priv_name(name, sizeof(name), number);
+            e_string_hash_map_remove(&map, e_string_view_from_cstr(name));
+        }
+        for (size_t number = 0; number < numbers; number += 2) {
+            priv_name(name, sizeof(name), number);
+            e_string_hash_map_put(&map, e_string_view_from_cstr(name),
+                                  &number);
+        }
+    }
+    if (map.capacity > capacity * 2
+        || e_string_hash_map_reserve(&map, 10 * numbers) != E_STRING_SUCCESS
+        || map.growth_left < 9 * numbers) {
+        test_fail();
+    }
+    for (size_t number = 0; number < numbers; number += 2) {
+        priv_name(name, sizeof(name), number);
+        const uint64_t* value = e_string_hash_map_get_cstr(&map, name);
+        if (value == NULL || *value != number) {
+            test_fail();
+        }
+    }
+
+    free(expected);
+    e_string_hash_map_free(&map);
+    if (map.count != 0 || map.capacity != 0
+        || e_string_hash_map_get_cstr(&map, "s1") != NULL) {
+        test_fail();
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_hash_map] Testing removed keys release their memory");
+
+    e_string_hash_map_t map;
+    e_string_hash_map_init(&map, sizeof(size_t));
+    const size_t kept = 7;
+    if (e_string_hash_map_put(&map, e_string_view_from_cstr(
+            "kept::symbol::namespace::name"), &kept) != E_STRING_SUCCESS) {
+        test_fail();
+    }
+
+    /* long keys added and removed over and over */
+    char name[64];
+    for (size_t i = 0; i < 200000; i++) {
+        snprintf(name, sizeof(name), "symbol::namespace::%09zu", i);
+        const e_string_view_t key = e_string_view_from_cstr(name);
+        if (e_string_hash_map_put(&map, key, &i) != E_STRING_SUCCESS
+            || e_string_hash_map_remove(&map, key) == false) {
+            test_fail();
+        }
+    }
+
+    size_t chunks = 0;
+    for (const e_arena_chunk_t* chunk = map.arena.head; chunk != NULL;
+         chunk = chunk->next) {
+        chunks += 1;
+    }
+    const size_t* value = e_string_hash_map_get_cstr(
+        &map, "kept::symbol::namespace::name");
+    if (chunks > 2 || map.count != 1 || value == NULL || *value != kept) {
+        test_fail();
+    }
+
+    e_string_hash_map_free(&map);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,199 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_hash testing
+ *
+ * known hashes pin the algorithm, so the scalar and the SIMD engines must
+ * agree with each other and across releases. the lengths cover every path:
+ * short reads, the mum loops, and the lanes with and without a full block.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_fail.h"
+
+/* private function priv_fill
+ *
+ * fills length bytes of data with a fixed pattern
+ */
+static void priv_fill(uint8_t* data, const size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        data[i] = (uint8_t)(i * 131 + 7);
+    }
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_hash] Testing known hashes on every path");
+
+    const size_t lengths[9] = { 0, 3, 16, 48, 255, 257, 1024, 1025, 5000 };
+    const uint64_t expected[9] = {
+        0x0409638ee2bde459ULL, 0x8e4fbcba74db6389ULL, 0x47340008ff15ca56ULL,
+        0xb61c237f7239a6efULL, 0x47f0f82501a490a7ULL, 0x82811a4491434ebeULL,
+        0xe1534e9c3407167dULL, 0x68242a2ce63176b9ULL, 0x6325d329ef1cabe0ULL
+    };
+    uint8_t* data = malloc(5000 + 64);
+    priv_fill(data, 5000);
+    for (size_t i = 0; i < 9; i++) {
+        const e_string_view_t view = e_string_view_from_bytes(data,
+                                                              lengths[i]);
+        if (e_string_view_hash64(view, 0) != expected[i]
+            || e_string_view_hash64(view, 1) == expected[i]) {
+            test_fail();
+        }
+    }
+
+    /* the hash does not depend on alignment or on where the data is kept */
+    for (size_t length = 0; length < 2100; length++) {
+        const uint64_t hash = e_string_view_hash64(
+            e_string_view_from_bytes(data, length), 42);
+        for (size_t shift = 1; shift < 64; shift += 21) {
+            memmove(data + shift, data, length);
+            const uint64_t moved = e_string_view_hash64(
+                e_string_view_from_bytes(data + shift, length), 42);
+            memmove(data, data + shift, length);
+            if (moved != hash) {
+                test_fail();
+            }
+        }
+    }
+
+    e_arena_t arena;
+    e_arena_init(&arena, 1024);
+    const char* texts[2] = { "short", "a string long enough for the heap" };
+    for (size_t i = 0; i < 2; i++) {
+        e_string_t string = e_string_from_cstr(texts[i]);
+        e_string_t in_arena = e_string_from_cstr_in(&arena, texts[i]);
+        const uint64_t hash = e_string_view_hash64(
+            e_string_view_from_cstr(texts[i]), 7);
+        if (e_string_hash64(&string, 7) != hash
+            || e_string_hash64(&in_arena, 7) != hash) {
+            test_fail();
+        }
+        e_string_free(&string);
+    }
+    e_arena_destroy(&arena);
+
+    free(data);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_hash] Testing that every bit changes the hash");
+
+    /* one bit flipped anywhere, on lengths of every path */
+    const size_t lengths[6] = { 1, 13, 40, 200, 700, 3000 };
+    uint8_t* data = malloc(3000);
+    for (size_t i = 0; i < 6; i++) {
+        const size_t length = lengths[i];
+        priv_fill(data, length);
+        const e_string_view_t view = e_string_view_from_bytes(data, length);
+        const uint64_t hash = e_string_view_hash64(view, 0);
+        for (size_t bit = 0; bit < length * 8; bit++) {
+            data[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+            const uint64_t flipped = e_string_view_hash64(view, 0);
+            data[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+
+            /* about half of the bits of the hash change */
+            uint64_t changed = hash ^ flipped;
+            size_t count = 0;
+            for (; changed != 0; changed &= changed - 1) {
+                count += 1;
+            }
+            if (count < 12 || count > 52) {
+                test_fail();
+            }
+        }
+    }
+
+    /* similar keys spread evenly over the low bits */
+    size_t buckets[256] = { 0 };
+    char key[32];
+    for (size_t i = 0; i < 256 * 64; i++) {
+        snprintf(key, sizeof(key), "user-%zu", i);
+        const uint64_t hash = e_string_view_hash64(
+            e_string_view_from_cstr(key), 0);
+        buckets[hash & 255] += 1;
+    }
+    for (size_t i = 0; i < 256; i++) {
+        if (buckets[i] < 32 || buckets[i] > 96) {
+            test_fail();
+        }
+    }
+
+    free(data);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_hash] Testing batches and cached key hashes");
+
+    e_string_t strings[37];
+    char text[64];
+    for (size_t i = 0; i < 37; i++) {
+        snprintf(text, sizeof(text), "%0*zu", (int)(i * 3 % 60), i);
+        strings[i] = e_string_from_cstr(text);
+    }
+    uint64_t hashes[37];
+    e_string_hash64_batch(strings, 37, 99, hashes);
+    for (size_t i = 0; i < 37; i++) {
+        if (hashes[i] != e_string_hash64(&strings[i], 99)) {
+            test_fail();
+        }
+        e_string_free(&strings[i]);
+    }
+    e_string_hash64_batch(NULL, 0, 99, NULL);
+
+    /* the cached hash is dropped when the key is invalidated */
+    e_string_key_t key = { .string = e_string_from_cstr("session") };
+    const uint64_t hash = e_string_key_hash(&key);
+    if (hash != e_string_hash64(&key.string, E_STRING_HASH_SEED)
+        || key.hashed == false || e_string_key_hash(&key) != hash) {
+        test_fail();
+    }
+    e_string_append_cstr(&key.string, "-2");
+    e_string_key_invalidate(&key);
+    if (key.hashed == true
+        || e_string_key_hash(&key) == hash
+        || e_string_key_hash(&key) != e_string_view_hash64(
+               e_string_view_from_cstr("session-2"), E_STRING_HASH_SEED)) {
+        test_fail();
+    }
+
+    /* a key made from the string of a hashed key computes its own hash */
+    e_string_key_t copy = { .string = key.string };
+    if (copy.hashed == true
+        || e_string_key_hash(&copy) != e_string_key_hash(&key)) {
+        test_fail();
+    }
+    e_string_clear(&key.string);
+    e_string_key_invalidate(&key);
+    if (e_string_key_hash(&key) != e_string_view_hash64(
+            e_string_view_from_cstr(""), E_STRING_HASH_SEED)) {
+        test_fail();
+    }
+
+    e_string_free(&key.string);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,268 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_intern testing
+ *
+ * several threads intern the same keys in different orders, and every one
+ * of them must get the same id for the same key.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <threads.h>
+
+#include "e_string.h"
+#include "test_allocator.h"
+#include "test_fail.h"
+
+#define PRIV_THREADS 8
+#define PRIV_KEYS 20000
+
+/* private struct priv_worker
+ *
+ * pool and results of a thread of test_3
+ */
+typedef struct priv_worker
+{
+    e_string_intern_pool_t* pool;
+    size_t first;
+    e_string_id_t ids[PRIV_KEYS];
+    bool failed;
+} priv_worker_t;
+
+/* private function priv_equals
+ *
+ * checks if string holds cstr
+ */
+static bool priv_equals(const e_string_t* string, const char* cstr)
+{
+    return string != NULL && e_string_length(string) == strlen(cstr)
+           && memcmp(e_string_data(string), cstr, strlen(cstr)) == 0;
+}
+
+/* private function priv_work
+ *
+ * interns every key starting at a different one on each thread
+ */
+static int priv_work(void* context)
+{
+    priv_worker_t* worker = context;
+    char key[32];
+    for (size_t n = 0; n < PRIV_KEYS; n++) {
+        const size_t i = (worker->first + n) % PRIV_KEYS;
+        snprintf(key, sizeof(key), "field_%zu", i % 7 == 0 ? i : i * 31);
+        if (e_string_intern(worker->pool, e_string_view_from_cstr(key),
+                            &worker->ids[i]) != E_STRING_SUCCESS
+            || priv_equals(e_string_intern_get(worker->pool,
+                                               worker->ids[i]), key)
+               == false) {
+            worker->failed = true;
+        }
+    }
+    return 0;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_intern] Testing ids of repeated field names");
+
+    e_string_intern_pool_t pool;
+    if (e_string_intern_pool_init(&pool) != E_STRING_SUCCESS) {
+        test_fail();
+    }
+
+    const char* fields[5] = { "timestamp", "level", "", "message",
+                              "a field name too long to be stored inline" };
+    e_string_id_t ids[5];
+    for (size_t round = 0; round < 3; round++) {
+        for (size_t i = 0; i < 5; i++) {
+            e_string_id_t id = E_STRING_INTERN_NONE;
+            if (e_string_intern(&pool, e_string_view_from_cstr(fields[i]),
+                                &id) != E_STRING_SUCCESS
+                || id == E_STRING_INTERN_NONE
+                || (round > 0 && id != ids[i])) {
+                test_fail();
+            }
+            ids[i] = id;
+        }
+    }
+    for (size_t i = 0; i < 5; i++) {
+        for (size_t j = i + 1; j < 5; j++) {
+            if (ids[i] == ids[j]) {
+                test_fail();
+            }
+        }
+        if (priv_equals(e_string_intern_get(&pool, ids[i]), fields[i])
+            == false
+            || e_string_intern_find(&pool, e_string_view_from_cstr(fields[i]))
+               != ids[i]) {
+            test_fail();
+        }
+    }
+    if (e_string_intern_pool_count(&pool) != 5
+        || e_string_intern_find(&pool, e_string_view_from_cstr("host"))
+           != E_STRING_INTERN_NONE
+        || e_string_intern_get(&pool, E_STRING_INTERN_NONE) != NULL
+        || e_string_intern_get(&pool, ids[0] + (1u << 20)) != NULL) {
+        test_fail();
+    }
+
+    /* the flags known by the view are kept */
+    e_string_t level = e_string_from_cstr(u8"nível");
+    e_string_validate(&level);
+    e_string_id_t id = E_STRING_INTERN_NONE;
+    e_string_intern(&pool, e_string_view(&level), &id);
+    if ((e_string_intern_get(&pool, id)->flags & E_STRING_FLAG_UTF8) == 0) {
+        test_fail();
+    }
+
+    e_string_free(&level);
+    e_string_intern_pool_free(&pool);
+    e_string_intern_pool_free(&pool);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_intern] Testing stable entries while the pool grows");
+
+    e_string_intern_pool_t pool;
+    e_string_intern_pool_init(&pool);
+
+    e_string_id_t first = E_STRING_INTERN_NONE;
+    e_string_intern(&pool, e_string_view_from_cstr("first value"), &first);
+    const e_string_t* stable = e_string_intern_get(&pool, first);
+
+    const size_t count = 200000;
+    e_string_id_t* ids = malloc(count * sizeof(e_string_id_t));
+    char key[48];
+    for (size_t i = 0; i < count; i++) {
+        snprintf(key, sizeof(key), "value-%zu%s", i,
+                 (i % 3 == 0) ? "-with-a-longer-heap-suffix" : "");
+        if (e_string_intern(&pool, e_string_view_from_cstr(key), &ids[i])
+            != E_STRING_SUCCESS) {
+            test_fail();
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        snprintf(key, sizeof(key), "value-%zu%s", i,
+                 (i % 3 == 0) ? "-with-a-longer-heap-suffix" : "");
+        if (priv_equals(e_string_intern_get(&pool, ids[i]), key) == false
+            || e_string_intern_find(&pool, e_string_view_from_cstr(key))
+               != ids[i]) {
+            test_fail();
+        }
+    }
+    if (e_string_intern_get(&pool, first) != stable
+        || priv_equals(stable, "first value") == false
+        || e_string_intern_pool_count(&pool) != count + 1) {
+        test_fail();
+    }
+
+    free(ids);
+    e_string_intern_pool_free(&pool);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_intern] Testing the same ids from many threads");
+
+    e_string_intern_pool_t pool;
+    e_string_intern_pool_init(&pool);
+
+    priv_worker_t* workers = calloc(PRIV_THREADS, sizeof(priv_worker_t));
+    thrd_t threads[PRIV_THREADS];
+    for (size_t t = 0; t < PRIV_THREADS; t++) {
+        workers[t].pool = &pool;
+        workers[t].first = t * (PRIV_KEYS / PRIV_THREADS);
+        if (thrd_create(&threads[t], priv_work, &workers[t]) != thrd_success) {
+            test_fail();
+        }
+    }
+    for (size_t t = 0; t < PRIV_THREADS; t++) {
+        thrd_join(threads[t], NULL);
+    }
+
+    for (size_t t = 0; t < PRIV_THREADS; t++) {
+        if (workers[t].failed
+            || memcmp(workers[t].ids, workers[0].ids,
+                      sizeof(workers[t].ids)) != 0) {
+            test_fail();
+        }
+    }
+    if (e_string_intern_pool_count(&pool) != PRIV_KEYS) {
+        test_fail();
+    }
+
+    free(workers);
+    e_string_intern_pool_free(&pool);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+static bool fail_chunks = false;
+
+/* private function priv_allocate
+ *
+ * counting allocation that fails for arena chunks while fail_chunks is set
+ */
+static void* priv_allocate(void* context, const size_t size)
+{
+    if (fail_chunks == true && size >= E_ARENA_DEFAULT_CHUNK_SIZE) {
+        return NULL;
+    }
+    return test_allocate(context, size);
+}
+
+void test_4(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_intern] Testing a failed insert keeps its page");
+
+    const e_string_allocator_t allocator = {
+        .allocate = priv_allocate,
+        .reallocate = test_reallocate,
+        .release = test_release,
+        .context = &counter
+    };
+    e_string_set_allocator(&allocator);
+
+    /* the first entry of a shard gets a page, then fails on its arena */
+    e_string_intern_pool_t pool;
+    e_string_intern_pool_init(&pool);
+    const e_string_view_t key = e_string_view_from_cstr(
+        "a key too long to be stored inline");
+    e_string_id_t id = E_STRING_INTERN_NONE;
+    fail_chunks = true;
+    if (e_string_intern(&pool, key, &id) != E_STRING_OUT_OF_MEMORY) {
+        test_fail();
+    }
+    fail_chunks = false;
+    if (e_string_intern(&pool, key, &id) != E_STRING_SUCCESS
+        || e_string_intern_find(&pool, key) != id) {
+        test_fail();
+    }
+    e_string_intern_pool_free(&pool);
+
+    if (test_allocator_check(u8"[e_string_intern]") != EXIT_SUCCESS) {
+        test_fail();
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    test_4();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_map_file testing
+ *
+ * files are written on the working directory and removed afterwards.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_fail.h"
+
+#define TEST_FILE "e_string_map_test.tmp"
+
+/* private function priv_write
+ *
+ * writes length bytes of data to TEST_FILE
+ */
+static void priv_write(const uint8_t* data, const size_t length)
+{
+    FILE* file = fopen(TEST_FILE, "wb");
+    if (file == NULL
+        || (length > 0 && fwrite(data, 1, length, file) != length)) {
+        test_fail();
+    }
+    fclose(file);
+}
+
+/* private function priv_repeat
+ *
+ * fills a new buffer of about size bytes with copies of piece
+ */
+static uint8_t* priv_repeat(const char* piece, const size_t size,
+                            size_t* length)
+{
+    const size_t piece_length = strlen(piece);
+    *length = size - size % piece_length;
+    uint8_t* data = malloc(*length);
+    for (size_t i = 0; i < *length; i += piece_length) {
+        memcpy(data + i, piece, piece_length);
+    }
+    return data;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_map] Testing files larger than a validation window");
+
+    /* 6 byte pieces, so the 4 MiB window limits fall inside a codepoint */
+    size_t length;
+    uint8_t* data = priv_repeat("ab\xF0\x9F\x9A\x80", 9 << 20, &length);
+    priv_write(data, length);
+
+    e_string_map_t map;
+    if (e_string_map_file(TEST_FILE, &map) != E_STRING_SUCCESS
+        || map.view.length != length
+        || map.view.flags != E_STRING_FLAG_UTF8
+        || memcmp(map.view.data, data, length) != 0) {
+        test_fail();
+    }
+    e_string_unmap(&map);
+
+    /* an invalid byte is found in the last window as well */
+    data[length - 5] = 0xFF;
+    priv_write(data, length);
+    if (e_string_map_file(TEST_FILE, &map) != E_STRING_INVALID_UTF8
+        || map.view.length != length
+        || map.view.flags != 0) {
+        test_fail();
+    }
+    e_string_unmap(&map);
+    if (map.mapping != NULL || map.view.length != 0) {
+        test_fail();
+    }
+
+    free(data);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_map] Testing US ASCII files and empty files");
+
+    size_t length;
+    uint8_t* data = priv_repeat("id,name,value\n", 5 << 20, &length);
+    priv_write(data, length);
+
+    e_string_map_t map;
+    if (e_string_map_file(TEST_FILE, &map) != E_STRING_SUCCESS
+        || map.view.length != length
+        || map.view.flags != (E_STRING_FLAG_UTF8 | E_STRING_FLAG_ASCII)) {
+        test_fail();
+    }
+    e_string_unmap(&map);
+    free(data);
+
+    priv_write(NULL, 0);
+    if (e_string_map_file(TEST_FILE, &map) != E_STRING_SUCCESS
+        || map.view.length != 0
+        || map.view.data == NULL
+        || map.mapping != NULL) {
+        test_fail();
+    }
+    e_string_unmap(&map);
+    e_string_unmap(&map);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_map] Testing paths that can not be mapped");
+
+    e_string_map_t map;
+    remove(TEST_FILE);
+    if (e_string_map_file(TEST_FILE, &map) != E_STRING_IO_ERROR
+        || map.mapping != NULL || map.view.length != 0
+        || e_string_map_file(".", &map) != E_STRING_IO_ERROR) {
+        test_fail();
+    }
+    e_string_unmap(&map);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_file = TEST_FILE;
+    test_1();
+    test_2();
+    test_3();
+    remove(TEST_FILE);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_matcher testing
+ *
+ * matches are checked against a naive search of every pattern on every
+ * offset, on random texts and patterns of a small alphabet, so patterns are
+ * prefixes and suffixes of each other.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_fail.h"
+
+/* private struct priv_collect
+ *
+ * matches gathered by priv_collect_match
+ */
+typedef struct priv_collect
+{
+    e_string_match_t matches[64];
+    size_t count;
+    size_t stop_after;
+} priv_collect_t;
+
+/* private function priv_matches_at
+ *
+ * checks if pattern is found at offset of text
+ */
+static bool priv_matches_at(const e_string_view_t text, const size_t offset,
+                            const e_string_t* pattern)
+{
+    const size_t length = e_string_length(pattern);
+    return length <= text.length - offset
+           && memcmp(text.data + offset, e_string_data(pattern), length) == 0;
+}
+
+/* private function priv_collect_match
+ *
+ * stores match on the priv_collect_t of context
+ */
+static bool priv_collect_match(const e_string_match_t* match, void* context)
+{
+    priv_collect_t* collect = context;
+    if (collect->count < 64) {
+        collect->matches[collect->count] = *match;
+    }
+    collect->count += 1;
+    return collect->count != collect->stop_after;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_matcher] Testing a blocklist on request paths");
+
+    e_string_t patterns[] = {
+        e_string_from_cstr("/admin"), e_string_from_cstr("/etc/passwd"),
+        e_string_from_cstr(".."), e_string_from_cstr("admin"),
+        e_string_from_cstr(u8"café")
+    };
+    e_string_matcher_t matcher;
+    if (e_string_matcher_build(&matcher, patterns, 5) != E_STRING_SUCCESS) {
+        test_fail();
+    }
+
+    const e_string_view_t safe = e_string_view_from_cstr("/api/v1/users?id=7");
+    const e_string_view_t bad = e_string_view_from_cstr(
+        u8"/static/../../etc/passwd?u=admin&q=café");
+    e_string_match_t match;
+    priv_collect_t collect = { .count = 0 };
+    if (e_string_matcher_find(&matcher, safe, 0, &match) == true
+        || e_string_matcher_find_all(&matcher, safe, NULL, NULL) != 0
+        || e_string_matcher_find(&matcher, bad, 0, &match) == false
+        || match.pattern != 2 || match.offset != 8 || match.length != 2
+        || e_string_matcher_find(&matcher, bad, 10, &match) == false
+        || match.pattern != 2 || match.offset != 11
+        || e_string_matcher_find(&matcher, bad, 13, &match) == false
+        || match.pattern != 1 || match.offset != 13
+        || e_string_matcher_find_all(&matcher, bad, priv_collect_match,
+                                     &collect) != 5
+        || collect.matches[2].pattern != 1
+        || collect.matches[3].pattern != 3
+        || collect.matches[4].pattern != 4
+        || collect.matches[4].offset != 35) {
+        test_fail();
+    }
+
+    /* the scan stops when the callback returns false */
+    collect.count = 0;
+    collect.stop_after = 2;
+    if (e_string_matcher_find_all(&matcher, bad, priv_collect_match, &collect)
+        != 2) {
+        test_fail();
+    }
+
+    e_string_t empty = e_string_from_cstr("");
+    e_string_matcher_free(&matcher);
+    if (e_string_matcher_find(&matcher, bad, 0, &match) == true
+        || e_string_matcher_build(&matcher, &empty, 1)
+           != E_STRING_INVALID_BUFFER
+        || e_string_matcher_build(&matcher, NULL, 0) != E_STRING_SUCCESS
+        || e_string_matcher_find_all(&matcher, bad, NULL, NULL) != 0) {
+        test_fail();
+    }
+    e_string_matcher_free(&matcher);
+
+    for (size_t i = 0; i < 5; i++) {
+        e_string_free(&patterns[i]);
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_matcher] Testing random pattern sets against naive search");
+
+    uint32_t seed = 3;
+    char buffer[2048];
+    for (size_t round = 0; round < 40; round++) {
+        /* duplicates and patterns sharing prefixes are likely */
+        const size_t pattern_count = 1 + round * 3;
+        e_string_t* patterns = malloc(pattern_count * sizeof(e_string_t));
+        for (size_t p = 0; p < pattern_count; p++) {
+            seed = seed * 1103515245u + 12345u;
+            const size_t length = 1 + (seed >> 16) % 6;
+            for (size_t i = 0; i < length; i++) {
+                seed = seed * 1103515245u + 12345u;
+                buffer[i] = "abcab"[(seed >> 16) % (2 + round % 4)];
+            }
+            buffer[length] = '\0';
+            patterns[p] = e_string_from_cstr(buffer);
+        }
+        const size_t length = 500 + round * 30;
+        for (size_t i = 0; i < length; i++) {
+            seed = seed * 1103515245u + 12345u;
+            buffer[i] = "abcx"[(seed >> 16) % 4];
+        }
+        const e_string_view_t text = e_string_view_from_bytes(
+            (const uint8_t*)buffer, length);
+
+        e_string_matcher_t matcher;
+        if (e_string_matcher_build(&matcher, patterns, pattern_count)
+            != E_STRING_SUCCESS) {
+            test_fail();
+        }
+
+        size_t all = 0;
+        for (size_t offset = 0; offset < length; offset++) {
+            for (size_t p = 0; p < pattern_count; p++) {
+                all += priv_matches_at(text, offset, &patterns[p]);
+            }
+        }
+        if (e_string_matcher_find_all(&matcher, text, NULL, NULL) != all) {
+            test_fail();
+        }
+
+        /* non-overlapping leftmost-first matches */
+        size_t from = 0;
+        e_string_match_t match;
+        while (e_string_matcher_find(&matcher, text, from, &match) == true) {
+            size_t offset = from;
+            size_t pattern = pattern_count;
+            for (; offset < length && pattern == pattern_count; offset++) {
+                for (pattern = 0; pattern < pattern_count; pattern++) {
+                    if (priv_matches_at(text, offset, &patterns[pattern])) {
+                        break;
+                    }
+                }
+            }
+            if (match.offset != offset - 1 || match.pattern != pattern
+                || match.length != e_string_length(&patterns[pattern])) {
+                test_fail();
+            }
+            from = match.offset + match.length;
+        }
+        for (size_t offset = from; offset < length; offset++) {
+            for (size_t p = 0; p < pattern_count; p++) {
+                if (priv_matches_at(text, offset, &patterns[p])) {
+                    test_fail();
+                }
+            }
+        }
+
+        e_string_matcher_free(&matcher);
+        for (size_t p = 0; p < pattern_count; p++) {
+            e_string_free(&patterns[p]);
+        }
+        free(patterns);
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,206 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string mutators and allocator testing
+ *
+ * every test runs on a counting allocator, which checks that sizes given
+ * back match the allocated ones and that nothing is leaked.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_allocator.h"
+#include "test_fail.h"
+
+/* private function priv_equals
+ *
+ * checks string holds expected, and that the cached flags agree with a fresh
+ * validation of the data
+ */
+static bool priv_equals(const e_string_t* string, const char* expected)
+{
+    const size_t length = strlen(expected);
+    e_string_t copy = *string;
+    e_string_invalidate(&copy);
+    const bool utf8 = e_string_validate(&copy) == E_STRING_SUCCESS;
+    return e_string_length(string) == length
+        && memcmp(e_string_data(string), expected, length) == 0
+        && ((string->flags & E_STRING_FLAG_UTF8) == 0 || utf8)
+        && ((string->flags & E_STRING_FLAG_COUNTED) == 0
+            || string->codepoint_count == copy.codepoint_count
+            || (copy.flags & E_STRING_FLAG_COUNTED) == 0);
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_mutate] Testing push_codepoint grows geometrically");
+
+    e_string_t string = e_string_from_cstr("");
+    const uint32_t codepoints[] = { 'a', 0xE7, 0x65E5, 0x1F680 };
+    const char* encoded[] = { "a", "\xC3\xA7", "\xE6\x97\xA5", "\xF0\x9F\x9A\x80" };
+    size_t length = 0;
+    for (size_t i = 0; i < 100000; i++) {
+        if (e_string_push_codepoint(&string, codepoints[i % 4])
+            != E_STRING_SUCCESS) {
+            test_fail();
+        }
+        length += strlen(encoded[i % 4]);
+        if (i == 3 && (e_string_is_inline(&string) == false
+                       || priv_equals(&string, u8"aç日🚀") == false)) {
+            test_fail();
+        }
+    }
+
+    /* the cache is kept, so the string is known valid without a new pass */
+    if (e_string_length(&string) != length
+        || e_string_is_inline(&string) == true
+        || counter.allocations != 1
+        || counter.reallocations > 20
+        || string.flags != (E_STRING_FLAG_UTF8 | E_STRING_FLAG_COUNTED)
+        || string.codepoint_count != 100000
+        || e_string_validate_ex(&string, E_STRING_ENGINE_SCALAR)
+           != E_STRING_SUCCESS) {
+        test_fail();
+    }
+    e_string_free(&string);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_mutate] Testing invalid codepoints are refused");
+
+    e_string_t string = e_string_from_cstr("ok");
+    const uint32_t invalid[] = { 0x00, 0x1B, 0x7F, 0xD800, 0xDFFF, 0x110000 };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        if (e_string_push_codepoint(&string, invalid[i])
+            != E_STRING_INVALID_UTF8) {
+            test_fail();
+        }
+    }
+    if (e_string_push_codepoint(&string, '\n') != E_STRING_SUCCESS
+        || e_string_push_codepoint(&string, 0x10FFFF) != E_STRING_SUCCESS
+        || priv_equals(&string, "ok\n\xF4\x8F\xBF\xBF") == false) {
+        test_fail();
+    }
+    e_string_free(&string);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_mutate] Testing append, self append and arena strings");
+
+    e_string_t string = e_string_from_cstr("abc");
+    e_string_validate(&string);
+    e_string_t other = e_string_from_cstr("");
+    e_string_push_codepoint(&other, 0xE7);
+    e_string_push_codepoint(&other, 0xE3);
+    e_string_push_codepoint(&other, 'o');
+    if (e_string_append(&string, &other) != E_STRING_SUCCESS
+        || priv_equals(&string, u8"abcção") == false
+        || string.flags != (E_STRING_FLAG_INLINE | E_STRING_FLAG_UTF8
+                            | E_STRING_FLAG_COUNTED)
+        || string.codepoint_count != 6) {
+        test_fail();
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (e_string_append(&string, &string) != E_STRING_SUCCESS) {
+            test_fail();
+        }
+    }
+    if (priv_equals(&string, u8"abcçãoabcçãoabcçãoabcçãoabcçãoabcçãoabcçãoabcção")
+            == false
+        || string.codepoint_count != 48
+        || e_string_append_cstr(&string, "!") != E_STRING_SUCCESS
+        || (string.flags & ~E_STRING_FLAGS_LAYOUT) != 0) {
+        test_fail();
+    }
+
+    /* arena strings move to the heap when they grow */
+    e_arena_t arena;
+    e_arena_init(&arena, 0);
+    e_string_t arena_string = e_string_from_cstr_in(&arena,
+                                                    "longer than inline storage");
+    if (e_string_append_cstr(&arena_string, "!") != E_STRING_SUCCESS
+        || (arena_string.flags & E_STRING_FLAG_ARENA) != 0
+        || priv_equals(&arena_string, "longer than inline storage!") == false) {
+        test_fail();
+    }
+    e_arena_destroy(&arena);
+
+    e_string_free(&arena_string);
+    e_string_free(&string);
+    e_string_free(&other);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_4(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_mutate] Testing reserve, shrink_to_fit and clear");
+
+    e_string_t string = e_string_from_cstr("short");
+    if (e_string_reserve(&string, 10) != E_STRING_SUCCESS
+        || e_string_is_inline(&string) == false
+        || e_string_reserve(&string, 1000) != E_STRING_SUCCESS
+        || e_string_capacity(&string) < 1005
+        || priv_equals(&string, "short") == false
+        || e_string_reserve(&string, SIZE_MAX) != E_STRING_OUT_OF_MEMORY) {
+        test_fail();
+    }
+
+    const size_t allocations = counter.allocations;
+    e_string_clear(&string);
+    if (e_string_length(&string) != 0
+        || e_string_capacity(&string) < 1005
+        || e_string_append_cstr(&string, "reused buffer, no allocation")
+           != E_STRING_SUCCESS
+        || counter.allocations != allocations
+        || e_string_shrink_to_fit(&string) != E_STRING_SUCCESS
+        || e_string_capacity(&string) != 28
+        || priv_equals(&string, "reused buffer, no allocation") == false) {
+        test_fail();
+    }
+
+    e_string_clear(&string);
+    if (e_string_append_cstr(&string, "fits inline") != E_STRING_SUCCESS
+        || e_string_shrink_to_fit(&string) != E_STRING_SUCCESS
+        || e_string_is_inline(&string) == false
+        || priv_equals(&string, "fits inline") == false) {
+        test_fail();
+    }
+    e_string_free(&string);
+
+    /* a zero initialized string is an empty heap string */
+    e_string_t zero = { 0 };
+    if (e_string_push_codepoint(&zero, 'z') != E_STRING_SUCCESS
+        || priv_equals(&zero, "z") == false) {
+        test_fail();
+    }
+    e_string_free(&zero);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_allocator_install();
+
+    test_1();
+    test_2();
+    test_3();
+    test_4();
+
+    return test_allocator_check(u8"[e_string_mutate]");
+}
@@ -0,0 +1,185 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_sort testing
+ *
+ * sorted arrays are compared with the same strings sorted by qsort, on
+ * inputs made to reach every path: short and long strings, strings that
+ * are prefixes of others, embedded zero bytes and long common prefixes.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_fail.h"
+
+#define TEST_COUNT 50000
+
+/* private function priv_random
+ *
+ * xorshift generator, so the inputs are the same on every run
+ */
+static uint64_t priv_random(void)
+{
+    static uint64_t state = 0x9E3779B97F4A7C15ULL;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+/* private function priv_compare
+ *
+ * qsort order of strings, the reference order
+ */
+static int priv_compare(const void* a, const void* b)
+{
+    const e_string_t* first = a;
+    const e_string_t* second = b;
+    const size_t first_length = e_string_length(first);
+    const size_t second_length = e_string_length(second);
+    const size_t shortest = (first_length < second_length) ? first_length
+                                                           : second_length;
+    const int order = (shortest > 0)
+                      ? memcmp(e_string_data(first), e_string_data(second),
+                               shortest)
+                      : 0;
+    if (order != 0) {
+        return order;
+    }
+    return (first_length > second_length) - (first_length < second_length);
+}
+
+/* private function priv_fill
+ *
+ * fills strings with count strings of the given kind:
+ *   - 0: random words of 0 to 12 letters from a small alphabet
+ *   - 1: urls sharing a 30 byte prefix, with zero bytes and prefixes
+ *   - 2: few distinct values repeated many times
+ */
+static void priv_fill(e_string_t* strings, const size_t count,
+                      const int kind)
+{
+    uint8_t buffer[128];
+    for (size_t i = 0; i < count; i++) {
+        size_t length = 0;
+        if (kind == 0) {
+            length = (size_t)(priv_random() % 13);
+            for (size_t j = 0; j < length; j++) {
+                buffer[j] = (uint8_t)('a' + priv_random() % 4);
+            }
+        } else if (kind == 1) {
+            memcpy(buffer, "https://example.com/api/users/", 30);
+            length = 30 + (size_t)(priv_random() % 40);
+            for (size_t j = 30; j < length; j++) {
+                buffer[j] = (uint8_t)(priv_random() % 3);
+            }
+        } else {
+            length = (size_t)snprintf((char*)buffer, sizeof(buffer),
+                                      "value-%02u-with-a-long-tail-%s",
+                                      (unsigned)(priv_random() % 20),
+                                      (priv_random() % 2) ? "x" : "");
+        }
+        const e_string_view_t view = { .data = buffer, .length = length };
+        strings[i] = e_string_from_view(view);
+    }
+}
+
+/* private function priv_free
+ *
+ * releases count strings
+ */
+static void priv_free(e_string_t* strings, const size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        e_string_free(&strings[i]);
+    }
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_sort] Testing sort matches qsort");
+
+    e_string_t* strings = malloc(TEST_COUNT * sizeof(e_string_t));
+    e_string_t* expected = malloc(TEST_COUNT * sizeof(e_string_t));
+    const size_t counts[] = { 0, 1, 2, 31, 33, 1000, TEST_COUNT };
+    for (int kind = 0; kind < 3; kind++) {
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+            for (size_t threads = 1; threads <= 4; threads += 3) {
+                const size_t count = counts[c];
+                priv_fill(strings, count, kind);
+                memcpy(expected, strings, count * sizeof(e_string_t));
+                qsort(expected, count, sizeof(e_string_t), priv_compare);
+                if (e_string_sort(strings, count, threads)
+                    != E_STRING_SUCCESS) {
+                    test_fail();
+                }
+                for (size_t i = 0; i < count; i++) {
+                    if (priv_compare(&strings[i], &expected[i]) != 0) {
+                        test_fail();
+                    }
+                }
+                priv_free(strings, count);
+            }
+        }
+    }
+    free(expected);
+    free(strings);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_sort] Testing stable sort and index permutation");
+
+    e_string_t* strings = malloc(TEST_COUNT * sizeof(e_string_t));
+    e_string_t* sorted = malloc(TEST_COUNT * sizeof(e_string_t));
+    size_t* indices = malloc(TEST_COUNT * sizeof(size_t));
+    for (int kind = 0; kind < 3; kind++) {
+        for (size_t threads = 1; threads <= 4; threads += 3) {
+            /* equal strings are told apart by their position, kept on
+             * codepoint_count which is unused without E_STRING_FLAG_COUNTED */
+            priv_fill(strings, TEST_COUNT, kind);
+            for (size_t i = 0; i < TEST_COUNT; i++) {
+                strings[i].codepoint_count = (uint32_t)i;
+            }
+            memcpy(sorted, strings, TEST_COUNT * sizeof(e_string_t));
+            if (e_string_sort_indices(strings, TEST_COUNT, indices, threads)
+                    != E_STRING_SUCCESS
+                || e_string_sort_stable(sorted, TEST_COUNT, threads)
+                   != E_STRING_SUCCESS) {
+                test_fail();
+            }
+
+            for (size_t i = 0; i < TEST_COUNT; i++) {
+                if (sorted[i].codepoint_count != indices[i]
+                    || (i > 0
+                        && (priv_compare(&sorted[i - 1], &sorted[i]) > 0
+                            || (priv_compare(&sorted[i - 1], &sorted[i]) == 0
+                                && indices[i - 1] > indices[i])))) {
+                    test_fail();
+                }
+            }
+            priv_free(strings, TEST_COUNT);
+        }
+    }
+    free(indices);
+    free(sorted);
+    free(strings);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    return EXIT_SUCCESS;
+}
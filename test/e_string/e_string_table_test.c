@@ -0,0 +1,308 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_table testing
+ *
+ * tables are compared with the strings they were built from, before and
+ * after a round trip through a buffer and a file. files are written on the
+ * working directory and removed afterwards.
+ */
+
+/* fileno is POSIX, the tests are built without extensions */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_fail.h"
+
+#define TEST_FILE "e_string_table_test.tmp"
+#define TEST_COUNT 100000
+
+/* private function priv_row
+ *
+ * writes the text of row i on buffer, returning its length
+ */
+static size_t priv_row(const size_t i, char* buffer)
+{
+    if (i % 7 == 0) {
+        return 0;
+    }
+    return (size_t)snprintf(buffer, 64, "row %zu %s", i,
+                            (i % 3 == 0) ? u8"ção" : "abc");
+}
+
+/* private function priv_check
+ *
+ * checks table holds the rows from priv_row
+ */
+static bool priv_check(const e_string_table_t* table)
+{
+    char buffer[64];
+    if (table->count != TEST_COUNT) {
+        return false;
+    }
+    for (size_t i = 0; i < TEST_COUNT; i++) {
+        const size_t length = priv_row(i, buffer);
+        const e_string_view_t view = e_string_table_get(table, i);
+        if (view.length != length
+            || memcmp(view.data, buffer, length) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* private function priv_build
+ *
+ * fills table with the rows from priv_row
+ */
+static void priv_build(e_string_table_t* table)
+{
+    char buffer[64];
+    e_string_table_init(table);
+    for (size_t i = 0; i < TEST_COUNT; i++) {
+        const size_t length = priv_row(i, buffer);
+        const e_string_view_t view = { .data = (const uint8_t*)buffer,
+                                       .length = length };
+        if (e_string_table_append_view(table, view) != E_STRING_SUCCESS) {
+            test_fail();
+        }
+    }
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_table] Testing append and indexed access");
+
+    e_string_table_t table;
+    priv_build(&table);
+    if (priv_check(&table) == false || table.offset_width != 4
+        || table.offsets == NULL || table.flags != 0
+        || e_string_table_get(&table, TEST_COUNT).length != 0) {
+        test_fail();
+    }
+
+    /* a string costs its bytes and 4 bytes of offset */
+    if (table.offset_capacity * table.offset_width + table.data_capacity
+        > 2 * (TEST_COUNT * 4 + table.data_length)) {
+        test_fail();
+    }
+
+    e_string_t text = e_string_from_cstr(u8"one more, now validated: 你好");
+    e_string_validate(&text);
+    if (e_string_table_append(&table, &text) != E_STRING_SUCCESS
+        || table.count != TEST_COUNT + 1
+        || e_string_table_get(&table, TEST_COUNT).length
+           != e_string_length(&text)) {
+        test_fail();
+    }
+    e_string_free(&text);
+
+    e_string_table_free(&table);
+    if (table.count != 0 || table.data != NULL || table.offsets != NULL) {
+        test_fail();
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_table] Testing validate all strings at once");
+
+    e_string_table_t table;
+    priv_build(&table);
+    if (e_string_table_validate(&table) != E_STRING_SUCCESS
+        || table.flags != E_STRING_FLAG_UTF8
+        || e_string_table_get(&table, 3).flags != E_STRING_FLAG_UTF8) {
+        test_fail();
+    }
+    e_string_table_free(&table);
+
+    /* "ç" split between two strings: the blob is valid, the strings not */
+    const uint8_t split[] = { 'a', 0xC3, 0xA7, 'b' };
+    const e_string_view_t first = { .data = split, .length = 2 };
+    const e_string_view_t second = { .data = split + 2, .length = 2 };
+    e_string_table_init(&table);
+    if (e_string_table_append_view(&table, first) != E_STRING_SUCCESS
+        || e_string_table_append_view(&table, second) != E_STRING_SUCCESS
+        || e_string_table_validate(&table) != E_STRING_INVALID_UTF8
+        || table.flags != 0) {
+        test_fail();
+    }
+    e_string_table_free(&table);
+
+    /* ASCII strings and the empty table */
+    e_string_table_init(&table);
+    if (e_string_table_validate(&table) != E_STRING_SUCCESS
+        || e_string_table_append_view(&table,
+                                      e_string_view_from_cstr("plain"))
+           != E_STRING_SUCCESS
+        || e_string_table_validate(&table) != E_STRING_SUCCESS
+        || table.flags != (E_STRING_FLAG_UTF8 | E_STRING_FLAG_ASCII)) {
+        test_fail();
+    }
+    e_string_table_free(&table);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_table] Testing serialize and borrow back");
+
+    e_string_table_t table;
+    priv_build(&table);
+
+    /* the header, the 100001 offsets padded to 8 bytes and the blob */
+    size_t length = 0;
+    if (e_string_table_serialize(&table, NULL, 0, &length)
+            != E_STRING_OUT_OF_RANGE
+        || length != e_string_table_serialized_length(&table)
+        || length != 32 + (TEST_COUNT + 2) * 4 + table.data_length) {
+        test_fail();
+    }
+
+    /* malloc memory is aligned as a mmapped file is */
+    uint8_t* buffer = malloc(length);
+    size_t written = 0;
+    if (e_string_table_serialize(&table, buffer, length, &written)
+            != E_STRING_SUCCESS
+        || written != length) {
+        test_fail();
+    }
+
+    e_string_table_t borrowed;
+    if (e_string_table_deserialize(&borrowed, buffer, length)
+            != E_STRING_SUCCESS
+        || borrowed.borrowed == false || borrowed.data < buffer
+        || borrowed.data >= buffer + length || priv_check(&borrowed) == false) {
+        test_fail();
+    }
+
+    /* changing a borrowed table copies it first */
+    uint8_t* copy = malloc(length);
+    memcpy(copy, buffer, length);
+    if (e_string_table_append_view(&borrowed,
+                                   e_string_view_from_cstr("new row"))
+            != E_STRING_SUCCESS
+        || borrowed.borrowed == true || borrowed.count != TEST_COUNT + 1
+        || memcmp(copy, buffer, length) != 0) {
+        test_fail();
+    }
+    e_string_table_free(&borrowed);
+
+    /* broken memory is refused */
+    e_string_table_t broken;
+    buffer[0] ^= 1;
+    if (e_string_table_deserialize(&broken, buffer, length)
+            != E_STRING_INVALID_BUFFER) {
+        test_fail();
+    }
+    buffer[0] ^= 1;
+    const uint32_t large = UINT32_MAX;
+    memcpy(buffer + 32 + 10 * 4, &large, sizeof(large));
+    if (e_string_table_deserialize(&broken, buffer, length)
+            != E_STRING_INVALID_BUFFER
+        || e_string_table_deserialize(&broken, copy, length - 1)
+           != E_STRING_INVALID_BUFFER
+        || e_string_table_deserialize(&broken, copy + 1, length - 1)
+           != E_STRING_INVALID_BUFFER) {
+        test_fail();
+    }
+    free(copy);
+    free(buffer);
+
+    /* the same bytes go to a file */
+    FILE* file = fopen(TEST_FILE, "wb");
+    if (file == NULL
+        || e_string_table_write(&table, fileno(file)) != E_STRING_SUCCESS) {
+        test_fail();
+    }
+    fclose(file);
+
+    buffer = malloc(length + 1);
+    file = fopen(TEST_FILE, "rb");
+    if (file == NULL || fread(buffer, 1, length + 1, file) != length
+        || e_string_table_deserialize(&borrowed, buffer, length)
+           != E_STRING_SUCCESS
+        || priv_check(&borrowed) == false) {
+        test_fail();
+    }
+    fclose(file);
+    remove(TEST_FILE);
+    e_string_table_free(&borrowed);
+    free(buffer);
+
+    if (e_string_table_write(&table, -1) != E_STRING_IO_ERROR) {
+        test_fail();
+    }
+    e_string_table_free(&table);
+
+    /* an empty table has a single offset */
+    e_string_table_init(&table);
+    uint64_t empty[5];
+    if (e_string_table_serialize(&table, (uint8_t*)empty, sizeof(empty),
+                                 &length)
+            != E_STRING_SUCCESS
+        || length != 40
+        || e_string_table_deserialize(&borrowed, empty, length)
+           != E_STRING_SUCCESS
+        || borrowed.count != 0) {
+        test_fail();
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_4(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_table] Testing append of its own strings");
+
+    /* the appended string lives in the data that grows */
+    uint8_t row[1000];
+    for (size_t i = 0; i < sizeof(row); i++) {
+        row[i] = (uint8_t)('a' + i % 26);
+    }
+    e_string_table_t table;
+    e_string_table_init(&table);
+    if (e_string_table_append_view(&table,
+                                   e_string_view_from_bytes(row, sizeof(row)))
+        != E_STRING_SUCCESS) {
+        test_fail();
+    }
+    for (size_t i = 0; i < 8; i++) {
+        if (e_string_table_append_view(&table, e_string_table_get(&table, i))
+            != E_STRING_SUCCESS) {
+            test_fail();
+        }
+    }
+    for (size_t i = 0; i < table.count; i++) {
+        const e_string_view_t view = e_string_table_get(&table, i);
+        if (view.length != sizeof(row)
+            || memcmp(view.data, row, sizeof(row)) != 0) {
+            test_fail();
+        }
+    }
+
+    e_string_table_free(&table);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_file = TEST_FILE;
+    test_1();
+    test_2();
+    test_3();
+    test_4();
+    return EXIT_SUCCESS;
+}
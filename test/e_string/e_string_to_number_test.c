@@ -0,0 +1,242 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_to_number parsers testing */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+
+/* private function priv_fail
+ *
+ * reports the failed case and stops the test
+ */
+static void priv_fail(const char* text)
+{
+    fprintf(stdout, "%s (%s)\n", u8"FAIL", text);
+    exit(EXIT_FAILURE);
+}
+
+/* private function priv_bits
+ *
+ * bits of number, so zeros and infinities compare with their sign
+ */
+static uint64_t priv_bits(const double number)
+{
+    uint64_t bits = 0;
+    memcpy(&bits, &number, sizeof(bits));
+    return bits;
+}
+
+/* private function priv_double
+ *
+ * checks text reads as expected with the expected result
+ */
+static void priv_double(const char* text, const double expected,
+                        const e_string_errno_t result)
+{
+    double number = 0.0;
+    if (e_string_view_to_double(e_string_view_from_cstr(text), &number)
+            != result
+        || priv_bits(number) != priv_bits(expected)) {
+        priv_fail(text);
+    }
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_to_number] Testing integers and their limits");
+
+    const struct {
+        const char* text;
+        int64_t expected;
+    } valid[] = {
+        { "0", 0 },
+        { "-0", 0 },
+        { "+42", 42 },
+        { "0000000000000000000000000007", 7 },
+        { "12345678", 12345678 },
+        { "-1234567890123456", -1234567890123456 },
+        { "9223372036854775807", INT64_MAX },
+        { "-9223372036854775808", INT64_MIN },
+    };
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        int64_t number = 1;
+        if (e_string_view_to_int64(e_string_view_from_cstr(valid[i].text),
+                                   &number) != E_STRING_SUCCESS
+            || number != valid[i].expected) {
+            priv_fail(valid[i].text);
+        }
+    }
+
+    const char* invalid[] = { "", "-", "+", " 1", "1 ", "1.0", "0x10",
+                              "--1", "1e3", "12345678a" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        int64_t number = 1;
+        if (e_string_view_to_int64(e_string_view_from_cstr(invalid[i]),
+                                   &number) != E_STRING_INVALID_NUMBER
+            || number != 1) {
+            priv_fail(invalid[i]);
+        }
+    }
+
+    int64_t number = 1;
+    uint64_t unsigned_number = 1;
+    if (e_string_view_to_int64(e_string_view_from_cstr(
+            "9223372036854775808"), &number) != E_STRING_OUT_OF_RANGE
+        || e_string_view_to_int64(e_string_view_from_cstr(
+            "-9223372036854775809"), &number) != E_STRING_OUT_OF_RANGE
+        || e_string_view_to_int64(e_string_view_from_cstr(
+            "100000000000000000000"), &number) != E_STRING_OUT_OF_RANGE
+        || number != 1
+        || e_string_view_to_uint64(e_string_view_from_cstr(
+            "18446744073709551615"), &unsigned_number) != E_STRING_SUCCESS
+        || unsigned_number != UINT64_MAX
+        || e_string_view_to_uint64(e_string_view_from_cstr(
+            "18446744073709551616"), &unsigned_number)
+            != E_STRING_OUT_OF_RANGE
+        || e_string_view_to_uint64(e_string_view_from_cstr(
+            "99999999999999999999"), &unsigned_number)
+            != E_STRING_OUT_OF_RANGE
+        || e_string_view_to_uint64(e_string_view_from_cstr("-1"),
+                                   &unsigned_number)
+            != E_STRING_INVALID_NUMBER
+        || unsigned_number != UINT64_MAX) {
+        priv_fail("limits");
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_to_number] Testing doubles round to nearest");
+
+    priv_double("0", 0.0, E_STRING_SUCCESS);
+    priv_double("-0.0", -0.0, E_STRING_SUCCESS);
+    priv_double("1", 1.0, E_STRING_SUCCESS);
+    priv_double(".5", 0.5, E_STRING_SUCCESS);
+    priv_double("5.", 5.0, E_STRING_SUCCESS);
+    priv_double("+1.5E+2", 150.0, E_STRING_SUCCESS);
+    priv_double("0.1", 0.1, E_STRING_SUCCESS);
+    priv_double("3.141592653589793", 3.141592653589793, E_STRING_SUCCESS);
+    priv_double("-2.5e-3", -2.5e-3, E_STRING_SUCCESS);
+    priv_double("1e23", 1e23, E_STRING_SUCCESS);
+    priv_double("123456789012345678901234567890", 1.2345678901234568e29,
+                E_STRING_SUCCESS);
+    priv_double("0.000000000000000000000000000000000000000001", 1e-42,
+                E_STRING_SUCCESS);
+
+    /* the limits of the double range */
+    priv_double("1.7976931348623157e308", 1.7976931348623157e308,
+                E_STRING_SUCCESS);
+    priv_double("2.2250738585072014e-308", 2.2250738585072014e-308,
+                E_STRING_SUCCESS);
+    priv_double("4.9e-324", 4.9406564584124654e-324, E_STRING_SUCCESS);
+    priv_double("2.4703282292062328e-324", 4.9406564584124654e-324,
+                E_STRING_SUCCESS);
+    priv_double("2.4703282292062327e-324", 0.0, E_STRING_SUCCESS);
+    priv_double("1e-400", 0.0, E_STRING_SUCCESS);
+    priv_double("1.7976931348623159e308", HUGE_VAL, E_STRING_OUT_OF_RANGE);
+    priv_double("-1e400", -HUGE_VAL, E_STRING_OUT_OF_RANGE);
+
+    /* exactly halfway between 1 and the next double goes to even, any
+     * digit after the halfway point goes up */
+    priv_double("1.00000000000000011102230246251565404236316680908203125",
+                1.0, E_STRING_SUCCESS);
+    priv_double("1.000000000000000111022302462515654042363166809082031250001",
+                1.0000000000000002, E_STRING_SUCCESS);
+    priv_double("1.00000000000000033306690738754696212708950042724609375",
+                1.0000000000000004, E_STRING_SUCCESS);
+    priv_double("9007199254740993", 9007199254740992.0, E_STRING_SUCCESS);
+    priv_double("9007199254740993.0000000000000000000000000001",
+                9007199254740994.0, E_STRING_SUCCESS);
+
+    priv_double("inf", HUGE_VAL, E_STRING_SUCCESS);
+    priv_double("-Infinity", -HUGE_VAL, E_STRING_SUCCESS);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_to_number] Testing text that is not a double");
+
+    const char* invalid[] = { "", "+", ".", "-.", "e5", "1e", "1e+", "1..2",
+                              "1.2.3", " 1", "1 ", "0x1p3", "in", "infinit",
+                              "nanx", "1,5", "1e5e5" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        double number = 1.0;
+        if (e_string_view_to_double(e_string_view_from_cstr(invalid[i]),
+                                    &number) != E_STRING_INVALID_NUMBER
+            || number != 1.0) {
+            priv_fail(invalid[i]);
+        }
+    }
+
+    double number = 0.0;
+    if (e_string_view_to_double(e_string_view_from_cstr("NaN"), &number)
+            != E_STRING_SUCCESS
+        || number == number) {
+        priv_fail("NaN");
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_4(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_to_number] Testing strings and views in place");
+
+    /* views are length delimited, the bytes after them are not read */
+    const char* line = "id=1234567890123,price=-17.25e1,qty=007";
+    const e_string_view_t id = { .data = (const uint8_t*)line + 3,
+                                 .length = 13 };
+    const e_string_view_t price = { .data = (const uint8_t*)line + 23,
+                                    .length = 8 };
+    e_string_t qty = e_string_from_cstr(line + 36);
+
+    uint64_t id_number = 0;
+    double price_number = 0.0;
+    int64_t qty_number = 0;
+    if (e_string_view_to_uint64(id, &id_number) != E_STRING_SUCCESS
+        || id_number != 1234567890123
+        || e_string_view_to_double(price, &price_number) != E_STRING_SUCCESS
+        || price_number != -172.5
+        || e_string_to_int64(&qty, &qty_number) != E_STRING_SUCCESS
+        || qty_number != 7) {
+        priv_fail(line);
+    }
+
+    /* a double written by e_string_from_double reads back to itself */
+    const double numbers[] = { 0.1, 1.0 / 3.0, 6.02214076e23, 5e-324,
+                               -1.7976931348623157e308, 123456.789 };
+    for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); i++) {
+        e_string_t text = e_string_from_double(numbers[i]);
+        double number = 0.0;
+        if (e_string_to_double(&text, &number) != E_STRING_SUCCESS
+            || number != numbers[i]) {
+            priv_fail((const char*)e_string_data(&text));
+        }
+        e_string_free(&text);
+    }
+    e_string_free(&qty);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    test_4();
+    return EXIT_SUCCESS;
+}
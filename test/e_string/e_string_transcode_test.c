@@ -0,0 +1,323 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_transcode testing
+ *
+ * random texts are built as lists of codepoints and encoded by the test
+ * itself, then every conversion is checked against those encodings. runs of
+ * US ASCII and of BMP codepoints are long enough to go through SIMD blocks.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_fail.h"
+
+static const uint32_t ascii[] = { 'a', 'Z', ' ', '0', '\n', '\t', '~' };
+static const uint32_t bmp[] = { 0xE7, 0x3A9, 0x7FF, 0x800, 0x65E5, 0xFFFD };
+static const uint32_t astral[] = { 0x10000, 0x1F680, 0x10348, 0x10FFFF };
+
+/* private function priv_le16
+ *
+ * stores unit in little endian order whatever the host order is
+ */
+static uint16_t priv_le16(const uint16_t unit)
+{
+    const uint8_t bytes[2] = { (uint8_t)(unit & 0xFF), (uint8_t)(unit >> 8) };
+    uint16_t result;
+    memcpy(&result, bytes, sizeof(result));
+    return result;
+}
+
+/* private function priv_random_codepoints
+ *
+ * fills codepoints with runs of US ASCII, BMP and astral codepoints
+ */
+static void priv_random_codepoints(uint32_t* codepoints, const size_t count,
+                                   uint32_t seed)
+{
+    size_t i = 0;
+    while (i < count) {
+        seed = seed * 1103515245u + 12345u;
+        const uint32_t kind = (seed >> 16) % 3;
+        const size_t run = (seed >> 20) % 70;
+        for (size_t k = 0; k < run && i < count; k++, i++) {
+            seed = seed * 1103515245u + 12345u;
+            const uint32_t pick = seed >> 16;
+            codepoints[i] = (kind == 0) ? ascii[pick % 7]
+                          : (kind == 1) ? bmp[pick % 6] : astral[pick % 4];
+        }
+    }
+}
+
+/* private function priv_utf16
+ *
+ * encodes codepoints as UTF-16LE on units, returning the amount of units
+ */
+static size_t priv_utf16(const uint32_t* codepoints, const size_t count,
+                         uint16_t* units)
+{
+    size_t written = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (codepoints[i] < 0x10000) {
+            units[written++] = priv_le16((uint16_t)codepoints[i]);
+        } else {
+            const uint32_t offset = codepoints[i] - 0x10000;
+            units[written++] = priv_le16((uint16_t)(0xD800 + (offset >> 10)));
+            units[written++] = priv_le16((uint16_t)(0xDC00 + (offset & 0x3FF)));
+        }
+    }
+    return written;
+}
+
+/* private function priv_utf8
+ *
+ * encodes codepoints as a string, one push at a time
+ */
+static e_string_t priv_utf8(const uint32_t* codepoints, const size_t count)
+{
+    e_string_t text = e_string_from_cstr("");
+    for (size_t i = 0; i < count; i++) {
+        if (e_string_push_codepoint(&text, codepoints[i]) != E_STRING_SUCCESS) {
+            test_fail();
+        }
+    }
+    return text;
+}
+
+/* private function priv_same
+ *
+ * compares the data of two strings
+ */
+static bool priv_same(const e_string_t* left, const e_string_t* right)
+{
+    return e_string_length(left) == e_string_length(right)
+           && memcmp(e_string_data(left), e_string_data(right),
+                     e_string_length(left)) == 0;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_transcode] Testing round trips of random texts");
+
+    const size_t max_count = 700;
+    uint32_t* codepoints = malloc(max_count * sizeof(uint32_t));
+    uint32_t* utf32 = malloc(max_count * sizeof(uint32_t));
+    uint16_t* utf16 = malloc(2 * max_count * sizeof(uint16_t));
+    uint16_t* units = malloc(4 * max_count * sizeof(uint16_t));
+
+    for (size_t count = 0; count < max_count; count += 7) {
+        priv_random_codepoints(codepoints, count, (uint32_t)count + 1);
+        e_string_t expected = priv_utf8(codepoints, count);
+        const size_t utf16_count = priv_utf16(codepoints, count, utf16);
+
+        e_string_t from16;
+        e_string_t from32;
+        if (e_string_from_utf16le(utf16, utf16_count, &from16)
+                != E_STRING_SUCCESS
+            || e_string_from_utf32(codepoints, count, &from32)
+               != E_STRING_SUCCESS
+            || priv_same(&from16, &expected) == false
+            || priv_same(&from32, &expected) == false
+            || (from16.flags & E_STRING_FLAG_UTF8) == 0
+            || from16.codepoint_count != count
+            || from32.codepoint_count != count
+            || (e_string_is_inline(&from16) == false
+                && e_string_capacity(&from16) != e_string_length(&from16))) {
+            test_fail();
+        }
+
+        /* the string length is always a large enough capacity */
+        size_t written = 0;
+        e_string_t text = priv_utf8(codepoints, count);
+        e_string_invalidate(&text);
+        if (e_string_to_utf16le(&text, units, e_string_length(&text), &written)
+                != E_STRING_SUCCESS
+            || written != utf16_count
+            || memcmp(units, utf16, written * sizeof(uint16_t)) != 0
+            || (text.flags & E_STRING_FLAG_UTF8) == 0
+            || e_string_to_utf32(&text, utf32, e_string_length(&text), &written)
+               != E_STRING_SUCCESS
+            || written != count
+            || memcmp(utf32, codepoints, count * sizeof(uint32_t)) != 0) {
+            test_fail();
+        }
+
+        e_string_free(&text);
+        e_string_free(&expected);
+        e_string_free(&from16);
+        e_string_free(&from32);
+    }
+
+    free(codepoints);
+    free(utf32);
+    free(utf16);
+    free(units);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_transcode] Testing invalid UTF-16LE and UTF-32");
+
+    /* every bad unit is tried inside a SIMD block and in the scalar tail */
+    const uint16_t bad16[][2] = { { 0xD800, 'a' }, { 0xDC00, 'a' },
+                                  { 0xDBFF, 0xD800 }, { 0x01, 'a' },
+                                  { 0x7F, 'a' }, { 0xDBFF, 0 } };
+    const uint32_t bad32[] = { 0xD800, 0xDFFF, 0x110000, 0xFFFFFFFF, 0x00,
+                               0x1B, 0x7F };
+    uint16_t utf16[70];
+    uint32_t utf32[70];
+    for (size_t at = 0; at < 68; at += 13) {
+        for (size_t b = 0; b < sizeof(bad16) / sizeof(bad16[0]); b++) {
+            const size_t count = (bad16[b][1] == 0) ? at + 1 : 70;
+            for (size_t i = 0; i < 70; i++) {
+                utf16[i] = priv_le16((i % 3 == 0) ? 0x65E5 : 'x');
+            }
+            utf16[at] = priv_le16(bad16[b][0]);
+            utf16[at + 1] = priv_le16(bad16[b][1]);
+
+            e_string_t string;
+            if (e_string_from_utf16le(utf16, count, &string)
+                    != E_STRING_INVALID_UNICODE
+                || e_string_length(&string) != 0) {
+                test_fail();
+            }
+        }
+        for (size_t b = 0; b < sizeof(bad32) / sizeof(bad32[0]); b++) {
+            for (size_t i = 0; i < 70; i++) {
+                utf32[i] = 'x';
+            }
+            utf32[at] = bad32[b];
+
+            e_string_t string;
+            if (e_string_from_utf32(utf32, 70, &string)
+                    != E_STRING_INVALID_UNICODE
+                || e_string_length(&string) != 0) {
+                test_fail();
+            }
+        }
+    }
+
+    /* allowed control codepoints and a pair split by a block limit */
+    for (size_t i = 0; i < 70; i++) {
+        utf16[i] = priv_le16((i % 2 == 0) ? '\r' : '\n');
+    }
+    utf16[15] = priv_le16(0xD83D);
+    utf16[16] = priv_le16(0xDE80);
+    e_string_t string;
+    if (e_string_from_utf16le(utf16, 70, &string) != E_STRING_SUCCESS
+        || e_string_length(&string) != 72
+        || (string.flags & E_STRING_FLAG_ASCII) != 0
+        || string.codepoint_count != 69
+        || memcmp(e_string_data(&string) + 15, "\xF0\x9F\x9A\x80", 4) != 0) {
+        test_fail();
+    }
+    e_string_free(&string);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_transcode] Testing invalid UTF-8 and small buffers");
+
+    const char* invalid[] = { "overlong \xC0\x80", "surrogate \xED\xA0\x80",
+                              "too large \xF4\x90\x80\x80", "cut \xE6\x97",
+                              "control \x01" };
+    uint16_t utf16[64];
+    uint32_t utf32[64];
+    size_t count;
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        e_string_t string = e_string_from_cstr(invalid[i]);
+        if (e_string_to_utf16le(&string, utf16, 64, &count)
+                != E_STRING_INVALID_UTF8
+            || e_string_to_utf32(&string, utf32, 64, &count)
+               != E_STRING_INVALID_UTF8
+            || e_string_to_utf32(&string, NULL, 0, &count)
+               != E_STRING_INVALID_UTF8
+            || (string.flags & E_STRING_FLAG_UTF8) != 0) {
+            test_fail();
+        }
+        e_string_free(&string);
+    }
+
+    /* runs of 3 byte codepoints are decoded by 8 at once */
+    e_string_t cjk = e_string_from_cstr(u8"日本語のテキスト日本語のテキスト日本語のテキスト");
+    if (e_string_to_utf16le(&cjk, utf16, 64, &count) != E_STRING_SUCCESS
+        || count != 24
+        || utf16[16] != priv_le16(0x65E5)
+        || utf16[23] != priv_le16(0x30C8)
+        || e_string_to_utf32(&cjk, utf32, 64, &count) != E_STRING_SUCCESS
+        || count != 24
+        || utf32[9] != 0x672C) {
+        test_fail();
+    }
+    e_string_free(&cjk);
+
+    /* a bad sequence inside a run of 3 byte codepoints, at every position */
+    const char* bad3[] = { "\xED\xA0\x80", "\xE0\x9F\xBF", "\xE6\x97\x41",
+                           "\xF0\x97\xA5" };
+    for (size_t b = 0; b < sizeof(bad3) / sizeof(bad3[0]); b++) {
+        for (size_t at = 0; at < 20; at++) {
+            e_string_t string = e_string_from_cstr("");
+            for (size_t i = 0; i < 20; i++) {
+                const char* piece = (i == at) ? bad3[b] : u8"日";
+                if (e_string_append_cstr(&string, piece) != E_STRING_SUCCESS) {
+                    test_fail();
+                }
+            }
+            if (e_string_to_utf16le(&string, utf16, 64, &count)
+                    != E_STRING_INVALID_UTF8
+                || e_string_to_utf32(&string, utf32, 64, &count)
+                   != E_STRING_INVALID_UTF8) {
+                test_fail();
+            }
+            e_string_free(&string);
+        }
+    }
+
+    /* 7 codepoints: 8 UTF-16 units, 14 bytes */
+    e_string_t string = e_string_from_cstr(u8"日本 🚀 ok");
+    if (e_string_to_utf16le(&string, NULL, 0, &count) != E_STRING_INVALID_BUFFER
+        || count != 8
+        || e_string_to_utf16le(&string, utf16, 8, &count) != E_STRING_SUCCESS
+        || count != 8
+        || utf16[3] != priv_le16(0xD83D)
+        || e_string_to_utf32(&string, utf32, 6, &count)
+           != E_STRING_INVALID_BUFFER
+        || count != 7
+        || e_string_to_utf32(&string, utf32, 7, &count) != E_STRING_SUCCESS
+        || count != 7
+        || utf32[3] != 0x1F680) {
+        test_fail();
+    }
+    e_string_free(&string);
+
+    e_string_t empty = e_string_from_cstr("");
+    if (e_string_to_utf16le(&empty, NULL, 0, &count) != E_STRING_SUCCESS
+        || count != 0
+        || e_string_from_utf32(NULL, 0, &empty) != E_STRING_SUCCESS
+        || e_string_length(&empty) != 0
+        || (empty.flags & E_STRING_FLAG_ASCII) == 0) {
+        test_fail();
+    }
+    e_string_free(&empty);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,185 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_utf8 codepoint access testing
+ *
+ * random texts mixing 1 to 4 byte codepoints are built together with the
+ * list of their codepoints, which every function is checked against.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_fail.h"
+
+static const uint32_t alphabet[] = { 'a', 'Z', ' ', 0xE7, 0x3A9, 0x65E5,
+                                     0x8A9E, 0x1F680, 0x10348 };
+
+/* private function priv_random_text
+ *
+ * builds a string of count random codepoints, storing them on codepoints
+ */
+static e_string_t priv_random_text(const size_t count, uint32_t* codepoints,
+                                   uint32_t seed)
+{
+    e_string_t text = e_string_from_cstr("");
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1103515245u + 12345u;
+        codepoints[i] = alphabet[(seed >> 16) % 9];
+        if (e_string_push_codepoint(&text, codepoints[i]) != E_STRING_SUCCESS) {
+            test_fail();
+        }
+    }
+    return text;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_utf8_length] Testing counts on every length and alignment");
+
+    const size_t count = 3000;
+    uint32_t* codepoints = malloc(count * sizeof(uint32_t));
+    e_string_t text = priv_random_text(count, codepoints, 11);
+    const uint8_t* data = e_string_data(&text);
+
+    /* every prefix and suffix goes through the vector body and scalar tail */
+    size_t offset = 0;
+    for (size_t i = 0; i < count; i++) {
+        e_string_view_t suffix = e_string_view_from_bytes(data + offset,
+                                                          e_string_length(&text)
+                                                          - offset);
+        e_string_view_t prefix = e_string_view_from_bytes(data, offset);
+        if (e_string_view_utf8_length(suffix) != count - i
+            || e_string_view_utf8_length(prefix) != i) {
+            test_fail();
+        }
+        offset += (codepoints[i] < 0x80) ? 1 : (codepoints[i] < 0x800) ? 2
+                : (codepoints[i] < 0x10000) ? 3 : 4;
+    }
+
+    /* the count is cached once the string is known to be valid */
+    e_string_invalidate(&text);
+    if (e_string_utf8_length(&text) != count
+        || (text.flags & E_STRING_FLAG_COUNTED) != 0
+        || e_string_validate(&text) != E_STRING_SUCCESS
+        || e_string_utf8_length(&text) != count
+        || (text.flags & E_STRING_FLAG_COUNTED) == 0
+        || text.codepoint_count != count) {
+        test_fail();
+    }
+
+    e_string_free(&text);
+    free(codepoints);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_char_at] Testing random access with and without index");
+
+    const size_t count = 20000;
+    uint32_t* codepoints = malloc(count * sizeof(uint32_t));
+    e_string_t text = priv_random_text(count, codepoints, 5);
+
+    const size_t strides[] = { 1, 7, 64, 0 };
+    for (size_t s = 0; s < sizeof(strides) / sizeof(strides[0]); s++) {
+        e_string_index_t index;
+        if (e_string_index_build(&index, &text, strides[s]) != E_STRING_SUCCESS
+            || index.codepoint_count != count) {
+            test_fail();
+        }
+        for (size_t i = 0; i < count; i += (s + 1)) {
+            uint32_t codepoint = 0;
+            if (e_string_char_at(&text, &index, i, &codepoint)
+                    != E_STRING_SUCCESS
+                || codepoint != codepoints[i]) {
+                test_fail();
+            }
+        }
+        uint32_t codepoint;
+        if (e_string_char_at(&text, &index, count, &codepoint)
+                != E_STRING_OUT_OF_RANGE
+            || e_string_char_at(&text, &index, SIZE_MAX, &codepoint)
+                != E_STRING_OUT_OF_RANGE) {
+            test_fail();
+        }
+        e_string_index_free(&index);
+    }
+
+    for (size_t i = 0; i < count; i += 997) {
+        uint32_t codepoint = 0;
+        if (e_string_char_at(&text, NULL, i, &codepoint) != E_STRING_SUCCESS
+            || codepoint != codepoints[i]) {
+            test_fail();
+        }
+    }
+
+    e_string_free(&text);
+    free(codepoints);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_utf8_substr] Testing codepoint slicing");
+
+    e_string_t text = e_string_from_cstr(u8"日本語のテキスト and ascii");
+    e_string_index_t index;
+    e_string_view_t view;
+    if (e_string_index_build(&index, &text, 4) != E_STRING_SUCCESS
+        || e_string_utf8_substr(&text, &index, 3, 5, &view) != E_STRING_SUCCESS
+        || e_string_view_equals(view, e_string_view_from_cstr(u8"のテキスト"))
+           == false
+        || view.flags != E_STRING_FLAG_UTF8
+        || e_string_utf8_substr(&text, NULL, 13, 100, &view)
+           != E_STRING_SUCCESS
+        || e_string_view_equals(view, e_string_view_from_cstr("ascii"))
+           == false
+        || e_string_utf8_substr(&text, &index, 100, 1, &view)
+           != E_STRING_SUCCESS
+        || view.length != 0) {
+        test_fail();
+    }
+    e_string_index_free(&index);
+
+    /* US ASCII needs no checkpoints */
+    e_string_t ascii = e_string_from_cstr("plain US ASCII text, no index needed");
+    uint32_t codepoint;
+    if (e_string_index_build(&index, &ascii, 0) != E_STRING_SUCCESS
+        || index.offsets != NULL
+        || e_string_char_at(&ascii, &index, 6, &codepoint) != E_STRING_SUCCESS
+        || codepoint != 'U'
+        || e_string_utf8_substr(&ascii, NULL, 6, 8, &view) != E_STRING_SUCCESS
+        || e_string_view_equals(view, e_string_view_from_cstr("US ASCII"))
+           == false) {
+        test_fail();
+    }
+    e_string_index_free(&index);
+
+    e_string_t invalid = e_string_from_cstr("bad \xC3");
+    if (e_string_char_at(&invalid, NULL, 0, &codepoint) != E_STRING_INVALID_UTF8
+        || e_string_index_build(&index, &invalid, 0) != E_STRING_INVALID_UTF8) {
+        test_fail();
+    }
+
+    e_string_free(&text);
+    e_string_free(&ascii);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    return EXIT_SUCCESS;
+}
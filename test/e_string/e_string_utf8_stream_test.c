@@ -0,0 +1,158 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_utf8_stream namespace testing
+ *
+ * data split in chunks of every size must give the same result and the same
+ * error offset as the data validated at once.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+
+typedef struct test_case
+{
+    const char* data;
+    e_string_errno_t expected;
+    size_t error_offset;
+} test_case_t;
+
+static const test_case_t cases[] = {
+    { "hello world", E_STRING_SUCCESS, 0 },
+    { "ol\xC3\xA1 \xE4\xBD\xA0\xE5\xA5\xBD \xF0\x9F\x98\x80!", E_STRING_SUCCESS, 0 },
+    { "abc\xC3", E_STRING_INVALID_UTF8, 3 },
+    { "\xE4\xBD\xA0\xE5\xA5\xBD\xE4\xBD", E_STRING_INVALID_UTF8, 6 },
+    { "ab\xE0\x80\x80zz", E_STRING_INVALID_UTF8, 2 },
+    { "ab\xED\xA0\x80zz", E_STRING_INVALID_UTF8, 2 },
+    { "a\x01" "b", E_STRING_INVALID_UTF8, 1 },
+    { "\xF0\x9F\x98\x80\xF4\x90\x80\x80", E_STRING_INVALID_UTF8, 4 },
+    { "\xF0\x9F\x98\x80\x80", E_STRING_INVALID_UTF8, 4 },
+    { "xyz\xC3\xA1\xC0\xAF", E_STRING_INVALID_UTF8, 5 },
+    { "0123456789abcdef0123456789abcdef\xF0\x9F\x98\x41", E_STRING_INVALID_UTF8, 32 }
+};
+
+/* private function priv_feed_chunks
+ *
+ * feeds data in chunks of chunk_size bytes and returns the final result
+ */
+static e_string_errno_t priv_feed_chunks(e_string_utf8_stream_t* stream,
+                                         const uint8_t* data,
+                                         const size_t length,
+                                         const size_t chunk_size)
+{
+    e_string_utf8_stream_init(stream);
+    for (size_t index = 0; index < length; index += chunk_size) {
+        const size_t size = (length - index < chunk_size) ? length - index
+                                                          : chunk_size;
+        e_string_utf8_stream_feed(stream, data + index, size);
+    }
+    return e_string_utf8_stream_finish(stream);
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_utf8_stream] Testing every chunk size on edge cases");
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        const uint8_t* data = (const uint8_t*)cases[c].data;
+        const size_t length = strlen(cases[c].data);
+        for (size_t chunk = 1; chunk <= length; chunk++) {
+            e_string_utf8_stream_t stream;
+            const e_string_errno_t result = priv_feed_chunks(&stream, data,
+                                                             length, chunk);
+            if (result != cases[c].expected
+                || (result == E_STRING_INVALID_UTF8
+                    && stream.error_offset != cases[c].error_offset)) {
+                fprintf(stdout, "%s\n%s %zu %s %zu %s %zu\n", u8"FAIL",
+                        u8"[e_string_utf8_stream] case", c,
+                        u8"chunk", chunk,
+                        u8"error offset", stream.error_offset);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_utf8_stream] Testing large data against e_string_validate");
+
+    static const char* pieces[] = { "log line ", "\n", "\xC3\xA7", "\xE6\x97\xA5",
+                                    "\xF0\x9F\x9A\x80" };
+    const size_t length = 1 << 16;
+    uint8_t* data = malloc(length + 4);
+    size_t filled = 0;
+    uint32_t seed = 7;
+    while (filled < length) {
+        seed = seed * 1103515245u + 12345u;
+        const char* piece = pieces[(seed >> 16) % 5];
+        memcpy(data + filled, piece, strlen(piece));
+        filled += strlen(piece);
+    }
+
+    for (int round = 0; round < 64; round++) {
+        seed = seed * 1103515245u + 12345u;
+        const size_t corrupt = (seed >> 8) % filled;
+        const uint8_t saved = data[corrupt];
+        if (round % 2 == 1) {
+            data[corrupt] = 0xFF;
+        }
+
+        e_string_t string = {
+            .data_length = filled,
+            .buffer_capacity = filled,
+            .data = data
+        };
+        e_string_utf8_stream_t stream;
+        const e_string_errno_t result = priv_feed_chunks(&stream, data, filled,
+                                                         1 + (seed >> 20) % 4099);
+        if (result != e_string_validate(&string)
+            || (result == E_STRING_INVALID_UTF8
+                && (stream.error_offset > corrupt
+                    || corrupt - stream.error_offset > 3))) {
+            fprintf(stdout, "%s\n", u8"FAIL");
+            exit(EXIT_FAILURE);
+        }
+        data[corrupt] = saved;
+    }
+
+    free(data);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_utf8_stream] Testing chunks are ignored after an error");
+
+    e_string_utf8_stream_t stream;
+    e_string_utf8_stream_init(&stream);
+    if (e_string_utf8_stream_feed(&stream, (const uint8_t*)"ab\xFF", 3)
+            != E_STRING_INVALID_UTF8
+        || e_string_utf8_stream_feed(&stream, (const uint8_t*)"cd", 2)
+            != E_STRING_INVALID_UTF8
+        || e_string_utf8_stream_finish(&stream) != E_STRING_INVALID_UTF8
+        || stream.error_offset != 2) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    return EXIT_SUCCESS;
+}
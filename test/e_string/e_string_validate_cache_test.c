@@ -0,0 +1,114 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_validate cached flags testing */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+
+/* private function priv_string
+ *
+ * creates a e_string_t pointing to a copy of cstr, with nothing cached
+ */
+static e_string_t priv_string(const char* cstr)
+{
+    const size_t length = strlen(cstr);
+    e_string_t result = {
+        .data_length = length,
+        .buffer_capacity = length,
+        .data = malloc(length + 1)
+    };
+    memcpy(result.data, cstr, length + 1);
+    return result;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_validate_cache] Testing US ASCII caches count");
+
+    e_string_t string = priv_string("hello");
+    if (string.flags != 0
+        || e_string_validate(&string) != E_STRING_SUCCESS
+        || string.flags != (E_STRING_FLAG_UTF8 | E_STRING_FLAG_ASCII
+                            | E_STRING_FLAG_COUNTED)
+        || string.codepoint_count != 5) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    free(string.data);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_validate_cache] Testing UTF-8 is not flagged ASCII");
+
+    e_string_t string = priv_string(u8"olá 你好");
+    if (e_string_validate(&string) != E_STRING_SUCCESS
+        || string.flags != E_STRING_FLAG_UTF8) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    free(string.data);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_validate_cache] Testing cache is kept until invalidate");
+
+    e_string_t string = priv_string("abc");
+    e_string_validate(&string);
+
+    /* direct change without invalidate keeps the cached result */
+    string.data[1] = 0xFF;
+    if (e_string_validate(&string) != E_STRING_SUCCESS) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+
+    e_string_invalidate(&string);
+    if (string.flags != 0
+        || e_string_validate(&string) != E_STRING_INVALID_UTF8
+        || string.flags != 0) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    free(string.data);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_4(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_validate_cache] Testing buffer is checked when cached");
+
+    e_string_t string = priv_string("abc");
+    e_string_validate(&string);
+    string.buffer_capacity = 2;
+    if (e_string_validate(&string) != E_STRING_INVALID_BUFFER) {
+        fprintf(stdout, "%s\n", u8"FAIL");
+        exit(EXIT_FAILURE);
+    }
+    free(string.data);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    test_4();
+    return EXIT_SUCCESS;
+}
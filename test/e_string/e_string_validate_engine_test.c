@@ -0,0 +1,203 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_validate engines testing
+ *
+ * every engine supported by the running CPU must return exactly the same
+ * result as the scalar engine, for both valid and invalid data.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+
+#define TEST_BUFFER_SIZE 512
+
+static const e_string_engine_t engines[] = {
+    E_STRING_ENGINE_AUTO,
+    E_STRING_ENGINE_DFA,
+    E_STRING_ENGINE_SSE42,
+    E_STRING_ENGINE_AVX2,
+    E_STRING_ENGINE_AVX512
+};
+
+/* private function priv_random
+ *
+ * deterministic xorshift generator so failures can be reproduced
+ */
+static uint64_t priv_random(void)
+{
+    static uint64_t state = 0x9E3779B97F4A7C15ULL;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+/* private function priv_compare_engines
+ *
+ * validates data with every engine, placing it at the end of a vector so
+ * truncated sequences are checked on every tail size.
+ */
+static bool priv_compare_engines(const uint8_t* data, const size_t length)
+{
+    e_string_t string = {
+        .data_length = length,
+        .buffer_capacity = length,
+        .data = (uint8_t*)data
+    };
+    const e_string_errno_t expected = e_string_validate_ex(&string,
+                                                           E_STRING_ENGINE_SCALAR);
+
+    for (size_t i = 0; i < sizeof(engines) / sizeof(engines[0]); i++) {
+        const e_string_errno_t result = e_string_validate_ex(&string,
+                                                             engines[i]);
+        if (result == E_STRING_UNSUPPORTED_ENGINE) {
+            continue;
+        }
+        if (result != expected) {
+            fprintf(stdout, "\n%s %d %s %zu %s %d %s %d\n",
+                    u8"[e_string_validate_engine] engine", (int)engines[i],
+                    u8"length", length,
+                    u8"returned", result,
+                    u8"expected", expected);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* private function priv_compare_padded
+ *
+ * checks a sequence preceded by ASCII of sizes around every vector boundary,
+ * so the sequence crosses the boundaries of every engine.
+ */
+static bool priv_compare_padded(const uint8_t* sequence, const size_t length)
+{
+    static const size_t prefixes[] = { 0, 13, 14, 15, 29, 30, 31, 61, 62, 63 };
+    uint8_t buffer[TEST_BUFFER_SIZE];
+    for (size_t i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); i++) {
+        const size_t prefix = prefixes[i];
+        memset(buffer, 'a', prefix);
+        memcpy(buffer + prefix, sequence, length);
+        if (priv_compare_engines(buffer, prefix + length) == false
+            || priv_compare_engines(buffer, prefix + length - 1) == false) {
+            return false;
+        }
+        /* also followed by ASCII */
+        memset(buffer + prefix + length, 'b', 70);
+        if (priv_compare_engines(buffer, prefix + length + 70) == false) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_validate_engine] Testing every 1 and 2 byte pair");
+
+    for (unsigned first = 0; first <= 0xFF; first++) {
+        for (unsigned second = 0; second <= 0xFF; second++) {
+            const uint8_t sequence[] = { (uint8_t)first, (uint8_t)second };
+            if (priv_compare_padded(sequence, 2) == false) {
+                fprintf(stdout, "%s\n", u8"FAIL");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_validate_engine] Testing 3 and 4 byte boundaries");
+
+    static const uint8_t leads[] = { 0xE0, 0xE1, 0xEC, 0xED, 0xEE, 0xEF,
+                                     0xF0, 0xF1, 0xF3, 0xF4, 0xF5, 0xFF };
+    static const uint8_t conts[] = { 0x00, 0x41, 0x7F, 0x80, 0x8F, 0x90,
+                                     0x9F, 0xA0, 0xBF, 0xC0, 0xC2, 0xFF };
+    for (size_t l = 0; l < sizeof(leads); l++) {
+        for (size_t a = 0; a < sizeof(conts); a++) {
+            for (size_t b = 0; b < sizeof(conts); b++) {
+                for (size_t c = 0; c < sizeof(conts); c++) {
+                    const uint8_t sequence[] = { leads[l], conts[a],
+                                                 conts[b], conts[c] };
+                    if (priv_compare_engines(sequence, 3) == false
+                        || priv_compare_padded(sequence, 4) == false) {
+                        fprintf(stdout, "%s\n", u8"FAIL");
+                        exit(EXIT_FAILURE);
+                    }
+                }
+            }
+        }
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_validate_engine] Testing random mixed-script data");
+
+    static const char* pieces[] = { "a", "hello ", "\t", "\r\n", "á", "ç",
+                                    "你好", "日本", "😀", "𝄞", "\xF4\x8F\xBF\xBF",
+                                    "\xEF\xBF\xBD" };
+    uint8_t buffer[TEST_BUFFER_SIZE];
+    for (int round = 0; round < 20000; round++) {
+        size_t length = 0;
+        const size_t target = priv_random() % (TEST_BUFFER_SIZE - 16);
+        while (length < target) {
+            const char* piece = pieces[priv_random()
+                                       % (sizeof(pieces) / sizeof(pieces[0]))];
+            memcpy(buffer + length, piece, strlen(piece));
+            length += strlen(piece);
+        }
+        /* half of the rounds corrupt one byte */
+        if (round % 2 == 1 && length > 0) {
+            buffer[priv_random() % length] = (uint8_t)priv_random();
+        }
+        if (priv_compare_engines(buffer, length) == false) {
+            fprintf(stdout, "%s\n", u8"FAIL");
+            exit(EXIT_FAILURE);
+        }
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_4(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_validate_engine] Testing ASCII control codepoints");
+
+    uint8_t buffer[TEST_BUFFER_SIZE];
+    memset(buffer, 'x', sizeof(buffer));
+    for (size_t position = 0; position < 130; position++) {
+        for (unsigned byte = 0; byte <= 0x7F; byte++) {
+            buffer[position] = (uint8_t)byte;
+            if (priv_compare_engines(buffer, 130) == false) {
+                fprintf(stdout, "%s\n", u8"FAIL");
+                exit(EXIT_FAILURE);
+            }
+        }
+        buffer[position] = 'x';
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_1();
+    test_2();
+    test_3();
+    test_4();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,188 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_string_view namespace testing */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_string.h"
+#include "test_allocator.h"
+#include "test_fail.h"
+
+/* private function priv_is
+ *
+ * checks view holds expected with the expected flags
+ */
+static bool priv_is(const e_string_view_t view, const char* expected,
+                    const uint32_t flags)
+{
+    return e_string_view_equals(view, e_string_view_from_cstr(expected))
+        && view.flags == flags;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_view] Testing substr keeps flags on boundaries");
+
+    e_string_t string = e_string_from_cstr(u8"não há pão sem açúcar");
+    e_string_validate(&string);
+    const e_string_view_t view = e_string_view(&string);
+    const uint32_t utf8 = E_STRING_FLAG_UTF8;
+
+    if (priv_is(view, u8"não há pão sem açúcar", utf8) == false
+        || priv_is(e_string_view_substr(view, 0, 3), u8"nã", utf8) == false
+        || priv_is(e_string_view_substr(view, 0, 2), "n\xC3", 0) == false
+        || priv_is(e_string_view_substr(view, 1, 2), u8"ã", utf8) == false
+        || priv_is(e_string_view_substr(view, 2, 1), "\xA3", 0) == false
+        || priv_is(e_string_view_substr(view, 18, 100), u8"açúcar", utf8)
+           == false
+        || e_string_view_substr(view, 100, 5).length != 0) {
+        test_fail();
+    }
+
+    e_string_t ascii = e_string_from_cstr("plain ascii");
+    e_string_validate(&ascii);
+    if (priv_is(e_string_view_substr(e_string_view(&ascii), 6, 3), "asc",
+                E_STRING_FLAG_UTF8 | E_STRING_FLAG_ASCII) == false) {
+        test_fail();
+    }
+    e_string_free(&string);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_view] Testing trim, starts_with and ends_with");
+
+    e_string_view_t view = e_string_view_from_cstr(" \t value \xC3\xA7\r\n");
+    if (e_string_view_validate(&view) != E_STRING_SUCCESS
+        || priv_is(e_string_view_trim(view), "value \xC3\xA7",
+                   E_STRING_FLAG_UTF8) == false
+        || priv_is(e_string_view_trim_start(view), "value \xC3\xA7\r\n",
+                   E_STRING_FLAG_UTF8) == false
+        || priv_is(e_string_view_trim_end(view), " \t value \xC3\xA7",
+                   E_STRING_FLAG_UTF8) == false
+        || e_string_view_trim(e_string_view_from_cstr(" \r\n")).length != 0
+        || e_string_view_starts_with(view, e_string_view_from_cstr(" \t v"))
+           == false
+        || e_string_view_starts_with(view, e_string_view_from_cstr("v"))
+           == true
+        || e_string_view_ends_with(view, e_string_view_from_cstr("\r\n"))
+           == false
+        || e_string_view_ends_with(view, e_string_view_from_cstr(""))
+           == false
+        || e_string_view_ends_with(e_string_view_from_cstr("a"), view)
+           == true) {
+        test_fail();
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_view] Testing split_once and the split iterator");
+
+    const e_string_view_t comma = e_string_view_from_cstr(",");
+    const char* expected[] = { "a", "", u8"çç", "" };
+    e_string_split_t split;
+    e_string_view_t part;
+    size_t count = 0;
+    e_string_split_init(&split, e_string_view_from_cstr(u8"a,,çç,"), comma);
+    while (e_string_split_next(&split, &part) == true) {
+        if (count >= 4 || priv_is(part, expected[count], 0) == false) {
+            test_fail();
+        }
+        count += 1;
+    }
+
+    e_string_view_t before;
+    e_string_view_t after;
+    e_string_split_init(&split, e_string_view_from_cstr(""), comma);
+    if (count != 4
+        || e_string_split_next(&split, &part) == false || part.length != 0
+        || e_string_split_next(&split, &part) == true
+        || e_string_view_split_once(e_string_view_from_cstr("k: v: w"),
+                                    e_string_view_from_cstr(": "),
+                                    &before, &after) == false
+        || priv_is(before, "k", 0) == false
+        || priv_is(after, "v: w", 0) == false
+        || e_string_view_split_once(e_string_view_from_cstr("abc"),
+                                    e_string_view_from_cstr("abcd"),
+                                    &before, &after) == true
+        || e_string_view_split_once(e_string_view_from_cstr("abc"),
+                                    e_string_view_from_cstr(""),
+                                    &before, &after) == true) {
+        test_fail();
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_4(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_string_view] Testing header parsing does not allocate");
+    const size_t allocations = counter.allocations + counter.reallocations;
+
+    const char* request = "GET / HTTP/1.1\r\n"
+                          "Host: example.com\r\n"
+                          "Content-Type:  text/plain; charset=utf-8 \r\n"
+                          "X-Name: Jos\xC3\xA9\r\n"
+                          "\r\n";
+    e_string_view_t message = e_string_view_from_cstr(request);
+    if (e_string_view_validate(&message) != E_STRING_SUCCESS) {
+        test_fail();
+    }
+
+    const e_string_view_t crlf = e_string_view_from_cstr("\r\n");
+    const e_string_view_t colon = e_string_view_from_cstr(":");
+    e_string_view_t content_type = { 0 };
+    e_string_view_t name = { 0 };
+    e_string_split_t lines;
+    e_string_view_t line;
+    e_string_split_init(&lines, message, crlf);
+    e_string_split_next(&lines, &line);
+    while (e_string_split_next(&lines, &line) == true && line.length > 0) {
+        e_string_view_t key;
+        e_string_view_t value;
+        if (e_string_view_split_once(line, colon, &key, &value) == false) {
+            test_fail();
+        }
+        if (e_string_view_equals(key, e_string_view_from_cstr("Content-Type"))) {
+            content_type = e_string_view_trim(value);
+        } else if (e_string_view_equals(key,
+                                        e_string_view_from_cstr("X-Name"))) {
+            name = e_string_view_trim(value);
+        }
+    }
+
+    e_string_t owned = e_string_from_view(name);
+    if (counter.allocations + counter.reallocations != allocations
+        || priv_is(content_type, "text/plain; charset=utf-8",
+                   E_STRING_FLAG_UTF8) == false
+        || priv_is(name, "Jos\xC3\xA9", E_STRING_FLAG_UTF8) == false
+        || owned.flags != (E_STRING_FLAG_INLINE | E_STRING_FLAG_UTF8)) {
+        test_fail();
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_allocator_install();
+
+    test_1();
+    test_2();
+    test_3();
+    test_4();
+
+    return test_allocator_check(u8"[e_string_view]");
+}
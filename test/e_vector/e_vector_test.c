@@ -0,0 +1,205 @@
+/* Copyright (c) 2023, diogoefl
+ * SPDX-License-Identifier: BSD-3-Clause
+ * See LICENSE file at this project root for more detailed information
+ */
+
+/* e_vector testing
+ *
+ * every test runs on a counting e_string allocator, which checks that the
+ * vectors use it, that sizes given back match the allocated ones and that
+ * nothing is leaked.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "e_vector.h"
+#include "test_allocator.h"
+#include "test_fail.h"
+
+typedef struct test_span
+{
+    uint32_t start;
+    uint32_t length;
+} test_span_t;
+
+E_VECTOR_DECLARE(test_u64_vector, uint64_t)
+E_VECTOR_DECLARE_SMALL(test_span_vector, test_span_t, 4)
+
+/* private function priv_is_odd
+ *
+ * erase_if predicate removing odd numbers
+ */
+static bool priv_is_odd(const uint64_t* element, void* context)
+{
+    (void)context;
+    return (*element & 1) != 0;
+}
+
+/* private function priv_is_longer
+ *
+ * erase_if predicate removing spans longer than the context
+ */
+static bool priv_is_longer(const test_span_t* element, void* context)
+{
+    return element->length > *(const uint32_t*)context;
+}
+
+void test_1(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_vector] Testing push, pop, growth and shrink");
+
+    test_u64_vector_t vector;
+    test_u64_vector_init(&vector);
+    uint64_t value = 0;
+    if (vector.data != NULL || test_u64_vector_pop(&vector, &value) == true
+        || test_u64_vector_shrink(&vector) != E_STRING_SUCCESS) {
+        test_fail();
+    }
+
+    /* 10000 pushes take a logarithmic amount of allocations */
+    const size_t allocations = counter.allocations + counter.reallocations;
+    for (uint64_t i = 0; i < 10000; i++) {
+        if (test_u64_vector_push(&vector, i * i) != E_STRING_SUCCESS) {
+            test_fail();
+        }
+    }
+    if (vector.length != 10000 || vector.capacity < 10000
+        || counter.allocations + counter.reallocations - allocations > 16
+        || vector.data[9999] != 9999 * 9999) {
+        test_fail();
+    }
+
+    if (test_u64_vector_pop(&vector, &value) == false
+        || value != 9999 * 9999 || vector.length != 9999
+        || test_u64_vector_pop(&vector, NULL) == false
+        || test_u64_vector_shrink(&vector) != E_STRING_SUCCESS
+        || vector.capacity != 9998 || counter.live_bytes != 9998 * 8
+        || vector.data[9997] != 9997 * 9997
+        || test_u64_vector_reserve(&vector, 20000) != E_STRING_SUCCESS
+        || vector.capacity < 20000 || vector.data[5000] != 5000 * 5000) {
+        test_fail();
+    }
+
+    test_u64_vector_clear(&vector);
+    if (vector.length != 0 || vector.capacity < 20000
+        || test_u64_vector_shrink(&vector) != E_STRING_SUCCESS
+        || vector.data != NULL || counter.live_bytes != 0) {
+        test_fail();
+    }
+    test_u64_vector_free(&vector);
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_2(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_vector] Testing append_n, insert_range and erase");
+
+    test_u64_vector_t vector;
+    test_u64_vector_init(&vector);
+    const uint64_t numbers[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    const uint64_t tens[] = { 10, 20, 30 };
+    if (test_u64_vector_append_n(&vector, numbers, 8) != E_STRING_SUCCESS
+        || test_u64_vector_insert_range(&vector, 2, tens, 3)
+            != E_STRING_SUCCESS
+        || test_u64_vector_insert_range(&vector, 11, tens, 1)
+            != E_STRING_SUCCESS
+        || test_u64_vector_insert_range(&vector, 0, tens + 2, 1)
+            != E_STRING_SUCCESS
+        || test_u64_vector_insert_range(&vector, 14, tens, 1)
+            != E_STRING_OUT_OF_RANGE
+        || test_u64_vector_append_n(&vector, NULL, 0) != E_STRING_SUCCESS) {
+        test_fail();
+    }
+
+    const uint64_t inserted[] = { 30, 1, 2, 10, 20, 30, 3, 4, 5, 6, 7, 8,
+                                  10 };
+    if (vector.length != 13
+        || memcmp(vector.data, inserted, sizeof(inserted)) != 0) {
+        test_fail();
+    }
+
+    const uint64_t erased[] = { 30, 1, 2, 3, 4, 5, 6, 7, 8 };
+    if (test_u64_vector_erase_range(&vector, 3, 3) != E_STRING_SUCCESS
+        || test_u64_vector_erase_range(&vector, 9, 1) != E_STRING_SUCCESS
+        || test_u64_vector_erase_range(&vector, 8, 2) != E_STRING_OUT_OF_RANGE
+        || test_u64_vector_erase_range(&vector, 9, 0) != E_STRING_SUCCESS
+        || vector.length != 9
+        || memcmp(vector.data, erased, sizeof(erased)) != 0) {
+        test_fail();
+    }
+
+    const uint64_t even[] = { 30, 2, 4, 6, 8 };
+    if (test_u64_vector_erase_if(&vector, priv_is_odd, NULL) != 4
+        || vector.length != 5
+        || memcmp(vector.data, even, sizeof(even)) != 0
+        || test_u64_vector_erase_if(&vector, priv_is_odd, NULL) != 0) {
+        test_fail();
+    }
+    test_u64_vector_free(&vector);
+    if (counter.live_bytes != 0) {
+        test_fail();
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+void test_3(void)
+{
+    fprintf(stdout, "%s ... ",
+            u8"[e_vector] Testing small vectors stay inline until they grow");
+
+    test_span_vector_t vector;
+    test_span_vector_init(&vector);
+    const size_t allocations = counter.allocations;
+    for (uint32_t i = 0; i < 4; i++) {
+        const test_span_t span = { .start = i * 10, .length = i };
+        if (test_span_vector_push(&vector, span) != E_STRING_SUCCESS) {
+            test_fail();
+        }
+    }
+    if (vector.data != vector.small || vector.capacity != 4
+        || counter.allocations != allocations) {
+        test_fail();
+    }
+
+    /* the fifth element moves everything to the heap */
+    const test_span_t spans[] = { { 40, 4 }, { 50, 5 }, { 60, 6 } };
+    if (test_span_vector_append_n(&vector, spans, 3) != E_STRING_SUCCESS
+        || vector.data == vector.small || vector.length != 7
+        || counter.allocations != allocations + 1
+        || vector.data[2].start != 20 || vector.data[6].length != 6) {
+        test_fail();
+    }
+
+    /* shrinking back below the inline capacity returns to it */
+    const uint32_t limit = 2;
+    if (test_span_vector_erase_if(&vector, priv_is_longer,
+                                  (void*)&limit) != 4
+        || test_span_vector_shrink(&vector) != E_STRING_SUCCESS
+        || vector.data != vector.small || vector.capacity != 4
+        || vector.length != 3 || vector.data[2].start != 20
+        || counter.live_bytes != 0) {
+        test_fail();
+    }
+    test_span_vector_free(&vector);
+    if (vector.data != vector.small || vector.length != 0) {
+        test_fail();
+    }
+    fprintf(stdout, "%s\n", u8"SUCCESS");
+}
+
+int main(void)
+{
+    test_allocator_install();
+
+    test_1();
+    test_2();
+    test_3();
+
+    return test_allocator_check(u8"[e_vector]");
+}